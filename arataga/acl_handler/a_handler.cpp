@@ -19,6 +19,15 @@
 #include <fmt/ostream.h>
 #include <fmt/chrono.h>
 
+#if defined(__linux__)
+	#include <sys/socket.h>
+	#include <netinet/in.h>
+	#include <netinet/tcp.h>
+	#include <unistd.h>
+
+	#include <cerrno>
+#endif
+
 using namespace std::chrono_literals;
 
 namespace arataga::acl_handler
@@ -58,6 +67,20 @@ actual_config_t::io_chunk_count() const noexcept
 	return m_common_acl_params.m_io_chunk_count;
 }
 
+relay_mode_t
+actual_config_t::relay_mode() const noexcept
+{
+	// The personal value for the ACL has the priority.
+	return m_acl_config.m_relay_mode.value_or(
+			m_common_acl_params.m_relay_mode );
+}
+
+std::chrono::milliseconds
+actual_config_t::bandlim_refill_interval() const noexcept
+{
+	return m_common_acl_params.m_bandlim_refill_interval;
+}
+
 std::chrono::milliseconds
 actual_config_t::protocol_detection_timeout() const noexcept
 {
@@ -112,6 +135,18 @@ actual_config_t::http_negative_response_timeout() const noexcept
 	return m_common_acl_params.m_http_negative_response_timeout;
 }
 
+std::size_t
+actual_config_t::http_upstream_pool_size() const noexcept
+{
+	return m_common_acl_params.m_http_upstream_pool_size;
+}
+
+std::chrono::milliseconds
+actual_config_t::http_upstream_idle_timeout() const noexcept
+{
+	return m_common_acl_params.m_http_upstream_idle_timeout;
+}
+
 const http_message_value_limits_t &
 actual_config_t::http_message_limits() const noexcept
 {
@@ -127,10 +162,16 @@ actual_config_t::http_message_limits() const noexcept
  */
 class actual_traffic_limiter_t final : public traffic_limiter_t
 {
+	// The state of the ACL. It holds the limit for the whole ACL.
+	std::shared_ptr< shard_group_t > m_shard_group;
+
 	// This reference is necessary to decrement the count of connections
 	// when traffic_limiter is destroyed (maybe the information about
 	// this user will be removed too if it was the last connection).
-	authentificated_user_map_t & m_auth_users;
+	//
+	// Since v.0.6.0 the info about users is shared by all ACLs and
+	// the map of users should be modified only under the lock.
+	std::shared_ptr< authentificated_users_t > m_authentificated_users;
 
 	// Reference to the description of that user.
 	authentificated_user_map_t::iterator m_it_auth_user;
@@ -142,16 +183,36 @@ class actual_traffic_limiter_t final : public traffic_limiter_t
 
 	// Type of a pointer to a field in channel_limits_data_t.
 	using end_member_ptr_t =
-			bandlim_manager_t::direction_traffic_info_t
+			atomic_token_bucket_t
 					bandlim_manager_t::channel_limits_data_t::*;
 
+	// Max count of buckets to be checked for one connection:
+	// the ACL, the user and the domain.
+	static constexpr std::size_t max_buckets{ 3u };
+
+	// Type of container for buckets to be checked for one direction.
+	//
+	// NOTE: buckets are ordered from the widest limit to the narrowest.
+	struct bucket_chain_t
+	{
+		std::array< atomic_token_bucket_t *, max_buckets > m_buckets;
+		std::size_t m_size{};
+	};
+
 	[[nodiscard]]
-	static bandlim_manager_t::direction_traffic_info_t &
-	get_reference_to_member(
-		end_member_ptr_t member,
-		bandlim_manager_t::channel_limits_data_t & channel_limits ) noexcept
+	bucket_chain_t
+	make_bucket_chain( end_member_ptr_t member ) const noexcept
 	{
-		return (channel_limits.*member);
+		bucket_chain_t chain;
+		chain.m_buckets[ chain.m_size++ ] =
+				&(m_shard_group->bandlims().*member);
+		chain.m_buckets[ chain.m_size++ ] =
+				&(m_it_auth_user->second.m_bandlims.general_traffic().*member);
+		if( m_it_domain_traffic )
+			chain.m_buckets[ chain.m_size++ ] =
+					&((*m_it_domain_traffic)->second.m_traffic.*member);
+
+		return chain;
 	}
 
 	[[nodiscard]]
@@ -160,51 +221,33 @@ class actual_traffic_limiter_t final : public traffic_limiter_t
 		end_member_ptr_t member,
 		std::size_t buffer_size ) noexcept
 	{
-		std::size_t reserved_amount{};
+		const auto chain = make_bucket_chain( member );
 
-		const auto free_space_or_zero =
-			[]( auto quote, auto reserved, auto actual ) {
-				const auto spent = reserved + actual;
+		// Since v.0.6.0 token buckets have to be refilled before
+		// the detection of the free space.
+		const auto now = std::chrono::steady_clock::now();
 
-				return static_cast< std::size_t >(
-						spent < *quote ? (*quote - spent) : 0u );
-			};
+		std::size_t reserved_amount = buffer_size;
+		for( std::size_t i = 0u; i != chain.m_size && reserved_amount; ++i )
+		{
+			auto & bucket = *(chain.m_buckets[ i ]);
+			bucket.refill( now );
 
-		bandlim_manager_t::direction_traffic_info_t & total_traffic =
-				get_reference_to_member(
-						member,
-						m_it_auth_user->second.m_bandlims.general_traffic() );
-
-		bandlim_manager_t::direction_traffic_info_t * opt_domain_traffic =
-				m_it_domain_traffic ?
-				  	&(get_reference_to_member(
-							member,
-							(*m_it_domain_traffic)->second.m_traffic )) 
-					: nullptr;
-
-		reserved_amount = free_space_or_zero(
-				total_traffic.m_quote,
-				total_traffic.m_reserved,
-				total_traffic.m_actual );
-
-		if( opt_domain_traffic )
-			reserved_amount = std::min(
-					reserved_amount,
-					free_space_or_zero(
-							opt_domain_traffic->m_quote,
-							opt_domain_traffic->m_reserved,
-							opt_domain_traffic->m_actual )
-				);
-
-		reserved_amount = std::min( reserved_amount, buffer_size );
-
-		total_traffic.m_reserved += reserved_amount;
-		if( opt_domain_traffic )
-			opt_domain_traffic->m_reserved += reserved_amount;
-
-		// Use the fact that sequence numbers are the same
-		// for all instances of direction_traffic_info_t.
-		return { reserved_amount, total_traffic.m_sequence_number };
+			const auto acquired = bucket.try_acquire( reserved_amount );
+			if( acquired < reserved_amount )
+			{
+				// Previous buckets gave more than can be used now.
+				// The surplus has to be returned to them.
+				for( std::size_t j = 0u; j != i; ++j )
+					chain.m_buckets[ j ]->give_back( reserved_amount - acquired );
+
+				reserved_amount = acquired;
+			}
+		}
+
+		// NOTE: since v.0.6.0 there are no turns and the sequence number
+		// isn't used anymore.
+		return { reserved_amount, sequence_number_t{} };
 	}
 
 	void
@@ -213,56 +256,64 @@ class actual_traffic_limiter_t final : public traffic_limiter_t
 		reserved_capacity_t reserved_capacity,
 		std::size_t bytes ) noexcept
 	{
-		const auto bytes_to_release = reserved_capacity.m_capacity;
+		const auto chain = make_bucket_chain( member );
+		const auto reserved = reserved_capacity.m_capacity;
 
+		for( std::size_t i = 0u; i != chain.m_size; ++i )
 		{
-			auto & traffic = get_reference_to_member(
-					member,
-					m_it_auth_user->second.m_bandlims.general_traffic() );
-			traffic.m_actual += bytes;
-			auto & reserved = traffic.m_reserved;
-			if( reserved_capacity.m_sequence_number == traffic.m_sequence_number
-					// We don't expect that value of `reserved` will be less
-					// that `bytes_to_release` on the same turn.
-					// But it better to play it safe to avoid underflow.
-					&& reserved >= bytes_to_release )
-			{
-				reserved -= bytes_to_release;
-			}
+			auto & bucket = *(chain.m_buckets[ i ]);
+			if( bytes < reserved )
+				bucket.give_back( reserved - bytes );
+			else
+				// The debt is allowed: the bucket will be refilled later.
+				bucket.consume( bytes - reserved );
 		}
+	}
 
-		if( m_it_domain_traffic )
-		{
-			auto & traffic = get_reference_to_member(
-					member,
-					(*m_it_domain_traffic)->second.m_traffic );
-			traffic.m_actual += bytes;
-			auto & reserved = traffic.m_reserved;
-			if( reserved_capacity.m_sequence_number == traffic.m_sequence_number
-					// We don't expect that value of `reserved` will be less
-					// that `bytes_to_release` on the same tick.
-					// But it better to play it safe to avoid underflow.
-					&& reserved >= bytes_to_release )
-			{
-				reserved -= bytes_to_release;
-			}
-		}
+	// Since v.0.6.0 default limits aren't applied to all users on
+	// a change of the config. They are applied to a user by the first
+	// limiter of that user that detects the change.
+	void
+	refresh_default_limits_if_necessary() noexcept
+	{
+		auto & user_info = m_it_auth_user->second;
+		if( !m_authentificated_users->default_limits_outdated( user_info ) )
+			return;
+
+		// If the lock can't be acquired the refresh will be tried again
+		// on the next read.
+		ARATAGA_NOTHROW_BLOCK_BEGIN()
+			ARATAGA_NOTHROW_BLOCK_STAGE(refresh_default_limits)
+
+			std::lock_guard< std::mutex > lock{ m_authentificated_users->lock() };
+
+			m_authentificated_users->refresh_default_limits( user_info );
+			m_user_traffic.update_limits( user_info.m_bandlims.general_limits() );
+		ARATAGA_NOTHROW_BLOCK_END(LOG_THEN_IGNORE)
 	}
 
 public:
 	actual_traffic_limiter_t(
-		authentificated_user_map_t & auth_users,
+		std::shared_ptr< shard_group_t > shard_group,
+		std::shared_ptr< authentificated_users_t > authentificated_users,
 		authentificated_user_map_t::iterator it_auth_user,
 		std::optional<
 					bandlim_manager_t::domain_traffic_map_t::iterator
-				> it_domain_traffic )
-		:	m_auth_users{ auth_users }
+				> it_domain_traffic,
+		::arataga::stats::traffic::counters_ref_t user_traffic,
+		::arataga::stats::traffic::counters_ref_t acl_traffic )
+		:	m_shard_group{ std::move(shard_group) }
+		,	m_authentificated_users{ std::move(authentificated_users) }
 		,	m_it_auth_user{ it_auth_user }
 		,	m_it_domain_traffic{ std::move(it_domain_traffic) }
+		,	m_user_traffic{ std::move(user_traffic) }
+		,	m_acl_traffic{ std::move(acl_traffic) }
 	{}
 
 	~actual_traffic_limiter_t() override
 	{
+		std::lock_guard< std::mutex > lock{ m_authentificated_users->lock() };
+
 		auto & user_info = m_it_auth_user->second;
 
 		if( m_it_domain_traffic )
@@ -272,14 +323,19 @@ public:
 
 		user_info.m_connection_count -= 1u;
 		if( !user_info.m_connection_count )
-			m_auth_users.erase( m_it_auth_user );
+			m_authentificated_users->users().erase( m_it_auth_user );
 	}
 
+	// NOTE: since v.0.6.0 there is no lock here. Buckets are atomic
+	// and the info about the user can't be removed while this
+	// limiter exists.
 	reserved_capacity_t
 	reserve_read_portion(
 		direction_t dir,
 		std::size_t buffer_size ) noexcept override
 	{
+		refresh_default_limits_if_necessary();
+
 		reserved_capacity_t result;
 		switch( dir )
 		{
@@ -311,6 +367,11 @@ public:
 					&bandlim_manager_t::channel_limits_data_t::m_user_end_traffic,
 					reserved_capacity,
 					bytes );
+			if( bytes )
+			{
+				m_user_traffic->add_from_user( bytes );
+				m_acl_traffic->add_from_user( bytes );
+			}
 		break;
 
 		case direction_t::from_target:
@@ -318,6 +379,11 @@ public:
 					&bandlim_manager_t::channel_limits_data_t::m_target_end_traffic,
 					reserved_capacity,
 					bytes );
+			if( bytes )
+			{
+				m_user_traffic->add_from_target( bytes );
+				m_acl_traffic->add_from_target( bytes );
+			}
 		break;
 		}
 	}
@@ -333,6 +399,12 @@ a_handler_t::a_handler_t(
 	:	so_5::agent_t{ std::move(ctx) }
 	,	m_app_ctx{ std::move(app_ctx) }
 	,	m_params{ std::move(params) }
+	,	m_acl_stats{
+			std::make_shared< ::arataga::stats::connections::acl_stats_t >(
+					fmt::format( "{}:{}",
+							fmt::streamed(m_params.m_acl_config.m_in_addr),
+							m_params.m_acl_config.m_port ) )
+		}
 	,	m_acl_stats_reg{
 			m_app_ctx.m_acl_stats_manager,
 			m_acl_stats
@@ -393,11 +465,15 @@ a_handler_t::so_define_agent()
 										"new connections (current count: {}, "
 										"allowed limit: {})",
 									m_params.m_name,
-									m_connections.size(),
+									m_params.m_shard_group->connection_count(),
 									m_current_common_acl_params.m_maxconn );
 						} );
 			} )
-		.just_switch_to< enable_accepting_connections_t >( st_accepting );
+		.just_switch_to< enable_accepting_connections_t >( st_accepting )
+		// A connection can be closed on another shard of the ACL.
+		.just_switch_to< connection_slot_released_t >(
+				m_params.m_shard_group->notification_mbox(),
+				st_accepting );
 }
 
 void
@@ -413,6 +489,15 @@ a_handler_t::so_evt_start()
 						m_params.m_acl_id_seed );
 			} );
 
+	// Limits for the whole ACL should be set before the acception
+	// of the first connection.
+	update_acl_bandlims();
+
+	// NOTE: traffic counters have to be acquired on the IO-thread
+	// they belong to, so it isn't done in the constructor.
+	m_acl_traffic = m_params.m_traffic_stats->acquire_acl_counters(
+			m_acl_stats->m_acl_name );
+
 	so_5::send< try_create_entry_point_t >( *this );
 }
 
@@ -429,10 +514,13 @@ a_handler_t::so_evt_finish()
 
 	// Cleanup all sockets.
 	m_acceptor.close();
+
+	// Slots of all connections of this shard have to be released.
+	for( std::size_t i = 0u, count = m_connections.size(); i != count; ++i )
+		release_connection_slot();
 	m_connections.clear();
 
-	// Deactivate timer if activated.
-	m_params.m_timer_provider.deactivate_consumer( *this );
+	m_acl_traffic = ::arataga::stats::traffic::counters_ref_t{};
 }
 
 void
@@ -471,6 +559,8 @@ a_handler_t::remove_connection_handler(
 	{
 		m_connections.erase( it );
 
+		release_connection_slot();
+
 		update_remove_handle_stats( reason );
 
 		// Do not catch exceptions because if an exception is thrown
@@ -484,17 +574,12 @@ a_handler_t::remove_connection_handler(
 							m_params.m_name,
 							make_long_id(id),
 							fmt::streamed(reason),
-							m_connections.size(),
+							m_params.m_shard_group->connection_count(),
 							m_current_common_acl_params.m_maxconn );
 				} );
 
 		try_switch_to_accepting_if_necessary_and_possible();
 	}
-
-	// Maybe there is no more live handlers and timers have to be
-	// deactivated.
-	if( m_connections.empty() )
-		m_params.m_timer_provider.deactivate_consumer( *this );
 }
 
 void
@@ -532,17 +617,27 @@ a_handler_t::async_resolve_hostname(
 	// hostname-result-handler received from connection_handler.
 	class token_t final : public dnsr::forward::completion_token_t
 	{
+		a_handler_t & m_agent;
+		std::chrono::steady_clock::time_point m_started_at;
 		dns_resolving::hostname_result_handler_t m_handler;
 
 	public:
 		token_t(
+			a_handler_t & agent,
+			std::chrono::steady_clock::time_point started_at,
 			dns_resolving::hostname_result_handler_t handler )
-			:	m_handler{ std::move(handler) }
+			:	m_agent{ agent }
+			,	m_started_at{ started_at }
+			,	m_handler{ std::move(handler) }
 		{}
 
 		void
 		complete( const dnsr::forward::resolve_result_t & result ) override
 		{
+			// NOTE: complete() is called on the context of the agent.
+			m_agent.stats_record_setup_stage(
+					setup_stage_t::dns_lookup, m_started_at );
+
 			m_handler( std::visit( ::arataga::utils::overloaded{
 					[]( const dnsr::forward::failed_resolve_t & info )
 					-> dns_resolving::hostname_result_t
@@ -578,15 +673,44 @@ a_handler_t::async_resolve_hostname(
 						id );
 			} );
 
+	const auto started_at = std::chrono::steady_clock::now();
+
 	const auto ip_version_for_result =
 			m_params.m_acl_config.m_out_addr.is_v4() ?
 					ip_version_t::ip_v4 : ip_version_t::ip_v6;
 
+	// Since v.0.6.0 there is no need to ask dns_resolver-agent if
+	// the name is a direct IP-address or is already in the cache.
+	// The result is delivered right now without any messages.
+	if( const auto address = m_params.m_inline_resolver->try_resolve(
+			hostname,
+			ip_version_for_result ) )
+	{
+		::arataga::logging::direct_mode::trace(
+				[&]( auto & logger, auto level )
+				{
+					logger.log(
+							level,
+							"{}: DNS resolve for id {} completed inline: {}",
+							m_params.m_name,
+							id,
+							fmt::streamed(*address) );
+				} );
+
+		stats_record_setup_stage( setup_stage_t::dns_lookup, started_at );
+
+		result_handler( dns_resolving::hostname_found_t{ *address } );
+		return;
+	}
+
 	so_5::send< dnsr::resolve_request_t >( m_params.m_dns_mbox,
 			id,
 			hostname,
 			ip_version_for_result,
-			std::make_shared< token_t >( std::move(result_handler) ),
+			std::make_shared< token_t >(
+					*this,
+					started_at,
+					std::move(result_handler) ),
 			so_direct_mbox() );
 }
 
@@ -652,7 +776,8 @@ a_handler_t::async_authentificate(
 					-> authentification::result_t
 					{
 						return authentification::success_t{
-								(m_agent.*m_post_auth_hook)( info )
+								(m_agent.*m_post_auth_hook)( info ),
+								info.m_user_list_generation
 						};
 					}
 				},
@@ -672,29 +797,60 @@ a_handler_t::async_authentificate(
 						id );
 			} );
 
-	auto req = std::make_unique< auth_ns::auth_request_t >();
-
-	req->m_req_id = id;
-	req->m_reply_to = so_direct_mbox();
-	req->m_completion_token = std::make_shared< token_t >(
-			*this,
-			&a_handler_t::user_authentificated,
-			std::move(result_handler) );
-
-	req->m_proxy_in_addr = m_params.m_acl_config.m_in_addr;
-	req->m_proxy_port = m_params.m_acl_config.m_port;
-
-	req->m_user_ip = request.m_user_ip;
-	req->m_username = std::move(request.m_username);
-	req->m_password = std::move(request.m_password);
+	// Since v.0.6.0 all the data for authentification is in memory
+	// of the IO-thread, so there is no need to send a message to
+	// authentificator-agent.
+	const auto started_at = std::chrono::steady_clock::now();
+	auto result = m_params.m_auth_engine->authentificate(
+			auth_ns::auth_params_t{
+				m_params.m_acl_config.m_in_addr,
+				m_params.m_acl_config.m_port,
+				request.m_user_ip,
+				request.m_username ?
+						std::optional< std::string_view >{ *request.m_username } :
+						std::nullopt,
+				request.m_password ?
+						std::optional< std::string_view >{ *request.m_password } :
+						std::nullopt,
+				request.m_target_host,
+				request.m_target_port
+			} );
+	// NOTE: the delay for negative results isn't included, it's
+	// the time of the authentification itself.
+	stats_record_setup_stage( setup_stage_t::authentification, started_at );
 
-	req->m_target_host = std::move(request.m_target_host);
-	req->m_target_port = request.m_target_port;
+	if( auto * info = std::get_if< auth_ns::successful_auth_t >( &result ) )
+	{
+		::arataga::logging::direct_mode::trace(
+				[&]( auto & logger, auto level )
+				{
+					logger.log(
+							level,
+							"{}: authentification with id {} completed inline",
+							m_params.m_name,
+							id );
+				} );
 
-	so_5::send( m_params.m_auth_mbox,
-			so_5::message_holder_t< auth_ns::auth_request_t >{
-					std::move(req)
+		result_handler( authentification::success_t{
+				user_authentificated( *info ),
+				info->m_user_list_generation
 			} );
+		return;
+	}
+
+	// A negative result should be delivered only after a time-out.
+	// We do it by a delayed message to ourselves. The connection can
+	// be removed before the arrival of that message, it's handled
+	// by on_auth_result().
+	so_5::send_delayed< auth_ns::auth_reply_t >(
+			*this,
+			m_params.m_auth_engine->failed_auth_reply_timeout(),
+			id,
+			std::make_shared< token_t >(
+					*this,
+					&a_handler_t::user_authentificated,
+					std::move(result_handler) ),
+			std::move(result) );
 }
 
 void
@@ -704,42 +860,60 @@ a_handler_t::stats_inc_connection_count(
 	switch( connection_type )
 	{
 		case connection_type_t::generic:
-			m_acl_stats.m_total_connections += 1u;
+			m_acl_stats->m_total_connections += 1u;
 		break;
 
 		case connection_type_t::http:
-			m_acl_stats.m_http_connections += 1u;
+			m_acl_stats->m_http_connections += 1u;
 		break;
 
 		case connection_type_t::socks5:
-			m_acl_stats.m_socks5_connections += 1u;
+			m_acl_stats->m_socks5_connections += 1u;
 		break;
 	}
 }
 
 void
-a_handler_t::on_timer() noexcept
+a_handler_t::stats_record_setup_stage(
+	setup_stage_t stage,
+	std::chrono::steady_clock::time_point started_at ) noexcept
 {
-	ARATAGA_NOTHROW_BLOCK_BEGIN()
-		ARATAGA_NOTHROW_BLOCK_STAGE(update_traffic_limit_quotes)
+	m_acl_stats->setup_latency( stage ).record(
+			std::chrono::steady_clock::now() - started_at );
+}
+
+io_chunk_pool_t &
+a_handler_t::io_chunk_pool() noexcept
+{
+	return *(m_params.m_io_chunk_pool);
+}
 
-		// Start a new turn. Traffic quotes have to be recalculated.
-		update_traffic_limit_quotes_on_new_turn();
+pacing_wheel_t &
+a_handler_t::pacing_wheel() noexcept
+{
+	return *(m_params.m_pacing_wheel);
+}
 
-		ARATAGA_NOTHROW_BLOCK_STAGE(call_on_timer_for_connection_handlers)
+timeout_wheel_t &
+a_handler_t::timeout_wheel() noexcept
+{
+	return *(m_params.m_timeout_wheel);
+}
 
-		// Additional care should be taken with iterators because
-		// the content of m_connections can be changed right inside
-		// on_timer call.
-		for( auto it = m_connections.begin(); it != m_connections.end(); )
-		{
-			// Hold a pointer until on_timer will be completed.
-			auto handler = it->second.handler();
-			++it; // Go to next item before the call to on_timer.
+upstream_connection_pool_t &
+a_handler_t::upstream_connection_pool() noexcept
+{
+	return *(m_params.m_upstream_connection_pool);
+}
 
-			handler->on_timer();
-		}
-	ARATAGA_NOTHROW_BLOCK_END(LOG_THEN_ABORT)
+bool
+a_handler_t::can_reuse_auth_result(
+	std::uint64_t user_list_generation,
+	std::uint16_t target_port ) const noexcept
+{
+	const auto & engine = *(m_params.m_auth_engine);
+	return engine.user_list_generation() == user_list_generation &&
+			!engine.is_denied_port( target_port );
 }
 
 void
@@ -832,6 +1006,25 @@ a_handler_t::on_try_create_entry_point(
 				ec.message() );
 	}
 
+#if defined(SO_REUSEPORT)
+	// Since v.0.6.0 an ACL can be served by several shards. Every shard
+	// has its own acceptor bound to the same endpoint.
+	if( 1u < m_params.m_acl_config.m_shards )
+	{
+		using reuse_port_t = asio::detail::socket_option::boolean<
+				SOL_SOCKET, SO_REUSEPORT >;
+
+		tmp_acceptor.set_option( reuse_port_t{ true }, ec );
+		if( ec )
+		{
+			return finish_on_failure(
+					fmt::runtime( "{}: unable to set REUSEPORT option: {}" ),
+					m_params.m_name,
+					ec.message() );
+		}
+	}
+#endif
+
 	tmp_acceptor.bind( endpoint, ec );
 	if( ec )
 	{
@@ -842,6 +1035,28 @@ a_handler_t::on_try_create_entry_point(
 				ec.message() );
 	}
 
+#if defined(__linux__)
+	// Since v.0.6.0 connections that don't send anything can be
+	// kept by the kernel until the arrival of the first data.
+	if( std::chrono::seconds::zero() != m_params.m_acl_config.m_defer_accept )
+	{
+		using defer_accept_t = asio::detail::socket_option::integer<
+				IPPROTO_TCP, TCP_DEFER_ACCEPT >;
+
+		tmp_acceptor.set_option(
+				defer_accept_t{ static_cast<int>(
+						m_params.m_acl_config.m_defer_accept.count() ) },
+				ec );
+		if( ec )
+		{
+			return finish_on_failure(
+					fmt::runtime( "{}: unable to set DEFER_ACCEPT option: {}" ),
+					m_params.m_name,
+					ec.message() );
+		}
+	}
+#endif
+
 	tmp_acceptor.listen(
 			// This is just an arbitrary value for the very first version.
 			10,
@@ -875,7 +1090,7 @@ a_handler_t::on_enter_st_accepting() noexcept
 						"{}: resuming the acception of "
 							"new connections (current count: {}, allowed limit: {})",
 						m_params.m_name,
-						m_connections.size(),
+						m_params.m_shard_group->connection_count(),
 						m_current_common_acl_params.m_maxconn );
 			} );
 
@@ -886,6 +1101,18 @@ a_handler_t::on_enter_st_accepting() noexcept
 void
 a_handler_t::on_accept_next_when_accepting( mhood_t< accept_next_t > )
 {
+	// Since v.0.6.0 the maxconn limit is shared by all shards of the ACL.
+	// A slot isn't reserved here: an idle shard shouldn't hold a slot
+	// while it waits for a connection. The slot is reserved right
+	// before the acception of a connection.
+	if( m_params.m_shard_group->connection_count() >=
+			m_current_common_acl_params.m_maxconn )
+	{
+		// Should go to the state where new connections are not accepted.
+		this >>= st_too_many_connections;
+		return;
+	}
+
 	::arataga::logging::direct_mode::debug(
 			[&]( auto & logger, auto level )
 			{
@@ -895,6 +1122,38 @@ a_handler_t::on_accept_next_when_accepting( mhood_t< accept_next_t > )
 						m_params.m_name );
 			} );
 
+#if defined(__linux__)
+	// Since v.0.6.0 connections are accepted by accept4() when
+	// the acceptor is ready. All pending connections are accepted
+	// on one readiness event.
+	//
+	// Do not wait exceptions here.
+	// There is no sense to continue if this call throws.
+	m_acceptor.async_wait(
+			asio::ip::tcp::acceptor::wait_read,
+			[self = so_5::make_agent_ref(this)]( const asio::error_code & ec )
+			{
+				if( ec )
+				{
+					// Ignore operation_aborted because it's expected
+					// during the shutdown operation.
+					if( asio::error::operation_aborted != ec )
+						::arataga::logging::direct_mode::err(
+								[&]( auto & logger, auto level )
+								{
+									logger.log(
+											level,
+											"{}: async_wait for acceptor failure: {}",
+											self->m_params.m_name,
+											ec.message() );
+								} );
+				}
+				else
+					self->accept_pending_connections();
+
+				so_5::send< current_accept_completed_t >( *self );
+			} );
+#else
 	// Do not wait exceptions here.
 	// There is no sense to continue if this call throws.
 	m_acceptor.async_accept(
@@ -917,24 +1176,48 @@ a_handler_t::on_accept_next_when_accepting( mhood_t< accept_next_t > )
 											ec.message() );
 								} );
 				}
+				else if( !self->m_params.m_shard_group->try_reserve_connection_slot(
+						self->m_current_common_acl_params.m_maxconn ) )
+				{
+					// maxconn has been reached by other shards during
+					// the acception. The connection can't be served.
+					::arataga::logging::direct_mode::warn(
+							[&]( auto & logger, auto level )
+							{
+								logger.log(
+										level,
+										"{}: accepted connection is closed "
+											"because maxconn is reached",
+										self->m_params.m_name );
+							} );
+
+					asio::error_code ignored_ec;
+					connection.close( ignored_ec );
+				}
 				else
 				{
+					const auto count_before = self->m_connections.size();
+
 					self->accept_new_connection( std::move(connection) );
+
+					// If the new connection isn't stored then the reserved
+					// slot isn't used.
+					if( count_before == self->m_connections.size() )
+						self->release_connection_slot();
 				}
 
 				so_5::send< current_accept_completed_t >( *self );
 			} );
+#endif
 }
 
 void
 a_handler_t::on_accept_completion_when_accepting(
 	mhood_t< current_accept_completed_t > )
 {
-	if( m_connections.size() < m_current_common_acl_params.m_maxconn )
-		so_5::send< accept_next_t >( *this );
-	else
-		// Should go to the state where new connections are not accepted.
-		this >>= st_too_many_connections;
+	// The maxconn limit will be checked before the wait for
+	// the next connection.
+	so_5::send< accept_next_t >( *this );
 }
 
 void
@@ -995,8 +1278,11 @@ a_handler_t::on_updated_config(
 {
 	m_current_common_acl_params = cmd->m_params;
 
-	// Limits for all bandlim_managers should be updated.
-	update_default_bandlims_on_confg_change();
+	// NOTE: since v.0.6.0 default limits for users are updated by
+	// config_processor in the shared info about users.
+
+	// The refill interval for the ACL limits could be changed too.
+	update_acl_bandlims();
 
 	// If we are in st_accepting then there is no need to do anything,
 	// even if maxconn is less than the current connection count.
@@ -1096,72 +1382,149 @@ a_handler_t::accept_new_connection(
 
 	ARATAGA_NOTHROW_BLOCK_STAGE(store_new_handler_to_connections_map)
 
-	// If there were no connections then timer has to be activated
-	// after accepting new connection.
-	//
-	// NOTE: activate_consumer() is called before emplace().
-	// If activate_consumer() throws then we shouldn't remove
-	// connection_info from m_connections.
-	if( m_connections.empty() )
-		m_params.m_timer_provider.activate_consumer( *this );
-
 	// New connection has to be stored in the list of known connections.
 	m_connections.emplace( id, std::move(new_connection_info) );
 
 	ARATAGA_NOTHROW_BLOCK_END(LOG_THEN_IGNORE)
 }
 
+#if defined(__linux__)
 void
-a_handler_t::update_default_bandlims_on_confg_change() noexcept
+a_handler_t::accept_pending_connections()
 {
-	for( auto & [id, info] : m_authentificated_users )
+	// A slot is reserved right before accept4() and is kept for
+	// the next iteration if it isn't used.
+	bool slot_reserved = false;
+
+	for( std::size_t i = 0u; i != max_accepts_per_event; ++i )
 	{
-		info.m_bandlims.update_default_limits(
-				m_current_common_acl_params.m_client_bandlim );
+		if( !slot_reserved )
+		{
+			// If maxconn is reached then the next accept_next_t will
+			// switch the agent to st_too_many_connections.
+			if( !m_params.m_shard_group->try_reserve_connection_slot(
+					m_current_common_acl_params.m_maxconn ) )
+				break;
+
+			slot_reserved = true;
+		}
+
+		const int fd = ::accept4(
+				m_acceptor.native_handle(),
+				nullptr,
+				nullptr,
+				SOCK_NONBLOCK | SOCK_CLOEXEC );
+		if( fd < 0 )
+		{
+			const int err = errno;
+			if( EINTR == err || ECONNABORTED == err )
+				// The connection was reset before the acception.
+				// We can try to accept the next one.
+				continue;
+
+			if( EAGAIN != err && EWOULDBLOCK != err )
+				::arataga::logging::direct_mode::err(
+						[&]( auto & logger, auto level )
+						{
+							logger.log(
+									level,
+									"{}: accept4 failure: {}",
+									m_params.m_name,
+									asio::error_code{ err, asio::system_category() }
+											.message() );
+						} );
+
+			// There is no more pending connections (or they can't be
+			// accepted now).
+			break;
+		}
+
+		asio::error_code ec;
+		asio::ip::tcp::socket connection{ m_params.m_io_ctx };
+		connection.assign( asio::ip::tcp::v4(), fd, ec );
+		if( ec )
+		{
+			::close( fd );
+
+			::arataga::logging::direct_mode::err(
+					[&]( auto & logger, auto level )
+					{
+						logger.log(
+								level,
+								"{}: unable to assign accepted socket: {}",
+								m_params.m_name,
+								ec.message() );
+					} );
+
+			continue;
+		}
+
+		const auto count_before = m_connections.size();
+
+		accept_new_connection( std::move(connection) );
+
+		// The reserved slot is used only if the new connection is stored.
+		if( count_before != m_connections.size() )
+			slot_reserved = false;
 	}
+
+	if( slot_reserved )
+		release_connection_slot();
 }
+#endif
 
 void
-a_handler_t::update_traffic_limit_quotes_on_new_turn()
+a_handler_t::update_acl_bandlims() noexcept
 {
-	if( !m_authentificated_users.empty() )
-	{
-		for( auto & [id, info] : m_authentificated_users )
-			info.m_bandlims.update_traffic_counters_for_new_turn();
-	}
+	m_params.m_shard_group->bandlims().set_limits(
+			m_params.m_acl_config.m_bandlim,
+			m_current_common_acl_params.m_bandlim_refill_interval,
+			std::chrono::steady_clock::now() );
 }
 
 traffic_limiter_unique_ptr_t
 a_handler_t::user_authentificated(
 	const ::arataga::authentificator::successful_auth_t & info )
 {
+	// Counters of transferred data are acquired before the lock
+	// on the shared info about users.
+	auto user_traffic = m_params.m_traffic_stats->acquire_user_counters(
+			info.m_user_id );
+
+	auto & authentificated_users = *(m_params.m_authentificated_users);
+	std::lock_guard< std::mutex > lock{ authentificated_users.lock() };
+
+	auto & users = authentificated_users.users();
+
 	// If there is no info about this user that info should be created.
-	auto it = m_authentificated_users.find( info.m_user_id );
-	if( it == m_authentificated_users.end() )
+	auto it = users.find( info.m_user_id );
+	if( it == users.end() )
 	{
-		it = m_authentificated_users.emplace(
+		// NOTE: the info holds atomic buckets and can't be moved,
+		// so it is constructed in place.
+		//
+		// NOTE: the default limits are taken from the shared info
+		// because this ACL can be not updated with the recent config yet.
+		it = users.try_emplace(
 				info.m_user_id,
-				authentificated_user_info_t{
-						// The current connection from the user is taken
-						// into account.
-						1u,
-						bandlim_manager_t{
-								info.m_user_bandlims,
-								m_current_common_acl_params.m_client_bandlim
-						}
-				} ).first;
+				info.m_user_bandlims,
+				authentificated_users.default_limits(),
+				authentificated_users.refill_interval()
+			).first;
 	}
 	else
 	{
-		// A new connection should be taken into account.
-		it->second.m_connection_count += 1u;
-
 		// The personal limit for the user could has been changed.
 		// This case should be reflected in bandlim_manager.
 		it->second.m_bandlims.update_personal_limits(
 				info.m_user_bandlims,
-				m_current_common_acl_params.m_client_bandlim );
+				authentificated_users.default_limits(),
+				authentificated_users.refill_interval() );
 	}
+	authentificated_users.default_limits_applied( it->second );
+
+	// A new connection should be taken into account.
+	it->second.m_connection_count += 1u;
 
 	std::optional< bandlim_manager_t::domain_traffic_map_t::iterator >
 			it_domain_traffic;
@@ -1175,10 +1538,15 @@ a_handler_t::user_authentificated(
 				info.m_domain_limits->m_bandlims );
 	}
 
+	user_traffic.update_limits( it->second.m_bandlims.general_limits() );
+
 	return std::make_unique< actual_traffic_limiter_t >(
-			m_authentificated_users,
+			m_params.m_shard_group,
+			m_params.m_authentificated_users,
 			it,
-			it_domain_traffic
+			it_domain_traffic,
+			std::move(user_traffic),
+			m_acl_traffic
 		);
 }
 
@@ -1200,7 +1568,8 @@ a_handler_t::try_switch_to_accepting_if_necessary_and_possible()
 	// current count of connection dropped below maxconn then
 	// we can resume the acception of new connection.
 	if( st_too_many_connections.is_active() &&
-			m_connections.size() < m_current_common_acl_params.m_maxconn )
+			m_params.m_shard_group->connection_count() <
+					m_current_common_acl_params.m_maxconn )
 	{
 		ARATAGA_NOTHROW_BLOCK_STAGE(sending_enable_acception_connections_signal)
 
@@ -1212,77 +1581,91 @@ a_handler_t::try_switch_to_accepting_if_necessary_and_possible()
 	ARATAGA_NOTHROW_BLOCK_END(LOG_THEN_ABORT)
 }
 
+void
+a_handler_t::release_connection_slot() noexcept
+{
+	// Normal work can't be continued if the notification about
+	// the released slot can't be sent. Other shards can wait for it.
+	ARATAGA_NOTHROW_BLOCK_BEGIN()
+		ARATAGA_NOTHROW_BLOCK_STAGE(release_slot_in_shard_group)
+
+		m_params.m_shard_group->release_connection_slot(
+				m_current_common_acl_params.m_maxconn );
+
+	ARATAGA_NOTHROW_BLOCK_END(LOG_THEN_ABORT)
+}
+
 void
 a_handler_t::update_remove_handle_stats( remove_reason_t reason ) noexcept
 {
 	switch( reason )
 	{
 		case remove_reason_t::normal_completion:
-			m_acl_stats.m_remove_reason_normal_completion += 1u;
+			m_acl_stats->m_remove_reason_normal_completion += 1u;
 		break;
 
 		case remove_reason_t::io_error:
-			m_acl_stats.m_remove_reason_io_error += 1u;
+			m_acl_stats->m_remove_reason_io_error += 1u;
 		break;
 
 		case remove_reason_t::current_operation_timed_out:
-			m_acl_stats.m_remove_reason_current_operation_timed_out += 1u;
+			m_acl_stats->m_remove_reason_current_operation_timed_out += 1u;
 		break;
 
 		case remove_reason_t::unsupported_protocol:
-			m_acl_stats.m_remove_reason_unsupported_protocol += 1u;
+			m_acl_stats->m_remove_reason_unsupported_protocol += 1u;
 		break;
 
 		case remove_reason_t::protocol_error:
-			m_acl_stats.m_remove_reason_protocol_error += 1u;
+			m_acl_stats->m_remove_reason_protocol_error += 1u;
 		break;
 
 		case remove_reason_t::unexpected_and_unsupported_case:
-			m_acl_stats.m_remove_reason_unexpected_error += 1u;
+			m_acl_stats->m_remove_reason_unexpected_error += 1u;
 		break;
 
 		case remove_reason_t::no_activity_for_too_long:
-			m_acl_stats.m_remove_reason_no_activity_for_too_long += 1u;
+			m_acl_stats->m_remove_reason_no_activity_for_too_long += 1u;
 		break;
 
 		case remove_reason_t::current_operation_canceled:
-			m_acl_stats.m_remove_reason_current_operation_canceled += 1u;
+			m_acl_stats->m_remove_reason_current_operation_canceled += 1u;
 		break;
 
 		case remove_reason_t::unhandled_exception:
-			m_acl_stats.m_remove_reason_unhandled_exception += 1u;
+			m_acl_stats->m_remove_reason_unhandled_exception += 1u;
 		break;
 
 		case remove_reason_t::ip_version_mismatch:
-			m_acl_stats.m_remove_reason_ip_version_mismatch += 1u;
+			m_acl_stats->m_remove_reason_ip_version_mismatch += 1u;
 		break;
 
 		case remove_reason_t::access_denied:
-			m_acl_stats.m_remove_reason_access_denied += 1u;
+			m_acl_stats->m_remove_reason_access_denied += 1u;
 		break;
 
 		case remove_reason_t::unresolved_target:
-			m_acl_stats.m_remove_reason_unresolved_target += 1u;
+			m_acl_stats->m_remove_reason_unresolved_target += 1u;
 		break;
 
 		case remove_reason_t::target_end_broken:
-			m_acl_stats.m_remove_reason_target_end_broken += 1u;
+			m_acl_stats->m_remove_reason_target_end_broken += 1u;
 		break;
 
 		case remove_reason_t::user_end_broken:
-			m_acl_stats.m_remove_reason_user_end_broken += 1u;
+			m_acl_stats->m_remove_reason_user_end_broken += 1u;
 		break;
 
 		case remove_reason_t::http_response_before_completion_of_http_request:
-			m_acl_stats.m_remove_reason_early_http_response += 1u;
+			m_acl_stats->m_remove_reason_early_http_response += 1u;
 		break;
 
 		case remove_reason_t::user_end_closed_by_client:
-			m_acl_stats.m_remove_reason_user_end_closed_by_client += 1u;
+			m_acl_stats->m_remove_reason_user_end_closed_by_client += 1u;
 		break;
 
 		case remove_reason_t::http_no_incoming_request:
-			m_acl_stats.m_remove_reason_http_no_incoming_request += 1u;
+			m_acl_stats->m_remove_reason_http_no_incoming_request += 1u;
 		break;
 	}
 }
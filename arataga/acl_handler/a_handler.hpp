@@ -19,8 +19,6 @@
 
 #include <arataga/authentificator/pub.hpp>
 
-#include <arataga/io_thread_timer/ifaces.hpp>
-
 #include <asio/ip/tcp.hpp>
 
 namespace arataga::acl_handler
@@ -58,6 +56,14 @@ public:
 	std::size_t
 	io_chunk_count() const noexcept override;
 
+	[[nodiscard]]
+	relay_mode_t
+	relay_mode() const noexcept override;
+
+	[[nodiscard]]
+	std::chrono::milliseconds
+	bandlim_refill_interval() const noexcept override;
+
 	[[nodiscard]]
 	std::chrono::milliseconds
 	protocol_detection_timeout() const noexcept override;
@@ -95,32 +101,18 @@ public:
 	http_negative_response_timeout() const noexcept override;
 
 	[[nodiscard]]
-	const http_message_value_limits_t &
-	http_message_limits() const noexcept override;
-};
+	std::size_t
+	http_upstream_pool_size() const noexcept override;
 
-//
-// authentificated_user_info_t
-//
-//! Info about successfully authentificated client.
-struct authentificated_user_info_t
-{
-	//! The number of current connection from this user.
-	std::size_t m_connection_count{};
+	[[nodiscard]]
+	std::chrono::milliseconds
+	http_upstream_idle_timeout() const noexcept override;
 
-	//! Limits for this user.
-	bandlim_manager_t m_bandlims;
+	[[nodiscard]]
+	const http_message_value_limits_t &
+	http_message_limits() const noexcept override;
 };
 
-//
-// authentificated_user_map_t
-//
-//! Map of successfully authentificated users.
-using authentificated_user_map_t = std::map<
-		::arataga::user_list_auth::user_id_t,
-		authentificated_user_info_t
-	>;
-
 //
 // a_handler_t
 //
@@ -142,11 +134,15 @@ using authentificated_user_map_t = std::map<
  * for connection-handlers, because a backward call to remove_connection()
  * can be made from inside on_timer. In that case a_handler should delete
  * a object for that on_timer() isn't completed yet.
+ *
+ * @note
+ * Since v.0.6.0 a_handler doesn't call on_timer() for its
+ * connection-handlers once a second. Every connection-handler schedules
+ * its own deadline in timeout_wheel_t of the IO-thread.
  */
 class a_handler_t final
 	:	public so_5::agent_t
 	,	public handler_context_t
-	,	public arataga::io_thread_timer::consumer_t
 {
 public:
 	//! Initializing constructor.
@@ -202,7 +198,31 @@ public:
 		connection_type_t connection_type ) override;
 
 	void
-	on_timer() noexcept override;
+	stats_record_setup_stage(
+		setup_stage_t stage,
+		std::chrono::steady_clock::time_point started_at ) noexcept override;
+
+	[[nodiscard]]
+	io_chunk_pool_t &
+	io_chunk_pool() noexcept override;
+
+	[[nodiscard]]
+	pacing_wheel_t &
+	pacing_wheel() noexcept override;
+
+	[[nodiscard]]
+	timeout_wheel_t &
+	timeout_wheel() noexcept override;
+
+	[[nodiscard]]
+	upstream_connection_pool_t &
+	upstream_connection_pool() noexcept override;
+
+	[[nodiscard]]
+	bool
+	can_reuse_auth_result(
+		std::uint64_t user_list_generation,
+		std::uint16_t target_port ) const noexcept override;
 
 private:
 	//! Signal for next attempt to make an entry point.
@@ -328,9 +348,18 @@ private:
 	const params_t m_params;
 
 	//! Individual stats for this ACL.
-	::arataga::stats::connections::acl_stats_t m_acl_stats;
+	std::shared_ptr< ::arataga::stats::connections::acl_stats_t > m_acl_stats;
 	::arataga::stats::connections::auto_reg_t m_acl_stats_reg;
 
+	//! Counters of data transferred via this ACL.
+	/*!
+	 * They are acquired in so_evt_start() and released in so_evt_finish(),
+	 * i.e. on the IO-thread of the agent.
+	 *
+	 * @since v.0.6.0
+	 */
+	::arataga::stats::traffic::counters_ref_t m_acl_traffic;
+
 	//! The current values of common ACL params.
 	common_acl_params_t m_current_common_acl_params;
 
@@ -346,9 +375,6 @@ private:
 	//! The map of current connections.
 	connection_map_t m_connections;
 
-	//! The map of successfully authentificated users.
-	authentificated_user_map_t m_authentificated_users;
-
 	void
 	on_shutdown( mhood_t< shutdown_t > );
 
@@ -404,23 +430,43 @@ private:
 	accept_new_connection(
 		asio::ip::tcp::socket connection ) noexcept;
 
-	//! Update the info about default limits.
+#if defined(__linux__)
+	//! Max number of connections accepted on one readiness event.
+	/*!
+	 * @since v.0.6.0
+	 */
+	static constexpr std::size_t max_accepts_per_event = 64u;
+
+	//! Acception of all pending connections.
 	/*!
-	 * This method is called when the config is changed.
+	 * It's called when the acceptor becomes ready. Connections are
+	 * accepted by accept4() until there are no more pending connections,
+	 * or max_accepts_per_event connections are accepted, or maxconn
+	 * is reached.
+	 *
+	 * A slot for a connection is reserved right before the call
+	 * to accept4().
+	 *
+	 * @since v.0.6.0
 	 */
 	void
-	update_default_bandlims_on_confg_change() noexcept;
+	accept_pending_connections();
+#endif
 
-	//! Recalculation of traffic quotes.
+	//! Apply the bandwidth limits for the whole ACL.
 	/*!
-	 * This method is called at the beginning of a new turn.
+	 * This method is called at the start and when the config is changed
+	 * (because the refill interval can be changed).
+	 *
+	 * @since v.0.6.0
 	 */
 	void
-	update_traffic_limit_quotes_on_new_turn();
+	update_acl_bandlims() noexcept;
 
 	//! Handling of successful authentification.
 	/*!
-	 * The info about this client should go into m_authentificated_users.
+	 * The info about this client should go into the map of
+	 * authentificated users (it is shared by all ACLs since v.0.6.0).
 	 *
 	 * An instance of traffic_limiter for a new connection from this client
 	 * is returned.
@@ -441,6 +487,13 @@ private:
 	void
 	try_switch_to_accepting_if_necessary_and_possible();
 
+	//! Release a connection slot in the shard group.
+	/*!
+	 * @since v.0.6.0
+	 */
+	void
+	release_connection_slot() noexcept;
+
 	//! Update the stats for removed connection-handlers.
 	void
 	update_remove_handle_stats( remove_reason_t reason ) noexcept;
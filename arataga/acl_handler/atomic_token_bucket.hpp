@@ -0,0 +1,279 @@
+/*!
+ * @file
+ * @brief A token bucket that can be shared between IO-threads.
+ * @since v.0.6.0
+ */
+
+#pragma once
+
+#include <arataga/bandlim_config.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace arataga::acl_handler
+{
+
+//
+// atomic_token_bucket_t
+//
+/*!
+ * @brief A token bucket that can be shared between IO-threads.
+ *
+ * Connections of the same user (and connections of the same ACL) can
+ * be served by different IO-threads. Protection of a shared bucket
+ * by a mutex means that every read from a socket on every IO-thread
+ * has to acquire that mutex. So the state of the bucket is held in
+ * atomic variables and all hot-path operations are lock-free.
+ *
+ * The bucket is refilled lazily by refill(). Only the whole number of
+ * tokens is added, the rest of the elapsed time is kept for the next
+ * refill, so low rates don't lose tokens due to rounding.
+ *
+ * The amount of tokens can become negative if more data than acquired
+ * was transferred. That debt will be paid off by next refills.
+ *
+ * @note
+ * A change of the rate by set_rate() isn't atomic as a whole. Concurrent
+ * readers can see a mix of old and new values for a short time. It isn't
+ * a problem because the bucket is reset by set_rate() anyway.
+ *
+ * @since v.0.6.0
+ */
+class atomic_token_bucket_t
+{
+public:
+	//! Type for the rate and the amount of tokens.
+	using value_t = bandlim_config_t::value_t;
+
+	//! Type of time point used by the bucket.
+	using time_point_t = std::chrono::steady_clock::time_point;
+
+private:
+	//! The rate in bytes per second.
+	/*!
+	 * The value bandlim_config_t::unlimited means that there is no limit.
+	 */
+	std::atomic< value_t > m_rate{ bandlim_config_t::unlimited };
+
+	//! The max amount of tokens in the bucket.
+	std::atomic< std::int64_t > m_capacity{ 0 };
+
+	//! The current amount of tokens.
+	std::atomic< std::int64_t > m_tokens{ 0 };
+
+	//! The time of the last refill (in nanoseconds of steady_clock).
+	std::atomic< std::int64_t > m_refilled_at{ 0 };
+
+	[[nodiscard]]
+	static std::int64_t
+	to_nanoseconds( time_point_t tp ) noexcept
+	{
+		return std::chrono::duration_cast< std::chrono::nanoseconds >(
+				tp.time_since_epoch() ).count();
+	}
+
+	//! Add tokens to the bucket but no more than the capacity.
+	void
+	add_tokens( std::int64_t amount ) noexcept
+	{
+		const auto capacity = m_capacity.load( std::memory_order_relaxed );
+		auto current = m_tokens.load( std::memory_order_relaxed );
+		do
+		{
+			if( current >= capacity )
+				return;
+		}
+		while( !m_tokens.compare_exchange_weak(
+				current, std::min( current + amount, capacity ),
+				std::memory_order_acq_rel,
+				std::memory_order_relaxed ) );
+	}
+
+public:
+	//! The capacity of a bucket for the @a rate.
+	/*!
+	 * It is the amount of data allowed for one refill interval.
+	 * But it can't be less than one byte, otherwise the data will
+	 * never be transferred.
+	 */
+	[[nodiscard]]
+	static std::int64_t
+	capacity_for(
+		value_t rate,
+		std::chrono::milliseconds refill_interval ) noexcept
+	{
+		const auto capacity = static_cast< std::int64_t >(
+				static_cast<double>(rate) *
+				static_cast<double>(refill_interval.count()) / 1000.0 );
+
+		return capacity < 1 ? 1 : capacity;
+	}
+
+	atomic_token_bucket_t() = default;
+
+	atomic_token_bucket_t( const atomic_token_bucket_t & ) = delete;
+	atomic_token_bucket_t( atomic_token_bucket_t && ) = delete;
+
+	//! Set a new rate for the bucket.
+	/*!
+	 * If the rate or the capacity is changed then the bucket is reset
+	 * and becomes full. Otherwise the bucket is left as is.
+	 */
+	void
+	set_rate(
+		value_t rate,
+		std::chrono::milliseconds refill_interval,
+		time_point_t now ) noexcept
+	{
+		const auto capacity = bandlim_config_t::is_unlimited( rate ) ?
+				std::int64_t{ 0 } : capacity_for( rate, refill_interval );
+
+		if( rate == m_rate.load( std::memory_order_acquire ) &&
+				capacity == m_capacity.load( std::memory_order_acquire ) )
+			return;
+
+		m_refilled_at.store( to_nanoseconds( now ), std::memory_order_relaxed );
+		m_capacity.store( capacity, std::memory_order_relaxed );
+		m_tokens.store( capacity, std::memory_order_relaxed );
+		m_rate.store( rate, std::memory_order_release );
+	}
+
+	//! Get the current rate.
+	[[nodiscard]]
+	value_t
+	rate() const noexcept
+	{
+		return m_rate.load( std::memory_order_acquire );
+	}
+
+	[[nodiscard]]
+	bool
+	is_unlimited() const noexcept
+	{
+		return bandlim_config_t::is_unlimited( rate() );
+	}
+
+	//! Get the current amount of tokens.
+	/*!
+	 * It's intended to be used for testing and debugging.
+	 */
+	[[nodiscard]]
+	std::int64_t
+	tokens() const noexcept
+	{
+		return m_tokens.load( std::memory_order_acquire );
+	}
+
+	//! Add tokens for the time elapsed since the last refill.
+	void
+	refill( time_point_t now ) noexcept
+	{
+		const auto rate = m_rate.load( std::memory_order_acquire );
+		if( bandlim_config_t::is_unlimited( rate ) )
+			return;
+
+		const auto now_ns = to_nanoseconds( now );
+		const auto capacity = m_capacity.load( std::memory_order_relaxed );
+
+		auto refilled_at = m_refilled_at.load( std::memory_order_acquire );
+		for(;;)
+		{
+			if( now_ns <= refilled_at )
+				return;
+
+			const auto elapsed_ns = now_ns - refilled_at;
+			const double exact_amount = static_cast<double>(elapsed_ns) *
+					static_cast<double>(rate) / 1e9;
+
+			std::int64_t amount;
+			std::int64_t new_refilled_at;
+			if( exact_amount >= static_cast<double>(capacity) )
+			{
+				// The bucket will be full anyway, there is no need
+				// to keep the rest of the elapsed time.
+				amount = capacity;
+				new_refilled_at = now_ns;
+			}
+			else
+			{
+				amount = static_cast< std::int64_t >( exact_amount );
+				if( !amount )
+					// Too little time has passed.
+					return;
+
+				// Only the time spent for whole tokens is consumed.
+				const auto spent_ns = static_cast< std::int64_t >(
+						static_cast<double>(amount) * 1e9 /
+						static_cast<double>(rate) );
+				new_refilled_at = refilled_at + std::min( spent_ns, elapsed_ns );
+			}
+
+			// Only one thread can move the time of the last refill forward,
+			// so tokens for the same interval are added only once.
+			if( m_refilled_at.compare_exchange_weak(
+					refilled_at, new_refilled_at,
+					std::memory_order_acq_rel,
+					std::memory_order_acquire ) )
+			{
+				add_tokens( amount );
+				return;
+			}
+		}
+	}
+
+	//! Try to acquire up to @a max tokens.
+	/*!
+	 * @return the amount of acquired tokens. It is @a max if the bucket
+	 * is unlimited and 0 if the bucket is empty.
+	 */
+	[[nodiscard]]
+	std::size_t
+	try_acquire( std::size_t max ) noexcept
+	{
+		if( is_unlimited() )
+			return max;
+
+		auto current = m_tokens.load( std::memory_order_acquire );
+		std::int64_t acquired;
+		do
+		{
+			if( current <= 0 )
+				return 0u;
+
+			acquired = std::min( current, static_cast< std::int64_t >(max) );
+		}
+		while( !m_tokens.compare_exchange_weak(
+				current, current - acquired,
+				std::memory_order_acq_rel,
+				std::memory_order_acquire ) );
+
+		return static_cast< std::size_t >( acquired );
+	}
+
+	//! Return unused tokens to the bucket.
+	void
+	give_back( std::size_t amount ) noexcept
+	{
+		if( amount && !is_unlimited() )
+			add_tokens( static_cast< std::int64_t >(amount) );
+	}
+
+	//! Consume tokens without any checks.
+	/*!
+	 * The bucket can go into debt.
+	 */
+	void
+	consume( std::size_t amount ) noexcept
+	{
+		if( amount && !is_unlimited() )
+			m_tokens.fetch_sub(
+					static_cast< std::int64_t >(amount),
+					std::memory_order_acq_rel );
+	}
+};
+
+} /* namespace arataga::acl_handler */
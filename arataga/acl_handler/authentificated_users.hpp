@@ -0,0 +1,238 @@
+/*!
+ * @file
+ * @brief The info about authentificated users shared by all ACLs.
+ * @since v.0.6.0
+ */
+
+#pragma once
+
+#include <arataga/acl_handler/bandlim_manager.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+
+namespace arataga::acl_handler
+{
+
+//
+// authentificated_user_info_t
+//
+//! Info about successfully authentificated client.
+struct authentificated_user_info_t
+{
+	//! The number of current connection from this user.
+	std::size_t m_connection_count{};
+
+	//! Limits for this user.
+	bandlim_manager_t m_bandlims;
+
+	//! The generation of default limits applied to m_bandlims.
+	/*!
+	 * It's atomic because it's checked by traffic limiters without
+	 * the lock. It's changed only under the lock.
+	 *
+	 * @since v.0.6.0
+	 */
+	std::atomic< std::uint64_t > m_defaults_generation{};
+
+	//! Initializing constructor.
+	/*!
+	 * @note
+	 * The connection count is set to 0, it should be incremented
+	 * by the caller.
+	 *
+	 * @since v.0.6.0
+	 */
+	authentificated_user_info_t(
+		bandlim_config_t personal_limits,
+		bandlim_config_t default_limits,
+		std::chrono::milliseconds refill_interval )
+		:	m_bandlims{ personal_limits, default_limits, refill_interval }
+	{}
+};
+
+//
+// authentificated_user_map_t
+//
+//! Map of successfully authentificated users.
+using authentificated_user_map_t = std::map<
+		::arataga::user_list_auth::user_id_t,
+		authentificated_user_info_t
+	>;
+
+//
+// authentificated_users_t
+//
+/*!
+ * @brief The info about authentificated users shared by all ACLs.
+ *
+ * Before v.0.6.0 every ACL had its own map of authentificated users.
+ * It meant that a user with the limit 10MiB/s got 10MiB/s on every ACL
+ * (and on every shard of an ACL).
+ *
+ * Since v.0.6.0 there is only one instance of that map for the whole
+ * process. It is created by config_processor and is passed to every
+ * acl_handler-agent.
+ *
+ * The map itself is protected by a mutex. The mutex is acquired only
+ * when a connection is authentificated or is closed and when the config
+ * is changed. Bandwidth limits are atomic token buckets and are used
+ * without the mutex: items of std::map are never moved and an item
+ * lives while there is at least one connection of the user.
+ *
+ * Default limits for users are held here too. They are set by
+ * config_processor once per a config, and only the generation of
+ * defaults is incremented: users aren't walked. The limits of a user
+ * are refreshed lazily by refresh_default_limits() when a traffic
+ * limiter of the user detects that the user's generation is outdated.
+ *
+ * @since v.0.6.0
+ */
+class authentificated_users_t
+{
+	//! The lock for m_users.
+	std::mutex m_lock;
+
+	//! The map of successfully authentificated users.
+	authentificated_user_map_t m_users;
+
+	//! The default limits for a user.
+	bandlim_config_t m_default_limits;
+
+	//! The refill interval for limits of users.
+	std::chrono::milliseconds m_refill_interval{ 20 };
+
+	//! The generation of the default limits.
+	/*!
+	 * It's incremented when the default limits are changed.
+	 * It's atomic because it's checked without the lock.
+	 */
+	std::atomic< std::uint64_t > m_defaults_generation{};
+
+public:
+	authentificated_users_t() = default;
+
+	authentificated_users_t( const authentificated_users_t & ) = delete;
+	authentificated_users_t( authentificated_users_t && ) = delete;
+
+	//! Get the lock for the info about authentificated users.
+	[[nodiscard]]
+	std::mutex &
+	lock() noexcept
+	{
+		return m_lock;
+	}
+
+	//! Get the info about authentificated users.
+	/*!
+	 * @attention
+	 * Should be called only when lock() is acquired.
+	 */
+	[[nodiscard]]
+	authentificated_user_map_t &
+	users() noexcept
+	{
+		return m_users;
+	}
+
+	//! Get the default limits for a user.
+	/*!
+	 * @attention
+	 * Should be called only when lock() is acquired.
+	 */
+	[[nodiscard]]
+	bandlim_config_t
+	default_limits() const noexcept
+	{
+		return m_default_limits;
+	}
+
+	//! Get the refill interval for limits of users.
+	/*!
+	 * @attention
+	 * Should be called only when lock() is acquired.
+	 */
+	[[nodiscard]]
+	std::chrono::milliseconds
+	refill_interval() const noexcept
+	{
+		return m_refill_interval;
+	}
+
+	//! Set new default limits.
+	/*!
+	 * The info about users isn't updated here. The generation is
+	 * incremented (if values are changed) and users will be updated
+	 * by refresh_default_limits().
+	 *
+	 * @attention
+	 * Should be called only when lock() is acquired.
+	 */
+	void
+	update_default_limits(
+		bandlim_config_t default_limits,
+		std::chrono::milliseconds refill_interval ) noexcept
+	{
+		if( default_limits.m_in == m_default_limits.m_in &&
+				default_limits.m_out == m_default_limits.m_out &&
+				refill_interval == m_refill_interval )
+			return;
+
+		m_default_limits = default_limits;
+		m_refill_interval = refill_interval;
+		m_defaults_generation.fetch_add( 1u, std::memory_order_relaxed );
+	}
+
+	//! Are the default limits applied to the user outdated?
+	/*!
+	 * It's a cheap check that can be called without the lock.
+	 * The value can be stale, but a change of the defaults will
+	 * be seen eventually.
+	 */
+	[[nodiscard]]
+	bool
+	default_limits_outdated(
+		const authentificated_user_info_t & info ) const noexcept
+	{
+		return info.m_defaults_generation.load( std::memory_order_relaxed ) !=
+				m_defaults_generation.load( std::memory_order_relaxed );
+	}
+
+	//! Mark the default limits applied to the user as the current ones.
+	/*!
+	 * It's used when the limits of the user are set with
+	 * default_limits() and refill_interval().
+	 *
+	 * @attention
+	 * Should be called only when lock() is acquired.
+	 */
+	void
+	default_limits_applied( authentificated_user_info_t & info ) noexcept
+	{
+		info.m_defaults_generation.store(
+				m_defaults_generation.load( std::memory_order_relaxed ),
+				std::memory_order_relaxed );
+	}
+
+	//! Apply the current default limits to the user if they are outdated.
+	/*!
+	 * @attention
+	 * Should be called only when lock() is acquired.
+	 */
+	void
+	refresh_default_limits( authentificated_user_info_t & info ) noexcept
+	{
+		if( default_limits_outdated( info ) )
+		{
+			info.m_bandlims.update_default_limits(
+					m_default_limits, m_refill_interval );
+			default_limits_applied( info );
+		}
+	}
+};
+
+} /* namespace arataga::acl_handler */
+
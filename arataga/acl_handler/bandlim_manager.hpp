@@ -5,10 +5,11 @@
 
 #pragma once
 
-#include <arataga/acl_handler/sequence_number.hpp>
+#include <arataga/acl_handler/atomic_token_bucket.hpp>
 
 #include <arataga/user_list_auth_data.hpp>
 
+#include <chrono>
 #include <map>
 
 namespace arataga::acl_handler
@@ -22,6 +23,20 @@ using domain_name_t = ::arataga::user_list_auth::domain_name_t;
 //
 /*!
  * @brief Bandwidth limit manager for a single user.
+ *
+ * Before v.0.6.0 quotes were recalculated once per second and a limited
+ * user got the whole quote for a second at the start of that second.
+ * It led to a burst of traffic followed by silence.
+ *
+ * Since v.0.6.0 every limit is a token bucket. The bucket is refilled
+ * continuously (the refill is performed lazily on every access to the
+ * bucket) and can't hold more than the amount of data allowed for one
+ * refill interval. So the traffic is spread evenly inside a second.
+ *
+ * The info about a user is shared by all IO-threads. Methods of
+ * bandlim_manager_t should be called under the lock of
+ * authentificated_users_t, but buckets from channel_limits_data_t can
+ * be used without any locks.
  */
 class bandlim_manager_t
 {
@@ -30,72 +45,51 @@ public:
 	// Public data type.
 	//
 	
-	//! A special representation of a quote with automatic handling
-	//! of `unlimited` value.
-	class quote_t
-	{
-		static constexpr bandlim_config_t::value_t maximum =
-				std::numeric_limits< bandlim_config_t::value_t >::max();
-
-		bandlim_config_t::value_t m_raw_value{ maximum };
-
-	public:
-		quote_t() = default;
-		quote_t( bandlim_config_t::value_t limit ) noexcept
-			:	m_raw_value{
-					bandlim_config_t::is_unlimited(limit) ? maximum : limit
-				}
-		{}
-
-		[[nodiscard]]
-		auto
-		get() const noexcept { return m_raw_value; }
-
-		[[nodiscard]]
-		auto
-		operator*() const noexcept { return get(); }
-
-		friend std::ostream &
-		operator<<( std::ostream & to, const quote_t v )
-		{
-			if( v.m_raw_value == quote_t::maximum )
-				to << "unlimited";
-			else
-				to << v.m_raw_value;
-			return to;
-		}
-	};
-
-	//! Info about traffic in one direction.
-	struct direction_traffic_info_t
-	{
-		//! The quote for the current turn.
-		quote_t m_quote{};
-		//! How much bandwidth are reserved on the current turn.
-		bandlim_config_t::value_t m_reserved{};
-		//! How much bandwidth are consumed on the current turn.
-		bandlim_config_t::value_t m_actual{};
-
-		//! The number of the turn for that this information is actual.
-		sequence_number_t m_sequence_number{};
-	};
-
 	//! Info about limits for one connection.
+	/*!
+	 * Since v.0.6.0 limits are atomic token buckets because they are
+	 * shared by connections from different IO-threads.
+	 */
 	struct channel_limits_data_t
 	{
-		//! Source values from the config.
-		bandlim_config_t m_directive_values;
+		//! The limit for data from the user.
+		atomic_token_bucket_t m_user_end_traffic;
+		//! The limit for data from the target.
+		atomic_token_bucket_t m_target_end_traffic;
+
+		//! Apply new values from the config.
+		/*!
+		 * A bucket is reset only if its value is changed.
+		 *
+		 * @since v.0.6.0
+		 */
+		void
+		set_limits(
+			bandlim_config_t limits,
+			std::chrono::milliseconds refill_interval,
+			std::chrono::steady_clock::time_point now ) noexcept
+		{
+			m_user_end_traffic.set_rate( limits.m_out, refill_interval, now );
+			m_target_end_traffic.set_rate( limits.m_in, refill_interval, now );
+		}
 
-		// The current values.
-		direction_traffic_info_t m_user_end_traffic;
-		direction_traffic_info_t m_target_end_traffic;
+		//! Refill buckets for both directions.
+		/*!
+		 * @since v.0.6.0
+		 */
+		void
+		refill( std::chrono::steady_clock::time_point now ) noexcept
+		{
+			m_user_end_traffic.refill( now );
+			m_target_end_traffic.refill( now );
+		}
 	};
 
 	//! Info about traffic for one specific domain.
 	struct domain_traffic_data_t
 	{
 		//! How many connections are established to that domain.
-		std::size_t m_connection_count;
+		std::size_t m_connection_count{};
 
 		//! Info about traffic for that domain.
 		channel_limits_data_t m_traffic;
@@ -127,27 +121,47 @@ private:
 	//! Traffic counters for particular domains.
 	domain_traffic_map_t m_domain_traffic;
 
-	//! Counter for number of turns.
-	sequence_number_t m_sequence_number;
-
-	//! The timepoint of the last recalculation of limits.
-	std::chrono::steady_clock::time_point m_last_update_at;
+	//! The interval of the refill of token buckets.
+	/*!
+	 * The capacity of a bucket is the amount of data allowed for
+	 * that interval.
+	 *
+	 * @since v.0.6.0
+	 */
+	std::chrono::milliseconds m_refill_interval;
 
 public:
 	bandlim_manager_t(
 		bandlim_config_t personal_limits,
-		bandlim_config_t default_limits );
+		bandlim_config_t default_limits,
+		std::chrono::milliseconds refill_interval );
+
+	bandlim_manager_t( const bandlim_manager_t & ) = delete;
+	bandlim_manager_t( bandlim_manager_t && ) = delete;
 
 	// Called every time of successful authentification of the user.
 	void
 	update_personal_limits(
 		bandlim_config_t personal_limits,
-		bandlim_config_t default_limits );
+		bandlim_config_t default_limits,
+		std::chrono::milliseconds refill_interval );
 
 	// Called every time of a change of arataga's config.
 	void
 	update_default_limits(
-		bandlim_config_t default_limits ) noexcept;
+		bandlim_config_t default_limits,
+		std::chrono::milliseconds refill_interval ) noexcept;
+
+	//! The current limits for the user.
+	/*!
+	 * It's the personal limit with respect to `default_limits`
+	 * from the config.
+	 *
+	 * @since v.0.6.0
+	 */
+	[[nodiscard]]
+	bandlim_config_t
+	general_limits() const noexcept;
 
 	[[nodiscard]]
 	channel_limits_data_t &
@@ -171,9 +185,6 @@ public:
 	void
 	connection_removed(
 		domain_traffic_map_t::iterator it_domain_traffic ) noexcept;
-
-	void
-	update_traffic_counters_for_new_turn() noexcept;
 };
 
 } /* namespace arataga::acl_handler */
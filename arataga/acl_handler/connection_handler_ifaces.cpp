@@ -42,6 +42,19 @@ traffic_limiter_t::reserved_capacity_t::release(
 traffic_limiter_t::traffic_limiter_t() = default;
 traffic_limiter_t::~traffic_limiter_t() {}
 
+//
+// connection_handler_t::timeout_entry_t
+//
+void
+connection_handler_t::timeout_entry_t::on_timeout() noexcept
+{
+	ARATAGA_NOTHROW_BLOCK_BEGIN()
+		ARATAGA_NOTHROW_BLOCK_STAGE(call_on_timer_for_connection_handler)
+
+		m_owner.on_timer();
+	ARATAGA_NOTHROW_BLOCK_END(LOG_THEN_ABORT)
+}
+
 //
 // connection_handler_t
 //
@@ -70,7 +83,13 @@ connection_handler_t::on_start()
 	// ATTENTION: it's very important for protection from deletion
 	// during replace_connection_handler or remove_connection_handler.
 	auto self = shared_from_this();
-	wrap_action_and_handle_exceptions( [this]() { on_start_impl(); } );
+	wrap_action_and_handle_exceptions( [this]() {
+			on_start_impl();
+
+			// The handler can be already replaced or removed.
+			if( status_t::active == m_status )
+				schedule_timeout_check();
+		} );
 }
 
 void
@@ -79,7 +98,13 @@ connection_handler_t::on_timer()
 	// ATTENTION: it's very important for protection from deletion
 	// during replace_connection_handler or remove_connection_handler.
 	auto self = shared_from_this();
-	wrap_action_and_handle_exceptions( [this]() { on_timer_impl(); } );
+	wrap_action_and_handle_exceptions( [this]() {
+			on_timer_impl();
+
+			// The handler can be already replaced or removed.
+			if( status_t::active == m_status )
+				schedule_timeout_check();
+		} );
 }
 
 void
@@ -87,6 +112,9 @@ connection_handler_t::release() noexcept
 {
 	m_status = status_t::released;
 
+	// A released handler doesn't need timeouts anymore.
+	m_timeout_entry.cancel();
+
 	if( m_connection.is_open() )
 	{
 		// Suppress exceptions because it's noexcept method and we have
@@ -6,9 +6,15 @@
 #pragma once
 
 #include <arataga/acl_handler/sequence_number.hpp>
+#include <arataga/acl_handler/io_chunk_pool.hpp>
+#include <arataga/acl_handler/pacing_wheel.hpp>
+#include <arataga/acl_handler/timeout_wheel.hpp>
+#include <arataga/acl_handler/upstream_connection_pool.hpp>
 
 #include <arataga/utils/string_literal.hpp>
 
+#include <arataga/stats/connections/pub.hpp>
+
 #include <arataga/config.hpp>
 
 #include <arataga/logging/wrap_logging.hpp>
@@ -63,6 +69,20 @@ public:
 	virtual std::size_t
 	io_chunk_count() const noexcept = 0;
 
+	/*!
+	 * @since v.0.6.0
+	 */
+	[[nodiscard]]
+	virtual relay_mode_t
+	relay_mode() const noexcept = 0;
+
+	/*!
+	 * @since v.0.6.0
+	 */
+	[[nodiscard]]
+	virtual std::chrono::milliseconds
+	bandlim_refill_interval() const noexcept = 0;
+
 	[[nodiscard]]
 	virtual std::chrono::milliseconds
 	protocol_detection_timeout() const noexcept = 0;
@@ -99,6 +119,22 @@ public:
 	virtual std::chrono::milliseconds
 	http_negative_response_timeout() const noexcept = 0;
 
+	//! Max count of idle connections to target hosts.
+	/*!
+	 * @since v.0.6.0
+	 */
+	[[nodiscard]]
+	virtual std::size_t
+	http_upstream_pool_size() const noexcept = 0;
+
+	//! Time-out for an idle connection to a target host.
+	/*!
+	 * @since v.0.6.0
+	 */
+	[[nodiscard]]
+	virtual std::chrono::milliseconds
+	http_upstream_idle_timeout() const noexcept = 0;
+
 	[[nodiscard]]
 	virtual const http_message_value_limits_t &
 	http_message_limits() const noexcept = 0;
@@ -263,12 +299,17 @@ public:
 
 	/*!
 	 * @brief The result of asking a quote for reading incoming
-	 * data on the current turn.
+	 * data right now.
 	 *
 	 * If the direction can be read then m_capacity will contain
 	 * an enabled amount of data to be read. After the completion
 	 * of the read operation method release() should be called
 	 * for reserved_capacity_t object.
+	 *
+	 * @note
+	 * Since v.0.6.0 limits are implemented as token buckets and
+	 * there are no turns anymore. The m_sequence_number is kept
+	 * for compatibility but isn't used by the actual traffic limiter.
 	 */
 	struct reserved_capacity_t
 	{
@@ -283,8 +324,8 @@ public:
 		 *
 		 * @attention
 		 * This method must be called after the completion of I/O operation.
-		 * Otherwise the reserved capacity will remain reserved till the
-		 * end of the current turn.
+		 * Otherwise the reserved capacity will remain reserved and
+		 * the bandwidth available for the user will be reduced.
 		 */
 		void
 		release(
@@ -302,7 +343,7 @@ public:
 
 	// Can return 0.
 	// In that case attempts of reading data should be suspended
-	// until the next turn.
+	// for a while (see connection_handler_t::wait_for_bandwidth()).
 	[[nodiscard]]
 	virtual reserved_capacity_t
 	reserve_read_portion(
@@ -403,6 +444,12 @@ struct success_t
 {
 	//! Actual traffic limiter for the new connection.
 	traffic_limiter_unique_ptr_t m_traffic_limiter;
+
+	//! The generation of user-list used for the authentification.
+	/*!
+	 * @since v.0.6.0
+	 */
+	std::uint64_t m_user_list_generation{ 0u };
 };
 
 //! Type for authentification result.
@@ -436,6 +483,14 @@ enum class connection_type_t
 	http
 };
 
+//
+// setup_stage_t
+//
+/*!
+ * @since v.0.6.0
+ */
+using setup_stage_t = ::arataga::stats::connections::setup_stage_t;
+
 //
 // handler_context_t
 //
@@ -472,12 +527,25 @@ public:
 	virtual const config_t &
 	config() const noexcept = 0;
 
+	//! Initiate the resolution of a domain name.
+	/*!
+	 * @note
+	 * Since v.0.6.0 @a result_handler can be called before the return
+	 * from that method (if the name is a direct IP-address or is
+	 * already in the DNS cache).
+	 */
 	virtual void
 	async_resolve_hostname(
 		connection_id_t id,
 		const std::string & hostname,
 		dns_resolving::hostname_result_handler_t result_handler ) = 0;
 
+	//! Initiate the authentification of a client.
+	/*!
+	 * @note
+	 * Since v.0.6.0 @a result_handler is called before the return
+	 * from that method in the case of successful authentification.
+	 */
 	virtual void
 	async_authentificate(
 		connection_id_t id,
@@ -487,6 +555,62 @@ public:
 	virtual void
 	stats_inc_connection_count(
 		connection_type_t connection_type ) = 0;
+
+	//! Store the duration of a connection setup stage in the stats.
+	/*!
+	 * The duration is the time from @a started_at to the current moment.
+	 *
+	 * @since v.0.6.0
+	 */
+	virtual void
+	stats_record_setup_stage(
+		setup_stage_t stage,
+		std::chrono::steady_clock::time_point started_at ) noexcept = 0;
+
+	//! Get the pool of I/O chunks to be used by connection-handlers.
+	/*!
+	 * @since v.0.6.0
+	 */
+	[[nodiscard]]
+	virtual io_chunk_pool_t &
+	io_chunk_pool() noexcept = 0;
+
+	//! Get the timer wheel for waking up throttled connections.
+	/*!
+	 * @since v.0.6.0
+	 */
+	[[nodiscard]]
+	virtual pacing_wheel_t &
+	pacing_wheel() noexcept = 0;
+
+	//! Get the timer wheel for timeouts of connection-handlers.
+	/*!
+	 * @since v.0.6.0
+	 */
+	[[nodiscard]]
+	virtual timeout_wheel_t &
+	timeout_wheel() noexcept = 0;
+
+	//! Get the pool of idle connections to target hosts.
+	/*!
+	 * @since v.0.6.0
+	 */
+	[[nodiscard]]
+	virtual upstream_connection_pool_t &
+	upstream_connection_pool() noexcept = 0;
+
+	//! Check that the result of a previous authentification is still valid.
+	/*!
+	 * The result can be reused if there were no updates of the user-list
+	 * since the authentification and @a target_port isn't denied now.
+	 *
+	 * @since v.0.6.0
+	 */
+	[[nodiscard]]
+	virtual bool
+	can_reuse_auth_result(
+		std::uint64_t user_list_generation,
+		std::uint16_t target_port ) const noexcept = 0;
 };
 
 //
@@ -613,6 +737,23 @@ public:
 	};
 
 private:
+	//! The entry for the handler in the timeout wheel.
+	/*!
+	 * @since v.0.6.0
+	 */
+	class timeout_entry_t final : public timeout_wheel_t::entry_t
+	{
+		connection_handler_t & m_owner;
+
+	public:
+		explicit timeout_entry_t( connection_handler_t & owner ) noexcept
+			:	m_owner{ owner }
+		{}
+
+		void
+		on_timeout() noexcept override;
+	};
+
 	//! Remove the handler.
 	/*!
 	 * @note
@@ -644,6 +785,16 @@ protected:
 	//! Handler status.
 	status_t m_status;
 
+	//! The registration of the handler in the timeout wheel.
+	/*!
+	 * @note
+	 * It's declared after m_ctx, so it's cancelled before the release
+	 * of the handler_context.
+	 *
+	 * @since v.0.6.0
+	 */
+	timeout_entry_t m_timeout_entry{ *this };
+
 	/*!
 	 * @name Methods inside those the handler can be removed/replaced.
 	 * @{
@@ -651,12 +802,45 @@ protected:
 	virtual void
 	on_start_impl() = 0;
 
+	//! Check the deadline of the current operation.
+	/*!
+	 * Since v.0.6.0 it's called when timeout_deadline() comes, not
+	 * once a second. If the deadline is moved forward (for example,
+	 * some data has been read) the method has to do nothing, the next
+	 * check will be scheduled automatically.
+	 */
 	virtual void
 	on_timer_impl() = 0;
 	/*!
 	 * @}
 	 */
 
+	//! Get the time point when on_timer_impl() has to be called.
+	/*!
+	 * It's called after on_start_impl() and after every on_timer_impl()
+	 * if the handler is still active.
+	 *
+	 * @since v.0.6.0
+	 */
+	[[nodiscard]]
+	virtual std::chrono::steady_clock::time_point
+	timeout_deadline() noexcept = 0;
+
+	//! Schedule the call of on_timer_impl() at timeout_deadline().
+	/*!
+	 * It is done automatically after on_start_impl() and on_timer_impl().
+	 * A handler has to call it only if timeout_deadline() becomes
+	 * earlier in other places.
+	 *
+	 * @since v.0.6.0
+	 */
+	void
+	schedule_timeout_check() noexcept
+	{
+		context().timeout_wheel().schedule(
+				m_timeout_entry, timeout_deadline() );
+	}
+
 	[[nodiscard]]
 	handler_context_t &
 	context() noexcept { return m_ctx.ctx(); }
@@ -938,6 +1122,32 @@ protected:
 		return { shared_from_this() };
 	}
 
+	//! Resume an action when bandwidth limits allow it.
+	/*!
+	 * This method should be called when traffic_limiter returns zero
+	 * capacity. The @a completion will be called after
+	 * config_t::bandlim_refill_interval() (if the connection-handler
+	 * is still active at that moment).
+	 *
+	 * Usage example:
+	 * @code
+	 * if( 0u == reserved_capacity.m_capacity )
+	 * 	return wait_for_bandwidth( [this]() {
+	 * 			... // Try to reserve the capacity again.
+	 * 		} );
+	 * @endcode
+	 *
+	 * @since v.0.6.0
+	 */
+	template< typename Completion >
+	void
+	wait_for_bandwidth( Completion && completion )
+	{
+		context().pacing_wheel().schedule(
+				context().config().bandlim_refill_interval(),
+				with<>().make_handler( std::forward<Completion>(completion) ) );
+	}
+
 	template< typename Completion >
 	[[nodiscard]]
 	auto
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <arataga/acl_handler/exception.hpp>
+#include <arataga/acl_handler/io_chunk_pool.hpp>
 
 #include <fmt/format.h>
 
@@ -32,6 +33,10 @@ namespace arataga::acl_handler
  * Type first_chunk_t is a holder for the first IO-chunk written in RAII
  * maner.
  *
+ * Since v.0.6.0 the memory for the first IO-chunk is taken from
+ * io_chunk_pool of the current IO-thread and is returned to that pool
+ * when first_chunk_t is destroyed.
+ *
  * @note
  * This is Movable, but not Copyable type.
  * This type isn't DefaultConstructible.
@@ -40,18 +45,29 @@ namespace arataga::acl_handler
  */
 class first_chunk_t
 {
-public:
-	using chunk_t = std::unique_ptr< std::byte[] >;
+	io_chunk_t m_chunk;
+
+	[[nodiscard]]
+	static io_chunk_t
+	ensure_not_empty( io_chunk_t chunk )
+	{
+		if( chunk.empty() )
+			throw acl_handler_ex_t{
+					"first_chunk_t: an empty io_chunk can't be used"
+				};
 
-private:
-	std::unique_ptr< std::byte[] > m_chunk;
-	std::size_t m_capacity;
+		return chunk;
+	}
 
 public:
 	//NOTE: there is no default constructor!
-	first_chunk_t( std::size_t capacity )
-		:	m_chunk{ std::make_unique< std::byte[] >( capacity ) }
-		,	m_capacity{ capacity }
+	/*!
+	 * @note
+	 * Since v.0.6.0 the memory for the first chunk isn't allocated
+	 * by first_chunk_t itself. It is borrowed from io_chunk_pool.
+	 */
+	first_chunk_t( io_chunk_t chunk )
+		:	m_chunk{ ensure_not_empty( std::move(chunk) ) }
 	{}
 
 	first_chunk_t( const first_chunk_t & ) = delete;
@@ -67,12 +83,15 @@ public:
 	{
 		using std::swap;
 		swap( a.m_chunk, b.m_chunk );
-		swap( a.m_capacity, b.m_capacity );
 	}
 
+	/*!
+	 * @note
+	 * Since v.0.6.0 returns io_chunk_t instead of unique_ptr.
+	 */
 	[[nodiscard]]
-	std::unique_ptr< std::byte[] >
-	giveaway_buffer() noexcept
+	io_chunk_t
+	giveaway_io_chunk() noexcept
 	{
 		return std::move(m_chunk);
 	}
@@ -81,21 +100,21 @@ public:
 	std::byte *
 	buffer() noexcept
 	{
-		return m_chunk.get();
+		return m_chunk.data();
 	}
 
 	[[nodiscard]]
 	const std::byte *
 	buffer() const noexcept
 	{
-		return m_chunk.get();
+		return m_chunk.data();
 	}
 
 	[[nodiscard]]
 	std::size_t
 	capacity() const noexcept
 	{
-		return m_capacity;
+		return m_chunk.capacity();
 	}
 };
 
@@ -11,6 +11,16 @@
 
 #include <noexcept_ctcheck/pub.hpp>
 
+#include <optional>
+#include <utility>
+
+#if defined(__linux__)
+	#include <fcntl.h>
+	#include <unistd.h>
+
+	#include <cerrno>
+#endif
+
 namespace arataga::acl_handler
 {
 
@@ -19,6 +29,45 @@ namespace handlers::data_transfer
 
 using namespace arataga::utils::string_literals;
 
+//
+// ensure_non_blocking_mode
+//
+/*!
+ * @brief Switch a socket to non-blocking mode if it isn't switched yet.
+ *
+ * Data is read by synchronous calls after the readiness of a socket.
+ * Those calls mustn't block the IO-thread.
+ *
+ * @since v.0.6.0
+ */
+[[nodiscard]]
+asio::ip::tcp::socket
+ensure_non_blocking_mode(
+	asio::ip::tcp::socket channel )
+{
+	if( !channel.non_blocking() )
+		channel.non_blocking( true );
+
+	return channel;
+}
+
+//
+// ensure_traffic_limiter_not_null
+//
+[[nodiscard]]
+traffic_limiter_unique_ptr_t
+ensure_traffic_limiter_not_null(
+	traffic_limiter_unique_ptr_t value )
+{
+	if( !value )
+		throw acl_handler_ex_t{
+				"data_transfer_handler_t's constructor: "
+				"traffic_limiter parameter can't be nullptr!"
+			};
+
+	return value;
+}
+
 //
 // data_transfer_handler_t
 //
@@ -51,6 +100,14 @@ using namespace arataga::utils::string_literals;
  * Since v.0.5.0 data_transfer_handler_t handles the case when
  * some data is already read from the incoming connection (in the form
  * of first_chunk_for_next_handler_t object passed to the constructor).
+ *
+ * Since v.0.6.0 I/O buffers aren't preallocated. The handler waits for
+ * the readiness of a socket without any buffer and only then borrows
+ * a chunk from io_chunk_pool, reads the available data into it in
+ * non-blocking mode and returns the chunk to the pool as soon as the data
+ * is written to the opposite direction. So an idle connection holds
+ * no I/O buffers at all. The io_chunk_count parameter limits the count of
+ * chunks with pending outgoing data for a single direction.
  */
 class data_transfer_handler_t final : public connection_handler_t
 {
@@ -83,26 +140,18 @@ class data_transfer_handler_t final : public connection_handler_t
 		struct io_buffer_t
 		{
 			//! Data read from this direction to be written to opposite direction.
-			std::unique_ptr< std::byte[] > m_data_read;
+			/*!
+			 * Since v.0.6.0 this chunk is borrowed from io_chunk_pool only
+			 * when there is data to be read and is returned back after
+			 * writing the data to the opposite direction. It is empty
+			 * the rest of the time.
+			 */
+			io_chunk_t m_data_read;
 			//! Count of bytes in data_read.
 			/*!
 			 * Gets a new value after every read operation.
 			 */
 			std::size_t m_data_size{ 0u };
-
-			// The constructor allocates data_read buffer.
-			io_buffer_t( std::size_t io_chunk_size )
-				:	m_data_read( std::make_unique<std::byte[]>(io_chunk_size) )
-			{}
-
-			// The constructor for the case when data_read buffer is
-			// already allocated. And can have some initial data inside.
-			io_buffer_t(
-				std::unique_ptr< std::byte[] > data_read,
-				std::size_t data_size )
-				:	m_data_read{ std::move(data_read) }
-				,	m_data_size{ data_size }
-			{}
 		};
 
 		//! List of buffers for I/O operations.
@@ -125,22 +174,32 @@ class data_transfer_handler_t final : public connection_handler_t
 		bool m_is_alive{ true };
 
 		//! Does traffic-limit for this direction exceeded?
+		/*!
+		 * Since v.0.6.0 it also means that there is a pending wake-up
+		 * in pacing_wheel. No new reads should be initiated until
+		 * that wake-up.
+		 */
 		bool m_is_traffic_limit_exceeded{ false };
 
 		//! Is there an active read operation?
+		/*!
+		 * Since v.0.6.0 it means that there is an active wait for
+		 * the readiness of the channel.
+		 */
 		bool m_active_read{ false };
 		//! Is there an active write operation?
 		bool m_active_write{ false };
 
 		//! Constructor for user-end connection.
 		/*!
-		 * There is first_chunk, so the first item in m_in_buffers should
-		 * be constructed from that first_chunk.
+		 * There is first_chunk, so if there are some incoming data in it
+		 * the first item in m_in_buffers should be constructed from that
+		 * first_chunk. In that case value of m_available_for_read_buffers
+		 * should be decremented, m_available_for_write_buffers should be
+		 * incremented, and m_read_index should be changed appropriately.
 		 *
-		 * There could also be some incoming data in the first_chunk.
-		 * In that case value of m_available_for_read_buffers should be
-		 * decremented, m_available_for_write_buffers should be incremented,
-		 * and m_read_index should be changed appropriately.
+		 * If there is no data in the first_chunk then the first_chunk
+		 * is just returned to io_chunk_pool.
 		 *
 		 * @since v.0.5.0
 		 */
@@ -153,6 +212,7 @@ class data_transfer_handler_t final : public connection_handler_t
 			traffic_limiter_t::direction_t traffic_direction )
 			:	m_channel{ channel }
 			,	m_name{ name }
+			,	m_in_buffers( io_chunk_count )
 			,	m_available_for_read_buffers{ io_chunk_count }
 			,	m_traffic_direction{ traffic_direction }
 		{
@@ -164,25 +224,16 @@ class data_transfer_handler_t final : public connection_handler_t
 							first_chunk_data.chunk().capacity() )
 				};
 
-			// I/O buffers have to be created manually except the first one.
-			m_in_buffers.reserve( m_available_for_read_buffers );
-
-			// Item with index 0 has to be constructed from first_chunk.
-			m_in_buffers.emplace_back(
-					first_chunk_data.giveaway_chunk().giveaway_buffer(),
-					first_chunk_data.remaining_bytes() );
-
-			for( std::size_t i = 1u; i < m_available_for_read_buffers; ++i )
-			{
-				m_in_buffers.emplace_back( io_chunk_size );
-			}
-
 			// If there are some incoming data from the user-end then
 			// it should be reflected in values of m_available_for_read_buffers,
 			// m_available_for_write_buffers, m_read_index.
 			if( first_chunk_data.remaining_bytes() )
 			{
-				m_in_buffers[ 0u ].m_data_size = first_chunk_data.remaining_bytes();
+				auto & buffer = m_in_buffers[ 0u ];
+				buffer.m_data_read =
+						first_chunk_data.giveaway_chunk().giveaway_io_chunk();
+				buffer.m_data_size = first_chunk_data.remaining_bytes();
+
 				m_available_for_read_buffers -= 1u;
 				m_available_for_write_buffers += 1u;
 
@@ -198,21 +249,14 @@ class data_transfer_handler_t final : public connection_handler_t
 		direction_state_t(
 			asio::ip::tcp::socket & channel,
 			arataga::utils::string_literal_t name,
-			std::size_t io_chunk_size,
 			std::size_t io_chunk_count,
 			traffic_limiter_t::direction_t traffic_direction )
 			:	m_channel{ channel }
 			,	m_name{ name }
+			,	m_in_buffers( io_chunk_count )
 			,	m_available_for_read_buffers{ io_chunk_count }
 			,	m_traffic_direction{ traffic_direction }
-		{
-			// I/O buffers have to be created manually.
-			m_in_buffers.reserve( m_available_for_read_buffers );
-			for( std::size_t i = 0u; i != m_available_for_read_buffers; ++i )
-			{
-				m_in_buffers.emplace_back( io_chunk_size );
-			}
-		}
+		{}
 
 		void
 		increment_read_index() noexcept
@@ -237,20 +281,6 @@ class data_transfer_handler_t final : public connection_handler_t
 			std::chrono::steady_clock::now()
 		};
 
-	[[nodiscard]]
-	static traffic_limiter_unique_ptr_t
-	ensure_traffic_limiter_not_null(
-		traffic_limiter_unique_ptr_t value )
-	{
-		if( !value )
-			throw acl_handler_ex_t{
-					"data_transfer_handler_t's constructor: "
-					"traffic_limiter parameter can't be nullptr!"
-				};
-
-		return value;
-	}
-
 public:
 	data_transfer_handler_t(
 		handler_context_holder_t ctx,
@@ -259,8 +289,14 @@ public:
 		first_chunk_for_next_handler_t first_chunk_data,
 		asio::ip::tcp::socket out_connection,
 		traffic_limiter_unique_ptr_t traffic_limiter )
-		:	connection_handler_t{ std::move(ctx), id, std::move(in_connection) }
-		,	m_out_connection{ std::move(out_connection) }
+		:	connection_handler_t{
+				std::move(ctx),
+				id,
+				ensure_non_blocking_mode( std::move(in_connection) )
+			}
+		,	m_out_connection{
+				ensure_non_blocking_mode( std::move(out_connection) )
+			}
 		,	m_traffic_limiter{
 				ensure_traffic_limiter_not_null( std::move(traffic_limiter) )
 			}
@@ -274,7 +310,6 @@ public:
 			}
 		,	m_target_end{
 				m_out_connection, "target-end"_static_str,
-				m_io_chunk_size,
 				context().config().io_chunk_count(),
 				traffic_limiter_t::direction_t::from_target
 			}
@@ -300,6 +335,14 @@ protected:
 		initiate_read_target_end();
 	}
 
+	[[nodiscard]]
+	std::chrono::steady_clock::time_point
+	timeout_deadline() noexcept override
+	{
+		return m_last_read_at +
+				context().config().idle_connection_timeout();
+	}
+
 	void
 	on_timer_impl() override
 	{
@@ -335,20 +378,8 @@ protected:
 					"no data read for long time"_static_str );
 		}
 
-		// If some bandwidth limit was exceeded then we have to
-		// recheck that limit and initiate a new read if it's possible.
-		if( m_user_end.m_is_traffic_limit_exceeded )
-		{
-			// It's safe to initiate a new read operation because
-			// yet another check will be done inside initiate_read_*
-			// methods. As the result the flag will be set into the
-			// right value.
-			initiate_read_user_end();
-		}
-		if( m_target_end.m_is_traffic_limit_exceeded )
-		{
-			initiate_read_target_end();
-		}
+		// NOTE: since v.0.6.0 reads suspended because of the bandwidth
+		// limit are resumed by pacing_wheel, not here.
 	}
 
 	arataga::utils::string_literal_t
@@ -401,11 +432,50 @@ private:
 		if( src_dir.m_active_read )
 			return;
 
+		// The read will be resumed when the bandwidth limit allows it.
+		if( src_dir.m_is_traffic_limit_exceeded )
+			return;
+
 		// We can't start a new read operation if there is no free buffers.
 		if( !src_dir.m_available_for_read_buffers )
 			return;
 
-		// How many bytes can be read on that turn?
+		// Since v.0.6.0 we wait for incoming data without a buffer.
+		// The buffer will be taken from io_chunk_pool when the data arrives.
+		src_dir.m_channel.async_wait(
+				asio::ip::tcp::socket::wait_read,
+				with<const asio::error_code &>().make_handler(
+					[this, &src_dir, &dest_dir]( const asio::error_code & ec )
+					{
+						on_read_readiness( src_dir, dest_dir, ec );
+					} )
+			);
+
+		// There should be no exceptions!
+		NOEXCEPT_CTCHECK_ENSURE_NOEXCEPT_STATEMENT(
+			src_dir.m_active_read = true );
+	}
+
+	void
+	on_read_readiness(
+		// The direction from that data should be read.
+		direction_state_t & src_dir,
+		// The direction to that data should be written.
+		direction_state_t & dest_dir,
+		const asio::error_code & wait_ec )
+	{
+		// Regardless of the result the active read operation flag
+		// has to be reset.
+		src_dir.m_active_read = false;
+
+		// Index of buffer for reading into.
+		const auto selected_buffer = src_dir.m_read_index;
+
+		if( wait_ec )
+			return on_read_result(
+					src_dir, dest_dir, selected_buffer, wait_ec, 0u );
+
+		// How many bytes can be read right now?
 		const auto reserved_capacity = m_traffic_limiter->reserve_read_portion(
 				src_dir.m_traffic_direction, m_io_chunk_size );
 
@@ -413,40 +483,61 @@ private:
 		src_dir.m_is_traffic_limit_exceeded = ( 0u == reserved_capacity.m_capacity );
 
 		if( src_dir.m_is_traffic_limit_exceeded )
-			// Should wait for the next turn.
-			return;
+		{
+			// Incoming data will wait in the socket until the bucket
+			// is refilled. A buffer isn't needed until that time.
+			return wait_for_bandwidth( [this, &src_dir, &dest_dir]() {
+					src_dir.m_is_traffic_limit_exceeded = false;
+					initiate_async_read_for_direction( src_dir, dest_dir );
+				} );
+		}
 
-		// Detect the next buffer for reading into.
-		const auto selected_buffer = src_dir.m_read_index;
-		src_dir.increment_read_index();
+		auto & buffer = src_dir.m_in_buffers[ selected_buffer ];
+
+		// The buffer is borrowed only for the time the data is held.
+		try
+		{
+			buffer.m_data_read = context().io_chunk_pool().acquire(
+					m_io_chunk_size );
+		}
+		catch( ... )
+		{
+			// The reserved capacity has to be returned if nothing is read.
+			reserved_capacity.release(
+					*m_traffic_limiter,
+					src_dir.m_traffic_direction,
+					asio::error_code{},
+					0u );
+			throw;
+		}
 
-		src_dir.m_channel.async_read_some(
+		// The channel is in non-blocking mode, so this call reads only
+		// the data that is already available.
+		asio::error_code ec;
+		const std::size_t bytes = src_dir.m_channel.read_some(
 				asio::buffer(
-						src_dir.m_in_buffers[selected_buffer].m_data_read.get(),
+						buffer.m_data_read.data(),
 						reserved_capacity.m_capacity),
-				with<const asio::error_code &, std::size_t>().make_handler(
-					[this, &src_dir, &dest_dir, reserved_capacity, selected_buffer](
-						const asio::error_code & ec,
-						std::size_t bytes )
-					{
-						reserved_capacity.release(
-								*m_traffic_limiter,
-								src_dir.m_traffic_direction,
-								ec,
-								bytes );
-
-						on_read_result(
-								src_dir, dest_dir, selected_buffer,
-								ec,
-								bytes );
-					} )
-			);
+				ec );
 
-		// There should be no exceptions!
-		NOEXCEPT_CTCHECK_ENSURE_NOEXCEPT_STATEMENT(
-			src_dir.m_active_read = true );
-		NOEXCEPT_CTCHECK_ENSURE_NOEXCEPT_STATEMENT(
-			src_dir.m_available_for_read_buffers -= 1u );
+		reserved_capacity.release(
+				*m_traffic_limiter,
+				src_dir.m_traffic_direction,
+				ec,
+				bytes );
+
+		if( asio::error::would_block == ec || asio::error::try_again == ec )
+		{
+			// It was a spurious wake-up. The buffer isn't needed yet,
+			// the waiting should be resumed.
+			buffer.m_data_read.reset();
+			return initiate_async_read_for_direction( src_dir, dest_dir );
+		}
+
+		on_read_result(
+				src_dir, dest_dir, selected_buffer,
+				ec,
+				bytes );
 	}
 
 	void
@@ -479,7 +570,7 @@ private:
 		asio::async_write(
 				dest_dir.m_channel,
 				asio::buffer(
-						buffer.m_data_read.get(),
+						buffer.m_data_read.data(),
 						buffer.m_data_size),
 				with<const asio::error_code &, std::size_t>().make_handler(
 					[this, &dest_dir, &src_dir, selected_buffer](
@@ -540,6 +631,10 @@ private:
 			// No errors, we can trust bytes_transferred value.
 			src_dir.m_in_buffers[selected_buffer].m_data_size = bytes_transferred;
 
+			// The buffer is occupied until the data is written.
+			src_dir.increment_read_index();
+			src_dir.m_available_for_read_buffers -= 1u;
+
 			// There is another buffer with outgoing data.
 			src_dir.m_available_for_write_buffers += 1u;
 
@@ -555,6 +650,9 @@ private:
 
 		// Handle an error here.
 
+		// The buffer selected for the read isn't needed anymore.
+		src_dir.m_in_buffers[selected_buffer].m_data_read.reset();
+
 		// src_dir is assumed to be closed regardless of error type.
 		src_dir.m_is_alive = false;
 
@@ -636,10 +734,6 @@ private:
 				} );
 #endif
 
-		// Regardless of the result the active read operation flag
-		// has to be reset.
-		src_dir.m_active_read = false;
-
 		// Handle the result of read operation...
 		const auto handling_result = handle_read_error_code(
 				src_dir,
@@ -736,6 +830,9 @@ private:
 			}
 			else
 			{
+				// The data is written, the buffer can be returned to the pool.
+				src_dir.m_in_buffers[selected_buffer].m_data_read.reset();
+
 				// There is one more free buffer for next read.
 				src_dir.m_available_for_read_buffers += 1u;
 
@@ -784,6 +881,555 @@ private:
 	}
 };
 
+#if defined(__linux__)
+
+//
+// splice_pipe_t
+//
+/*!
+ * @brief A holder of a non-blocking pipe used by splice_transfer_handler.
+ *
+ * @note
+ * This is Movable, but not Copyable type.
+ *
+ * @since v.0.6.0
+ */
+class splice_pipe_t
+{
+	int m_read_end{ -1 };
+	int m_write_end{ -1 };
+
+	splice_pipe_t( int read_end, int write_end ) noexcept
+		:	m_read_end{ read_end }
+		,	m_write_end{ write_end }
+	{}
+
+public:
+	splice_pipe_t() noexcept = default;
+
+	~splice_pipe_t() noexcept
+	{
+		if( -1 != m_read_end )
+			::close( m_read_end );
+		if( -1 != m_write_end )
+			::close( m_write_end );
+	}
+
+	splice_pipe_t( const splice_pipe_t & ) = delete;
+	splice_pipe_t &
+	operator=( const splice_pipe_t & ) = delete;
+
+	splice_pipe_t( splice_pipe_t && other ) noexcept
+		:	m_read_end{ std::exchange( other.m_read_end, -1 ) }
+		,	m_write_end{ std::exchange( other.m_write_end, -1 ) }
+	{}
+
+	splice_pipe_t &
+	operator=( splice_pipe_t && other ) noexcept
+	{
+		splice_pipe_t tmp{ std::move(other) };
+		std::swap( m_read_end, tmp.m_read_end );
+		std::swap( m_write_end, tmp.m_write_end );
+		return *this;
+	}
+
+	//! Try to create a new pipe.
+	/*!
+	 * @return empty value if the pipe can't be created. The reason
+	 * is stored into @a ec.
+	 */
+	[[nodiscard]]
+	static std::optional< splice_pipe_t >
+	try_make( asio::error_code & ec ) noexcept
+	{
+		int fds[ 2 ];
+		if( 0 != ::pipe2( fds, O_NONBLOCK | O_CLOEXEC ) )
+		{
+			ec = asio::error_code{ errno, asio::error::get_system_category() };
+			return std::nullopt;
+		}
+
+		return splice_pipe_t{ fds[ 0 ], fds[ 1 ] };
+	}
+
+	[[nodiscard]]
+	int
+	read_end() const noexcept { return m_read_end; }
+
+	[[nodiscard]]
+	int
+	write_end() const noexcept { return m_write_end; }
+};
+
+//
+// splice_transfer_handler_t
+//
+/*!
+ * @brief An implementation of connection_handler for the data-transfer
+ * with splice(2).
+ *
+ * This handler is used instead of data_transfer_handler_t if
+ * relay_mode_t::splice is set in the config.
+ *
+ * Data isn't copied into the user-space. It's moved from a socket to
+ * a pipe and then from that pipe to the opposite socket by splice(2)
+ * calls. There is a separate pipe for every direction.
+ *
+ * The work scheme for a direction is simple: wait for the readiness of
+ * the source socket, move a portion of data (reserved in traffic_limiter)
+ * into the pipe, then move all data from the pipe to the destination
+ * socket (waiting for the readiness of the destination socket if
+ * necessary). A new portion is read only when the pipe is empty. So the
+ * bandwidth limits are respected the same way as in data_transfer_handler.
+ *
+ * The size of a portion is io_chunk_size*io_chunk_count (it is the max
+ * amount of pending data for a direction in the copy mode).
+ *
+ * If there is some data in the first chunk then that data is written
+ * to the target-end by an ordinary write before the start of the splicing.
+ * The first chunk is returned to io_chunk_pool after that.
+ *
+ * @since v.0.6.0
+ */
+class splice_transfer_handler_t final : public connection_handler_t
+{
+	//! Outgoing connection (targed-end connection).
+	asio::ip::tcp::socket m_out_connection;
+
+	//! Traffic limiter for that connection.
+	traffic_limiter_unique_ptr_t m_traffic_limiter;
+
+	//! Data that is already read from the user-end.
+	/*!
+	 * It is empty after writing the data to the target-end.
+	 */
+	first_chunk_for_next_handler_t m_first_chunk_data;
+
+	//! Max size of data to be read from a socket by one call.
+	const std::size_t m_max_portion_size;
+
+	//! State of a single direction.
+	struct direction_state_t
+	{
+		//! The socket for this direction.
+		asio::ip::tcp::socket & m_channel;
+
+		//! Name for this direction.
+		const arataga::utils::string_literal_t m_name;
+
+		//! The pipe for the data read from this direction.
+		splice_pipe_t m_pipe;
+
+		//! Count of bytes in m_pipe.
+		std::size_t m_bytes_in_pipe{ 0u };
+
+		//! Type of this direction for traffic_limiter.
+		traffic_limiter_t::direction_t m_traffic_direction;
+
+		//! Does traffic-limit for this direction exceeded?
+		bool m_is_traffic_limit_exceeded{ false };
+
+		//! Is there an active wait for the data in this direction?
+		bool m_active_read{ false };
+		//! Is there an active wait for the possibility to write
+		//! into this direction?
+		bool m_active_write{ false };
+
+		direction_state_t(
+			asio::ip::tcp::socket & channel,
+			arataga::utils::string_literal_t name,
+			splice_pipe_t pipe,
+			traffic_limiter_t::direction_t traffic_direction )
+			:	m_channel{ channel }
+			,	m_name{ name }
+			,	m_pipe{ std::move(pipe) }
+			,	m_traffic_direction{ traffic_direction }
+		{}
+	};
+
+	//! Direction from the user to the target host.
+	direction_state_t m_user_end;
+	//! Direction from the target host to the user.
+	direction_state_t m_target_end;
+
+	//! Time point of the last successful data read (from any direction).
+	std::chrono::steady_clock::time_point m_last_read_at{
+			std::chrono::steady_clock::now()
+		};
+
+	[[nodiscard]]
+	static asio::error_code
+	last_error() noexcept
+	{
+		return { errno, asio::error::get_system_category() };
+	}
+
+	[[nodiscard]]
+	static bool
+	is_would_block( const asio::error_code & ec ) noexcept
+	{
+		return asio::error::would_block == ec || asio::error::try_again == ec;
+	}
+
+public:
+	splice_transfer_handler_t(
+		handler_context_holder_t ctx,
+		handler_context_t::connection_id_t id,
+		asio::ip::tcp::socket in_connection,
+		first_chunk_for_next_handler_t first_chunk_data,
+		asio::ip::tcp::socket out_connection,
+		traffic_limiter_unique_ptr_t traffic_limiter,
+		splice_pipe_t user_end_pipe,
+		splice_pipe_t target_end_pipe )
+		:	connection_handler_t{
+				std::move(ctx),
+				id,
+				ensure_non_blocking_mode(
+						std::move(in_connection) )
+			}
+		,	m_out_connection{
+				ensure_non_blocking_mode(
+						std::move(out_connection) )
+			}
+		,	m_traffic_limiter{
+				ensure_traffic_limiter_not_null(
+						std::move(traffic_limiter) )
+			}
+		,	m_first_chunk_data{ std::move(first_chunk_data) }
+		,	m_max_portion_size{
+				context().config().io_chunk_size() *
+						context().config().io_chunk_count()
+			}
+		,	m_user_end{
+				m_connection, "user-end"_static_str,
+				std::move(user_end_pipe),
+				traffic_limiter_t::direction_t::from_user
+			}
+		,	m_target_end{
+				m_out_connection, "target-end"_static_str,
+				std::move(target_end_pipe),
+				traffic_limiter_t::direction_t::from_target
+			}
+	{
+	}
+
+protected:
+	void
+	on_start_impl() override
+	{
+		if( m_first_chunk_data.remaining_bytes() )
+		{
+			// The data already read from the user-end has to be written
+			// first. The user-end will be read after that.
+			asio::async_write(
+					m_out_connection,
+					asio::buffer(
+							m_first_chunk_data.chunk().buffer(),
+							m_first_chunk_data.remaining_bytes() ),
+					with<const asio::error_code &, std::size_t>().make_handler(
+						[this]( const asio::error_code & ec, std::size_t )
+						{
+							on_first_chunk_written( ec );
+						} )
+				);
+			m_target_end.m_active_write = true;
+		}
+		else
+		{
+			// The first chunk isn't needed anymore.
+			m_first_chunk_data.chunk().giveaway_io_chunk().reset();
+
+			wait_readable( m_user_end, m_target_end );
+		}
+
+		wait_readable( m_target_end, m_user_end );
+	}
+
+	[[nodiscard]]
+	std::chrono::steady_clock::time_point
+	timeout_deadline() noexcept override
+	{
+		return m_last_read_at +
+				context().config().idle_connection_timeout();
+	}
+
+	void
+	on_timer_impl() override
+	{
+		const auto now = std::chrono::steady_clock::now();
+
+		if( m_last_read_at +
+				context().config().idle_connection_timeout() < now )
+		{
+			connection_remover_t remover{
+					*this,
+					remove_reason_t::no_activity_for_too_long
+			};
+
+			using namespace arataga::utils::string_literals;
+			return easy_log_for_connection(
+					spdlog::level::warn,
+					"no data read for long time"_static_str );
+		}
+
+		// NOTE: reads suspended because of the bandwidth limit are
+		// resumed by pacing_wheel, not here.
+	}
+
+	arataga::utils::string_literal_t
+	name() const noexcept override
+	{
+		using namespace arataga::utils::string_literals;
+		return "splice-transfer-handler"_static_str;
+	}
+
+	// We have to redefine this method because we have another connection
+	// and that connection should be closed explicitely.
+	void
+	release() noexcept override
+	{
+		// Ignore all errors.
+		asio::error_code ec;
+		m_out_connection.shutdown( asio::ip::tcp::socket::shutdown_both, ec );
+		m_out_connection.close( ec );
+
+		// Let's the base class completes the release.
+		connection_handler_t::release();
+	}
+
+private:
+	void
+	on_first_chunk_written( const asio::error_code & ec )
+	{
+		m_target_end.m_active_write = false;
+
+		// The first chunk isn't needed anymore.
+		m_first_chunk_data.chunk().giveaway_io_chunk().reset();
+
+		if( ec )
+		{
+			connection_remover_t remover{
+					*this,
+					remove_reason_t::io_error
+			};
+
+			return log_on_io_error(
+					ec,
+					fmt::format( "writting to {}", m_target_end.m_name ) );
+		}
+
+		// Because async_write was used it's guaranteed that all
+		// data was written. Now the user-end can be read.
+		wait_readable( m_user_end, m_target_end );
+	}
+
+	void
+	wait_readable(
+		// The direction from that data should be read.
+		direction_state_t & src_dir,
+		// The direction to that data should be written.
+		direction_state_t & dest_dir )
+	{
+		if( src_dir.m_active_read )
+			return;
+
+		src_dir.m_channel.async_wait(
+				asio::ip::tcp::socket::wait_read,
+				with<const asio::error_code &>().make_handler(
+					[this, &src_dir, &dest_dir]( const asio::error_code & ec )
+					{
+						src_dir.m_active_read = false;
+
+						if( ec )
+							return handle_wait_error( src_dir, ec );
+
+						read_into_pipe( src_dir, dest_dir );
+					} )
+			);
+
+		// There should be no exceptions!
+		NOEXCEPT_CTCHECK_ENSURE_NOEXCEPT_STATEMENT(
+			src_dir.m_active_read = true );
+	}
+
+	void
+	wait_writable(
+		// The direction to that data should be written.
+		direction_state_t & dest_dir,
+		// The direction from that data was read.
+		direction_state_t & src_dir )
+	{
+		if( dest_dir.m_active_write )
+			return;
+
+		dest_dir.m_channel.async_wait(
+				asio::ip::tcp::socket::wait_write,
+				with<const asio::error_code &>().make_handler(
+					[this, &src_dir, &dest_dir]( const asio::error_code & ec )
+					{
+						dest_dir.m_active_write = false;
+
+						if( ec )
+							return handle_wait_error( dest_dir, ec );
+
+						write_from_pipe( src_dir, dest_dir );
+					} )
+			);
+
+		// There should be no exceptions!
+		NOEXCEPT_CTCHECK_ENSURE_NOEXCEPT_STATEMENT(
+			dest_dir.m_active_write = true );
+	}
+
+	void
+	handle_wait_error(
+		direction_state_t & dir,
+		const asio::error_code & ec )
+	{
+		connection_remover_t remover{
+				*this,
+				( asio::error::operation_aborted == ec ||
+						!dir.m_channel.is_open() ) ?
+					remove_reason_t::current_operation_canceled :
+					remove_reason_t::io_error
+		};
+
+		log_on_io_error(
+				ec,
+				fmt::format( "waiting for {}", dir.m_name ) );
+	}
+
+	void
+	read_into_pipe(
+		// The direction from that data should be read.
+		direction_state_t & src_dir,
+		// The direction to that data should be written.
+		direction_state_t & dest_dir )
+	{
+		// A new portion is read only when the previous one is written.
+		// And the read is suspended while the bandwidth limit is exceeded.
+		if( src_dir.m_bytes_in_pipe || src_dir.m_active_read ||
+				src_dir.m_is_traffic_limit_exceeded )
+			return;
+
+		// How many bytes can be read right now?
+		const auto reserved_capacity = m_traffic_limiter->reserve_read_portion(
+				src_dir.m_traffic_direction, m_max_portion_size );
+
+		// If reserved_capacity is 0 then the bandwidth limit is exceeded.
+		// The next attempt will be made when the bucket is refilled.
+		src_dir.m_is_traffic_limit_exceeded = ( 0u == reserved_capacity.m_capacity );
+		if( src_dir.m_is_traffic_limit_exceeded )
+			return wait_for_bandwidth( [this, &src_dir, &dest_dir]() {
+					src_dir.m_is_traffic_limit_exceeded = false;
+					read_into_pipe( src_dir, dest_dir );
+				} );
+
+		const auto r = ::splice(
+				src_dir.m_channel.native_handle(), nullptr,
+				src_dir.m_pipe.write_end(), nullptr,
+				reserved_capacity.m_capacity,
+				SPLICE_F_MOVE | SPLICE_F_NONBLOCK );
+		const auto ec = ( r < 0 ? last_error() : asio::error_code{} );
+		const std::size_t bytes = ( r < 0 ? 0u : static_cast<std::size_t>(r) );
+
+		reserved_capacity.release(
+				*m_traffic_limiter,
+				src_dir.m_traffic_direction,
+				ec,
+				bytes );
+
+		if( ec )
+		{
+			if( is_would_block( ec ) )
+				// There is no data yet.
+				return wait_readable( src_dir, dest_dir );
+
+			connection_remover_t remover{
+					*this,
+					remove_reason_t::io_error
+			};
+
+			return ::arataga::logging::proxy_mode::debug(
+					[this, &src_dir, &ec]( auto level )
+					{
+						log_message_for_connection(
+								level,
+								fmt::format( "error reading data from {}: {}",
+										src_dir.m_name,
+										ec.message() ) );
+					} );
+		}
+
+		if( 0u == bytes )
+		{
+			// The src_dir is closed on remote site. There is no pending
+			// data for that direction, so there is no sense to continue.
+			connection_remover_t remover{
+					*this,
+					remove_reason_t::normal_completion
+			};
+
+			return easy_log_for_connection(
+					spdlog::level::trace,
+					format_string{ "{} closed" },
+					src_dir.m_name );
+		}
+
+		src_dir.m_bytes_in_pipe = bytes;
+
+		// There is yet anoter activity in the channels.
+		m_last_read_at = std::chrono::steady_clock::now();
+
+		write_from_pipe( src_dir, dest_dir );
+	}
+
+	void
+	write_from_pipe(
+		// The direction from that data was read.
+		direction_state_t & src_dir,
+		// The direction to that data should be written.
+		direction_state_t & dest_dir )
+	{
+		// We can't write while the first chunk is being written
+		// or while we're waiting for the writeability.
+		if( dest_dir.m_active_write )
+			return;
+
+		const auto r = ::splice(
+				src_dir.m_pipe.read_end(), nullptr,
+				dest_dir.m_channel.native_handle(), nullptr,
+				src_dir.m_bytes_in_pipe,
+				SPLICE_F_MOVE | SPLICE_F_NONBLOCK );
+		if( r < 0 )
+		{
+			const auto ec = last_error();
+			if( is_would_block( ec ) )
+				return wait_writable( dest_dir, src_dir );
+
+			connection_remover_t remover{
+					*this,
+					remove_reason_t::io_error
+			};
+
+			return log_on_io_error(
+					ec,
+					fmt::format( "writting to {}", dest_dir.m_name ) );
+		}
+
+		src_dir.m_bytes_in_pipe -= static_cast<std::size_t>(r);
+		if( src_dir.m_bytes_in_pipe )
+			// Only a part of the data was written, the rest will be
+			// written when dest_dir is ready.
+			wait_writable( dest_dir, src_dir );
+		else
+			// The pipe is empty, a new portion can be read.
+			wait_readable( src_dir, dest_dir );
+	}
+};
+
+#endif /* defined(__linux__) */
+
 } /* namespace handlers::data_transfer */
 
 //
@@ -801,6 +1447,39 @@ make_data_transfer_handler(
 {
 	using namespace handlers::data_transfer;
 
+#if defined(__linux__)
+	if( relay_mode_t::splice == ctx.ctx().config().relay_mode() )
+	{
+		// Pipes are created before the sockets are moved into a handler.
+		// If they can't be created the copy mode is used.
+		asio::error_code ec;
+		auto user_end_pipe = splice_pipe_t::try_make( ec );
+		auto target_end_pipe = user_end_pipe ?
+				splice_pipe_t::try_make( ec ) : std::nullopt;
+
+		if( user_end_pipe && target_end_pipe )
+			return std::make_shared< splice_transfer_handler_t >(
+					std::move(ctx), id,
+					std::move(in_connection),
+					std::move(first_chunk),
+					std::move(out_connection),
+					std::move(traffic_limiter),
+					std::move(*user_end_pipe),
+					std::move(*target_end_pipe) );
+
+		::arataga::logging::proxy_mode::warn(
+				[&ctx, id, &ec]( auto level )
+				{
+					ctx.ctx().log_message_for_connection(
+							id,
+							level,
+							fmt::format( "unable to create pipes for splice "
+									"relay mode, copy mode will be used: {}",
+									ec.message() ) );
+				} );
+	}
+#endif
+
 	return std::make_shared< data_transfer_handler_t >(
 			std::move(ctx), id,
 			std::move(in_connection),
@@ -104,6 +104,23 @@ class authentification_handler_t final : public basic_http_handler_t
 	//! The timepoint of the start of authentification.
 	std::chrono::steady_clock::time_point m_created_at;
 
+	//! The raw value of Proxy-Authorization header field.
+	/*!
+	 * Empty value means that there is no Proxy-Authorization.
+	 *
+	 * @since v.0.6.0
+	 */
+	std::optional< std::string > m_proxy_authorization_value;
+
+	//! The description of the current authentification.
+	/*!
+	 * It'll be stored into m_request_info in the case of successful
+	 * authentification.
+	 *
+	 * @since v.0.6.0
+	 */
+	connection_auth_cache_unique_ptr_t m_new_auth_cache;
+
 public:
 	authentification_handler_t(
 		handler_context_holder_t ctx,
@@ -199,6 +216,14 @@ protected:
 				target_host_and_port_extraction_result );
 	}
 
+	[[nodiscard]]
+	std::chrono::steady_clock::time_point
+	timeout_deadline() noexcept override
+	{
+		return m_created_at +
+				context().config().authentification_timeout();
+	}
+
 	void
 	on_timer_impl() override
 	{
@@ -234,10 +259,27 @@ private:
 	try_extract_username_and_password()
 	{
 		auto opt_proxy_auth_value = m_request_info.m_headers.opt_value_of(
-				restinio::http_field_t::proxy_authorization );
+				"Proxy-Authorization" );
 		if( !opt_proxy_auth_value )
 			return no_username_password_provided_t{};
 
+		m_proxy_authorization_value = std::string{ *opt_proxy_auth_value };
+
+		// There is no need to parse the same value again if it was
+		// already successfuly parsed for the previous request on
+		// that connection.
+		if( const auto & cache = m_request_info.m_auth_cache;
+				cache && cache->m_proxy_authorization == m_proxy_authorization_value )
+		{
+			m_request_info.m_headers.remove_all_of(
+					"Proxy-Authorization" );
+
+			return username_password_t{
+					*(cache->m_username),
+					*(cache->m_password)
+			};
+		}
+
 		using namespace restinio::http_field_parsers;
 		const auto auth_value_result = authorization_value_t::try_parse(
 				*opt_proxy_auth_value );
@@ -266,7 +308,7 @@ private:
 		// The Proxy-Authorization header field isn't needed anymore
 		// and should be removed.
 		m_request_info.m_headers.remove_all_of(
-				restinio::http_field_t::proxy_authorization );
+				"Proxy-Authorization" );
 
 		auto & basic_auth = *basic_auth_result;
 		return username_password_t{
@@ -290,7 +332,7 @@ private:
 		}
 
 		// The Host header field should be removed after the extraction.
-		m_request_info.m_headers.remove_all_of( restinio::http_field_t::host );
+		m_request_info.m_headers.remove_all_of( "Host" );
 
 		return extraction_result;
 	}
@@ -386,7 +428,7 @@ private:
 		std::size_t host_occurrences{ 0u };
 
 		m_request_info.m_headers.for_each_value_of(
-				restinio::http_field_t::host,
+				"Host",
 				[&]( std::string_view value )
 				{
 					++host_occurrences;
@@ -395,7 +437,7 @@ private:
 						opt_host = value;
 					}
 
-					return restinio::http_header_fields_t::continue_enumeration();
+					return http_header_table_t::continue_enumeration();
 				} );
 
 		if( 0u == host_occurrences )
@@ -541,6 +583,22 @@ private:
 			m_request_info.m_target_port = host_port.m_port;
 		}
 
+		if( try_reuse_previous_auth_result( username, password ) )
+			return;
+
+		// This info will be stored for the next request on that
+		// connection in the case of successful authentification.
+		m_new_auth_cache = std::make_unique< connection_auth_cache_t >(
+				connection_auth_cache_t{
+					m_proxy_authorization_value,
+					username,
+					password,
+					m_request_info.m_target_host,
+					m_request_info.m_target_port,
+					0u,
+					traffic_limiter_unique_ptr_t{}
+				} );
+
 		context().async_authentificate(
 				m_id,
 				authentification::request_params_t {
@@ -560,6 +618,69 @@ private:
 			);
 	}
 
+	/*!
+	 * @brief An attempt to use the result of the previous
+	 * authentification on that connection.
+	 *
+	 * The previous result can be reused if the user sends the same
+	 * credentials to the same target and the user-list wasn't changed
+	 * since the previous authentification.
+	 *
+	 * @retval true if the previous result is used and the handler
+	 * has been replaced.
+	 *
+	 * @since v.0.6.0
+	 */
+	[[nodiscard]]
+	bool
+	try_reuse_previous_auth_result(
+		const std::optional< std::string > & username,
+		const std::optional< std::string > & password )
+	{
+		auto & cache = m_request_info.m_auth_cache;
+		if( !cache )
+			return false;
+
+		const bool can_be_reused =
+				cache->m_traffic_limiter &&
+				cache->m_username == username &&
+				cache->m_password == password &&
+				cache->m_target_host == m_request_info.m_target_host &&
+				cache->m_target_port == m_request_info.m_target_port &&
+				context().can_reuse_auth_result(
+						cache->m_user_list_generation,
+						cache->m_target_port );
+		if( !can_be_reused )
+		{
+			// The previous result is useless now.
+			cache.reset();
+			return false;
+		}
+
+		::arataga::logging::proxy_mode::debug(
+				[this]( auto level )
+				{
+					log_message_for_connection(
+							level,
+							"the previous authentification result is reused" );
+				} );
+
+		auto traffic_limiter = std::move(cache->m_traffic_limiter);
+		replace_handler(
+				[this, &traffic_limiter]()
+				{
+					return make_dns_lookup_handler(
+							std::move(m_ctx),
+							m_id,
+							std::move(m_connection),
+							std::move(m_request_state),
+							std::move(m_request_info),
+							std::move(traffic_limiter) );
+				} );
+
+		return true;
+	}
+
 	void
 	on_authentification_result(
 		authentification::result_t & result )
@@ -567,6 +688,10 @@ private:
 		std::visit( ::arataga::utils::overloaded{
 				[&]( authentification::success_t & info )
 				{
+					m_new_auth_cache->m_user_list_generation =
+							info.m_user_list_generation;
+					m_request_info.m_auth_cache = std::move(m_new_auth_cache);
+
 					replace_handler(
 							[this, &info]()
 							{
@@ -12,6 +12,22 @@ namespace arataga::acl_handler
 namespace handlers::http
 {
 
+//
+// make_upstream_connection_key
+//
+[[nodiscard]]
+upstream_connection_pool_t::key_t
+make_upstream_connection_key(
+	const config_t & config,
+	const request_info_t & request_info )
+{
+	return {
+			config.out_addr(),
+			request_info.m_target_host,
+			request_info.m_target_port
+		};
+}
+
 //
 // basic_http_handler_t
 //
@@ -10,11 +10,13 @@
 
 #include <arataga/acl_handler/exception.hpp>
 
-#include <restinio/http_headers.hpp>
+#include <arataga/acl_handler/handlers/http/header_table.hpp>
 
 #include <nodejs/http_parser/http_parser.h>
 
 #include <memory>
+#include <optional>
+#include <string>
 #include <vector>
 
 namespace arataga::acl_handler
@@ -85,6 +87,56 @@ using http_handling_state_unique_ptr_t = std::unique_ptr<
 		http_handling_state_t
 	>;
 
+//
+// connection_auth_cache_t
+//
+/*!
+ * @brief The result of the last successful authentification on
+ * a kept-alive connection.
+ *
+ * Every request on a kept-alive connection has to be authentificated.
+ * But usually all requests from the user have the same credentials
+ * and the same target. In that case the result of the previous
+ * authentification is reused without asking an authentificator.
+ *
+ * @since v.0.6.0
+ */
+struct connection_auth_cache_t
+{
+	//! The raw value of Proxy-Authorization header field.
+	/*!
+	 * Empty value means that there was no Proxy-Authorization.
+	 */
+	std::optional< std::string > m_proxy_authorization;
+
+	//! Username and password extracted from m_proxy_authorization.
+	std::optional< std::string > m_username;
+	std::optional< std::string > m_password;
+
+	//! The target of the request.
+	std::string m_target_host;
+	std::uint16_t m_target_port{};
+
+	//! The generation of user-list used for the authentification.
+	std::uint64_t m_user_list_generation{};
+
+	//! Traffic limiter produced by the authentification.
+	/*!
+	 * It's nullptr while the request is being processed. It's returned
+	 * here when the response has been sent.
+	 */
+	traffic_limiter_unique_ptr_t m_traffic_limiter;
+};
+
+/*!
+ * @brief Alias for unique_ptr to connection_auth_cache.
+ *
+ * @since v.0.6.0
+ */
+using connection_auth_cache_unique_ptr_t = std::unique_ptr<
+		connection_auth_cache_t
+	>;
+
 /*!
  * @brief Type of object for collecting additional info about HTTP-request.
  *
@@ -105,7 +157,12 @@ struct request_info_t
 	std::string m_request_target;
 
 	//! Parsed HTTP header fields from the incoming request.
-	restinio::http_header_fields_t m_headers;
+	/*!
+	 * @note
+	 * Since v.0.6.0 the fields refer to the first chunk from
+	 * http_handling_state_t.
+	 */
+	http_header_table_t m_headers;
 
 	//! The target-host value for the request.
 	/*!
@@ -124,8 +181,31 @@ struct request_info_t
 	 * by default.
 	 */
 	bool m_keep_user_end_alive{ true };
+
+	//! The result of the previous authentification on that connection.
+	/*!
+	 * It is nullptr for the first request on the connection.
+	 *
+	 * @since v.0.6.0
+	 */
+	connection_auth_cache_unique_ptr_t m_auth_cache;
 };
 
+//
+// make_upstream_connection_key
+//
+/*!
+ * @brief Make a key for the search of an idle connection to the target
+ * host of a request.
+ *
+ * @since v.0.6.0
+ */
+[[nodiscard]]
+upstream_connection_pool_t::key_t
+make_upstream_connection_key(
+	const config_t & config,
+	const request_info_t & request_info );
+
 //
 // basic_http_handler_t
 //
@@ -117,6 +117,14 @@ protected:
 				} );
 	}
 
+	[[nodiscard]]
+	std::chrono::steady_clock::time_point
+	timeout_deadline() noexcept override
+	{
+		return m_created_at +
+				context().config().idle_connection_timeout();
+	}
+
 	void
 	on_timer_impl() override
 	{
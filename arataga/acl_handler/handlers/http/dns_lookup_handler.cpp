@@ -55,6 +55,19 @@ protected:
 	void
 	on_start_impl() override
 	{
+		// There is no need to resolve the name of the target host if
+		// a connection to it can be reused. It's possible only for
+		// ordinary methods because a connection for CONNECT is never
+		// returned to the pool.
+		if( HTTP_CONNECT != m_request_info.m_method )
+		{
+			auto out_connection = context().upstream_connection_pool()
+					.try_acquire( make_upstream_connection_key(
+							context().config(), m_request_info ) );
+			if( out_connection )
+				return reuse_out_connection( std::move(*out_connection) );
+		}
+
 		context().async_resolve_hostname(
 				m_id,
 				m_request_info.m_target_host,
@@ -67,6 +80,14 @@ protected:
 			);
 	}
 
+	[[nodiscard]]
+	std::chrono::steady_clock::time_point
+	timeout_deadline() noexcept override
+	{
+		return m_created_at +
+				context().config().dns_resolving_timeout();
+	}
+
 	void
 	on_timer_impl() override
 	{
@@ -96,6 +117,37 @@ public:
 	}
 
 private:
+	void
+	reuse_out_connection( asio::ip::tcp::socket out_connection )
+	{
+		::arataga::logging::proxy_mode::debug(
+				[this, &out_connection]( auto level )
+				{
+					asio::error_code ec;
+					log_message_for_connection(
+							level,
+							fmt::format( "reusing outgoing connection to {} "
+									"from {}",
+									fmt::streamed(
+											out_connection.remote_endpoint( ec ) ),
+									fmt::streamed(
+											out_connection.local_endpoint( ec ) ) ) );
+				} );
+
+		replace_handler(
+				[this, &out_connection]()
+				{
+					return make_ordinary_method_handler(
+							std::move(m_ctx),
+							m_id,
+							std::move(m_connection),
+							std::move(m_request_state),
+							std::move(m_request_info),
+							std::move(m_traffic_limiter),
+							std::move(out_connection) );
+				} );
+	}
+
 	void
 	on_hostname_result(
 		const dns_resolving::hostname_result_t & result )
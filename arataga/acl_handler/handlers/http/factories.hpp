@@ -12,6 +12,25 @@ namespace arataga::acl_handler
 namespace handlers::http
 {
 
+/*!
+ * @brief Factory for a handler of the next request on
+ * a kept-alive connection.
+ *
+ * Unlike make_http_handler() it allows to pass the result of
+ * the previous authentification on that connection.
+ *
+ * @since v.0.6.0
+ */
+[[nodiscard]]
+connection_handler_shptr_t
+make_http_handler_for_next_request(
+	handler_context_holder_t ctx,
+	handler_context_t::connection_id_t id,
+	asio::ip::tcp::socket connection,
+	first_chunk_for_next_handler_t first_chunk_data,
+	std::chrono::steady_clock::time_point created_at,
+	connection_auth_cache_unique_ptr_t auth_cache );
+
 [[nodiscard]]
 connection_handler_shptr_t
 make_negative_response_sender(
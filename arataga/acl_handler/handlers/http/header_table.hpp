@@ -0,0 +1,459 @@
+/*!
+ * @file
+ * @brief Storage for HTTP header fields of an incoming request.
+ * @since v.0.6.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace arataga::acl_handler
+{
+
+namespace handlers::http
+{
+
+//
+// http_header_table_t
+//
+/*!
+ * @brief Table of HTTP header fields that refers to the incoming buffer.
+ *
+ * Names and values of header fields are not copied. They are stored as
+ * (offset, length) slices into the buffer with the incoming data (it's
+ * the first chunk of a connection). Only the rare fields that span
+ * several reads are copied into a small arena: the buffer is reused
+ * for every read, so the parts of such a field have to be saved before
+ * the next read. See spill_to_arena().
+ *
+ * Removed fields are only marked as removed and are skipped by all
+ * enumeration methods.
+ *
+ * The values of fields that are adjacent in the incoming buffer are
+ * sent to the target host as one piece of the original data.
+ * See for_each_outgoing_piece().
+ *
+ * @attention
+ * The table doesn't own the incoming buffer. The buffer has to outlive
+ * the table and all pieces returned by the table.
+ *
+ * @since v.0.6.0
+ */
+class http_header_table_t
+{
+public:
+	//! What to do after the call of a callback in for_each_value_of().
+	enum class enumeration_result_t
+	{
+		continue_enumeration,
+		stop_enumeration
+	};
+
+	[[nodiscard]]
+	static constexpr enumeration_result_t
+	continue_enumeration() noexcept
+	{
+		return enumeration_result_t::continue_enumeration;
+	}
+
+	[[nodiscard]]
+	static constexpr enumeration_result_t
+	stop_enumeration() noexcept
+	{
+		return enumeration_result_t::stop_enumeration;
+	}
+
+private:
+	//! Location of a name or a value.
+	struct slice_t
+	{
+		std::size_t m_offset{ 0u };
+		std::size_t m_length{ 0u };
+		//! Is the data in m_arena or in the incoming buffer?
+		bool m_in_arena{ false };
+	};
+
+	//! Description of a single header field.
+	struct field_t
+	{
+		slice_t m_name;
+		slice_t m_value;
+		bool m_removed{ false };
+	};
+
+	//! The buffer with incoming data.
+	const char * m_buffer{ nullptr };
+	//! The capacity of the incoming buffer.
+	std::size_t m_buffer_capacity{ 0u };
+
+	//! Storage for fields that don't fit into the incoming buffer.
+	std::string m_arena;
+
+	//! Completed header fields in the order of appearance.
+	std::vector< field_t > m_fields;
+
+	//! The field that is being parsed now.
+	field_t m_current;
+	//! Is there a field that is being parsed now?
+	bool m_has_current{ false };
+
+	[[nodiscard]]
+	static bool
+	is_equal_caseless( std::string_view a, std::string_view b ) noexcept
+	{
+		if( a.size() != b.size() )
+			return false;
+
+		const auto to_lower = []( char ch ) noexcept -> char {
+				return ( ch >= 'A' && ch <= 'Z' ) ? static_cast<char>(ch + 32) : ch;
+			};
+
+		for( std::size_t i = 0u; i != a.size(); ++i )
+			if( to_lower( a[ i ] ) != to_lower( b[ i ] ) )
+				return false;
+
+		return true;
+	}
+
+	[[nodiscard]]
+	bool
+	is_in_buffer( std::string_view data ) const noexcept
+	{
+		const std::less< const char * > less;
+		return m_buffer
+				&& !less( data.data(), m_buffer )
+				&& !less( m_buffer + m_buffer_capacity, data.data() + data.size() );
+	}
+
+	[[nodiscard]]
+	std::string_view
+	view( const slice_t & slice ) const noexcept
+	{
+		const char * base = slice.m_in_arena ? m_arena.data() : m_buffer;
+		return { base + slice.m_offset, slice.m_length };
+	}
+
+	//! Copy the slice to the end of the arena if it isn't there yet.
+	void
+	move_to_arena_end( slice_t & slice )
+	{
+		if( slice.m_in_arena &&
+				slice.m_offset + slice.m_length == m_arena.size() )
+			return;
+
+		const auto new_offset = m_arena.size();
+		// The reservation guarantees that data in the arena isn't
+		// reallocated during the append.
+		m_arena.reserve( new_offset + slice.m_length );
+		const auto data = view( slice );
+		m_arena.append( data.data(), data.size() );
+
+		slice = slice_t{ new_offset, slice.m_length, true };
+	}
+
+	//! Move the slice from the incoming buffer to the arena.
+	void
+	spill_slice( slice_t & slice )
+	{
+		if( !slice.m_in_arena && 0u != slice.m_length )
+			move_to_arena_end( slice );
+	}
+
+	void
+	append_to( slice_t & slice, std::string_view data )
+	{
+		if( data.empty() )
+			return;
+
+		if( 0u == slice.m_length )
+		{
+			if( is_in_buffer( data ) )
+				slice = slice_t{
+						static_cast<std::size_t>( data.data() - m_buffer ),
+						data.size(),
+						false
+					};
+			else
+			{
+				slice = slice_t{ m_arena.size(), data.size(), true };
+				m_arena.append( data.data(), data.size() );
+			}
+		}
+		else if( !slice.m_in_arena && is_in_buffer( data ) &&
+				m_buffer + slice.m_offset + slice.m_length == data.data() )
+		{
+			// The continuation of data in the incoming buffer.
+			slice.m_length += data.size();
+		}
+		else
+		{
+			// The parts of the value aren't adjacent, they have to be
+			// glued together in the arena.
+			move_to_arena_end( slice );
+			m_arena.append( data.data(), data.size() );
+			slice.m_length += data.size();
+		}
+	}
+
+	//! Can the field be sent as a part of the original data?
+	[[nodiscard]]
+	static bool
+	is_in_buffer( const field_t & field ) noexcept
+	{
+		return !field.m_name.m_in_arena && 0u != field.m_name.m_length
+				&& !field.m_value.m_in_arena && 0u != field.m_value.m_length;
+	}
+
+public:
+	http_header_table_t() = default;
+
+	//! Set the buffer with incoming data.
+	/*!
+	 * @note
+	 * It also makes the reservation for a typical number of fields.
+	 */
+	void
+	attach_to_buffer(
+		const std::byte * buffer,
+		std::size_t capacity )
+	{
+		m_buffer = reinterpret_cast<const char *>(buffer);
+		m_buffer_capacity = capacity;
+
+		m_fields.reserve( 24u );
+	}
+
+	//! Add a part of the name of the current field.
+	/*!
+	 * Starts a new field if there is no current one.
+	 */
+	void
+	append_name( std::string_view data )
+	{
+		if( !m_has_current )
+		{
+			m_current = field_t{};
+			m_has_current = true;
+		}
+
+		append_to( m_current.m_name, data );
+	}
+
+	//! Add a part of the value of the current field.
+	void
+	append_value( std::string_view data )
+	{
+		if( !m_has_current )
+		{
+			m_current = field_t{};
+			m_has_current = true;
+		}
+
+		append_to( m_current.m_value, data );
+	}
+
+	//! The size of the name of the current field.
+	[[nodiscard]]
+	std::size_t
+	current_name_size() const noexcept
+	{
+		return m_has_current ? m_current.m_name.m_length : 0u;
+	}
+
+	//! The size of the value of the current field.
+	[[nodiscard]]
+	std::size_t
+	current_value_size() const noexcept
+	{
+		return m_has_current ? m_current.m_value.m_length : 0u;
+	}
+
+	//! Add the current field to the table.
+	void
+	complete_field()
+	{
+		if( m_has_current )
+		{
+			m_fields.push_back( m_current );
+			m_has_current = false;
+		}
+	}
+
+	//! Save all fields from the incoming buffer into the arena.
+	/*!
+	 * Has to be called before the incoming buffer is reused for
+	 * a new read.
+	 *
+	 * The current field is saved the last, so its continuation from
+	 * the next read will be appended to it without additional copies.
+	 */
+	void
+	spill_to_arena()
+	{
+		for( auto & f : m_fields )
+		{
+			spill_slice( f.m_name );
+			spill_slice( f.m_value );
+		}
+
+		if( m_has_current )
+		{
+			spill_slice( m_current.m_name );
+			spill_slice( m_current.m_value );
+		}
+	}
+
+	//! The number of fields that are not removed.
+	[[nodiscard]]
+	std::size_t
+	fields_count() const noexcept
+	{
+		std::size_t result{ 0u };
+		for( const auto & f : m_fields )
+			if( !f.m_removed )
+				++result;
+
+		return result;
+	}
+
+	//! Get the value of the first field with the specified name.
+	[[nodiscard]]
+	std::optional< std::string_view >
+	opt_value_of( std::string_view name ) const noexcept
+	{
+		for( const auto & f : m_fields )
+			if( !f.m_removed && is_equal_caseless( name, view( f.m_name ) ) )
+				return view( f.m_value );
+
+		return std::nullopt;
+	}
+
+	//! Enumerate values of all fields with the specified name.
+	/*!
+	 * The callback should have the format:
+	 * @code
+	 * enumeration_result_t(std::string_view value);
+	 * @endcode
+	 */
+	template< typename Handler >
+	void
+	for_each_value_of( std::string_view name, Handler && handler ) const
+	{
+		for( const auto & f : m_fields )
+			if( !f.m_removed && is_equal_caseless( name, view( f.m_name ) ) )
+			{
+				if( stop_enumeration() == handler( view( f.m_value ) ) )
+					break;
+			}
+	}
+
+	//! Enumerate all fields those are not removed.
+	/*!
+	 * The callback should have the format:
+	 * @code
+	 * void(std::string_view name, std::string_view value);
+	 * @endcode
+	 */
+	template< typename Handler >
+	void
+	for_each_field( Handler && handler ) const
+	{
+		for( const auto & f : m_fields )
+			if( !f.m_removed )
+				handler( view( f.m_name ), view( f.m_value ) );
+	}
+
+	//! Mark all fields with the specified name as removed.
+	void
+	remove_all_of( std::string_view name ) noexcept
+	{
+		for( auto & f : m_fields )
+			if( is_equal_caseless( name, view( f.m_name ) ) )
+				f.m_removed = true;
+	}
+
+	//! Enumerate pieces of data those form fields that are not removed.
+	/*!
+	 * The concatenation of all pieces is the header of a request
+	 * in the form "Name: Value\r\n" for every field (the empty line at
+	 * the end of the header isn't included).
+	 *
+	 * Adjacent fields those are in the incoming buffer are represented
+	 * by one piece that refers to the original data. Other fields
+	 * are represented by several pieces each.
+	 *
+	 * The callback should have the format:
+	 * @code
+	 * void(std::string_view piece);
+	 * @endcode
+	 *
+	 * @note
+	 * Pieces refer to the incoming buffer and to the table itself.
+	 */
+	template< typename Consumer >
+	void
+	for_each_outgoing_piece( Consumer && consumer ) const
+	{
+		using namespace std::string_view_literals;
+
+		// The range of adjacent fields in the incoming buffer.
+		const char * run_begin = nullptr;
+		const char * run_end = nullptr;
+
+		const auto flush_run = [&]() {
+			if( !run_begin )
+				return;
+
+			// Try to take CRLF after the last value from the original data.
+			if( run_end + 2 <= m_buffer + m_buffer_capacity
+					&& '\r' == run_end[ 0 ] && '\n' == run_end[ 1 ] )
+			{
+				consumer( std::string_view{
+						run_begin,
+						static_cast<std::size_t>( run_end - run_begin ) + 2u } );
+			}
+			else
+			{
+				consumer( std::string_view{
+						run_begin,
+						static_cast<std::size_t>( run_end - run_begin ) } );
+				consumer( "\r\n"sv );
+			}
+
+			run_begin = nullptr;
+		};
+
+		for( const auto & f : m_fields )
+		{
+			if( f.m_removed )
+				flush_run();
+			else if( is_in_buffer( f ) )
+			{
+				if( !run_begin )
+					run_begin = m_buffer + f.m_name.m_offset;
+				run_end = m_buffer + f.m_value.m_offset + f.m_value.m_length;
+			}
+			else
+			{
+				flush_run();
+
+				consumer( view( f.m_name ) );
+				consumer( ": "sv );
+				consumer( view( f.m_value ) );
+				consumer( "\r\n"sv );
+			}
+		}
+
+		flush_run();
+	}
+};
+
+} /* namespace handlers::http */
+
+} /* namespace arataga::acl_handler */
@@ -90,10 +90,6 @@ class initial_http_handler_t final : public basic_http_handler_t
 	//! The timepoint when the connection was accepted.
 	std::chrono::steady_clock::time_point m_created_at;
 
-	//! Object for collecting a name of the current HTTP header field.
-	std::string m_current_http_field_name;
-	//! Object for collecting a value of the current HTTP header field.
-	std::string m_current_http_field_value;
 	//! The flag that tells that the value of the current HTTP header field
 	//! has been extracted.
 	bool m_on_header_value_called{ false };
@@ -116,7 +112,8 @@ public:
 		handler_context_t::connection_id_t id,
 		asio::ip::tcp::socket connection,
 		first_chunk_for_next_handler_t first_chunk_data,
-		std::chrono::steady_clock::time_point created_at )
+		std::chrono::steady_clock::time_point created_at,
+		connection_auth_cache_unique_ptr_t auth_cache )
 		:	basic_http_handler_t{ std::move(ctx), id, std::move(connection) }
 		,	m_request_state{
 				std::make_unique< http_handling_state_t >(
@@ -124,6 +121,13 @@ public:
 			}
 		,	m_created_at{ created_at }
 	{
+		m_request_info.m_auth_cache = std::move(auth_cache);
+
+		// Header fields will refer to the incoming buffer.
+		m_request_info.m_headers.attach_to_buffer(
+				m_request_state->m_first_chunk.buffer(),
+				m_request_state->m_first_chunk.capacity() );
+
 		m_request_state->m_parser.data = this;
 
 		// Settings for HTTP-parser should also be initialized here.
@@ -138,6 +142,14 @@ protected:
 		try_handle_data_read();
 	}
 
+	[[nodiscard]]
+	std::chrono::steady_clock::time_point
+	timeout_deadline() noexcept override
+	{
+		return m_created_at +
+				context().config().http_headers_complete_timeout();
+	}
+
 	void
 	on_timer_impl() override
 	{
@@ -204,8 +216,8 @@ private:
 		{
 			// This is the start of a new header field.
 			m_total_headers_size +=
-					m_current_http_field_name.size() +
-					m_current_http_field_value.size();
+					m_request_info.m_headers.current_name_size() +
+					m_request_info.m_headers.current_value_size();
 
 			if( const auto lim =
 					context().config().http_message_limits().m_max_total_headers_size;
@@ -227,9 +239,7 @@ private:
 				return -1;
 			}
 
-			m_request_info.m_headers.add_field(
-					std::move(m_current_http_field_name),
-					std::move(m_current_http_field_value) );
+			m_request_info.m_headers.complete_field();
 
 			m_on_header_value_called = false;
 		}
@@ -327,10 +337,10 @@ private:
 			return rc;
 		}
 
-		m_current_http_field_name.append( data, length );
+		m_request_info.m_headers.append_name( std::string_view{ data, length } );
 		if( const auto lim =
 				context().config().http_message_limits().m_max_field_name_length;
-				lim < m_current_http_field_name.size() )
+				lim < m_request_info.m_headers.current_name_size() )
 		{
 			::arataga::logging::proxy_mode::err(
 					[this, &lim]( auto level )
@@ -340,7 +350,7 @@ private:
 								fmt::format(
 										"http-field name exceeds limit: "
 										"size={}, limit={}",
-										m_current_http_field_name.size(),
+										m_request_info.m_headers.current_name_size(),
 										lim )
 							);
 					} );
@@ -354,11 +364,11 @@ private:
 	int
 	on_header_value( const char * data, std::size_t length )
 	{
-		m_current_http_field_value.append( data, length );
+		m_request_info.m_headers.append_value( std::string_view{ data, length } );
 		m_on_header_value_called = true;
 		if( const auto lim =
 				context().config().http_message_limits().m_max_field_value_length;
-				lim < m_current_http_field_value.size() )
+				lim < m_request_info.m_headers.current_value_size() )
 		{
 			::arataga::logging::proxy_mode::err(
 					[this, &lim]( auto level )
@@ -368,7 +378,7 @@ private:
 								fmt::format(
 										"http-field value exceeds limit: "
 										"size={}, limit={}",
-										m_current_http_field_value.size(),
+										m_request_info.m_headers.current_value_size(),
 										lim )
 							);
 					} );
@@ -648,6 +658,9 @@ private:
 		}
 
 		// All that we can do is to initiate next read.
+		// The buffer will be overwritten, so header fields collected
+		// so far have to be saved.
+		m_request_info.m_headers.spill_to_arena();
 		m_request_state->m_incoming_data_size = 0u;
 		// Use async_read_some to handle EOF by ourselves.
 		auto buffer = asio::buffer(
@@ -683,7 +696,7 @@ private:
 						std::move( r->values.begin(), r->values.end(),
 								std::back_inserter( aggregated.values ) );
 
-						return restinio::http_header_fields_t::continue_enumeration();
+						return http_header_table_t::continue_enumeration();
 					}
 					else
 					{
@@ -707,7 +720,7 @@ private:
 							};
 
 						// There is no sense to continue.
-						return restinio::http_header_fields_t::stop_enumeration();
+						return http_header_table_t::stop_enumeration();
 					}
 				} );
 
@@ -818,6 +831,10 @@ private:
 		std::visit(
 			::arataga::utils::overloaded{
 				[&]( const valid_state_t & ) {
+					context().stats_record_setup_stage(
+							setup_stage_t::handshake,
+							m_created_at );
+
 					// Everything is fine, can delegate processing to the next
 					// connection-handler.
 					replace_handler(
@@ -908,6 +925,28 @@ private:
 	}
 };
 
+//
+// make_http_handler_for_next_request
+//
+[[nodiscard]]
+connection_handler_shptr_t
+make_http_handler_for_next_request(
+	handler_context_holder_t ctx,
+	handler_context_t::connection_id_t id,
+	asio::ip::tcp::socket connection,
+	first_chunk_for_next_handler_t first_chunk_data,
+	std::chrono::steady_clock::time_point created_at,
+	connection_auth_cache_unique_ptr_t auth_cache )
+{
+	return std::make_shared< initial_http_handler_t >(
+			std::move(ctx),
+			id,
+			std::move(connection),
+			std::move(first_chunk_data),
+			created_at,
+			std::move(auth_cache) );
+}
+
 } /* namespace arataga::acl_handler */
 
 [[nodiscard]]
@@ -924,7 +963,8 @@ make_http_handler(
 			id,
 			std::move(connection),
 			std::move(first_chunk_data),
-			created_at );
+			created_at,
+			handlers::http::connection_auth_cache_unique_ptr_t{} );
 }
 
 } /* namespace handlers::http */
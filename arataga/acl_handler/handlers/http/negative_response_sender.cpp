@@ -60,6 +60,14 @@ protected:
 				} );
 	}
 
+	[[nodiscard]]
+	std::chrono::steady_clock::time_point
+	timeout_deadline() noexcept override
+	{
+		return m_created_at +
+				context().config().http_negative_response_timeout();
+	}
+
 	void
 	on_timer_impl() override
 	{
@@ -14,11 +14,13 @@
 #include <arataga/utils/subview_of.hpp>
 
 #include <restinio/helpers/http_field_parsers/connection.hpp>
+#include <restinio/http_headers.hpp>
 
 #include <noexcept_ctcheck/pub.hpp>
 
 #include <list>
 #include <iterator>
+#include <limits>
 
 namespace arataga::acl_handler
 {
@@ -217,6 +219,39 @@ class ordinary_method_handler_t final : public handler_with_out_connection_t
 	//! Brief description of HTTP-request that is beging processed.
 	const brief_request_info_t m_brief_request_info;
 
+	//! Key for returning the connection to the target host to the pool.
+	/*!
+	 * @since v.0.6.0
+	 */
+	const upstream_connection_pool_t::key_t m_upstream_connection_key;
+
+	//! Flag that tells that the target host allows to reuse the connection.
+	/*!
+	 * It's set when the response is completely parsed.
+	 *
+	 * @since v.0.6.0
+	 */
+	bool m_target_end_reusable{ false };
+
+	//! The result of authentification for the next request
+	//! on the user's connection.
+	/*!
+	 * It can be nullptr.
+	 *
+	 * @since v.0.6.0
+	 */
+	connection_auth_cache_unique_ptr_t m_auth_cache;
+
+	//! Header fields of the request to be sent to the target host.
+	/*!
+	 * Pieces of the outgoing request refer to that object and to
+	 * the first chunk of m_user_end. So it has to be kept until
+	 * the request is written.
+	 *
+	 * @since v.0.6.0
+	 */
+	http_header_table_t m_request_headers;
+
 public:
 	ordinary_method_handler_t(
 		handler_context_holder_t ctx,
@@ -244,7 +279,10 @@ public:
 		,	m_target_end{
 				std::make_unique< http_handling_state_t >(
 						make_first_chunk_for_next_handler(
-								first_chunk_t{ context().config().io_chunk_size() },
+								first_chunk_t{
+										context().io_chunk_pool().acquire(
+												context().config().io_chunk_size() )
+								},
 								0u,
 								0u ) ),
 				m_out_connection,
@@ -254,6 +292,11 @@ public:
 						target_end_default_write_completed_handler
 			}
 		,	m_brief_request_info{ make_brief_request_info( request_info ) }
+		,	m_upstream_connection_key{
+				make_upstream_connection_key( context().config(), request_info )
+			}
+		,	m_auth_cache{ std::move(request_info.m_auth_cache) }
+		,	m_request_headers{ std::move(request_info.m_headers) }
 	{
 		tune_http_settings();
 
@@ -316,6 +359,14 @@ protected:
 		initiate_async_read_for_direction( m_target_end );
 	}
 
+	[[nodiscard]]
+	std::chrono::steady_clock::time_point
+	timeout_deadline() noexcept override
+	{
+		return m_last_read_at +
+				context().config().idle_connection_timeout();
+	}
+
 	void
 	on_timer_impl() override
 	{
@@ -349,19 +400,8 @@ protected:
 					"no data read for long time"_static_str );
 		}
 
-		// If bandwidth limit was exceeded we should recheck it again.
-		// A special case related to HTTP: the limit is checked for
-		// write operations, not for read ones.
-		if( m_user_end.m_is_traffic_limit_exceeded )
-		{
-			initiate_write_outgoing_data_or_read_next_incoming_portion(
-					m_user_end, m_target_end );
-		}
-		if( m_target_end.m_is_traffic_limit_exceeded )
-		{
-			initiate_write_outgoing_data_or_read_next_incoming_portion(
-					m_target_end, m_user_end );
-		}
+		// NOTE: since v.0.6.0 writes suspended because of the bandwidth
+		// limit are resumed by pacing_wheel, not here.
 	}
 
 public:
@@ -505,7 +545,8 @@ private:
 	make_user_end_outgoing_data(
 		const request_info_t & request_info )
 	{
-		// Collect the pieces of outgoing data into one buffer.
+		// The start-line and the Host header field are collected
+		// into one buffer.
 		fmt::memory_buffer out_data;
 
 		// The start-line is going first.
@@ -522,31 +563,31 @@ private:
 				"Host: {}\r\n",
 				m_brief_request_info.m_host_field_value );
 
+		m_user_end.m_pieces_read.push_back( std::move(out_data) );
+
 		// Form the list of header fields that should go to the target host.
-		fill_headers_for_outgoing_request( request_info, out_data );
+		add_headers_for_outgoing_request();
 
 		// This the end of the header.
-		fmt::format_to( std::back_inserter(out_data), "\r\n" );
-
-		m_user_end.m_pieces_read.push_back( std::move(out_data) );
+		m_user_end.m_pieces_read.push_back( ("\r\n"_static_str).as_view() );
 
 		try_complete_parsing_of_initial_user_end_data();
 	}
 
-	static void
-	fill_headers_for_outgoing_request(
-		const request_info_t & request_info,
-		// Outgoing data should be written here.
-		fmt::memory_buffer & out_data )
+	void
+	add_headers_for_outgoing_request()
 	{
 		// Assume that all unnecessary fields were deleted earliers.
-		// So just copy remaining fields as is.
-		request_info.m_headers.for_each_field(
-			[&]( const auto & field )
+		// So just send remaining fields as is.
+		//
+		// NOTE: since v.0.6.0 fields aren't copied. Pieces refer
+		// to the incoming data. It's safe because the first chunk of
+		// m_user_end isn't used for reading until the write completes.
+		m_request_headers.for_each_outgoing_piece(
+			[this]( std::string_view piece )
 			{
-				fmt::format_to(
-						std::back_inserter(out_data),
-						"{}: {}\r\n", field.name(), field.value() );
+				if( !piece.empty() )
+					m_user_end.m_pieces_read.push_back( piece );
 			} );
 	}
 
@@ -624,6 +665,10 @@ private:
 	void
 	target_end_normal_finilization_write_completed_handler()
 	{
+		// The connection to the target host can be used for
+		// subsequent requests regardless of the user's connection.
+		try_return_out_connection_to_pool();
+
 		// If there is no need to keep the connection then we can
 		// simply delete the handler.
 		// But in the opposite case we have to create a new
@@ -640,12 +685,19 @@ private:
 			replace_handler(
 					[this, fcd = std::move(first_chunk_data)]() mutable
 					{
-						return make_http_handler(
+						// The traffic limiter will be reused by the next request
+						// if the user doesn't change the credentials and the target.
+						if( m_auth_cache )
+							m_auth_cache->m_traffic_limiter =
+									std::move(m_traffic_limiter);
+
+						return make_http_handler_for_next_request(
 								std::move(m_ctx),
 								m_id,
 								std::move(m_connection),
 								std::move(fcd),
-								std::chrono::steady_clock::now() );
+								std::chrono::steady_clock::now(),
+								std::move(m_auth_cache) );
 					} );
 		}
 		else
@@ -658,6 +710,35 @@ private:
 	}
 
 
+	/*!
+	 * Returns the connection to the target host to the pool if
+	 * the connection can be reused.
+	 *
+	 * @since v.0.6.0
+	 */
+	void
+	try_return_out_connection_to_pool()
+	{
+		const auto & target_state = *(m_target_end.m_http_state);
+
+		// The whole request has to be written to the target host and
+		// nothing should be received after the response.
+		const bool reusable = m_target_end_reusable
+				&& m_target_end.m_is_alive
+				&& incoming_http_message_stage_t::message_completed ==
+						m_user_end.m_incoming_message_stage
+				&& m_user_end.m_pieces_read.empty()
+				&& target_state.m_next_execute_position ==
+						target_state.m_incoming_data_size;
+
+		if( reusable )
+			context().upstream_connection_pool().release(
+					m_upstream_connection_key,
+					std::move(m_out_connection),
+					context().config().http_upstream_pool_size(),
+					context().config().http_upstream_idle_timeout() );
+	}
+
 	// The handler for the completion of write of data read from the
 	// target_end that is used in the case of forced deletion of
 	// the current connection-handler.
@@ -1097,6 +1178,16 @@ private:
 		// Don't pause the parsing because don't expect additional
 		// data from the target_end.
 
+		// Since v.0.6.0 the connection to the target host can be reused
+		// if the target host doesn't want to close it. A response to HEAD
+		// and interim responses are ignored because the length of them
+		// can't be detected the usual way.
+		const auto & parser = m_target_end.m_http_state->m_parser;
+		m_target_end_reusable = 0 != http_should_keep_alive( &parser )
+				&& 0u == parser.upgrade
+				&& 200u <= parser.status_code
+				&& HTTP_HEAD != m_brief_request_info.m_method;
+
 		return 0;
 	}
 
@@ -1338,44 +1429,58 @@ private:
 					"empty src_dir.m_pieces_read"
 			};
 
-		auto & piece_to_send = src_dir.m_pieces_read.front();
+		// All pending pieces are written by one operation.
+		// NOTE: since v.0.6.0 pieces aren't written one by one.
+		auto buffers_to_write = gather_out_buffers(
+				src_dir.m_pieces_read,
+				std::numeric_limits< std::size_t >::max() );
 
 		// How many data we can send without exceeding the bandwidth limit.
 		const auto reserved_capacity = m_traffic_limiter->reserve_read_portion(
 				src_dir.m_traffic_direction,
-				piece_to_send.remaining() );
+				buffers_to_write.total_size() );
 
 		// If nothing to send then the bandwidth limit is exceeded.
 		src_dir.m_is_traffic_limit_exceeded =
 				( 0u == reserved_capacity.m_capacity );
 
 		if( src_dir.m_is_traffic_limit_exceeded )
-			// Have to wait for the next turn.
-			return;
+			// Have to wait for the refill of the bucket.
+			// A special case related to HTTP: the limit is checked for
+			// write operations, not for read ones.
+			return wait_for_bandwidth( [this, &src_dir, &dest_dir]() {
+					// The flag can be already reset if the write was
+					// initiated by someone else.
+					if( src_dir.m_is_traffic_limit_exceeded )
+						initiate_write_outgoing_data_or_read_next_incoming_portion(
+								src_dir, dest_dir );
+				} );
 
-		asio::const_buffer data_to_write{
-				piece_to_send.asio_buffer().data(),
-				reserved_capacity.m_capacity
-		};
+		// The quota can be less than the size of pending data.
+		if( reserved_capacity.m_capacity < buffers_to_write.total_size() )
+			buffers_to_write = gather_out_buffers(
+					src_dir.m_pieces_read,
+					reserved_capacity.m_capacity );
 
 		// Have to count the number of bytes sent.
 		// This info will be used later to detect was something sent
 		// to dest_dir or not.
-		dest_dir.m_bytes_from_opposite_dir += data_to_write.size();
+		dest_dir.m_bytes_from_opposite_dir += buffers_to_write.total_size();
 
 // Kept here for debugging purposes.
 #if 0
-		std::cout << "*** ougoing data: '"
-				<< std::string_view{
-							reinterpret_cast<const char *>(data_to_write.data()),
-							data_to_write.size()
-						}
-				<< std::endl;
+		std::cout << "*** ougoing data: '";
+		for( const auto & b : buffers_to_write )
+			std::cout << std::string_view{
+							reinterpret_cast<const char *>(b.data()),
+							b.size()
+						};
+		std::cout << "'" << std::endl;
 #endif
 
 		asio::async_write(
 				dest_dir.m_channel,
-				data_to_write,
+				buffers_to_write,
 				with<const asio::error_code &, std::size_t>().make_handler(
 					[this, &src_dir, &dest_dir, reserved_capacity](
 						const asio::error_code & ec, std::size_t bytes )
@@ -1555,17 +1660,15 @@ private:
 		{
 			if( src_dir.m_pieces_read.empty() )
 				// Don't expect this, because it is the result of
-				// writing the first item from src_dir.m_pieces_read.
+				// writing items from src_dir.m_pieces_read.
 				throw acl_handler_ex_t{
 					fmt::format( "on_write_result is called for "
 							"empty {}.m_pieces_read",
 							src_dir.m_name )
 				};
 
-			auto & piece_to_send = src_dir.m_pieces_read.front();
-			piece_to_send.increment_bytes_written( bytes_transferred );
-			if( !piece_to_send.remaining() )
-				src_dir.m_pieces_read.pop_front();
+			// Several pieces can be written by one operation.
+			consume_written_bytes( src_dir.m_pieces_read, bytes_transferred );
 
 			// If there is some remaining data it has to be written.
 			if( !src_dir.m_pieces_read.empty() )
@@ -63,6 +63,14 @@ protected:
 		initiate_connect();
 	}
 
+	[[nodiscard]]
+	std::chrono::steady_clock::time_point
+	timeout_deadline() noexcept override
+	{
+		return m_created_at +
+				context().config().connect_target_timeout();
+	}
+
 	void
 	on_timer_impl() override
 	{
@@ -221,6 +229,10 @@ private:
 												m_out_connection.local_endpoint()) ) );
 					} );
 
+			context().stats_record_setup_stage(
+					setup_stage_t::connect_target,
+					m_created_at );
+
 			// New connection-handler depends on HTTP-method from the request.
 			// At the moment only CONNECT method requires a special handler.
 			const auto factory = (HTTP_CONNECT == m_request_info.m_method ?
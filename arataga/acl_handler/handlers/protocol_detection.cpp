@@ -4,11 +4,12 @@
  */
 
 #include <arataga/acl_handler/connection_handler_ifaces.hpp>
-#include <arataga/acl_handler/buffers.hpp>
 #include <arataga/acl_handler/handler_factories.hpp>
 
 #include <arataga/utils/overloaded.hpp>
 
+#include <array>
+
 namespace arataga::acl_handler
 {
 
@@ -20,10 +21,8 @@ class handler_t : public connection_handler_t
 	//! A time when the connection was accepted.
 	std::chrono::steady_clock::time_point m_created_at;
 
-	//! The first chunk for the connection.
-	first_chunk_t m_first_chunk;
-	//! In-buffer for parsing incoming data.
-	in_external_buffer_t m_in_buffer;
+	//! Number of bytes required for the detection of the protocol.
+	static constexpr std::size_t detection_bytes = 1u;
 
 public :
 	handler_t(
@@ -32,12 +31,6 @@ public :
 		asio::ip::tcp::socket connection )
 		:	connection_handler_t{ std::move(ctx), id, std::move(connection) }
 		,	m_created_at{ std::chrono::steady_clock::now() }
-		,	m_first_chunk{ context().config().io_chunk_size() }
-		,	m_in_buffer{
-				m_first_chunk.buffer(),
-				// There is no incoming data at the moment.
-				m_first_chunk.capacity()
-			}
 	{}
 
 protected:
@@ -47,14 +40,20 @@ protected:
 		// A new connection has to be reflected in the stats.
 		context().stats_inc_connection_count( connection_type_t::generic );
 
-		// The first part of data has to be read and analyzed.
-		read_some(
-				m_connection,
-				m_in_buffer,
-				[this]()
-				{
-					analyze_data_read();
-				} );
+		// Incoming data is peeked by a synchronous call after the readiness
+		// of the socket. That call mustn't block the IO-thread.
+		if( !m_connection.non_blocking() )
+			m_connection.non_blocking( true );
+
+		wait_for_incoming_data();
+	}
+
+	[[nodiscard]]
+	std::chrono::steady_clock::time_point
+	timeout_deadline() noexcept override
+	{
+		return m_created_at +
+				context().config().protocol_detection_timeout();
 	}
 
 	void
@@ -89,59 +88,101 @@ private:
 		std::byte m_first_byte;
 	};
 
-	struct connection_accepted_t
-	{
-		connection_type_t m_connection_type;
-		connection_handler_shptr_t m_handler;
-	};
-
-	// Type to be used as the result on try_accept_*_connection methods.
 	using detection_result_t = std::variant<
 			unknown_protocol_t,
-			connection_accepted_t
+			connection_type_t
 		>;
 
+	/*!
+	 * @note
+	 * Since v.0.6.0 the first chunk isn't allocated until the arrival
+	 * of the first data. Clients that connect and send nothing don't
+	 * hold a buffer until protocol_detection_timeout.
+	 */
+	void
+	wait_for_incoming_data()
+	{
+		m_connection.async_wait(
+				asio::ip::tcp::socket::wait_read,
+				with<const asio::error_code &>().make_handler(
+					[this]( const asio::error_code & ec )
+					{
+						on_read_readiness( ec );
+					} )
+			);
+	}
+
+	void
+	on_read_readiness( const asio::error_code & wait_ec )
+	{
+		using namespace arataga::utils::string_literals;
+
+		if( wait_ec )
+			return remove_on_io_error( wait_ec, "wait_read"_static_str );
+
+		// Only the bytes necessary for the detection are looked at.
+		// They are left in the socket and will be read into the first
+		// chunk if the protocol is supported.
+		std::array< std::byte, detection_bytes > peeked;
+		asio::error_code ec;
+		m_connection.receive(
+				asio::buffer( peeked ),
+				asio::socket_base::message_peek,
+				ec );
+
+		if( asio::error::would_block == ec || asio::error::try_again == ec )
+			// It was a spurious wake-up.
+			return wait_for_incoming_data();
+
+		if( ec )
+			return remove_on_io_error( ec, "peek"_static_str );
+
+		analyze_first_byte( peeked[ 0 ] );
+	}
+
 	void
-	analyze_data_read()
+	remove_on_io_error(
+		const asio::error_code & ec,
+		arataga::utils::string_literal_t op_name )
 	{
-		detection_result_t detection_result{ unknown_protocol_t{} };
+		connection_remover_t remover{
+				*this,
+				remove_reason_t::io_error
+		};
+
+		log_on_io_error( ec, op_name );
+	}
 
-		// Run only those try_accept_*_connection that enabled for the ACL.
+	void
+	analyze_first_byte( std::byte first_byte )
+	{
+		detection_result_t detection_result{ unknown_protocol_t{ first_byte } };
+
+		// Run only those try_detect_* that enabled for the ACL.
 		const auto acl_protocol = context().config().acl_protocol();
 		if( acl_protocol_t::autodetect == acl_protocol )
 		{
-			detection_result = try_accept_socks_connection();
+			detection_result = try_detect_socks( first_byte );
 			if( std::holds_alternative< unknown_protocol_t >( detection_result ) )
 			{
-				detection_result = try_accept_http_connection();
+				detection_result = try_detect_http( first_byte );
 			}
 		}
 		else if( acl_protocol_t::socks == acl_protocol )
 		{
-			detection_result = try_accept_socks_connection();
+			detection_result = try_detect_socks( first_byte );
 		}
 		else if( acl_protocol_t::http == acl_protocol )
 		{
-			detection_result = try_accept_http_connection();
+			detection_result = try_detect_http( first_byte );
 		}
 
-		// Analyze the result of acception attempt.
+		// Analyze the result of detection attempt.
 		std::visit( ::arataga::utils::overloaded{
 				[this]
-				( connection_accepted_t & accepted )
+				( connection_type_t connection_type )
 				{
-					// Update the stats. It should be done now because
-					// in the case of HTTP keep-alive connection can be used.
-					// In the case of HTTP keep-alive the connection should be
-					// counted only once. If we'll update the stats in
-					// http::initial_http_handler then the stats will be updated
-					// for every incoming request (there could be many
-					// requests in a single keep-alive connection).
-					context().stats_inc_connection_count(
-							accepted.m_connection_type );
-
-					// The handler can be changed now.
-					replace_handler( [&]() { return std::move(accepted.m_handler); } );
+					accept_connection( connection_type );
 				},
 				[this]
 				( const unknown_protocol_t & info )
@@ -164,39 +205,22 @@ private:
 				detection_result );
 	}
 
-	detection_result_t
-	try_accept_socks_connection()
+	[[nodiscard]]
+	static detection_result_t
+	try_detect_socks( std::byte first_byte ) noexcept
 	{
 		constexpr std::byte socks5_protocol_first_byte{ 5u };
 
-		const auto first_byte = m_in_buffer.read_byte();
-
 		if( socks5_protocol_first_byte == first_byte )
-		{
 			// Assume that is SOCKS5.
-			return {
-					connection_accepted_t{
-							connection_type_t::socks5,
-							make_socks5_auth_method_detection_handler(
-									m_ctx,
-									m_id,
-									std::move(m_connection),
-									// All data in m_first_chunk are going to
-									// the next handler.
-									make_first_chunk_for_next_handler(
-											std::move(m_first_chunk),
-											0u,
-											m_in_buffer.size() ),
-									m_created_at )
-					}
-			};
-		}
+			return { connection_type_t::socks5 };
 
 		return { unknown_protocol_t{ first_byte } };
 	}
 
-	detection_result_t
-	try_accept_http_connection()
+	[[nodiscard]]
+	static detection_result_t
+	try_detect_http( std::byte first_byte ) noexcept
 	{
 		// Assume that this is HTTP if the first byte is a capital
 		// latin letter (it is because methods in HTTP are identified
@@ -205,30 +229,69 @@ private:
 		// Even if we've made a mistake the consequent parsing of HTTP
 		// will fail and the connection will be closed.
 		//
-		const auto first_byte = m_in_buffer.read_byte();
 		if( std::byte{'A'} <= first_byte && first_byte <= std::byte{'Z'} )
-		{
 			// Assume that it's HTTP protocol.
-			return {
-					connection_accepted_t{
-							connection_type_t::http,
-							make_http_handler(
-									m_ctx,
-									m_id,
-									std::move(m_connection),
-									// All data in m_first_chunk are going to
-									// the next handler.
-									make_first_chunk_for_next_handler(
-											std::move(m_first_chunk),
-											0u,
-											m_in_buffer.size() ),
-									m_created_at )
-					}
-			};
-		}
+			return { connection_type_t::http };
 
 		return { unknown_protocol_t{ first_byte } };
 	}
+
+	void
+	accept_connection( connection_type_t connection_type )
+	{
+		using namespace arataga::utils::string_literals;
+
+		// The protocol is known, the buffer is necessary now.
+		first_chunk_t first_chunk{
+				context().io_chunk_pool().acquire(
+						context().config().io_chunk_size() )
+			};
+
+		// The socket is in non-blocking mode and there is data in it
+		// (it was peeked), so this call reads the data that is
+		// already available.
+		asio::error_code ec;
+		const std::size_t bytes = m_connection.read_some(
+				asio::buffer( first_chunk.buffer(), first_chunk.capacity() ),
+				ec );
+		if( ec )
+			return remove_on_io_error( ec, "read"_static_str );
+
+		// All data in first_chunk are going to the next handler.
+		auto first_chunk_data = make_first_chunk_for_next_handler(
+				std::move(first_chunk),
+				0u,
+				bytes );
+
+		auto handler = connection_type_t::socks5 == connection_type ?
+				make_socks5_auth_method_detection_handler(
+						m_ctx,
+						m_id,
+						std::move(m_connection),
+						std::move(first_chunk_data),
+						m_created_at ) :
+				make_http_handler(
+						m_ctx,
+						m_id,
+						std::move(m_connection),
+						std::move(first_chunk_data),
+						m_created_at );
+
+		// Update the stats. It should be done now because
+		// in the case of HTTP keep-alive connection can be used.
+		// In the case of HTTP keep-alive the connection should be
+		// counted only once. If we'll update the stats in
+		// http::initial_http_handler then the stats will be updated
+		// for every incoming request (there could be many
+		// requests in a single keep-alive connection).
+		context().stats_inc_connection_count( connection_type );
+		context().stats_record_setup_stage(
+				setup_stage_t::protocol_detection,
+				m_created_at );
+
+		// The handler can be changed now.
+		replace_handler( [&]() { return std::move(handler); } );
+	}
 };
 
 } /* namespace handlers::protocol_detection */
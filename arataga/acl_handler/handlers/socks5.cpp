@@ -193,6 +193,14 @@ protected:
 		handle_data_already_read_or_read_more();
 	}
 
+	[[nodiscard]]
+	std::chrono::steady_clock::time_point
+	timeout_deadline() noexcept override
+	{
+		return m_created_at +
+				context().config().socks_handshake_phase_timeout();
+	}
+
 	void
 	on_timer_impl() override
 	{
@@ -488,6 +496,14 @@ protected:
 		handle_data_already_read_or_read_more();
 	}
 
+	[[nodiscard]]
+	std::chrono::steady_clock::time_point
+	timeout_deadline() noexcept override
+	{
+		return m_created_at +
+				context().config().socks_handshake_phase_timeout();
+	}
+
 	void
 	on_timer_impl() override
 	{
@@ -700,6 +716,14 @@ protected:
 				} );
 	}
 
+	[[nodiscard]]
+	std::chrono::steady_clock::time_point
+	timeout_deadline() noexcept override
+	{
+		return m_created_at +
+				context().config().socks_handshake_phase_timeout();
+	}
+
 	void
 	on_timer_impl() override
 	{
@@ -979,6 +1003,14 @@ protected:
 			} );
 	}
 
+	[[nodiscard]]
+	std::chrono::steady_clock::time_point
+	timeout_deadline() noexcept override
+	{
+		return m_created_at +
+				context().config().socks_handshake_phase_timeout();
+	}
+
 	void
 	on_timer_impl() override
 	{
@@ -1091,6 +1123,10 @@ private:
 		// Everything has been read, nothing left in the buffer.
 		read_trx.commit();
 
+		context().stats_record_setup_stage(
+				setup_stage_t::handshake,
+				m_created_at );
+
 		if( connect_cmd == cmd )
 		{
 			// This command has to be handled by another handler.
@@ -1318,6 +1354,14 @@ protected:
 			&connect_and_bind_handler_base_t::authentification_timeout_handler
 		};
 
+	//! The duration of the current operation.
+	/*!
+	 * It's necessary for the calculation of timeout_deadline().
+	 *
+	 * @since v.0.6.0
+	 */
+	std::chrono::milliseconds m_last_op_timeout;
+
 	/*!
 	 * @attention
 	 * The implementation assumes that dst_addr_bytes contains the
@@ -1379,6 +1423,7 @@ public:
 		,	m_dst_addr{ make_destination_addr( atype_value, dst_addr ) }
 		,	m_dst_port{ dst_port }
 		,	m_last_op_started_at{ std::chrono::steady_clock::now() }
+		,	m_last_op_timeout{ context().config().authentification_timeout() }
 	{}
 
 protected:
@@ -1407,6 +1452,13 @@ protected:
 			m_dst_addr );
 	}
 
+	[[nodiscard]]
+	std::chrono::steady_clock::time_point
+	timeout_deadline() noexcept override
+	{
+		return m_last_op_started_at + m_last_op_timeout;
+	}
+
 	void
 	on_timer_impl() override
 	{
@@ -1453,10 +1505,15 @@ protected:
 
 	void
 	set_operation_started_markers(
-		timeout_handler_t timeout_handler )
+		timeout_handler_t timeout_handler,
+		std::chrono::milliseconds timeout )
 	{
 		m_last_op_started_at = std::chrono::steady_clock::now();
 		m_last_op_timeout_handler = timeout_handler;
+		m_last_op_timeout = timeout;
+
+		// The new deadline can be earlier than the scheduled one.
+		schedule_timeout_check();
 	}
 
 	void
@@ -1534,7 +1591,8 @@ protected:
 				} );
 
 		set_operation_started_markers(
-				&connect_and_bind_handler_base_t::dns_resolving_timeout_handler );
+				&connect_and_bind_handler_base_t::dns_resolving_timeout_handler,
+				context().config().dns_resolving_timeout() );
 
 		context().async_resolve_hostname(
 				m_id,
@@ -1551,7 +1609,8 @@ protected:
 	initiate_authentification()
 	{
 		set_operation_started_markers(
-				&connect_and_bind_handler_base_t::authentification_timeout_handler );
+				&connect_and_bind_handler_base_t::authentification_timeout_handler,
+				context().config().authentification_timeout() );
 
 		context().async_authentificate(
 				m_id,
@@ -1781,7 +1840,8 @@ private:
 	initiate_next_step() override
 	{
 		set_operation_started_markers(
-				&connect_command_handler_t::connect_target_timeout_handler );
+				&connect_command_handler_t::connect_target_timeout_handler,
+				context().config().connect_target_timeout() );
 
 		try
 		{
@@ -1909,6 +1969,10 @@ private:
 												m_out_connection.local_endpoint()) ) );
 					} );
 
+			context().stats_record_setup_stage(
+					setup_stage_t::connect_target,
+					m_last_op_started_at );
+
 			make_and_send_positive_response_then_switch_handler();
 		}
 	}
@@ -2025,7 +2089,8 @@ private:
 	initiate_next_step() override
 	{
 		set_operation_started_markers(
-				&bind_command_handler_t::accept_incoming_timeout_handler );
+				&bind_command_handler_t::accept_incoming_timeout_handler,
+				context().config().socks_bind_timeout() );
 
 		// A helper function to reduce the amount of error-handling code.
 		const auto finish_on_failure =
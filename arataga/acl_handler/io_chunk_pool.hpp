@@ -0,0 +1,304 @@
+/*!
+ * @file
+ * @brief A pool of I/O chunks shared by all connections of an IO-thread.
+ * @since v.0.6.0
+ */
+
+#pragma once
+
+#include <arataga/stats/io_chunks/pub.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace arataga::acl_handler
+{
+
+class io_chunk_pool_t;
+
+//
+// io_chunk_t
+//
+/*!
+ * @brief A chunk of memory for I/O operations borrowed from io_chunk_pool.
+ *
+ * An instance of io_chunk_t returns the memory back to the pool in the
+ * destructor or in reset() method.
+ *
+ * @attention
+ * The pool must outlive all chunks borrowed from it. It is guaranteed for
+ * chunks owned by connection-handlers because every connection-handler
+ * holds a reference to handler_context and handler_context holds the pool.
+ *
+ * @note
+ * This is Movable, but not Copyable type. A default constructed
+ * instance is empty.
+ *
+ * @since v.0.6.0
+ */
+class io_chunk_t
+{
+	friend class io_chunk_pool_t;
+
+	//! The owner of the chunk.
+	/*!
+	 * It is nullptr for an empty chunk.
+	 */
+	io_chunk_pool_t * m_pool{ nullptr };
+
+	//! The memory of the chunk.
+	std::unique_ptr< std::byte[] > m_data;
+
+	//! The capacity of the chunk.
+	std::size_t m_capacity{ 0u };
+
+	// Only io_chunk_pool can create non-empty chunks.
+	io_chunk_t(
+		io_chunk_pool_t & pool,
+		std::unique_ptr< std::byte[] > data,
+		std::size_t capacity ) noexcept
+		:	m_pool{ &pool }
+		,	m_data{ std::move(data) }
+		,	m_capacity{ capacity }
+	{}
+
+public:
+	io_chunk_t() noexcept = default;
+
+	~io_chunk_t() noexcept
+	{
+		reset();
+	}
+
+	io_chunk_t( const io_chunk_t & ) = delete;
+	io_chunk_t &
+	operator=( const io_chunk_t & ) = delete;
+
+	io_chunk_t( io_chunk_t && other ) noexcept
+		:	m_pool{ std::exchange( other.m_pool, nullptr ) }
+		,	m_data{ std::move(other.m_data) }
+		,	m_capacity{ std::exchange( other.m_capacity, 0u ) }
+	{}
+
+	io_chunk_t &
+	operator=( io_chunk_t && other ) noexcept
+	{
+		io_chunk_t tmp{ std::move(other) };
+		swap( *this, tmp );
+		return *this;
+	}
+
+	friend void
+	swap( io_chunk_t & a, io_chunk_t & b ) noexcept
+	{
+		using std::swap;
+		swap( a.m_pool, b.m_pool );
+		swap( a.m_data, b.m_data );
+		swap( a.m_capacity, b.m_capacity );
+	}
+
+	//! Return the memory to the pool.
+	/*!
+	 * The chunk becomes empty after that call.
+	 */
+	void
+	reset() noexcept;
+
+	[[nodiscard]]
+	bool
+	empty() const noexcept
+	{
+		return !m_data;
+	}
+
+	[[nodiscard]]
+	std::byte *
+	data() noexcept
+	{
+		return m_data.get();
+	}
+
+	[[nodiscard]]
+	const std::byte *
+	data() const noexcept
+	{
+		return m_data.get();
+	}
+
+	[[nodiscard]]
+	std::size_t
+	capacity() const noexcept
+	{
+		return m_capacity;
+	}
+};
+
+//
+// io_chunk_pool_t
+//
+/*!
+ * @brief A pool of I/O chunks for all connections on one IO-thread.
+ *
+ * Before v.0.6.0 every connection allocated io_chunk_count buffers for
+ * every direction at the start of data-transfer and held them until the
+ * connection was closed. Most of that memory was never touched for
+ * idle connections.
+ *
+ * Since v.0.6.0 chunks are lent by this pool only when they are really
+ * needed (there is data to be read or written) and are returned back as
+ * soon as possible. Returned chunks are kept in the pool for reuse.
+ *
+ * The pool keeps chunks of one size only (the size from the last
+ * acquire() call). If io_chunk_size is changed in the config then all
+ * cached chunks are deallocated and chunks of the old size aren't
+ * returned to the pool.
+ *
+ * @attention
+ * This class isn't thread safe. It is intended to be used only on the
+ * IO-thread it belongs to. Only the stats can be read from other threads.
+ *
+ * @since v.0.6.0
+ */
+class io_chunk_pool_t
+{
+	friend class io_chunk_t;
+
+	//! Max count of free chunks to be kept in the pool.
+	const std::size_t m_max_free_chunks;
+
+	//! The size of chunks in m_free_chunks.
+	std::size_t m_chunk_size{ 0u };
+
+	//! Free chunks ready for reuse.
+	/*!
+	 * @note
+	 * The capacity of that container is reserved in the constructor,
+	 * so the returning of a chunk never allocates.
+	 */
+	std::vector< std::unique_ptr< std::byte[] > > m_free_chunks;
+
+	//! The stats for that pool.
+	::arataga::stats::io_chunks::io_chunk_stats_t m_stats;
+	::arataga::stats::io_chunks::auto_reg_t m_stats_reg;
+
+	void
+	drop_free_chunks() noexcept
+	{
+		m_stats.m_chunks_cached -= m_free_chunks.size();
+		m_stats.m_bytes_cached -= m_free_chunks.size() * m_chunk_size;
+
+		m_free_chunks.clear();
+	}
+
+	void
+	give_back(
+		std::unique_ptr< std::byte[] > data,
+		std::size_t capacity ) noexcept
+	{
+		m_stats.m_chunks_in_use -= 1u;
+		m_stats.m_bytes_in_use -= capacity;
+
+		// Chunks of outdated size and extra chunks are just deallocated.
+		if( capacity == m_chunk_size &&
+				m_free_chunks.size() < m_max_free_chunks )
+		{
+			m_free_chunks.push_back( std::move(data) );
+
+			m_stats.m_chunks_cached += 1u;
+			m_stats.m_bytes_cached += capacity;
+		}
+	}
+
+public:
+	//! The default value for max count of free chunks to be kept.
+	static constexpr std::size_t default_max_free_chunks{ 1024u };
+
+	io_chunk_pool_t(
+		std::shared_ptr<
+				::arataga::stats::io_chunks::io_chunk_stats_reference_manager_t
+			> stats_manager,
+		std::size_t max_free_chunks )
+		:	m_max_free_chunks{ max_free_chunks }
+		,	m_stats_reg{ std::move(stats_manager), m_stats }
+	{
+		m_free_chunks.reserve( m_max_free_chunks );
+	}
+
+	~io_chunk_pool_t() noexcept
+	{
+		drop_free_chunks();
+	}
+
+	// Objects of that type can't be copied or moved.
+	io_chunk_pool_t( const io_chunk_pool_t & ) = delete;
+	io_chunk_pool_t( io_chunk_pool_t && ) = delete;
+
+	//! Get a chunk of the specified capacity.
+	/*!
+	 * A free chunk is reused if it is present. Otherwise a new
+	 * chunk is allocated.
+	 *
+	 * @throw std::bad_alloc if a new chunk can't be allocated.
+	 */
+	[[nodiscard]]
+	io_chunk_t
+	acquire( std::size_t capacity )
+	{
+		if( capacity != m_chunk_size )
+		{
+			// The size of I/O chunks has been changed. All cached chunks
+			// are useless now.
+			drop_free_chunks();
+			m_chunk_size = capacity;
+		}
+
+		std::unique_ptr< std::byte[] > data;
+		if( m_free_chunks.empty() )
+		{
+			data = std::make_unique< std::byte[] >( capacity );
+
+			m_stats.m_chunks_allocated += 1u;
+		}
+		else
+		{
+			data = std::move(m_free_chunks.back());
+			m_free_chunks.pop_back();
+
+			m_stats.m_chunks_reused += 1u;
+			m_stats.m_chunks_cached -= 1u;
+			m_stats.m_bytes_cached -= capacity;
+		}
+
+		m_stats.m_chunks_in_use += 1u;
+		m_stats.m_bytes_in_use += capacity;
+
+		return { *this, std::move(data), capacity };
+	}
+
+	//! Get the stats of that pool.
+	[[nodiscard]]
+	const ::arataga::stats::io_chunks::io_chunk_stats_t &
+	stats() const noexcept
+	{
+		return m_stats;
+	}
+};
+
+//
+// io_chunk_t implementation
+//
+inline void
+io_chunk_t::reset() noexcept
+{
+	if( m_pool )
+	{
+		m_pool->give_back( std::move(m_data), m_capacity );
+
+		m_pool = nullptr;
+		m_capacity = 0u;
+	}
+}
+
+} /* namespace arataga::acl_handler */
@@ -9,6 +9,9 @@
 
 #include <arataga/utils/overloaded.hpp>
 
+#include <algorithm>
+#include <array>
+
 namespace arataga::acl_handler
 {
 
@@ -101,5 +104,139 @@ public:
 	}
 };
 
+//
+// gathered_out_buffers_t
+//
+/*!
+ * @brief Buffer sequence for writing several pieces of outgoing data
+ * by one write operation (writev).
+ *
+ * It has the fixed capacity, so it can be copied into an asynchronous
+ * write operation without memory allocation.
+ *
+ * @since v.0.6.0
+ */
+class gathered_out_buffers_t
+{
+public:
+	//! Max number of buffers for one write operation.
+	/*!
+	 * @note
+	 * Asio passes at most 64 buffers to one writev() call.
+	 */
+	static constexpr std::size_t max_buffers = 32u;
+
+	using value_type = asio::const_buffer;
+	using const_iterator = const asio::const_buffer *;
+
+private:
+	std::array< asio::const_buffer, max_buffers > m_buffers;
+	std::size_t m_count{ 0u };
+	std::size_t m_total_size{ 0u };
+
+public:
+	[[nodiscard]]
+	bool
+	full() const noexcept { return max_buffers == m_count; }
+
+	//! The total size of all buffers.
+	[[nodiscard]]
+	std::size_t
+	total_size() const noexcept { return m_total_size; }
+
+	//! Add a buffer to the sequence.
+	/*!
+	 * @attention
+	 * The sequence shouldn't be full.
+	 */
+	void
+	push_back( asio::const_buffer buffer ) noexcept
+	{
+		m_buffers[ m_count ] = buffer;
+		++m_count;
+		m_total_size += buffer.size();
+	}
+
+	[[nodiscard]]
+	const_iterator
+	begin() const noexcept { return m_buffers.data(); }
+
+	[[nodiscard]]
+	const_iterator
+	end() const noexcept { return m_buffers.data() + m_count; }
+};
+
+//
+// gather_out_buffers
+//
+/*!
+ * @brief Collect buffers of pending pieces of outgoing data.
+ *
+ * Pieces are taken from the beginning of @a pieces until
+ * gathered_out_buffers_t is full or @a max_bytes is reached (the last
+ * buffer is shortened in that case).
+ *
+ * @since v.0.6.0
+ */
+template< typename Container >
+[[nodiscard]]
+gathered_out_buffers_t
+gather_out_buffers(
+	//! Container with out_data_piece_t objects.
+	const Container & pieces,
+	//! Max number of bytes to be gathered.
+	std::size_t max_bytes ) noexcept
+{
+	gathered_out_buffers_t result;
+
+	for( const auto & piece : pieces )
+	{
+		if( result.full() || 0u == max_bytes )
+			break;
+
+		const auto buffer = piece.asio_buffer();
+		if( 0u == buffer.size() )
+			continue;
+
+		const auto bytes = std::min( buffer.size(), max_bytes );
+		result.push_back( asio::const_buffer{ buffer.data(), bytes } );
+		max_bytes -= bytes;
+	}
+
+	return result;
+}
+
+//
+// consume_written_bytes
+//
+/*!
+ * @brief Remove pieces of outgoing data those were written.
+ *
+ * The first partially written piece is left in @a pieces.
+ *
+ * @since v.0.6.0
+ */
+template< typename Container >
+void
+consume_written_bytes(
+	//! Container with out_data_piece_t objects.
+	Container & pieces,
+	//! The result of the write operation.
+	std::size_t bytes_written )
+{
+	while( !pieces.empty() )
+	{
+		auto & piece = pieces.front();
+		const auto bytes = std::min( bytes_written, piece.remaining() );
+		piece.increment_bytes_written( bytes );
+		bytes_written -= bytes;
+
+		if( piece.remaining() )
+			break;
+
+		pieces.pop_front();
+	}
+}
+
 } /* namespace arataga::acl_handler */
 
@@ -0,0 +1,190 @@
+/*!
+ * @file
+ * @brief A timer wheel for waking up throttled connections.
+ * @since v.0.6.0
+ */
+
+#pragma once
+
+#include <arataga/acl_handler/wheel_timer.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace arataga::acl_handler
+{
+
+//
+// pacing_wheel_t
+//
+/*!
+ * @brief A timer wheel for waking up throttled connections on one IO-thread.
+ *
+ * Before v.0.6.0 a connection that exceeded its bandwidth limit was
+ * resumed only from the one-second timer. Since v.0.6.0 bandwidth limits
+ * are refilled continuously and a throttled connection has to be resumed
+ * in several milliseconds.
+ *
+ * Creation of an asio::steady_timer for every throttled connection is too
+ * expensive. Instead there is one wheel per IO-thread. The wheel consists
+ * of slots, every slot corresponds to one tick. A callback is placed into
+ * a slot depending on the required delay. When the tick for a slot comes
+ * all callbacks from it are invoked.
+ *
+ * The wheel holds a single wheel_timer_t that is active only if there
+ * are pending callbacks. So there is no overhead when nobody is throttled.
+ *
+ * Callbacks are expected to be created by
+ * connection_handler_t::with().make_handler(), so they hold the
+ * connection-handler and do nothing if that handler is already removed.
+ *
+ * @attention
+ * This class isn't thread safe. It is intended to be used only on the
+ * IO-thread it belongs to.
+ *
+ * @attention
+ * Callbacks mustn't throw.
+ *
+ * @note
+ * An instance of that class should be created as std::shared_ptr because
+ * an active wait for the timer holds a reference to the wheel.
+ *
+ * @since v.0.6.0
+ */
+class pacing_wheel_t
+	:	public std::enable_shared_from_this< pacing_wheel_t >
+{
+public:
+	//! Type of a callback to be invoked.
+	using callback_t = std::function< void() >;
+
+	//! The duration of one tick.
+	static constexpr std::chrono::milliseconds tick{ 5 };
+
+	//! The count of slots in the wheel.
+	/*!
+	 * Delays longer than tick*slots_count are truncated.
+	 */
+	static constexpr std::size_t slots_count{ 256u };
+
+private:
+	//! Type of container for callbacks in one slot.
+	using slot_t = std::vector< callback_t >;
+
+	//! The timer for ticks.
+	wheel_timer_t m_timer;
+
+	//! Slots of the wheel.
+	std::array< slot_t, slots_count > m_slots;
+
+	//! Index of the slot to be processed on the next tick.
+	std::size_t m_current_slot{ 0u };
+
+	//! The time point of the next tick.
+	std::chrono::steady_clock::time_point m_next_tick_at{};
+
+	//! The total count of pending callbacks.
+	std::size_t m_pending{ 0u };
+
+	//! A container for callbacks that are being invoked.
+	/*!
+	 * It is swapped with a slot to be processed. This allows to reuse
+	 * the memory allocated by slots.
+	 */
+	slot_t m_ready;
+
+	void
+	arm_timer() noexcept
+	{
+		if( m_timer.needs_arming( m_next_tick_at ) )
+			m_timer.arm(
+					m_next_tick_at,
+					[self = shared_from_this()] { self->on_tick(); } );
+	}
+
+	void
+	on_tick() noexcept
+	{
+		const auto now = std::chrono::steady_clock::now();
+
+		// The timer can fire late, so several slots may have to be
+		// processed at once.
+		while( m_pending && m_next_tick_at <= now )
+		{
+			m_ready.swap( m_slots[ m_current_slot ] );
+
+			// The wheel should be moved forward before the invocation
+			// of callbacks because a callback can schedule another one.
+			m_current_slot = (m_current_slot + 1u) % slots_count;
+			m_next_tick_at += tick;
+			m_pending -= m_ready.size();
+
+			for( auto & cb : m_ready )
+				cb();
+
+			m_ready.clear();
+		}
+
+		// Callbacks don't arm the timer during the processing,
+		// it's done only once here.
+		m_timer.expiry_processed();
+		if( m_pending )
+			arm_timer();
+	}
+
+public:
+	pacing_wheel_t( asio::io_context & io_ctx )
+		:	m_timer{ io_ctx }
+	{}
+
+	pacing_wheel_t( const pacing_wheel_t & ) = delete;
+	pacing_wheel_t( pacing_wheel_t && ) = delete;
+
+	//! Schedule a callback to be invoked after @a delay.
+	/*!
+	 * The delay is rounded up to the whole number of ticks. But the
+	 * callback can be invoked up to one tick earlier because the current
+	 * tick is already in progress.
+	 *
+	 * @throw std::bad_alloc if there is no memory for a new callback.
+	 */
+	void
+	schedule(
+		std::chrono::milliseconds delay,
+		callback_t callback )
+	{
+		if( !m_pending && !m_timer.active() )
+		{
+			// The wheel was idle. Ticks should be counted from now.
+			m_next_tick_at = std::chrono::steady_clock::now() + tick;
+		}
+
+		auto ticks = static_cast< std::size_t >(
+				(delay.count() + tick.count() - 1) / tick.count() );
+		if( ticks < 1u )
+			ticks = 1u;
+		else if( ticks > slots_count )
+			ticks = slots_count;
+
+		m_slots[ (m_current_slot + ticks - 1u) % slots_count ].push_back(
+				std::move(callback) );
+		m_pending += 1u;
+
+		arm_timer();
+	}
+
+	//! Get the count of pending callbacks.
+	[[nodiscard]]
+	std::size_t
+	pending() const noexcept
+	{
+		return m_pending;
+	}
+};
+
+} /* namespace arataga::acl_handler */
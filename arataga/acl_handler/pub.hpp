@@ -5,9 +5,18 @@
 
 #pragma once
 
-#include <arataga/utils/acl_req_id.hpp>
+#include <arataga/acl_handler/authentificated_users.hpp>
+#include <arataga/acl_handler/io_chunk_pool.hpp>
+#include <arataga/acl_handler/pacing_wheel.hpp>
+#include <arataga/acl_handler/shard_group.hpp>
+#include <arataga/acl_handler/timeout_wheel.hpp>
+#include <arataga/acl_handler/upstream_connection_pool.hpp>
+
+#include <arataga/authentificator/auth_engine.hpp>
 
-#include <arataga/io_thread_timer/ifaces.hpp>
+#include <arataga/dns_resolver/inline_resolver.hpp>
+
+#include <arataga/utils/acl_req_id.hpp>
 
 #include <arataga/application_context.hpp>
 
@@ -35,11 +44,67 @@ struct params_t
 	//! mbox of dns_resolver to be used.
 	so_5::mbox_t m_dns_mbox;
 
-	//! mbox of authentificator to be used.
-	so_5::mbox_t m_auth_mbox;
+	//! Resolver for names that don't require a lookup.
+	/*!
+	 * @since v.0.6.0
+	 */
+	std::shared_ptr< ::arataga::dns_resolver::inline_resolver_t >
+			m_inline_resolver;
+
+	//! Authentification engine of the IO-thread.
+	/*!
+	 * @note
+	 * Since v.0.6.0 it replaces mbox of authentificator.
+	 *
+	 * @since v.0.6.0
+	 */
+	std::shared_ptr< ::arataga::authentificator::auth_engine_t > m_auth_engine;
+
+	//! Pool of I/O chunks of the IO-thread.
+	/*!
+	 * @since v.0.6.0
+	 */
+	std::shared_ptr< io_chunk_pool_t > m_io_chunk_pool;
+
+	//! Timer wheel for throttled connections of the IO-thread.
+	/*!
+	 * @since v.0.6.0
+	 */
+	std::shared_ptr< pacing_wheel_t > m_pacing_wheel;
 
-	//! Timer-provider to be used by the agent.
-	arataga::io_thread_timer::provider_t & m_timer_provider;
+	//! Timer wheel for timeouts of connections of the IO-thread.
+	/*!
+	 * @note
+	 * Since v.0.6.0 it replaces the timer-provider.
+	 *
+	 * @since v.0.6.0
+	 */
+	std::shared_ptr< timeout_wheel_t > m_timeout_wheel;
+
+	//! Idle connections to target hosts of the IO-thread.
+	/*!
+	 * @since v.0.6.0
+	 */
+	std::shared_ptr< upstream_connection_pool_t > m_upstream_connection_pool;
+
+	//! Counters of transferred data of the IO-thread.
+	/*!
+	 * @since v.0.6.0
+	 */
+	std::shared_ptr< ::arataga::stats::traffic::traffic_stats_t >
+			m_traffic_stats;
+
+	//! The state shared by all shards of the ACL.
+	/*!
+	 * @since v.0.6.0
+	 */
+	std::shared_ptr< shard_group_t > m_shard_group;
+
+	//! The info about authentificated users shared by all ACLs.
+	/*!
+	 * @since v.0.6.0
+	 */
+	std::shared_ptr< authentificated_users_t > m_authentificated_users;
 
 	//! Unique name to be used for logging.
 	std::string m_name;
@@ -0,0 +1,158 @@
+/*!
+ * @file
+ * @brief The state shared by all shards of one ACL.
+ * @since v.0.6.0
+ */
+
+#pragma once
+
+#include <arataga/acl_handler/bandlim_manager.hpp>
+
+#include <so_5/all.hpp>
+
+#include <asio/ip/tcp.hpp>
+
+#include <atomic>
+
+namespace arataga::acl_handler
+{
+
+//
+// connection_slot_released_t
+//
+/*!
+ * @brief Notification about a released connection slot in a shard group.
+ *
+ * This signal is sent to shard_group_t::notification_mbox() when the
+ * count of connections drops below maxconn. Shards that have paused the
+ * acception of new connections can resume it.
+ *
+ * @since v.0.6.0
+ */
+struct connection_slot_released_t final : public so_5::signal_t {};
+
+//
+// shard_group_t
+//
+/*!
+ * @brief The state shared by all shards of one ACL.
+ *
+ * Since v.0.6.0 an ACL can be served by several acl_handler-agents
+ * (shards) on different IO-threads. Every shard has its own listening
+ * socket bound to the same address with SO_REUSEPORT, so the kernel
+ * distributes new connections between shards.
+ *
+ * But the ACL should still be seen as a single entity:
+ *
+ * - the maxconn limit is applied to the total count of connections
+ *   of all shards. Every shard reserves a slot before the acception of
+ *   a new connection and releases it when the connection is closed;
+ * - the bandwidth limit for the ACL (if it's set) is applied to
+ *   the total traffic of all shards. So buckets for that limit are
+ *   stored here. Those buckets are atomic and are used without locks.
+ *
+ * An ACL without sharding is a group with a single shard.
+ *
+ * @since v.0.6.0
+ */
+class shard_group_t
+{
+	//! The mbox for connection_slot_released_t notifications.
+	/*!
+	 * It is a MPMC-mbox, all shards are subscribed to it.
+	 */
+	const so_5::mbox_t m_notification_mbox;
+
+	//! The total count of connections of all shards.
+	/*!
+	 * Reserved but not accepted yet connections are counted too.
+	 */
+	std::atomic< std::size_t > m_connection_count{ 0u };
+
+	//! The bandwidth limits for the whole ACL.
+	bandlim_manager_t::channel_limits_data_t m_bandlims;
+
+public:
+	//! Can an ACL be served by several shards on that platform?
+	/*!
+	 * Several shards require SO_REUSEPORT option.
+	 */
+	static constexpr bool sharding_supported =
+#if defined(SO_REUSEPORT)
+			true;
+#else
+			false;
+#endif
+
+	shard_group_t( so_5::mbox_t notification_mbox )
+		:	m_notification_mbox{ std::move(notification_mbox) }
+	{}
+
+	shard_group_t( const shard_group_t & ) = delete;
+	shard_group_t( shard_group_t && ) = delete;
+
+	[[nodiscard]]
+	const so_5::mbox_t &
+	notification_mbox() const noexcept
+	{
+		return m_notification_mbox;
+	}
+
+	//! Get the total count of connections of all shards.
+	[[nodiscard]]
+	std::size_t
+	connection_count() const noexcept
+	{
+		return m_connection_count.load( std::memory_order_acquire );
+	}
+
+	//! An attempt to reserve a slot for a new connection.
+	/*!
+	 * @return false if @a maxconn is already reached.
+	 */
+	[[nodiscard]]
+	bool
+	try_reserve_connection_slot( std::size_t maxconn ) noexcept
+	{
+		auto current = m_connection_count.load( std::memory_order_acquire );
+		do
+		{
+			if( current >= maxconn )
+				return false;
+		}
+		while( !m_connection_count.compare_exchange_weak(
+				current, current + 1u,
+				std::memory_order_acq_rel,
+				std::memory_order_acquire ) );
+
+		return true;
+	}
+
+	//! Release a slot for a connection.
+	/*!
+	 * Shards are notified if the maxconn was reached before that call.
+	 */
+	void
+	release_connection_slot( std::size_t maxconn )
+	{
+		const auto prev = m_connection_count.fetch_sub(
+				1u, std::memory_order_acq_rel );
+		if( prev >= maxconn )
+			so_5::send< connection_slot_released_t >( m_notification_mbox );
+	}
+
+	//! Get the bandwidth limits for the whole ACL.
+	/*!
+	 * Buckets are unlimited until limits are set by
+	 * channel_limits_data_t::set_limits().
+	 */
+	[[nodiscard]]
+	bandlim_manager_t::channel_limits_data_t &
+	bandlims() noexcept
+	{
+		return m_bandlims;
+	}
+};
+
+} /* namespace arataga::acl_handler */
+
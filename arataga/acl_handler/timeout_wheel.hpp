@@ -0,0 +1,564 @@
+/*!
+ * @file
+ * @brief A hierarchical timer wheel for timeouts of connections.
+ * @since v.0.6.0
+ */
+
+#pragma once
+
+#include <arataga/acl_handler/wheel_timer.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace arataga::acl_handler
+{
+
+namespace timeout_wheel_details
+{
+
+//
+// link_t
+//
+/*!
+ * @brief A link in an intrusive circular doubly-linked list.
+ *
+ * A list is represented by a sentinel link. An empty list is
+ * a sentinel that points to itself.
+ *
+ * @since v.0.6.0
+ */
+struct link_t
+{
+	link_t * m_prev{ this };
+	link_t * m_next{ this };
+
+	[[nodiscard]]
+	bool
+	empty() const noexcept { return this == m_next; }
+
+	//! Add @a item to the end of the list.
+	void
+	push_back( link_t & item ) noexcept
+	{
+		item.m_prev = m_prev;
+		item.m_next = this;
+		m_prev->m_next = &item;
+		m_prev = &item;
+	}
+
+	//! Remove the item from the list it belongs to.
+	void
+	unlink() noexcept
+	{
+		m_prev->m_next = m_next;
+		m_next->m_prev = m_prev;
+		m_prev = m_next = this;
+	}
+
+	//! Move all items to the empty list @a to.
+	void
+	move_all_to( link_t & to ) noexcept
+	{
+		if( !empty() )
+		{
+			to.m_next = m_next;
+			to.m_prev = m_prev;
+			m_next->m_prev = &to;
+			m_prev->m_next = &to;
+			m_prev = m_next = this;
+		}
+	}
+};
+
+//! Get the index of the lowest set bit in a non-zero value.
+[[nodiscard]]
+inline unsigned
+lowest_bit_index( std::uint64_t v ) noexcept
+{
+	// The de Bruijn sequence is used to avoid compiler-specific intrinsics.
+	static constexpr std::uint64_t debruijn = 0x03f79d71b4cb0a89ull;
+	static constexpr unsigned char indexes[ 64 ] = {
+			 0,  1, 48,  2, 57, 49, 28,  3, 61, 58, 50, 42, 38, 29, 17,  4,
+			62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12,  5,
+			63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+			46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19,  9, 13,  8,  7,  6
+		};
+
+	return indexes[ ((v & (~v + 1u)) * debruijn) >> 58u ];
+}
+
+//! Rotate a 64-bit value to the right.
+[[nodiscard]]
+inline std::uint64_t
+rotate_right( std::uint64_t v, unsigned shift ) noexcept
+{
+	shift &= 63u;
+	return 0u == shift ? v : ((v >> shift) | (v << (64u - shift)));
+}
+
+} /* namespace timeout_wheel_details */
+
+//
+// timeout_wheel_t
+//
+/*!
+ * @brief A hierarchical timer wheel for timeouts of connections on
+ * one IO-thread.
+ *
+ * Before v.0.6.0 every acl_handler-agent checked all its connections
+ * once a second. It meant a walk over all connections of the IO-thread
+ * at the same moment, one-second resolution of timeouts and a lot of
+ * useless checks because almost all deadlines are far in the future.
+ *
+ * Since v.0.6.0 every connection-handler registers only the deadline
+ * it cares about (protocol detection, handshake, DNS lookup,
+ * authentification, connect, idle) in the wheel of its IO-thread.
+ *
+ * The wheel has several levels of 64 slots. One slot of level 0
+ * corresponds to one tick (1ms), one slot of level N corresponds to
+ * 64 slots of level N-1. An entry is placed into a slot depending on
+ * the distance to its deadline. When the time for a slot of an upper
+ * level comes its entries are redistributed to lower levels. So the
+ * insertion, cancellation and expiration of an entry are O(1).
+ *
+ * Entries are intrusive. They are linked into slots directly, so the
+ * wheel doesn't allocate memory and an entry can be cancelled at any
+ * moment (for example, in the destructor of its owner).
+ *
+ * The wheel holds a single wheel_timer_t (the same as pacing_wheel_t,
+ * but the wheels are separate because pacing_wheel_t needs a fine
+ * resolution only for short delays and owns its callbacks while entries
+ * of this wheel are intrusive and can be scheduled for hours). The timer is set for the
+ * nearest moment when there is something to do (an entry expires or
+ * a slot of an upper level should be redistributed). So there is no
+ * overhead when nobody waits.
+ *
+ * An entry never expires earlier than its deadline. The only exception
+ * is a deadline that is too far in the future (see max_distance). Such
+ * a deadline is truncated and the owner of the entry has to check the
+ * time and to schedule the entry again.
+ *
+ * @attention
+ * This class isn't thread safe. It is intended to be used only on the
+ * IO-thread it belongs to.
+ *
+ * @note
+ * An instance of that class should be created as std::shared_ptr because
+ * an active wait for the timer holds a reference to the wheel.
+ *
+ * @since v.0.6.0
+ */
+class timeout_wheel_t
+	:	public std::enable_shared_from_this< timeout_wheel_t >
+{
+public:
+	//! Type of time point used by the wheel.
+	using time_point_t = std::chrono::steady_clock::time_point;
+
+	//! The duration of one tick.
+	using tick_t = std::chrono::milliseconds;
+
+	//! The count of bits of a tick number for one level.
+	static constexpr unsigned bits_per_level{ 6u };
+
+	//! The count of slots at one level.
+	static constexpr std::size_t slots_per_level{ 1u << bits_per_level };
+
+	//! The count of levels.
+	static constexpr std::size_t levels_count{ 4u };
+
+	//! The max distance to a deadline.
+	/*!
+	 * It's about 4.6 hours. Longer deadlines are truncated.
+	 */
+	static constexpr tick_t max_distance{
+			tick_t::rep{1} << (bits_per_level * levels_count)
+		};
+
+	//
+	// entry_t
+	//
+	/*!
+	 * @brief An entry to be placed into the wheel.
+	 *
+	 * The entry is cancelled automatically in the destructor.
+	 */
+	class entry_t : private timeout_wheel_details::link_t
+	{
+		friend class timeout_wheel_t;
+
+		//! The wheel in that the entry is scheduled.
+		/*!
+		 * It's nullptr if the entry isn't scheduled.
+		 */
+		timeout_wheel_t * m_wheel{};
+
+		//! The tick at that the entry expires.
+		std::uint64_t m_expires_at{};
+
+		//! The level of the entry.
+		/*!
+		 * Value levels_count means that the entry is being expired.
+		 */
+		std::size_t m_level{};
+
+		//! The slot of the entry.
+		std::size_t m_slot{};
+
+	protected:
+		// NOTE: the destructor is not virtual and isn't public.
+		// This interface is not intended to be used for handling
+		// object lifetime.
+		~entry_t() { cancel(); }
+
+	public:
+		entry_t() = default;
+
+		entry_t( const entry_t & ) = delete;
+		entry_t( entry_t && ) = delete;
+
+		//! Hook for the expiration of the entry.
+		/*!
+		 * The entry is already removed from the wheel at the moment
+		 * of the call, so it can be scheduled again.
+		 */
+		virtual void
+		on_timeout() noexcept = 0;
+
+		[[nodiscard]]
+		bool
+		is_scheduled() const noexcept { return nullptr != m_wheel; }
+
+		//! Remove the entry from the wheel.
+		/*!
+		 * Nothing happens if the entry isn't scheduled.
+		 */
+		void
+		cancel() noexcept
+		{
+			if( m_wheel )
+				m_wheel->remove( *this );
+		}
+	};
+
+private:
+	//! The timer for waking up.
+	wheel_timer_t m_timer;
+
+	//! The time point of tick 0.
+	const time_point_t m_origin;
+
+	//! Slots of all levels.
+	std::array<
+				std::array< timeout_wheel_details::link_t, slots_per_level >,
+				levels_count >
+			m_slots;
+
+	//! Bit masks of non-empty slots for every level.
+	std::array< std::uint64_t, levels_count > m_occupied{};
+
+	//! Entries that are being expired.
+	timeout_wheel_details::link_t m_expired;
+
+	//! The next tick to be processed.
+	std::uint64_t m_next_tick{ 0u };
+
+	//! The total count of scheduled entries.
+	std::size_t m_size{ 0u };
+
+	[[nodiscard]]
+	static std::uint64_t
+	level_span( std::size_t level ) noexcept
+	{
+		return std::uint64_t{1u} << (bits_per_level * level);
+	}
+
+	//! The number of the first tick that isn't earlier than @a tp.
+	[[nodiscard]]
+	std::uint64_t
+	tick_not_earlier_than( time_point_t tp ) const noexcept
+	{
+		if( tp <= m_origin )
+			return 0u;
+
+		return static_cast< std::uint64_t >(
+				std::chrono::ceil< tick_t >( tp - m_origin ).count() );
+	}
+
+	//! The number of the last tick that isn't later than @a tp.
+	[[nodiscard]]
+	std::uint64_t
+	tick_not_later_than( time_point_t tp ) const noexcept
+	{
+		if( tp <= m_origin )
+			return 0u;
+
+		return static_cast< std::uint64_t >(
+				std::chrono::floor< tick_t >( tp - m_origin ).count() );
+	}
+
+	//! Place an entry into the appropriate slot.
+	/*!
+	 * @return the tick when the wheel has to process the entry (the
+	 * expiration for level 0 or the redistribution for upper levels).
+	 */
+	std::uint64_t
+	insert( entry_t & entry, std::uint64_t expires_at ) noexcept
+	{
+		if( expires_at < m_next_tick )
+			expires_at = m_next_tick;
+		else if( const auto max_ticks =
+					static_cast< std::uint64_t >( max_distance.count() );
+				expires_at - m_next_tick >= max_ticks )
+			expires_at = m_next_tick + max_ticks - 1u;
+
+		const auto distance = expires_at - m_next_tick;
+		std::size_t level = 0u;
+		while( distance >= level_span( level + 1u ) )
+			++level;
+
+		const auto bucket = expires_at >> (bits_per_level * level);
+		const auto slot = static_cast< std::size_t >(
+				bucket & (slots_per_level - 1u) );
+
+		m_slots[ level ][ slot ].push_back( entry );
+		m_occupied[ level ] |= std::uint64_t{1u} << slot;
+
+		entry.m_wheel = this;
+		entry.m_expires_at = expires_at;
+		entry.m_level = level;
+		entry.m_slot = slot;
+
+		return bucket << (bits_per_level * level);
+	}
+
+	void
+	remove( entry_t & entry ) noexcept
+	{
+		entry.unlink();
+
+		if( entry.m_level < levels_count &&
+				m_slots[ entry.m_level ][ entry.m_slot ].empty() )
+			m_occupied[ entry.m_level ] &= ~(std::uint64_t{1u} << entry.m_slot);
+
+		entry.m_wheel = nullptr;
+		--m_size;
+	}
+
+	//! Find the nearest tick when the wheel has something to do.
+	/*!
+	 * @attention
+	 * There should be at least one scheduled entry.
+	 */
+	[[nodiscard]]
+	std::uint64_t
+	next_event_tick() const noexcept
+	{
+		using namespace timeout_wheel_details;
+
+		auto result = ~std::uint64_t{0u};
+
+		// Entries of level 0 expire during the next slots_per_level ticks.
+		if( const auto occupied = rotate_right(
+				m_occupied[ 0u ], static_cast< unsigned >( m_next_tick ) );
+				occupied )
+			result = m_next_tick + lowest_bit_index( occupied );
+
+		// Entries of upper levels are redistributed at the beginning
+		// of their buckets.
+		for( std::size_t level = 1u; level != levels_count; ++level )
+		{
+			const auto shift = bits_per_level * level;
+			const auto first_bucket =
+					(m_next_tick + level_span( level ) - 1u) >> shift;
+			if( const auto occupied = rotate_right(
+					m_occupied[ level ], static_cast< unsigned >( first_bucket ) );
+					occupied )
+			{
+				const auto tick =
+						(first_bucket + lowest_bit_index( occupied )) << shift;
+				if( tick < result )
+					result = tick;
+			}
+		}
+
+		return result;
+	}
+
+	//! Redistribute entries from a slot of an upper level.
+	void
+	redistribute( std::size_t level, std::size_t slot ) noexcept
+	{
+		timeout_wheel_details::link_t entries;
+		m_slots[ level ][ slot ].move_all_to( entries );
+		m_occupied[ level ] &= ~(std::uint64_t{1u} << slot);
+
+		while( !entries.empty() )
+		{
+			auto & entry = static_cast< entry_t & >( *entries.m_next );
+			entry.unlink();
+			insert( entry, entry.m_expires_at );
+		}
+	}
+
+	//! Process the tick @a tick.
+	/*!
+	 * @attention
+	 * All ticks between m_next_tick and @a tick should have nothing to do.
+	 */
+	void
+	process_tick( std::uint64_t tick ) noexcept
+	{
+		m_next_tick = tick;
+
+		// Upper levels go first because their entries can be moved
+		// to lower levels right at this tick.
+		for( std::size_t level = levels_count - 1u; level != 0u; --level )
+		{
+			const auto shift = bits_per_level * level;
+			if( 0u == (tick & (level_span( level ) - 1u)) )
+				redistribute(
+						level,
+						static_cast< std::size_t >(
+								(tick >> shift) & (slots_per_level - 1u) ) );
+		}
+
+		const auto slot = static_cast< std::size_t >(
+				tick & (slots_per_level - 1u) );
+		m_slots[ 0u ][ slot ].move_all_to( m_expired );
+		m_occupied[ 0u ] &= ~(std::uint64_t{1u} << slot);
+
+		// The wheel should be moved forward before the invocation
+		// of hooks because a hook can schedule its entry again.
+		m_next_tick = tick + 1u;
+
+		// NOTE: a hook can cancel any other entry from m_expired.
+		while( !m_expired.empty() )
+		{
+			auto & entry = static_cast< entry_t & >( *m_expired.m_next );
+			entry.m_level = levels_count;
+			remove( entry );
+
+			entry.on_timeout();
+		}
+	}
+
+	void
+	arm_timer( std::uint64_t tick ) noexcept
+	{
+		const auto tp = m_origin + tick_t{ tick };
+		if( m_timer.needs_arming( tp ) )
+			m_timer.arm(
+					tp,
+					[self = shared_from_this()] { self->on_timer(); } );
+	}
+
+	//! Process all ticks up to @a now.
+	void
+	expire( time_point_t now ) noexcept
+	{
+		const auto now_tick = tick_not_later_than( now );
+
+		while( m_size )
+		{
+			const auto tick = next_event_tick();
+			if( tick > now_tick )
+				break;
+
+			process_tick( tick );
+		}
+
+		// Nothing happens till now_tick.
+		if( m_next_tick <= now_tick )
+			m_next_tick = now_tick + 1u;
+	}
+
+	void
+	on_timer() noexcept
+	{
+		expire( std::chrono::steady_clock::now() );
+
+		// Hooks don't arm the timer during the processing (for example,
+		// if a hook schedules its entry again), it's done only once here.
+		m_timer.expiry_processed();
+		if( m_size )
+			arm_timer( next_event_tick() );
+	}
+
+public:
+	timeout_wheel_t( asio::io_context & io_ctx )
+		:	m_timer{ io_ctx }
+		,	m_origin{ std::chrono::steady_clock::now() }
+	{}
+
+	~timeout_wheel_t()
+	{
+		// Entries that are still scheduled shouldn't refer to the wheel.
+		for( auto & level : m_slots )
+			for( auto & slot : level )
+				while( !slot.empty() )
+				{
+					auto & entry = static_cast< entry_t & >( *slot.m_next );
+					entry.unlink();
+					entry.m_wheel = nullptr;
+				}
+	}
+
+	timeout_wheel_t( const timeout_wheel_t & ) = delete;
+	timeout_wheel_t( timeout_wheel_t && ) = delete;
+
+	//! Schedule an entry to be expired at @a deadline.
+	/*!
+	 * If the entry is already scheduled it's moved to the new deadline.
+	 */
+	void
+	schedule( entry_t & entry, time_point_t deadline ) noexcept
+	{
+		if( entry.m_wheel )
+			remove( entry );
+
+		if( 0u == m_size )
+		{
+			// The wheel was idle. There is no need to process
+			// ticks from the past.
+			const auto now_tick = tick_not_later_than(
+					std::chrono::steady_clock::now() );
+			if( m_next_tick < now_tick )
+				m_next_tick = now_tick;
+		}
+
+		const auto event_tick = insert(
+				entry, tick_not_earlier_than( deadline ) );
+		++m_size;
+
+		arm_timer( event_tick );
+	}
+
+	//! Expire all entries with deadlines not later than @a now.
+	/*!
+	 * The wheel does the same when the timer fires. This method is
+	 * public to simplify the testing.
+	 */
+	void
+	advance( time_point_t now ) noexcept
+	{
+		expire( now );
+
+		if( m_size )
+			arm_timer( next_event_tick() );
+	}
+
+	//! Get the count of scheduled entries.
+	[[nodiscard]]
+	std::size_t
+	size() const noexcept
+	{
+		return m_size;
+	}
+};
+
+} /* namespace arataga::acl_handler */
@@ -0,0 +1,271 @@
+/*!
+ * @file
+ * @brief A pool of idle outgoing connections for HTTP keep-alive.
+ * @since v.0.6.0
+ */
+
+#pragma once
+
+#include <arataga/acl_handler/timeout_wheel.hpp>
+
+#include <asio/ip/tcp.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+
+namespace arataga::acl_handler
+{
+
+//
+// upstream_connection_pool_t
+//
+/*!
+ * @brief A pool of idle connections to target hosts.
+ *
+ * When an ordinary HTTP request (not CONNECT) is completed and the
+ * target host allows to keep the connection, the connection to the
+ * target host is returned to that pool. The next request to the same
+ * target host from the same ACL's external address can reuse that
+ * connection without DNS lookup and TCP handshake.
+ *
+ * The pool holds at most max_idle connections (this value is specified
+ * for every call to release() because it's a part of the config that can
+ * be changed at run-time). If the pool is full the oldest connection is
+ * closed.
+ *
+ * Every idle connection has a deadline in the timeout_wheel_t of the
+ * IO-thread. The connection is closed when the deadline expires.
+ *
+ * A connection can be closed by the target host at any moment. So
+ * the liveness of a connection is checked before it is returned by
+ * try_acquire(). It's just a non-blocking peek from the socket: there
+ * should be neither EOF nor data (the target host doesn't send anything
+ * until it receives a new request).
+ *
+ * @attention
+ * This class isn't thread safe. It is intended to be used only on the
+ * IO-thread it belongs to. All sockets passed to the pool have to be
+ * bound to the io_context of that IO-thread.
+ *
+ * @since v.0.6.0
+ */
+class upstream_connection_pool_t
+{
+public:
+	//! Identification of a target for which a connection was created.
+	struct key_t
+	{
+		//! The external address of ACL the connection is bound to.
+		asio::ip::address m_out_addr;
+
+		//! The name of the target host (as it specified in the request).
+		std::string m_target_host;
+
+		//! The port of the target host.
+		std::uint16_t m_target_port;
+
+		[[nodiscard]]
+		bool
+		operator<( const key_t & o ) const noexcept
+		{
+			return std::tie( m_out_addr, m_target_host, m_target_port )
+					< std::tie( o.m_out_addr, o.m_target_host, o.m_target_port );
+		}
+	};
+
+private:
+	struct idle_connection_t;
+
+	//! Type of container for idle connections.
+	/*!
+	 * The most recently released connection is at the end.
+	 *
+	 * @note
+	 * std::list is used because idle_connection_t is an entry of
+	 * timeout_wheel_t and can't be moved.
+	 */
+	using idle_connection_container_t = std::list< idle_connection_t >;
+
+	//! Type of index for search of idle connections by a key.
+	using index_t = std::multimap<
+			key_t,
+			idle_connection_container_t::iterator >;
+
+	//! Info about one idle connection.
+	struct idle_connection_t final : public timeout_wheel_t::entry_t
+	{
+		//! The pool the connection belongs to.
+		upstream_connection_pool_t & m_pool;
+
+		//! The connection itself.
+		asio::ip::tcp::socket m_socket;
+
+		//! Position of the connection in the index.
+		index_t::iterator m_index_position;
+
+		//! Position of the connection in m_connections.
+		idle_connection_container_t::iterator m_position;
+
+		idle_connection_t(
+			upstream_connection_pool_t & pool,
+			asio::ip::tcp::socket socket )
+			:	m_pool{ pool }
+			,	m_socket{ std::move(socket) }
+		{}
+
+		void
+		on_timeout() noexcept override
+		{
+			// NOTE: the object is destroyed here.
+			m_pool.remove( m_position );
+		}
+	};
+
+	//! Timer wheel for deadlines of idle connections.
+	/*!
+	 * Declared before the connections to outlive them.
+	 */
+	std::shared_ptr< timeout_wheel_t > m_timeout_wheel;
+
+	//! Idle connections.
+	idle_connection_container_t m_connections;
+
+	//! Index for search of connections by a key.
+	index_t m_index;
+
+	//! Remove the connection from the pool and close it.
+	void
+	remove( idle_connection_container_t::iterator it ) noexcept
+	{
+		m_index.erase( it->m_index_position );
+
+		// NOTE: the socket is closed by the destructor, the entry is
+		// removed from the wheel by the destructor too.
+		m_connections.erase( it );
+	}
+
+	//! Check that a connection can be used for a new request.
+	[[nodiscard]]
+	static bool
+	is_alive( asio::ip::tcp::socket & socket ) noexcept
+	{
+		// NOTE: the socket has to be in non-blocking mode.
+		// It's true for sockets created by target_connector_handler.
+		std::uint8_t dummy;
+		asio::error_code ec;
+		socket.receive(
+				asio::buffer( &dummy, sizeof(dummy) ),
+				asio::ip::tcp::socket::message_peek,
+				ec );
+
+		// There should be nothing to read: EOF means that the connection
+		// has been closed by the target host, and data means that the
+		// target host sent something unexpected.
+		return asio::error::would_block == ec || asio::error::try_again == ec;
+	}
+
+public:
+	upstream_connection_pool_t(
+		std::shared_ptr< timeout_wheel_t > timeout_wheel )
+		:	m_timeout_wheel{ std::move(timeout_wheel) }
+	{}
+
+	upstream_connection_pool_t( const upstream_connection_pool_t & ) = delete;
+	upstream_connection_pool_t( upstream_connection_pool_t && ) = delete;
+
+	//! An attempt to get an idle connection for @a key.
+	/*!
+	 * The most recently released connection is preferred. Connections
+	 * that were closed by the target host are removed from the pool.
+	 *
+	 * @return empty value if there is no alive connection for @a key.
+	 */
+	[[nodiscard]]
+	std::optional< asio::ip::tcp::socket >
+	try_acquire( const key_t & key )
+	{
+		auto [first, last] = m_index.equal_range( key );
+		while( first != last )
+		{
+			// Take the last item because it's the most recent one.
+			auto it = std::prev( last )->second;
+			const bool alive = is_alive( it->m_socket );
+
+			std::optional< asio::ip::tcp::socket > result;
+			if( alive )
+				result.emplace( std::move(it->m_socket) );
+
+			remove( it );
+
+			if( result )
+				return result;
+
+			std::tie( first, last ) = m_index.equal_range( key );
+		}
+
+		return std::nullopt;
+	}
+
+	//! Return a connection to the pool.
+	/*!
+	 * The connection is closed if @a max_idle is 0. If there are already
+	 * @a max_idle connections in the pool then the oldest one is closed.
+	 */
+	void
+	release(
+		key_t key,
+		asio::ip::tcp::socket socket,
+		std::size_t max_idle,
+		std::chrono::milliseconds idle_timeout )
+	{
+		if( 0u == max_idle )
+			return;
+
+		while( max_idle <= m_connections.size() )
+			remove( m_connections.begin() );
+
+		auto it = m_connections.emplace(
+				m_connections.end(), *this, std::move(socket) );
+		try
+		{
+			it->m_position = it;
+			it->m_index_position = m_index.emplace( std::move(key), it );
+		}
+		catch( ... )
+		{
+			m_connections.erase( it );
+			throw;
+		}
+
+		m_timeout_wheel->schedule(
+				*it,
+				std::chrono::steady_clock::now() + idle_timeout );
+	}
+
+	//! Close all idle connections.
+	void
+	clear() noexcept
+	{
+		m_index.clear();
+		m_connections.clear();
+	}
+
+	//! Get the count of idle connections.
+	[[nodiscard]]
+	std::size_t
+	size() const noexcept
+	{
+		return m_connections.size();
+	}
+};
+
+} /* namespace arataga::acl_handler */
+
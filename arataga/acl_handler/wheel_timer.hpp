@@ -0,0 +1,126 @@
+/*!
+ * @file
+ * @brief A timer for timer wheels of IO-threads.
+ * @since v.0.6.0
+ */
+
+#pragma once
+
+#include <asio/io_context.hpp>
+#include <asio/steady_timer.hpp>
+
+#include <chrono>
+#include <utility>
+
+namespace arataga::acl_handler
+{
+
+//
+// wheel_timer_t
+//
+/*!
+ * @brief A timer that wakes up a timer wheel.
+ *
+ * Every IO-thread has two wheels: pacing_wheel_t for throttled
+ * connections and timeout_wheel_t for timeouts of connections. They have
+ * different requirements (pacing_wheel_t invokes arbitrary callbacks
+ * in several milliseconds, timeout_wheel_t holds intrusive entries with
+ * deadlines up to several hours), but both of them need a single timer
+ * that is set for the nearest moment when the wheel has something to do.
+ * That logic lives here.
+ *
+ * The timer is active from the call to arm() until the call to
+ * expiry_processed(). It remains active during the processing of an
+ * expiry, so calls to arm() made by callbacks of the wheel don't touch
+ * the asio-timer. The wheel has to call expiry_processed() at the end
+ * of the processing and then arm the timer for its next event.
+ *
+ * Waits cancelled by rearming of the timer are ignored. They don't
+ * change the state of the timer.
+ *
+ * @attention
+ * This class isn't thread safe. It is intended to be used only on the
+ * IO-thread it belongs to.
+ *
+ * @since v.0.6.0
+ */
+class wheel_timer_t
+{
+public:
+	using time_point_t = std::chrono::steady_clock::time_point;
+
+private:
+	asio::steady_timer m_timer;
+
+	//! Is there an active wait or the processing of an expiry?
+	bool m_active{ false };
+
+	//! The time point for that the timer is set.
+	time_point_t m_expires_at{};
+
+public:
+	wheel_timer_t( asio::io_context & io_ctx )
+		:	m_timer{ io_ctx }
+	{}
+
+	[[nodiscard]]
+	bool
+	active() const noexcept { return m_active; }
+
+	//! Should the timer be armed to wake up at @a tp?
+	/*!
+	 * It's false if the timer is already set for @a tp or for an earlier
+	 * moment (or an expiry is being processed).
+	 */
+	[[nodiscard]]
+	bool
+	needs_arming( time_point_t tp ) const noexcept
+	{
+		return !m_active || tp < m_expires_at;
+	}
+
+	//! Set the timer for @a tp.
+	/*!
+	 * A previous wait is cancelled. @a on_expiry is called when the timer
+	 * fires (but not when the wait is cancelled).
+	 *
+	 * If the timer can't be set it becomes inactive. It will be armed
+	 * by the next call to arm().
+	 */
+	template< typename Handler >
+	void
+	arm( time_point_t tp, Handler on_expiry ) noexcept
+	{
+		try
+		{
+			m_timer.expires_at( tp );
+			m_timer.async_wait(
+					[handler = std::move(on_expiry)]( const asio::error_code & ec )
+					mutable {
+						// NOTE: operation_aborted means that the timer has
+						// been rearmed, there is another active wait.
+						if( asio::error::operation_aborted != ec )
+							handler();
+					} );
+			m_active = true;
+			m_expires_at = tp;
+		}
+		catch( ... )
+		{
+			m_active = false;
+		}
+	}
+
+	//! The processing of an expiry is finished.
+	/*!
+	 * The timer becomes inactive, the wheel has to arm it for its next
+	 * event if there is one.
+	 */
+	void
+	expiry_processed() noexcept
+	{
+		m_active = false;
+	}
+};
+
+} /* namespace arataga::acl_handler */
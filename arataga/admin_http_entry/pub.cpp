@@ -48,6 +48,16 @@ public:
 		:	m_request{ std::move(req) }
 	{}
 
+	/*!
+	 * @since v.0.6.0
+	 */
+	actual_replier_t(
+		restinio::request_handle_t req,
+		std::string_view content_type )
+		:	m_request{ std::move(req) }
+		,	m_content_type{ content_type }
+	{}
+
 	void
 	reply(
 		status_t status,
@@ -61,13 +71,20 @@ public:
 				)
 				.append_header_date_field()
 				.append_header(
-						restinio::http_field::content_type, "text/plain" )
+						restinio::http_field::content_type,
+						std::string{ m_content_type } )
 				.append_body( std::move(body) )
 				.done();
 	}
 
 private:
 	const restinio::request_handle_t m_request;
+
+	//! The value of Content-Type for the response.
+	/*!
+	 * @since v.0.6.0
+	 */
+	const std::string_view m_content_type{ "text/plain" };
 };
 
 // Names of entry-points.
@@ -75,6 +92,13 @@ constexpr std::string_view entry_point_config{ "/config" };
 constexpr std::string_view entry_point_acls{ "/acls" };
 constexpr std::string_view entry_point_users{ "/users" };
 constexpr std::string_view entry_point_stats{ "/stats" };
+constexpr std::string_view entry_point_stats_top{ "/stats/top" };
+constexpr std::string_view entry_point_metrics{ "/metrics" };
+
+// Content-Type for responses in OpenMetrics format.
+constexpr std::string_view openmetrics_content_type{
+	"application/openmetrics-text; version=1.0.0; charset=utf-8"
+};
 constexpr std::string_view entry_point_debug_auth{ "/debug/auth" };
 constexpr std::string_view entry_point_debug_dns_resolve{ "/debug/dns-resolve" };
 
@@ -125,10 +149,14 @@ make_content_type_checker()
 	return []( const auto & req ) -> restinio::request_handling_status_t
 	{
 		// The check is necessary only if it is POST request for
-		// /config and /users entries.
-		if( restinio::http_method_post() == req->header().method() &&
-				(req->header().path() == entry_point_config ||
-				req->header().path() == entry_point_users) )
+		// /config and /users entries or PATCH request for /users entry.
+		const bool content_expected =
+				(restinio::http_method_post() == req->header().method() &&
+					(req->header().path() == entry_point_config ||
+					req->header().path() == entry_point_users)) ||
+				(restinio::http_method_patch() == req->header().method() &&
+					req->header().path() == entry_point_users);
+		if( content_expected )
 		{
 			using namespace restinio::http_field_parsers;
 
@@ -202,12 +230,40 @@ private:
 	on_user_list(
 		restinio::request_handle_t req ) const;
 
+	//! The handler for a request with changes for the user-list.
+	/*!
+	 * @since v.0.6.0
+	 */
+	[[nodiscard]]
+	restinio::request_handling_status_t
+	on_user_list_delta(
+		restinio::request_handle_t req ) const;
+
 	//! The handler for a request for retrieving the current stats.
 	[[nodiscard]]
 	restinio::request_handling_status_t
 	on_get_current_stats(
 		restinio::request_handle_t req ) const;
 
+	//! The handler for a request for the top of users and ACLs
+	//! by throughput.
+	/*!
+	 * @since v.0.6.0
+	 */
+	[[nodiscard]]
+	restinio::request_handling_status_t
+	on_get_traffic_top(
+		restinio::request_handle_t req ) const;
+
+	//! The handler for a request for the stats in OpenMetrics format.
+	/*!
+	 * @since v.0.6.0
+	 */
+	[[nodiscard]]
+	restinio::request_handling_status_t
+	on_get_metrics(
+		restinio::request_handle_t req ) const;
+
 	//! The handler for a request with test authentification.
 	[[nodiscard]]
 	restinio::request_handling_status_t
@@ -247,12 +303,30 @@ request_processor_t::on_request( restinio::request_handle_t req )
 		return on_user_list( std::move(req) );
 	}
 
+	if( restinio::http_method_patch() == req->header().method() &&
+			req->header().path() == entry_point_users )
+	{
+		return on_user_list_delta( std::move(req) );
+	}
+
 	if( restinio::http_method_get() == req->header().method() &&
 			req->header().path() == entry_point_stats )
 	{
 		return on_get_current_stats( std::move(req) );
 	}
 
+	if( restinio::http_method_get() == req->header().method() &&
+			req->header().path() == entry_point_stats_top )
+	{
+		return on_get_traffic_top( std::move(req) );
+	}
+
+	if( restinio::http_method_get() == req->header().method() &&
+			req->header().path() == entry_point_metrics )
+	{
+		return on_get_metrics( std::move(req) );
+	}
+
 	if( restinio::http_method_get() == req->header().method() &&
 			req->header().path() == entry_point_debug_auth )
 	{
@@ -304,6 +378,18 @@ request_processor_t::on_user_list(
 	return restinio::request_accepted();
 }
 
+restinio::request_handling_status_t
+request_processor_t::on_user_list_delta(
+	restinio::request_handle_t req ) const
+{
+	std::string_view content{ req->body() };
+	m_mailbox.user_list_delta(
+			std::make_shared< actual_replier_t >( std::move(req) ),
+			content );
+
+	return restinio::request_accepted();
+}
+
 [[nodiscard]]
 restinio::request_handling_status_t
 request_processor_t::on_get_current_stats(
@@ -315,6 +401,56 @@ request_processor_t::on_get_current_stats(
 	return restinio::request_accepted();
 }
 
+[[nodiscard]]
+restinio::request_handling_status_t
+request_processor_t::on_get_traffic_top(
+	restinio::request_handle_t req ) const
+{
+	// The number of items for every period if it isn't specified.
+	constexpr std::size_t default_top_n{ 10u };
+
+	try
+	{
+		const auto qp = restinio::parse_query<
+			restinio::parse_query_traits::javascript_compatible >(
+				req->header().query() );
+
+		std::size_t top_n{ default_top_n };
+		if( qp.has( "n" ) )
+			top_n = restinio::cast_to< std::size_t >( qp[ "n" ] );
+
+		m_mailbox.get_traffic_top(
+				// NOTE: `req` is passed by value.
+				// It allows us to use `req` in catch block.
+				std::make_shared< actual_replier_t >( req ),
+				top_n );
+	}
+	catch( const std::exception & x )
+	{
+		req->create_response( restinio::status_bad_request() )
+			.append_header_date_field()
+			.append_body(
+					fmt::format( "Error during parsing request parameters: {}\r\n",
+							x.what() ) )
+			.done();
+	}
+
+	return restinio::request_accepted();
+}
+
+[[nodiscard]]
+restinio::request_handling_status_t
+request_processor_t::on_get_metrics(
+	restinio::request_handle_t req ) const
+{
+	m_mailbox.get_metrics(
+			std::make_shared< actual_replier_t >(
+					std::move(req),
+					openmetrics_content_type ) );
+
+	return restinio::request_accepted();
+}
+
 restinio::request_handling_status_t
 request_processor_t::on_debug_auth(
 	restinio::request_handle_t req ) const
@@ -212,12 +212,44 @@ public:
 		//! The content of the new user-list.
 		std::string_view content ) = 0;
 
+	//! Send a request to apply changes to the current user-list.
+	/*!
+	 * @since v.0.6.0
+	 */
+	virtual void
+	user_list_delta(
+		//! Replier for that request.
+		replier_shptr_t replier,
+		//! The content of the changes.
+		std::string_view content ) = 0;
+
 	//! Send a request to retrieve the current stats.
 	virtual void
 	get_current_stats(
 		//! Replier for that request.
 		replier_shptr_t replier ) = 0;
 
+	//! Send a request to retrieve the users and ACLs with
+	//! the highest throughput.
+	/*!
+	 * @since v.0.6.0
+	 */
+	virtual void
+	get_traffic_top(
+		//! Replier for that request.
+		replier_shptr_t replier,
+		//! How many users and ACLs should be reported for every period.
+		std::size_t top_n ) = 0;
+
+	//! Send a request to retrieve the current stats in OpenMetrics format.
+	/*!
+	 * @since v.0.6.0
+	 */
+	virtual void
+	get_metrics(
+		//! Replier for that request.
+		replier_shptr_t replier ) = 0;
+
 	//! Send a test request for user authentification.
 	virtual void
 	debug_authentificate(
@@ -10,6 +10,8 @@
 #include <arataga/stats/auth/pub.hpp>
 #include <arataga/stats/connections/pub.hpp>
 #include <arataga/stats/dns/pub.hpp>
+#include <arataga/stats/io_chunks/pub.hpp>
+#include <arataga/stats/traffic/pub.hpp>
 
 namespace arataga
 {
@@ -49,6 +51,22 @@ struct application_context_t
 	//! The storage for statistics from DNS operations.
 	std::shared_ptr<
 			stats::dns::dns_stats_reference_manager_t > m_dns_stats_manager;
+
+	//! The storage for statistics from pools of I/O chunks.
+	/*!
+	 * @since v.0.6.0
+	 */
+	std::shared_ptr<
+			stats::io_chunks::io_chunk_stats_reference_manager_t >
+				m_io_chunk_stats_manager;
+
+	//! The storage for counters of transferred data.
+	/*!
+	 * @since v.0.6.0
+	 */
+	std::shared_ptr<
+			stats::traffic::traffic_stats_reference_manager_t >
+				m_traffic_stats_manager;
 };
 
 } /* namespace arataga */
@@ -28,10 +28,6 @@ a_authentificator_t::a_authentificator_t(
 	:	so_5::agent_t{ std::move(ctx) }
 	,	m_app_ctx{ std::move(app_ctx) }
 	,	m_params{ std::move(params) }
-	,	m_auth_stats_reg{
-			m_app_ctx.m_auth_stats_manager,
-			m_auth_stats
-		}
 {}
 
 void
@@ -71,7 +67,12 @@ a_authentificator_t::on_updated_user_list(
 						"{}: updated user-list received", m_params.m_name );
 			} );
 
-	m_auth_data = cmd->m_auth_data;
+	// NOTE: since v.0.6.0 there is no copy of user-list, just
+	// a replacement of the pointer.
+	m_params.m_auth_engine->update_user_list(
+			cmd->m_auth_data,
+			cmd->m_delta,
+			cmd->m_generation );
 }
 
 void
@@ -88,8 +89,9 @@ a_authentificator_t::on_updated_auth_params(
 						"{}: updated auth-params received", m_params.m_name );
 			} );
 
-	m_denied_ports = cmd->m_denied_ports;
-	m_failed_auth_reply_timeout = cmd->m_failed_auth_reply_timeout;
+	m_params.m_auth_engine->update_auth_params(
+			cmd->m_denied_ports,
+			cmd->m_failed_auth_reply_timeout );
 }
 
 void
@@ -118,102 +120,40 @@ a_authentificator_t::on_auth_request(
 						cmd->m_target_port );
 			} );
 
-	m_auth_stats.m_auth_total_count += 1u;
-
-	if( cmd->m_username )
-		do_auth_by_login_password( *cmd );
-	else
-		do_auth_by_ip( *cmd );
-}
-
-void
-a_authentificator_t::do_auth_by_ip(
-	const auth_request_t & req )
-{
-	const auto it = m_auth_data.m_by_ip.find(
-			::arataga::user_list_auth::auth_by_ip_key_t{
-					req.m_proxy_in_addr,
-					req.m_proxy_port,
-					req.m_user_ip
-			}
-		);
-	if( it == m_auth_data.m_by_ip.end() )
-	{
-		// It is unknown client.
-		m_auth_stats.m_failed_auth_by_ip_count += 1u;
-		complete_failed_auth( req, failure_reason_t::unknown_user );
-	}
-	else
-	{
-		m_auth_stats.m_auth_by_ip_count += 1u;
-
-		// The client is authentificated. Now it should be authorized.
-		const auto authorize_result = try_authorize_user( req );
-		if( authorize_result )
-		{
-			if( failure_reason_t::target_blocked == *authorize_result )
-			{
-				m_auth_stats.m_failed_authorization_denied_port += 1u;
-			}
-
-			// Client isn't authorized, it can't work with arataga.
-			complete_failed_auth( req, *authorize_result );
-		}
-		else
-		{
-			// Client is authorized, it should receive positive response.
-			complete_successful_auth( req, it->second );
-		}
-	}
-}
-
-void
-a_authentificator_t::do_auth_by_login_password(
-	const auth_request_t & req )
-{
-	const auto it = m_auth_data.m_by_login.find(
-			::arataga::user_list_auth::auth_by_login_key_t{
-					req.m_proxy_in_addr,
-					req.m_proxy_port,
-					req.m_username.value(),
-					req.m_password.value_or( std::string{} )
-			}
-		);
-	if( it == m_auth_data.m_by_login.end() )
-	{
-		// It's unknown client.
-		m_auth_stats.m_failed_auth_by_login_count += 1u;
-		complete_failed_auth( req, failure_reason_t::unknown_user );
-	}
-	else
-	{
-		m_auth_stats.m_auth_by_login_count += 1u;
+	auto result = m_params.m_auth_engine->authentificate(
+			auth_params_t{
+				cmd->m_proxy_in_addr,
+				cmd->m_proxy_port,
+				cmd->m_user_ip,
+				cmd->m_username ?
+						std::optional< std::string_view >{ *(cmd->m_username) } :
+						std::nullopt,
+				cmd->m_password ?
+						std::optional< std::string_view >{ *(cmd->m_password) } :
+						std::nullopt,
+				cmd->m_target_host,
+				cmd->m_target_port
+			} );
 
-		// The client is authentificated. Now it should be authorized.
-		const auto authorize_result = try_authorize_user( req );
-		if( authorize_result )
-		{
-			if( failure_reason_t::target_blocked == *authorize_result )
-			{
-				m_auth_stats.m_failed_authorization_denied_port += 1u;
+	std::visit( ::arataga::utils::overloaded{
+			[&]( failed_auth_t & info ) {
+				complete_failed_auth( *cmd, std::move(info) );
+			},
+			[&]( successful_auth_t & info ) {
+				complete_successful_auth( *cmd, std::move(info) );
 			}
-
-			// Client isn't authorized, it can't work with arataga.
-			complete_failed_auth( req, *authorize_result );
-		}
-		else
-		{
-			// Client is authorized, it should receive positive response.
-			complete_successful_auth( req, it->second );
-		}
-	}
+		},
+		result );
 }
 
 void
 a_authentificator_t::complete_failed_auth(
 	const auth_request_t & req,
-	failure_reason_t reason )
+	failed_auth_t result )
 {
+	const auto reply_timeout =
+			m_params.m_auth_engine->failed_auth_reply_timeout();
+
 	::arataga::logging::direct_mode::debug(
 			[&]( auto & logger, auto level )
 			{
@@ -224,8 +164,8 @@ a_authentificator_t::complete_failed_auth(
 								"user_ip={}, username={} (password={})",
 						m_params.m_name,
 						req.m_req_id,
-						to_string_view( reason ),
-						m_failed_auth_reply_timeout,
+						to_string_view( result.m_reason ),
+						reply_timeout,
 						fmt::streamed(req.m_user_ip),
 						opt_username_dumper_t{req.m_username},
 						opt_password_dumper_t{req.m_password} );
@@ -233,26 +173,17 @@ a_authentificator_t::complete_failed_auth(
 
 	so_5::send_delayed< auth_reply_t >(
 			req.m_reply_to,
-			m_failed_auth_reply_timeout,
+			reply_timeout,
 			req.m_req_id,
 			req.m_completion_token,
-			auth_result_t{ failed_auth_t{ reason } } );
+			auth_result_t{ std::move(result) } );
 }
 
 void
 a_authentificator_t::complete_successful_auth(
 	const auth_request_t & req,
-	const ::arataga::user_list_auth::user_data_t & user_data )
+	successful_auth_t result )
 {
-	successful_auth_t result;
-	result.m_user_id = user_data.m_user_id;
-	result.m_user_bandlims = user_data.m_bandlims;
-
-	// Try to find an individual limit for the target domain.
-	result.m_domain_limits = try_detect_domain_limits(
-			user_data,
-			req.m_target_host );
-
 	::arataga::logging::direct_mode::debug(
 			[&]( auto & logger, auto level )
 			{
@@ -270,42 +201,6 @@ a_authentificator_t::complete_successful_auth(
 			auth_result_t{ std::move(result) } );
 }
 
-std::optional< failure_reason_t >
-a_authentificator_t::try_authorize_user(
-	const auth_request_t & req )
-{
-	std::optional< failure_reason_t > result;
-
-	// Client can't access a denied port.
-	if( m_denied_ports.is_denied( req.m_target_port ) )
-		result = failure_reason_t::target_blocked;
-
-	return result;
-}
-
-std::optional< one_domain_limit_t >
-a_authentificator_t::try_detect_domain_limits(
-	const ::arataga::user_list_auth::user_data_t & user_data,
-	const std::string & target_host ) const
-{
-	std::optional< one_domain_limit_t > result;
-
-	// The first step: try to find a list of limits for the user,
-	// it such list exists.
-	if( const auto it_list = m_auth_data.m_site_limits.find(
-			::arataga::user_list_auth::site_limits_key_t{
-					user_data.m_site_limits_id
-			} );
-			it_list != m_auth_data.m_site_limits.end() )
-	{
-		// If that list is found look for the target domain in the list.
-		result = it_list->second.try_find_limits_for(
-				::arataga::user_list_auth::domain_name_t{ target_host } );
-	}
-
-	return result;
-}
-
 //
 // introduce_authentificator
 //
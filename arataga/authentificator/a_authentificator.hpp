@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <arataga/authentificator/auth_engine.hpp>
 #include <arataga/authentificator/pub.hpp>
 
 #include <arataga/user_list_processor/notifications.hpp>
@@ -20,6 +21,12 @@ namespace arataga::authentificator
  * @brief Agent that performs authentification and authorization
  * of clients.
  *
+ * @note
+ * Since v.0.6.0 the authentification itself is performed by
+ * auth_engine_t. ACLs call the engine directly, the agent keeps
+ * the engine up to date and serves requests from other parts of
+ * the application.
+ *
  * @attention
  * The subscription to config updates is made in so_evt_start(), not
  * in so_define_agent() as usual. It's because in so_define_agent()
@@ -50,23 +57,6 @@ private:
 	//! Initial params for the agent.
 	const params_t m_params;
 
-	//! Local stats for the agent.
-	::arataga::stats::auth::auth_stats_t m_auth_stats;
-	::arataga::stats::auth::auto_reg_t m_auth_stats_reg;
-
-	//! Local copy of user-list.
-	/*!
-	 * The copy is used for the simplicity of the very first
-	 * version of arataga.
-	 */
-	::arataga::user_list_auth::auth_data_t m_auth_data;
-
-	//! Local copy of denied-ports list.
-	denied_ports_config_t m_denied_ports;
-
-	//! The size of time-out before sending a negative response.
-	std::chrono::milliseconds m_failed_auth_reply_timeout{ 750 };
-
 	//! Handler for updates of user-list.
 	void
 	on_updated_user_list(
@@ -82,43 +72,17 @@ private:
 	on_auth_request(
 		mhood_t< auth_request_t > cmd );
 
-	//! Authentification by client's IP-address.
-	void
-	do_auth_by_ip(
-		const auth_request_t & req );
-
-	//! Authentification by client's login/password.
-	void
-	do_auth_by_login_password(
-		const auth_request_t & req );
-
 	//! Completion of the failed authentification attempt.
 	void
 	complete_failed_auth(
 		const auth_request_t & req,
-		failure_reason_t reason );
+		failed_auth_t result );
 
 	//! Completion of the successful authentification attempt.
 	void
 	complete_successful_auth(
 		const auth_request_t & req,
-		const ::arataga::user_list_auth::user_data_t & user_data );
-
-	//! An attempt to authorize an authentificated client.
-	/*!
-	 * Return empty value if the client is authorized.
-	 */
-	[[nodiscard]]
-	std::optional< failure_reason_t >
-	try_authorize_user(
-		const auth_request_t & req );
-
-	//! An attempt to find an individual limit for target domain.
-	[[nodiscard]]
-	std::optional< one_domain_limit_t >
-	try_detect_domain_limits(
-		const ::arataga::user_list_auth::user_data_t & user_data,
-		const std::string & target_host ) const;
+		successful_auth_t result );
 };
 
 } /* namespace arataga::authentificator */
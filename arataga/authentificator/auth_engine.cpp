@@ -0,0 +1,203 @@
+/*!
+ * @file
+ * @brief Authentification logic shared by agents of one IO-thread.
+ * @since v.0.6.0
+ */
+
+#include <arataga/authentificator/auth_engine.hpp>
+
+namespace arataga::authentificator
+{
+
+//
+// auth_engine_t
+//
+auth_engine_t::auth_engine_t(
+	std::shared_ptr< ::arataga::stats::auth::auth_stats_reference_manager_t >
+		stats_manager )
+	:	m_auth_stats{
+			std::make_shared< ::arataga::stats::auth::auth_stats_t >()
+		}
+	,	m_auth_stats_reg{ std::move(stats_manager), m_auth_stats }
+	,	m_auth_data{
+			std::make_shared<
+					const ::arataga::user_list_auth::auth_data_index_t >()
+		}
+{}
+
+void
+auth_engine_t::update_user_list(
+	::arataga::user_list_auth::auth_data_snapshot_t auth_data,
+	::arataga::user_list_auth::auth_data_delta_snapshot_t delta,
+	std::uint64_t generation ) noexcept
+{
+	m_auth_data = std::move(auth_data);
+	m_auth_delta = std::move(delta);
+	m_user_list_generation = generation;
+}
+
+void
+auth_engine_t::update_auth_params(
+	const denied_ports_config_t & denied_ports,
+	std::chrono::milliseconds failed_auth_reply_timeout )
+{
+	m_denied_ports = denied_ports;
+	m_failed_auth_reply_timeout = failed_auth_reply_timeout;
+}
+
+auth_result_t
+auth_engine_t::authentificate( const auth_params_t & params )
+{
+	m_auth_stats->m_auth_total_count += 1u;
+
+	if( params.m_username )
+	{
+		const auto * user_data = find_by_login( params );
+		if( !user_data )
+		{
+			// It's unknown client.
+			m_auth_stats->m_failed_auth_by_login_count += 1u;
+			return failed_auth_t{ failure_reason_t::unknown_user };
+		}
+
+		m_auth_stats->m_auth_by_login_count += 1u;
+
+		// The client is authentificated. Now it should be authorized.
+		return authorize_user( params, *user_data );
+	}
+	else
+	{
+		const auto * user_data = find_by_ip( params );
+		if( !user_data )
+		{
+			// It is unknown client.
+			m_auth_stats->m_failed_auth_by_ip_count += 1u;
+			return failed_auth_t{ failure_reason_t::unknown_user };
+		}
+
+		m_auth_stats->m_auth_by_ip_count += 1u;
+
+		// The client is authentificated. Now it should be authorized.
+		return authorize_user( params, *user_data );
+	}
+}
+
+const ::arataga::user_list_auth::user_data_t *
+auth_engine_t::find_by_ip( const auth_params_t & params ) const
+{
+	if( m_auth_delta )
+	{
+		const auto & changes = m_auth_delta->m_by_ip;
+		const auto it = changes.find(
+				::arataga::user_list_auth::auth_by_ip_key_t{
+						params.m_proxy_in_addr,
+						params.m_proxy_port,
+						params.m_user_ip
+				} );
+		if( it != changes.end() )
+			// The user was changed or removed.
+			return it->second ? &*(it->second) : nullptr;
+	}
+
+	return m_auth_data->find_by_ip(
+			params.m_proxy_in_addr,
+			params.m_proxy_port,
+			params.m_user_ip );
+}
+
+const ::arataga::user_list_auth::user_data_t *
+auth_engine_t::find_by_login( const auth_params_t & params ) const
+{
+	const std::string_view password = params.m_password ?
+			*(params.m_password) : std::string_view{};
+
+	// NOTE: the key with strings is created only if there are changes
+	// for users with login/password.
+	if( m_auth_delta && !m_auth_delta->m_by_login.empty() )
+	{
+		const auto & changes = m_auth_delta->m_by_login;
+		const auto it = changes.find(
+				::arataga::user_list_auth::auth_by_login_key_t{
+						params.m_proxy_in_addr,
+						params.m_proxy_port,
+						std::string{ *(params.m_username) },
+						std::string{ password }
+				} );
+		if( it != changes.end() )
+			// The user was changed or removed.
+			return it->second ? &*(it->second) : nullptr;
+	}
+
+	return m_auth_data->find_by_login(
+			params.m_proxy_in_addr,
+			params.m_proxy_port,
+			*(params.m_username),
+			password );
+}
+
+auth_result_t
+auth_engine_t::authorize_user(
+	const auth_params_t & params,
+	const ::arataga::user_list_auth::user_data_t & user_data )
+{
+	// Client can't access a denied port.
+	if( m_denied_ports.is_denied( params.m_target_port ) )
+	{
+		m_auth_stats->m_failed_authorization_denied_port += 1u;
+		return failed_auth_t{ failure_reason_t::target_blocked };
+	}
+
+	successful_auth_t result;
+	result.m_user_id = user_data.m_user_id;
+	result.m_user_bandlims = user_data.m_bandlims;
+	result.m_user_list_generation = m_user_list_generation;
+
+	// Try to find an individual limit for the target domain.
+	result.m_domain_limits = try_detect_domain_limits(
+			user_data,
+			params.m_target_host );
+
+	return result;
+}
+
+std::optional< one_domain_limit_t >
+auth_engine_t::try_detect_domain_limits(
+	const ::arataga::user_list_auth::user_data_t & user_data,
+	std::string_view target_host ) const
+{
+	std::optional< one_domain_limit_t > result;
+
+	if( m_auth_delta )
+	{
+		const auto & changes = m_auth_delta->m_site_limits;
+		const auto it = changes.find(
+				::arataga::user_list_auth::site_limits_key_t{
+						user_data.m_site_limits_id
+				} );
+		if( it != changes.end() )
+		{
+			// Personal limits were changed or removed. The list of
+			// changed limits isn't indexed, so it's scanned.
+			if( it->second )
+				result = it->second->try_find_limits_for(
+						::arataga::user_list_auth::domain_name_t{
+								std::string{ target_host } } );
+
+			return result;
+		}
+	}
+
+	// Since v.0.6.0 the index finds the most specific domain
+	// without a scan of the whole list of limits for the user.
+	if( const auto * limits = m_auth_data->find_domain_limits(
+			user_data.m_site_limits_id,
+			::arataga::user_list_auth::domain_name_t{
+					std::string{ target_host } } ) )
+	{
+		result = *limits;
+	}
+
+	return result;
+}
+
+} /* namespace arataga::authentificator */
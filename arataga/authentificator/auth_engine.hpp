@@ -0,0 +1,206 @@
+/*!
+ * @file
+ * @brief Authentification logic shared by agents of one IO-thread.
+ * @since v.0.6.0
+ */
+
+#pragma once
+
+#include <arataga/authentificator/pub.hpp>
+
+#include <arataga/stats/auth/pub.hpp>
+
+#include <arataga/user_list_auth_index.hpp>
+
+#include <arataga/config.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+namespace arataga::authentificator
+{
+
+//
+// auth_params_t
+//
+/*!
+ * @brief Parameters of one authentification.
+ *
+ * @note
+ * This is a lightweight view: all referenced strings should outlive
+ * the call to auth_engine_t::authentificate().
+ *
+ * @since v.0.6.0
+ */
+struct auth_params_t
+{
+	//! IP address of ACL to that client is connected.
+	ipv4_address_t m_proxy_in_addr;
+	//! TCP-port of ACL to that client is connected.
+	ip_port_t m_proxy_port;
+
+	//! IP address of the client.
+	ipv4_address_t m_user_ip;
+
+	//! Name of the user.
+	std::optional< std::string_view > m_username;
+	//! Password of the user.
+	std::optional< std::string_view > m_password;
+
+	//! The client's target.
+	std::string_view m_target_host;
+	//! TCP-port on the target host where the client want to connect.
+	ip_port_t m_target_port;
+};
+
+//
+// auth_engine_t
+//
+/*!
+ * @brief Authentification and authorization of clients.
+ *
+ * Before v.0.6.0 all this stuff was a part of authentificator-agent
+ * and every authentification required a message to that agent and
+ * a reply message back. But all the data for authentification is in
+ * memory and the agent works on the same IO-thread as ACLs. So since
+ * v.0.6.0 there is a single auth_engine_t object for an IO-thread and
+ * ACLs call it directly.
+ *
+ * The authentificator-agent of the IO-thread updates the engine when
+ * a new user-list or new auth params arrive and handles authentification
+ * requests from other parts of the application (like admin HTTP-entry).
+ *
+ * @attention
+ * This class isn't thread safe. It is intended to be used only on the
+ * IO-thread it belongs to.
+ *
+ * @since v.0.6.0
+ */
+class auth_engine_t
+{
+public:
+	auth_engine_t(
+		std::shared_ptr< ::arataga::stats::auth::auth_stats_reference_manager_t >
+			stats_manager );
+
+	auth_engine_t( const auth_engine_t & ) = delete;
+	auth_engine_t( auth_engine_t && ) = delete;
+
+	//! Replace the current user-list.
+	void
+	update_user_list(
+		::arataga::user_list_auth::auth_data_snapshot_t auth_data,
+		//! Changes for @a auth_data. Can be nullptr.
+		::arataga::user_list_auth::auth_data_delta_snapshot_t delta,
+		std::uint64_t generation ) noexcept;
+
+	//! Replace the current auth params.
+	void
+	update_auth_params(
+		const denied_ports_config_t & denied_ports,
+		std::chrono::milliseconds failed_auth_reply_timeout );
+
+	//! Perform authentification and authorization of a client.
+	/*!
+	 * Stats for authentifications are updated inside that call.
+	 */
+	[[nodiscard]]
+	auth_result_t
+	authentificate( const auth_params_t & params );
+
+	//! Get the generation of the current user-list.
+	/*!
+	 * It's 0 before the receipt of the first update.
+	 */
+	[[nodiscard]]
+	std::uint64_t
+	user_list_generation() const noexcept { return m_user_list_generation; }
+
+	//! Is the port on a target host denied?
+	[[nodiscard]]
+	bool
+	is_denied_port( ip_port_t port ) const noexcept
+	{
+		return m_denied_ports.is_denied( port );
+	}
+
+	//! Get the size of time-out before sending a negative response.
+	[[nodiscard]]
+	std::chrono::milliseconds
+	failed_auth_reply_timeout() const noexcept
+	{
+		return m_failed_auth_reply_timeout;
+	}
+
+private:
+	//! Stats for that IO-thread.
+	std::shared_ptr< ::arataga::stats::auth::auth_stats_t > m_auth_stats;
+	::arataga::stats::auth::auto_reg_t m_auth_stats_reg;
+
+	//! The current snapshot of user-list.
+	/*!
+	 * @note
+	 * It can't be nullptr. It's an empty user-list before the receipt
+	 * of the first update.
+	 */
+	::arataga::user_list_auth::auth_data_snapshot_t m_auth_data;
+
+	//! Changes for m_auth_data.
+	/*!
+	 * They are checked before m_auth_data.
+	 *
+	 * @note
+	 * It can be nullptr if there is no changes.
+	 *
+	 * @since v.0.6.0
+	 */
+	::arataga::user_list_auth::auth_data_delta_snapshot_t m_auth_delta;
+
+	//! The generation of m_auth_data and m_auth_delta.
+	std::uint64_t m_user_list_generation{ 0u };
+
+	//! Local copy of denied-ports list.
+	denied_ports_config_t m_denied_ports;
+
+	//! The size of time-out before sending a negative response.
+	std::chrono::milliseconds m_failed_auth_reply_timeout{ 750 };
+
+	//! Find a user to be authentificated by IP.
+	/*!
+	 * @return nullptr if there is no such user.
+	 *
+	 * @since v.0.6.0
+	 */
+	[[nodiscard]]
+	const ::arataga::user_list_auth::user_data_t *
+	find_by_ip( const auth_params_t & params ) const;
+
+	//! Find a user to be authentificated by login/password.
+	/*!
+	 * @return nullptr if there is no such user.
+	 *
+	 * @since v.0.6.0
+	 */
+	[[nodiscard]]
+	const ::arataga::user_list_auth::user_data_t *
+	find_by_login( const auth_params_t & params ) const;
+
+	//! Authorization of an authentificated client.
+	[[nodiscard]]
+	auth_result_t
+	authorize_user(
+		const auth_params_t & params,
+		const ::arataga::user_list_auth::user_data_t & user_data );
+
+	//! An attempt to find an individual limit for target domain.
+	[[nodiscard]]
+	std::optional< one_domain_limit_t >
+	try_detect_domain_limits(
+		const ::arataga::user_list_auth::user_data_t & user_data,
+		std::string_view target_host ) const;
+};
+
+} /* namespace arataga::authentificator */
@@ -13,6 +13,7 @@
 #include <arataga/utils/overloaded.hpp>
 
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <variant>
 
@@ -40,6 +41,8 @@ using user_id_t = ::arataga::user_list_auth::user_id_t;
 //! Type for holding a limit for a single domain.
 using one_domain_limit_t = ::arataga::user_list_auth::site_limits_data_t::one_limit_t;
 
+class auth_engine_t;
+
 //
 // params_t
 //
@@ -50,6 +53,15 @@ struct params_t
 {
 	//! Unique name of the agent to be used in log messages.
 	std::string m_name;
+
+	//! Authentification engine of the IO-thread.
+	/*!
+	 * The agent updates it when a new user-list or new auth params
+	 * arrive.
+	 *
+	 * @since v.0.6.0
+	 */
+	std::shared_ptr< auth_engine_t > m_auth_engine;
 };
 
 //
@@ -123,6 +135,12 @@ struct successful_auth_t
 
 	//! Personal limit for the target host for that user.
 	std::optional< one_domain_limit_t > m_domain_limits;
+
+	//! The generation of user-list used for the authentification.
+	/*!
+	 * @since v.0.6.0
+	 */
+	std::uint64_t m_user_list_generation{ 0u };
 };
 
 //
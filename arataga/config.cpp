@@ -249,6 +249,44 @@ public:
 	}
 };
 
+//
+// dns_cache_ttl_handler_t
+//
+/*!
+ * @brief Handler for `dns_cache_min_ttl`, `dns_cache_max_ttl` and
+ * `dns_cache_negative_ttl` commands.
+ *
+ * @since v.0.6.0
+ */
+template< std::chrono::seconds config_t::*Field >
+class dns_cache_ttl_handler_t : public command_handler_t
+{
+public:
+	command_handling_result_t
+	try_handle(
+		std::string_view content,
+		config_t & current_cfg ) const override
+	{
+		using namespace restinio::http_field_parsers;
+
+		return perform_parsing(
+			content,
+			parsers::timeout_value_p(),
+			[&]( std::chrono::milliseconds v ) -> command_handling_result_t {
+				const auto ttl =
+						std::chrono::duration_cast< std::chrono::seconds >( v );
+				if( ttl != v )
+				{
+					return failure_t{ "TTL should be a whole number of seconds" };
+				}
+
+				current_cfg.*Field = ttl;
+
+				return success_t{};
+			} );
+	}
+};
+
 //
 // maxconn_handler_t
 //
@@ -422,6 +460,44 @@ public:
 	}
 };
 
+//
+// bandlim_refill_interval_handler_t
+//
+/*!
+ * @brief Handler for `bandlim.refill_interval` command.
+ *
+ * @since v.0.6.0
+ */
+class bandlim_refill_interval_handler_t : public command_handler_t
+{
+public:
+	command_handling_result_t
+	try_handle(
+		std::string_view content,
+		config_t & current_cfg ) const override
+	{
+		using namespace restinio::http_field_parsers;
+
+		return perform_parsing(
+			content,
+			parsers::timeout_value_p(),
+			[&]( std::chrono::milliseconds v ) -> command_handling_result_t {
+				using namespace std::chrono_literals;
+
+				if( v < 1ms || v > 1000ms )
+					return failure_t{
+							fmt::format( "bandlim.refill_interval should be "
+									"in range [1ms, 1s], got {}ms",
+									v.count() )
+					};
+
+				current_cfg.m_common_acl_params.m_bandlim_refill_interval = v;
+
+				return success_t{};
+			} );
+	}
+};
+
 //
 // io_chunk_size_t
 //
@@ -483,6 +559,84 @@ public:
 			} );
 	}
 };
+
+//
+// http_upstream_pool_size_handler_t
+//
+/*!
+ * @brief Handler for `http.upstream.pool_size` command.
+ *
+ * @since v.0.6.0
+ */
+class http_upstream_pool_size_handler_t : public command_handler_t
+{
+public:
+	command_handling_result_t
+	try_handle(
+		std::string_view content,
+		config_t & current_cfg ) const override
+	{
+		using namespace restinio::http_field_parsers;
+
+		return perform_parsing(
+			content,
+			non_negative_decimal_number_p< std::size_t >(),
+			[&]( std::size_t v ) -> command_handling_result_t {
+				current_cfg.m_common_acl_params.m_http_upstream_pool_size = v;
+
+				return success_t{};
+			} );
+	}
+};
+
+//
+// relay_mode_p
+//
+/*!
+ * @brief A producer for the value of relay mode.
+ *
+ * @since v.0.6.0
+ */
+[[nodiscard]]
+static inline auto
+relay_mode_p()
+{
+	using namespace restinio::http_field_parsers;
+
+	return produce< relay_mode_t >(
+			alternatives(
+				exact_p( "copy" ) >> just_result( relay_mode_t::copy ),
+				exact_p( "splice" ) >> just_result( relay_mode_t::splice )
+			)
+		);
+}
+
+//
+// relay_mode_handler_t
+//
+/*!
+ * @brief Handler for `acl.io.relay_mode` command.
+ *
+ * @since v.0.6.0
+ */
+class relay_mode_handler_t : public command_handler_t
+{
+public:
+	command_handling_result_t
+	try_handle(
+		std::string_view content,
+		config_t & current_cfg ) const override
+	{
+		return perform_parsing(
+			content,
+			relay_mode_p(),
+			[&]( relay_mode_t v ) -> command_handling_result_t {
+				current_cfg.m_common_acl_params.m_relay_mode = v;
+				return success_t{};
+			} );
+	}
+};
+
 namespace acl_handler_details
 {
 
@@ -492,10 +646,25 @@ struct in_ip_t { asio::ip::address_v4 m_addr; };
 
 struct out_ip_t { asio::ip::address m_addr; };
 
+struct relay_t { relay_mode_t m_mode; };
+
+struct shards_t { std::size_t m_count; };
+
+struct defer_accept_t { std::chrono::milliseconds m_timeout; };
+
+struct bandlim_in_t { bandlim_config_t::value_t m_value; };
+
+struct bandlim_out_t { bandlim_config_t::value_t m_value; };
+
 using parsed_parameter_t = std::variant<
 		in_port_t,
 		in_ip_t,
-		out_ip_t >;
+		out_ip_t,
+		relay_t,
+		shards_t,
+		defer_accept_t,
+		bandlim_in_t,
+		bandlim_out_t >;
 
 using parameters_container_t = std::vector< parsed_parameter_t >;
 
@@ -539,12 +708,65 @@ make_parser()
 				arataga::utils::parsers::ip_address_p() >> &out_ip_t::m_addr
 			);
 	};
+	const auto relay_p = []{
+		return produce< relay_t >(
+				exact( "relay" ),
+				ows(),
+				symbol( '=' ),
+				ows(),
+				relay_mode_p() >> &relay_t::m_mode
+			);
+	};
+	const auto shards_p = []{
+		return produce< shards_t >(
+				exact( "shards" ),
+				ows(),
+				symbol( '=' ),
+				ows(),
+				non_negative_decimal_number_p< std::size_t >()
+						>> &shards_t::m_count
+			);
+	};
+	const auto defer_accept_p = []{
+		return produce< defer_accept_t >(
+				exact( "defer_accept" ),
+				ows(),
+				symbol( '=' ),
+				ows(),
+				parsers::timeout_value_p() >> &defer_accept_t::m_timeout
+			);
+	};
+	const auto bandlim_in_p = []{
+		return produce< bandlim_in_t >(
+				exact( "bandlim.in" ),
+				ows(),
+				symbol( '=' ),
+				ows(),
+				arataga::utils::parsers::transfer_speed_p()
+						>> &bandlim_in_t::m_value
+			);
+	};
+	const auto bandlim_out_p = []{
+		return produce< bandlim_out_t >(
+				exact( "bandlim.out" ),
+				ows(),
+				symbol( '=' ),
+				ows(),
+				arataga::utils::parsers::transfer_speed_p()
+						>> &bandlim_out_t::m_value
+			);
+	};
 	const auto parsed_parameter_p = [&]{
 		return produce< parsed_parameter_t >(
 				alternatives(
 					in_port_p() >> as_result(),
 					in_ip_p() >> as_result(),
-					out_ip_p() >> as_result()
+					out_ip_p() >> as_result(),
+					relay_p() >> as_result(),
+					shards_p() >> as_result(),
+					defer_accept_p() >> as_result(),
+					bandlim_in_p() >> as_result(),
+					bandlim_out_p() >> as_result()
 				)
 			);
 	};
@@ -597,6 +819,11 @@ class acl_handler_t : public command_handler_t
 		std::optional< acl_config_t::port_t > m_port;
 		std::optional< asio::ip::address_v4 > m_in_ip;
 		std::optional< asio::ip::address > m_out_ip;
+		std::optional< relay_mode_t > m_relay_mode;
+		std::optional< std::size_t > m_shards;
+		std::optional< std::chrono::seconds > m_defer_accept;
+		std::optional< bandlim_config_t::value_t > m_bandlim_in;
+		std::optional< bandlim_config_t::value_t > m_bandlim_out;
 
 		command_handling_result_t
 		operator()( const acl_handler_details::in_port_t & port )
@@ -627,6 +854,66 @@ class acl_handler_t : public command_handler_t
 			m_out_ip = ip.m_addr;
 			return success_t{};
 		}
+
+		command_handling_result_t
+		operator()( const acl_handler_details::relay_t & relay )
+		{
+			if( m_relay_mode )
+				return failure_t{ "relay parameter is already set" };
+
+			m_relay_mode = relay.m_mode;
+			return success_t{};
+		}
+
+		command_handling_result_t
+		operator()( const acl_handler_details::shards_t & shards )
+		{
+			if( m_shards )
+				return failure_t{ "shards parameter is already set" };
+			if( 0u == shards.m_count )
+				return failure_t{ "shards can't be 0" };
+
+			m_shards = shards.m_count;
+			return success_t{};
+		}
+
+		command_handling_result_t
+		operator()( const acl_handler_details::defer_accept_t & v )
+		{
+			if( m_defer_accept )
+				return failure_t{ "defer_accept parameter is already set" };
+
+			const auto timeout =
+					std::chrono::duration_cast< std::chrono::seconds >(
+							v.m_timeout );
+			if( timeout != v.m_timeout )
+				return failure_t{
+						"defer_accept should be a whole number of seconds"
+					};
+
+			m_defer_accept = timeout;
+			return success_t{};
+		}
+
+		command_handling_result_t
+		operator()( const acl_handler_details::bandlim_in_t & v )
+		{
+			if( m_bandlim_in )
+				return failure_t{ "bandlim.in parameter is already set" };
+
+			m_bandlim_in = v.m_value;
+			return success_t{};
+		}
+
+		command_handling_result_t
+		operator()( const acl_handler_details::bandlim_out_t & v )
+		{
+			if( m_bandlim_out )
+				return failure_t{ "bandlim.out parameter is already set" };
+
+			m_bandlim_out = v.m_value;
+			return success_t{};
+		}
 	};
 
 public:
@@ -667,6 +954,19 @@ public:
 						*(params_handler.m_port),
 						*(params_handler.m_in_ip),
 						*(params_handler.m_out_ip) );
+				current_cfg.m_acls.back().m_relay_mode =
+						params_handler.m_relay_mode;
+				current_cfg.m_acls.back().m_shards =
+						params_handler.m_shards.value_or( 1u );
+				current_cfg.m_acls.back().m_defer_accept =
+						params_handler.m_defer_accept.value_or(
+								std::chrono::seconds::zero() );
+				current_cfg.m_acls.back().m_bandlim.m_in =
+						params_handler.m_bandlim_in.value_or(
+								bandlim_config_t::unlimited );
+				current_cfg.m_acls.back().m_bandlim.m_out =
+						params_handler.m_bandlim_out.value_or(
+								bandlim_config_t::unlimited );
 
 				return success_t{};
 			} );
@@ -838,6 +1138,22 @@ operator<<( std::ostream & to, acl_protocol_t proto )
 	return (to << n());
 }
 
+std::ostream &
+operator<<( std::ostream & to, relay_mode_t mode )
+{
+	const auto n = [mode]() noexcept -> const char * {
+		const char * r = "unknown";
+		switch( mode )
+		{
+			case relay_mode_t::copy: r = "copy"; break;
+			case relay_mode_t::splice: r = "splice"; break;
+		}
+		return r;
+	};
+
+	return (to << n());
+}
+
 std::ostream &
 operator<<( std::ostream & to, const acl_config_t & acl )
 {
@@ -846,6 +1162,15 @@ operator<<( std::ostream & to, const acl_config_t & acl )
 			acl.m_port,
 			fmt::streamed(acl.m_in_addr),
 			fmt::streamed(acl.m_out_addr) );
+	if( acl.m_relay_mode )
+		fmt::print( to, ", relay={}", fmt::streamed(*(acl.m_relay_mode)) );
+	if( 1u != acl.m_shards )
+		fmt::print( to, ", shards={}", acl.m_shards );
+	if( std::chrono::seconds::zero() != acl.m_defer_accept )
+		fmt::print( to, ", defer_accept={}s", acl.m_defer_accept.count() );
+	if( !bandlim_config_t::is_unlimited( acl.m_bandlim.m_in ) ||
+			!bandlim_config_t::is_unlimited( acl.m_bandlim.m_out ) )
+		fmt::print( to, ", bandlim=({})", fmt::streamed(acl.m_bandlim) );
 
 	return to;
 }
@@ -901,6 +1226,21 @@ config_parser_t::config_parser_t()
 	m_impl->m_commands.emplace(
 			"dns_cache_cleanup_period"s,
 			std::make_unique< dns_cache_cleanup_period_handler_t >() );
+	m_impl->m_commands.emplace(
+			"dns_cache_min_ttl"s,
+			std::make_unique<
+					dns_cache_ttl_handler_t<
+							&config_t::m_dns_cache_min_ttl > >() );
+	m_impl->m_commands.emplace(
+			"dns_cache_max_ttl"s,
+			std::make_unique<
+					dns_cache_ttl_handler_t<
+							&config_t::m_dns_cache_max_ttl > >() );
+	m_impl->m_commands.emplace(
+			"dns_cache_negative_ttl"s,
+			std::make_unique<
+					dns_cache_ttl_handler_t<
+							&config_t::m_dns_cache_negative_ttl > >() );
 	m_impl->m_commands.emplace(
 			"nserver"s,
 			std::make_unique< nserver_handler_t >() );
@@ -917,6 +1257,9 @@ config_parser_t::config_parser_t()
 					bandlim_single_value_handler_t<
 							&bandlim_config_t::m_out >
 			>() );
+	m_impl->m_commands.emplace(
+			"bandlim.refill_interval"s,
+			std::make_unique< bandlim_refill_interval_handler_t >() );
 
 	m_impl->m_commands.emplace(
 			"denied_ports"s,
@@ -992,6 +1335,13 @@ config_parser_t::config_parser_t()
 							&common_acl_params_t::m_http_negative_response_timeout
 					>
 			>() );
+	m_impl->m_commands.emplace(
+			"timeout.http.upstream_idle"s,
+			std::make_unique<
+					timeout_handler_t<
+							&common_acl_params_t::m_http_upstream_idle_timeout
+					>
+			>() );
 
 	m_impl->m_commands.emplace(
 			"acl.max.conn"s,
@@ -1002,6 +1352,13 @@ config_parser_t::config_parser_t()
 	m_impl->m_commands.emplace(
 			"acl.io.chunk_count"s,
 			std::make_unique< io_chunk_count_handler_t >() );
+	m_impl->m_commands.emplace(
+			"acl.io.relay_mode"s,
+			std::make_unique< relay_mode_handler_t >() );
+
+	m_impl->m_commands.emplace(
+			"http.upstream.pool_size"s,
+			std::make_unique< http_upstream_pool_size_handler_t >() );
 
 	m_impl->m_commands.emplace(
 			"http.limits.request_target"s,
@@ -1089,6 +1446,11 @@ config_parser_t::parse( std::string_view content )
 			"At least one name server IP should be specified"
 		};
 
+	if( result.m_dns_cache_min_ttl > result.m_dns_cache_max_ttl )
+		throw parser_exception_t{
+			"dns_cache_min_ttl can't be greater than dns_cache_max_ttl"
+		};
+
 	return result;
 }
 
@@ -16,6 +16,7 @@
 #include <algorithm>
 #include <chrono>
 #include <memory>
+#include <optional>
 #include <ostream>
 #include <string_view>
 #include <tuple>
@@ -129,6 +130,33 @@ enum class acl_protocol_t
 std::ostream &
 operator<<( std::ostream & to, acl_protocol_t proto );
 
+//
+// relay_mode_t
+//
+/*!
+ * @brief Type of relay engine to be used for the data transfer after
+ * the establishment of connections.
+ *
+ * @since v.0.6.0
+ */
+enum class relay_mode_t
+{
+	//! Data is copied through I/O buffers in the user-space.
+	copy,
+	//! Data is moved through a pipe by splice(2) without copying it
+	//! to the user-space.
+	/*!
+	 * This mode is supported on Linux only. The copy mode is used on
+	 * other platforms or if the splice mode can't be used for
+	 * a connection.
+	 */
+	splice
+};
+
+// For debugging purposes only.
+std::ostream &
+operator<<( std::ostream & to, relay_mode_t mode );
+
 //
 // acl_config_t
 //
@@ -166,6 +194,54 @@ struct acl_config_t
 	 */
 	asio::ip::address m_out_addr;
 
+	//! Personal relay mode for that ACL.
+	/*!
+	 * If it is empty then the value from common_acl_params_t is used.
+	 *
+	 * @since v.0.6.0
+	 */
+	std::optional< relay_mode_t > m_relay_mode;
+
+	//! Count of shards for that ACL.
+	/*!
+	 * If it is greater than 1 then the ACL will be served by several
+	 * IO-threads. Every IO-thread will have its own entry point bound
+	 * with SO_REUSEPORT option.
+	 *
+	 * The actual count of shards can't be greater than the count
+	 * of IO-threads.
+	 *
+	 * @since v.0.6.0
+	 */
+	std::size_t m_shards{ 1u };
+
+	//! Time-out for TCP_DEFER_ACCEPT option of the entry point.
+	/*!
+	 * If it isn't zero then the listening socket is created with
+	 * TCP_DEFER_ACCEPT option and a new connection is passed to the ACL
+	 * only when the first data from the client arrives (or after
+	 * that time-out).
+	 *
+	 * Zero means that the option isn't used.
+	 *
+	 * The option is used only on Linux.
+	 *
+	 * @since v.0.6.0
+	 */
+	std::chrono::seconds m_defer_accept{};
+
+	//! Bandwidth limits for the whole ACL.
+	/*!
+	 * Those limits are applied to the total traffic of all users
+	 * of that ACL (and all shards of that ACL). Personal limits of
+	 * users are applied too.
+	 *
+	 * By default there are no limits for the ACL.
+	 *
+	 * @since v.0.6.0
+	 */
+	bandlim_config_t m_bandlim;
+
 	//! Initializing constructor.
 	acl_config_t(
 		acl_protocol_t protocol,
@@ -185,7 +261,8 @@ struct acl_config_t
 	{
 		const auto tup = []( const auto & v ) {
 			return std::tie( v.m_protocol, v.m_port,
-					v.m_in_addr, v.m_out_addr );
+					v.m_in_addr, v.m_out_addr, v.m_relay_mode, v.m_shards,
+					v.m_defer_accept, v.m_bandlim.m_in, v.m_bandlim.m_out );
 		};
 		return tup( *this ) == tup( b );
 	}
@@ -236,6 +313,18 @@ struct common_acl_params_t
 	 */
 	bandlim_config_t m_client_bandlim;
 
+	/*!
+	 * @brief The interval of the refill for bandwidth limits.
+	 *
+	 * Bandwidth limits are implemented as token buckets. A bucket
+	 * can't hold more data than allowed for that interval. And
+	 * a connection that exceeds its limit will be resumed after
+	 * that interval.
+	 *
+	 * @since v.0.6.0
+	 */
+	std::chrono::milliseconds m_bandlim_refill_interval{ 20 };
+
 	/*!
 	 * @brief Time-out before sending negative authentification response.
 	 */
@@ -258,6 +347,26 @@ struct common_acl_params_t
 	 * @}
 	 */
 
+	/*!
+	 * @brief Max count of idle connections to target hosts.
+	 *
+	 * Connections to target hosts for ordinary HTTP requests are kept
+	 * for reuse by subsequent requests. This value limits the count
+	 * of such connections for one IO-thread.
+	 *
+	 * Value 0 disables the reuse of connections.
+	 *
+	 * @since v.0.6.0
+	 */
+	std::size_t m_http_upstream_pool_size{ 64u };
+
+	/*!
+	 * @brief Time-out for an idle connection to a target host.
+	 *
+	 * @since v.0.6.0
+	 */
+	std::chrono::milliseconds m_http_upstream_idle_timeout{ 4'000 };
+
 	/*!
 	 * @brief The size of one buffer for I/O ops.
 	 *
@@ -286,6 +395,15 @@ struct common_acl_params_t
 	 */
 	std::size_t m_io_chunk_count{ 4u };
 
+	/*!
+	 * @brief The relay engine for the data transfer.
+	 *
+	 * Can be overridden for an ACL by acl_config_t::m_relay_mode.
+	 *
+	 * @since v.0.6.0
+	 */
+	relay_mode_t m_relay_mode{ relay_mode_t::copy };
+
 	/*!
 	 * @brief Constraints for values of HTTP-protocols.
 	 */
@@ -316,6 +434,33 @@ struct config_t
 	 */
 	std::chrono::milliseconds m_dns_cache_cleanup_period{ 30*1000 };
 
+	/*!
+	 * @brief The min time to live for items in DNS cache.
+	 *
+	 * TTL from DNS response is increased to that value.
+	 *
+	 * @since v.0.6.0
+	 */
+	std::chrono::seconds m_dns_cache_min_ttl{ 5 };
+
+	/*!
+	 * @brief The max time to live for items in DNS cache.
+	 *
+	 * TTL from DNS response is decreased to that value.
+	 *
+	 * @since v.0.6.0
+	 */
+	std::chrono::seconds m_dns_cache_max_ttl{ 3600 };
+
+	/*!
+	 * @brief The time to live for negative answers in DNS cache.
+	 *
+	 * Value 0 means that negative answers aren't cached.
+	 *
+	 * @since v.0.6.0
+	 */
+	std::chrono::seconds m_dns_cache_negative_ttl{ 10 };
+
 	/*!
 	 * @brief IPs of name servers to be used.
 	 *
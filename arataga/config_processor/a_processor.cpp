@@ -78,7 +78,9 @@ port_and_in_addr_equal_comparator(
 auto
 make_full_acl_identity_tuple( const acl_config_t & v ) noexcept
 {
-	return std::tie( v.m_port, v.m_in_addr, v.m_out_addr, v.m_protocol );
+	return std::tie( v.m_port, v.m_in_addr, v.m_out_addr, v.m_protocol,
+			v.m_relay_mode, v.m_shards, v.m_defer_accept,
+			v.m_bandlim.m_in, v.m_bandlim.m_out );
 }
 
 // Throws an exception if there is a pair of ACL with the same (port, in_ip).
@@ -161,6 +163,15 @@ a_processor_t::a_processor_t(
 	,	m_params{ std::move(params) }
 	,	m_local_config_file_name{
 			m_params.m_local_config_path / "local-config.cfg" }
+	,	m_authentificated_users{
+			std::make_shared< ::arataga::acl_handler::authentificated_users_t >()
+		}
+	,	m_dns_cache{
+			std::make_shared< ::arataga::dns_resolver::dns_cache_t >()
+		}
+	,	m_dns_lookup_coalescer{
+			std::make_shared< ::arataga::dns_resolver::lookup_coalescer_t >()
+		}
 	,	m_acl_id_seed{ make_initial_acl_req_id_seed() }
 	,	m_own_acl_id_seed{ make_next_acl_req_id_seed( m_acl_id_seed ) }
 {
@@ -228,13 +239,14 @@ a_processor_t::on_get_acl_list(
 				std::string reply;
 
 				for( const auto & racl : m_running_acls )
-				{
-					fmt::format_to(
-							std::back_inserter(reply),
-							"thread #{:>3}, ACL: {}\r\n",
-							racl.m_io_thread_index,
-							fmt::streamed(racl.m_config) );
-				}
+					for( const auto & shard : racl.m_shards )
+					{
+						fmt::format_to(
+								std::back_inserter(reply),
+								"thread #{:>3}, ACL: {}\r\n",
+								shard.m_io_thread_index,
+								fmt::streamed(racl.m_config) );
+					}
 
 				// If we are here then everything is OK.
 				return http_entry::replier_t::reply_params_t{
@@ -500,6 +512,22 @@ void
 a_processor_t::send_updated_config_messages(
 	const config_t & config )
 {
+	// The cache is owned by us, so there is no need to notify
+	// dns_resolver-agents about new TTL limits.
+	m_dns_cache->set_ttl_limits(
+			config.m_dns_cache_min_ttl,
+			config.m_dns_cache_max_ttl );
+	m_dns_cache->set_negative_ttl( config.m_dns_cache_negative_ttl );
+
+	// The info about authentificated users is owned by us too.
+	// Users are updated lazily, so it's cheap.
+	{
+		std::lock_guard< std::mutex > lock{ m_authentificated_users->lock() };
+		m_authentificated_users->update_default_limits(
+				config.m_common_acl_params.m_client_bandlim,
+				config.m_common_acl_params.m_bandlim_refill_interval );
+	}
+
 	so_5::send< updated_dns_params_t >(
 			m_app_ctx.m_config_updates_mbox,
 			config.m_dns_cache_cleanup_period,
@@ -568,6 +596,12 @@ a_processor_t::create_dispatchers_if_necessary(
 						.use_own_io_context()
 			);
 
+		// All authentifications on the IO-thread are performed by
+		// the same engine.
+		info.m_auth_engine = std::make_shared<
+				::arataga::authentificator::auth_engine_t >(
+						m_app_ctx.m_auth_stats_manager );
+
 		// New authentificator agent should be created for the IO-thread.
 		std::tie( info.m_auth_coop, info.m_auth_mbox ) =
 				::arataga::authentificator::
@@ -577,10 +611,18 @@ a_processor_t::create_dispatchers_if_necessary(
 								info.m_disp.binder(),
 								m_app_ctx,
 								::arataga::authentificator::params_t{
-										fmt::format( "io_thr_{}_auth", i )
+										fmt::format( "io_thr_{}_auth", i ),
+										info.m_auth_engine
 								}
 							);
 
+		// Names that are already in the cache are resolved by ACLs
+		// without dns_resolver-agent.
+		info.m_inline_resolver = std::make_shared<
+				::arataga::dns_resolver::inline_resolver_t >(
+						m_dns_cache,
+						m_app_ctx.m_dns_stats_manager );
+
 		// New dns_resolver agent should be created for the IO-thread.
 		std::tie( info.m_dns_coop, info.m_dns_mbox ) =
 				::arataga::dns_resolver::
@@ -593,7 +635,11 @@ a_processor_t::create_dispatchers_if_necessary(
 										info.m_disp.io_context(),
 										info.m_disp.binder(),
 										fmt::format( "io_thr_{}_dns", i ),
-										config.m_dns_cache_cleanup_period
+										config.m_dns_cache_cleanup_period,
+										config.m_common_acl_params.
+												m_dns_resolving_timeout,
+										m_dns_cache,
+										m_dns_lookup_coalescer
 								}
 							);
 
@@ -606,6 +652,38 @@ a_processor_t::create_dispatchers_if_necessary(
 								info.m_disp.binder(),
 								m_app_ctx );
 
+		// All connections on the IO-thread will share the same
+		// pool of I/O chunks.
+		info.m_io_chunk_pool =
+				std::make_shared< ::arataga::acl_handler::io_chunk_pool_t >(
+						m_app_ctx.m_io_chunk_stats_manager,
+						::arataga::acl_handler::io_chunk_pool_t::
+								default_max_free_chunks );
+
+		// All throttled connections on the IO-thread will be woken up
+		// by the same timer wheel.
+		info.m_pacing_wheel =
+				std::make_shared< ::arataga::acl_handler::pacing_wheel_t >(
+						info.m_disp.io_context() );
+
+		// Timeouts of all connections on the IO-thread are handled
+		// by the same timer wheel.
+		info.m_timeout_wheel =
+				std::make_shared< ::arataga::acl_handler::timeout_wheel_t >(
+						info.m_disp.io_context() );
+
+		// Connections to target hosts can be reused by all ACLs on
+		// the IO-thread (if ACLs have the same external address).
+		info.m_upstream_connection_pool = std::make_shared<
+				::arataga::acl_handler::upstream_connection_pool_t >(
+						info.m_timeout_wheel );
+
+		// Traffic of all connections on the IO-thread is counted
+		// in the same storage.
+		info.m_traffic_stats = std::make_shared<
+				::arataga::stats::traffic::traffic_stats_t >(
+						m_app_ctx.m_traffic_stats_manager );
+
 		m_io_threads.emplace_back( std::move(info) );
 	}
 
@@ -657,9 +735,12 @@ a_processor_t::stop_and_remove_outdated_acls(
 							fmt::streamed(racl.m_config) );
 				} );
 
-		so_5::send< ::arataga::acl_handler::shutdown_t >( racl.m_mbox );
+		for( const auto & shard : racl.m_shards )
+		{
+			so_5::send< ::arataga::acl_handler::shutdown_t >( shard.m_mbox );
 
-		m_io_threads[ racl.m_io_thread_index ].m_running_acl_count -= 1u;
+			m_io_threads[ shard.m_io_thread_index ].m_running_acl_count -= 1u;
+		}
 	}
 }
 
@@ -689,41 +770,66 @@ a_processor_t::launch_new_acls(
 							fmt::streamed(acl_conf) );
 				} );
 
-		// Create ACL ID seed for a new ACL.
-		const auto acl_id_seed = make_next_acl_req_id_seed( m_acl_id_seed );
+		// All shards of the ACL will share the same state.
+		auto shard_group = std::make_shared< ::arataga::acl_handler::shard_group_t >(
+				so_environment().create_mbox() );
 
-		auto & io_thread_info = m_io_threads[ io_thread_index ];
+		running_acl_info_t racl{ acl_conf };
+
+		// Shards are placed on consecutive IO-threads starting from
+		// the current one.
+		const auto shards_count = actual_shards_count( acl_conf );
+		for( std::size_t i = 0u; i != shards_count; ++i )
+		{
+			const auto shard_io_thread_index =
+					(io_thread_index + i) % m_io_threads.size();
+
+			// Create ACL ID seed for a new shard.
+			const auto acl_id_seed = make_next_acl_req_id_seed( m_acl_id_seed );
+
+			auto & io_thread_info = m_io_threads[ shard_io_thread_index ];
+
+			// Now the new shard can be created.
+			racl.m_shards.push_back( running_acl_info_t::shard_info_t{
+					shard_io_thread_index,
+					::arataga::acl_handler::introduce_acl_handler(
+							so_environment(),
+							// NOTE: timer_provider_coop is used as the parent!
+							io_thread_info.m_timer_provider_coop,
+							io_thread_info.m_disp.binder(),
+							m_app_ctx,
+							::arataga::acl_handler::params_t{
+									io_thread_info.m_disp.io_context(),
+									acl_conf,
+									io_thread_info.m_dns_mbox,
+									io_thread_info.m_inline_resolver,
+									io_thread_info.m_auth_engine,
+									io_thread_info.m_io_chunk_pool,
+									io_thread_info.m_pacing_wheel,
+									io_thread_info.m_timeout_wheel,
+									io_thread_info.m_upstream_connection_pool,
+									io_thread_info.m_traffic_stats,
+									shard_group,
+									m_authentificated_users,
+									fmt::format( "{}-{}-{}-io_thr_{}-v{}",
+											fmt::streamed(acl_conf.m_protocol),
+											acl_conf.m_port,
+											fmt::streamed(acl_conf.m_in_addr),
+											shard_io_thread_index,
+											m_config_update_counter ),
+									acl_id_seed,
+									config.m_common_acl_params
+							}
+					)
+			} );
+
+			// We should know that this IO-thread holds one more ACL.
+			io_thread_info.m_running_acl_count += 1u;
+		}
 
-		// Now the new ACL can be created.
-		m_running_acls.emplace_back(
-				acl_conf,
-				io_thread_index,
-				::arataga::acl_handler::introduce_acl_handler(
-						so_environment(),
-						// NOTE: timer_provider_coop is used as the parent!
-						io_thread_info.m_timer_provider_coop,
-						io_thread_info.m_disp.binder(),
-						m_app_ctx,
-						::arataga::acl_handler::params_t{
-								io_thread_info.m_disp.io_context(),
-								acl_conf,
-								io_thread_info.m_dns_mbox,
-								io_thread_info.m_auth_mbox,
-								*(io_thread_info.m_timer_provider),
-								fmt::format( "{}-{}-{}-io_thr_{}-v{}",
-										fmt::streamed(acl_conf.m_protocol),
-										acl_conf.m_port,
-										fmt::streamed(acl_conf.m_in_addr),
-										io_thread_index,
-										m_config_update_counter ),
-								acl_id_seed,
-								config.m_common_acl_params
-						}
-				)
-		);
-
-		// We should know that this IO-thread holds one more ACL.
-		io_thread_info.m_running_acl_count += 1u;
+		m_running_acls.push_back( std::move(racl) );
+
+		auto & io_thread_info = m_io_threads[ io_thread_index ];
 
 		// Try to switch to another IO-thread.
 		// Do that only if the next IO-thread (or the first if the current
@@ -742,6 +848,20 @@ a_processor_t::launch_new_acls(
 			} );
 }
 
+std::size_t
+a_processor_t::actual_shards_count(
+	const acl_config_t & acl_conf ) const noexcept
+{
+	// Several entry points for the same endpoint can't be created
+	// without SO_REUSEPORT.
+	if( !::arataga::acl_handler::shard_group_t::sharding_supported )
+		return 1u;
+
+	// There is no sense to have more shards than IO-threads.
+	return std::max< std::size_t >( 1u,
+			std::min( acl_conf.m_shards, m_io_threads.size() ) );
+}
+
 std::size_t
 a_processor_t::index_of_io_thread_with_lowest_acl_count() const noexcept
 {
@@ -870,7 +990,7 @@ a_processor_t::initiate_debug_auth_processing(
 		// ACL found. The request will be sent to authentificator agent
 		// from ACL's IO-thread.
 		const so_5::mbox_t auth_mbox =
-				m_io_threads.at( it->m_io_thread_index ).m_auth_mbox;
+				m_io_threads.at( it->m_shards.front().m_io_thread_index ).m_auth_mbox;
 
 		// Make and fill the request object...
 		auto auth_msg = std::make_unique< auth::auth_request_t >();
@@ -971,7 +1091,7 @@ a_processor_t::initiate_debug_dns_resolve_processing(
 		// ACL found. The request will be sent to the dns_resolver agent
 		// from ACL's IO-thread.
 		const so_5::mbox_t dns_mbox =
-				m_io_threads.at( it->m_io_thread_index ).m_dns_mbox;
+				m_io_threads.at( it->m_shards.front().m_io_thread_index ).m_dns_mbox;
 
 		// Create and fill the request object...
 		auto dns_msg = std::make_unique< dns::resolve_request_t >();
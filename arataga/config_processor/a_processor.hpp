@@ -6,11 +6,19 @@
 #pragma once
 
 #include <arataga/config_processor/pub.hpp>
+#include <arataga/authentificator/auth_engine.hpp>
 #include <arataga/authentificator/pub.hpp>
+#include <arataga/dns_resolver/inline_resolver.hpp>
 #include <arataga/dns_resolver/pub.hpp>
 
 #include <arataga/io_thread_timer/ifaces.hpp>
 
+#include <arataga/acl_handler/authentificated_users.hpp>
+#include <arataga/acl_handler/io_chunk_pool.hpp>
+#include <arataga/acl_handler/pacing_wheel.hpp>
+#include <arataga/acl_handler/timeout_wheel.hpp>
+#include <arataga/acl_handler/upstream_connection_pool.hpp>
+
 #include <arataga/utils/acl_req_id.hpp>
 
 #include <arataga/config.hpp>
@@ -50,22 +58,34 @@ public:
 	//! The description for one running ACL.
 	struct running_acl_info_t
 	{
+		//! The description of one shard of the ACL.
+		/*!
+		 * @since v.0.6.0
+		 */
+		struct shard_info_t
+		{
+			//! Index of IO-thread on that the shard works.
+			std::size_t m_io_thread_index;
+
+			//! Shard's mbox.
+			so_5::mbox_t m_mbox;
+		};
+
 		//! Config for that ACL.
 		acl_config_t m_config;
 
-		//! Index of IO-thread on that the ACL works.
-		std::size_t m_io_thread_index;
-
-		//! ACL's mbox.
-		so_5::mbox_t m_mbox;
+		//! Shards of that ACL.
+		/*!
+		 * Since v.0.6.0 an ACL can be served by several acl_handler-agents
+		 * on different IO-threads.
+		 *
+		 * There is always at least one shard for a running ACL.
+		 */
+		std::vector< shard_info_t > m_shards;
 
 		running_acl_info_t(
-			acl_config_t config,
-			std::size_t io_thread_index,
-			so_5::mbox_t mbox )
+			acl_config_t config )
 			:	m_config{ std::move(config) }
-			,	m_io_thread_index{ io_thread_index }
-			,	m_mbox{ std::move(mbox) }
 		{}
 	};
 
@@ -76,11 +96,25 @@ private:
 		//! The dispatcher for acl_handler agents.
 		so_5::extra::disp::asio_one_thread::dispatcher_handle_t m_disp;
 
+		//! Authentification engine for that IO-thread.
+		/*!
+		 * @since v.0.6.0
+		 */
+		std::shared_ptr< ::arataga::authentificator::auth_engine_t >
+				m_auth_engine;
+
 		//! Coop with authentificator-agent for that IO-thread.
 		so_5::coop_handle_t m_auth_coop;
 		//! mbox of authentificator-agent for that IO-thread.
 		so_5::mbox_t m_auth_mbox;
 
+		//! Resolver for names that don't require a lookup.
+		/*!
+		 * @since v.0.6.0
+		 */
+		std::shared_ptr< ::arataga::dns_resolver::inline_resolver_t >
+				m_inline_resolver;
+
 		//! Coop with dns_resolver-agent for that IO-thread.
 		so_5::coop_handle_t m_dns_coop;
 		//! mbox of dns_resolver-agent for that IO-thread.
@@ -91,6 +125,41 @@ private:
 		//! Timer-provider for that IO-thread.
 		io_thread_timer::provider_t * m_timer_provider;
 
+		//! Pool of I/O chunks for that IO-thread.
+		/*!
+		 * @since v.0.6.0
+		 */
+		std::shared_ptr< ::arataga::acl_handler::io_chunk_pool_t >
+				m_io_chunk_pool;
+
+		//! Timer wheel for throttled connections on that IO-thread.
+		/*!
+		 * @since v.0.6.0
+		 */
+		std::shared_ptr< ::arataga::acl_handler::pacing_wheel_t >
+				m_pacing_wheel;
+
+		//! Timer wheel for timeouts of connections on that IO-thread.
+		/*!
+		 * @since v.0.6.0
+		 */
+		std::shared_ptr< ::arataga::acl_handler::timeout_wheel_t >
+				m_timeout_wheel;
+
+		//! Idle connections to target hosts on that IO-thread.
+		/*!
+		 * @since v.0.6.0
+		 */
+		std::shared_ptr< ::arataga::acl_handler::upstream_connection_pool_t >
+				m_upstream_connection_pool;
+
+		//! Counters of transferred data for that IO-thread.
+		/*!
+		 * @since v.0.6.0
+		 */
+		std::shared_ptr< ::arataga::stats::traffic::traffic_stats_t >
+				m_traffic_stats;
+
 		//! How many ACLs work on that IO-thread.
 		std::size_t m_running_acl_count{ 0u };
 	};
@@ -127,6 +196,29 @@ private:
 	 */
 	running_acl_container_t m_running_acls;
 
+	//! The info about authentificated users shared by all ACLs.
+	/*!
+	 * Bandwidth limits of a user are applied to the total traffic
+	 * of the user on all ACLs.
+	 *
+	 * @since v.0.6.0
+	 */
+	const std::shared_ptr< ::arataga::acl_handler::authentificated_users_t >
+			m_authentificated_users;
+
+	//! DNS cache shared by all dns_resolver-agents.
+	/*!
+	 * @since v.0.6.0
+	 */
+	const std::shared_ptr< ::arataga::dns_resolver::dns_cache_t > m_dns_cache;
+
+	//! Registry of ongoing DNS lookups shared by all dns_resolver-agents.
+	/*!
+	 * @since v.0.6.0
+	 */
+	const std::shared_ptr< ::arataga::dns_resolver::lookup_coalescer_t >
+			m_dns_lookup_coalescer;
+
 	//! Counter of configuration updates.
 	/*!
 	 * It's incremented on every successful config update.
@@ -247,6 +339,15 @@ private:
 	launch_new_acls(
 		const config_t & config );
 
+	//! Get the count of shards to be created for an ACL.
+	/*!
+	 * @since v.0.6.0
+	 */
+	[[nodiscard]]
+	std::size_t
+	actual_shards_count(
+		const acl_config_t & acl_conf ) const noexcept;
+
 	[[nodiscard]]
 	std::size_t
 	index_of_io_thread_with_lowest_acl_count() const noexcept;
@@ -0,0 +1,248 @@
+/*!
+ * @file
+ * @brief DNS cache shared by all IO-threads.
+ * @since v.0.6.0
+ */
+
+#include <arataga/dns_resolver/dns_cache.hpp>
+
+#include <algorithm>
+#include <functional>
+
+namespace arataga::dns_resolver
+{
+
+namespace
+{
+
+[[nodiscard]]
+std::chrono::nanoseconds::rep
+to_nanoseconds( dns_cache_t::time_point_t tp ) noexcept
+{
+	return std::chrono::duration_cast< std::chrono::nanoseconds >(
+			tp.time_since_epoch() ).count();
+}
+
+} /* namespace anonymous */
+
+void
+dns_cache_t::set_negative_ttl( std::chrono::seconds ttl ) noexcept
+{
+	m_negative_ttl.store( ttl.count(), std::memory_order_relaxed );
+}
+
+void
+dns_cache_t::set_ttl_limits(
+	std::chrono::seconds min_ttl,
+	std::chrono::seconds max_ttl ) noexcept
+{
+	m_min_ttl.store( min_ttl.count(), std::memory_order_relaxed );
+	m_max_ttl.store( max_ttl.count(), std::memory_order_relaxed );
+}
+
+std::optional< cached_answer_t >
+dns_cache_t::resolve(
+	const std::string & name,
+	ip_version_t ip_version,
+	time_point_t now )
+{
+	auto & shard = shard_for( name );
+
+	std::lock_guard< std::mutex > lock{ shard.m_lock };
+
+	auto & data = shard.data_for( ip_version );
+	const auto it = data.find( name );
+	if( it == data.end() )
+		return std::nullopt;
+
+	auto & info = it->second;
+	if( info.m_expires_at <= now )
+	{
+		// There is no need to wait for the next cleanup.
+		data.erase( it );
+		return std::nullopt;
+	}
+
+	if( info.m_addresses.empty() )
+		return cached_answer_t{
+				negative_answer_t{ info.m_failure_description }
+			};
+
+	const auto index = info.m_next_address;
+	info.m_next_address = (index + 1u) % info.m_addresses.size();
+
+	return cached_answer_t{ info.m_addresses[ index ] };
+}
+
+void
+dns_cache_t::add_records(
+	const std::string & name,
+	ip_version_t ip_version,
+	const address_container_t & addresses,
+	std::chrono::seconds time_to_live,
+	time_point_t now )
+{
+	if( addresses.empty() )
+		return;
+
+	const std::chrono::seconds ttl = std::max(
+			std::chrono::seconds{ m_min_ttl.load( std::memory_order_relaxed ) },
+			std::min(
+					time_to_live,
+					std::chrono::seconds{
+							m_max_ttl.load( std::memory_order_relaxed ) } ) );
+	if( ttl <= std::chrono::seconds::zero() )
+		return;
+
+	// NOTE: the copy is made before the acquisition of the lock.
+	// If there will be an exception the content of the cache won't
+	// be changed.
+	store( name, ip_version, resolve_info_t{ addresses, {}, now + ttl } );
+}
+
+void
+dns_cache_t::add_negative_answer(
+	const std::string & name,
+	ip_version_t ip_version,
+	std::string description,
+	time_point_t now )
+{
+	const std::chrono::seconds ttl{
+			m_negative_ttl.load( std::memory_order_relaxed )
+		};
+	if( ttl <= std::chrono::seconds::zero() )
+		return;
+
+	store(
+			name,
+			ip_version,
+			resolve_info_t{ {}, std::move(description), now + ttl } );
+}
+
+std::size_t
+dns_cache_t::remove_outdated_records(
+	time_point_t now,
+	std::chrono::milliseconds cleanup_period )
+{
+	// Only one of the concurrent callers will do the cleanup.
+	const auto now_ns = to_nanoseconds( now );
+	auto cleaned_up_at = m_cleaned_up_at.load( std::memory_order_relaxed );
+	if( cleaned_up_at != 0 &&
+			now_ns - cleaned_up_at <
+					std::chrono::nanoseconds{ cleanup_period }.count() )
+		return 0u;
+	if( !m_cleaned_up_at.compare_exchange_strong(
+			cleaned_up_at, now_ns, std::memory_order_relaxed ) )
+		return 0u;
+
+	std::size_t n_removed{};
+
+	for( auto & shard : m_shards )
+	{
+		std::lock_guard< std::mutex > lock{ shard.m_lock };
+
+		for( auto & data : shard.m_data )
+		{
+			for( auto it = data.begin(); it != data.end(); )
+			{
+				if( it->second.m_expires_at <= now )
+				{
+					it = data.erase( it );
+					++n_removed;
+				}
+				else
+					++it;
+			}
+		}
+	}
+
+	return n_removed;
+}
+
+void
+dns_cache_t::clear()
+{
+	for( auto & shard : m_shards )
+	{
+		std::lock_guard< std::mutex > lock{ shard.m_lock };
+
+		for( auto & data : shard.m_data )
+			data.clear();
+	}
+}
+
+std::size_t
+dns_cache_t::size() const
+{
+	std::size_t result{};
+
+	for( const auto & shard : m_shards )
+	{
+		std::lock_guard< std::mutex > lock{ shard.m_lock };
+
+		for( const auto & data : shard.m_data )
+			result += data.size();
+	}
+
+	return result;
+}
+
+void
+dns_cache_t::dump( std::ostream & o, time_point_t now ) const
+{
+	o << "[";
+
+	for( const auto & shard : m_shards )
+	{
+		std::lock_guard< std::mutex > lock{ shard.m_lock };
+
+		for( std::size_t i = 0u; i != shard.m_data.size(); ++i )
+		{
+			for( const auto & [name, info] : shard.m_data[ i ] )
+			{
+				o << "{" << "{name " << name << "}";
+				o << "{ip_version " << (0u == i ? "IPv4" : "IPv6") << "}";
+				o << "{ttl_sec " << std::chrono::duration_cast<
+						std::chrono::seconds >( info.m_expires_at - now ).count()
+					<< "}";
+				if( info.m_addresses.empty() )
+					o << "{failure " << info.m_failure_description << "}";
+				o << "[";
+
+				for( const auto & addr : info.m_addresses )
+				{
+					o << "{ip " << addr.to_string() << "}";
+				}
+
+				o << "]" << "}";
+			}
+		}
+	}
+
+	o << "]";
+}
+
+dns_cache_t::shard_t &
+dns_cache_t::shard_for( const std::string & name ) noexcept
+{
+	const auto h = std::hash< std::string >{}( name );
+	// The high bits are mixed in because the low bits are also
+	// used by unordered_map for the bucket index.
+	return m_shards[ (h ^ (h >> 29u)) % shards_count ];
+}
+
+void
+dns_cache_t::store(
+	const std::string & name,
+	ip_version_t ip_version,
+	resolve_info_t info )
+{
+	auto & shard = shard_for( name );
+
+	std::lock_guard< std::mutex > lock{ shard.m_lock };
+
+	shard.data_for( ip_version ).insert_or_assign( name, std::move(info) );
+}
+
+} /* namespace arataga::dns_resolver */
+
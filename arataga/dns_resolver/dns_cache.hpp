@@ -0,0 +1,272 @@
+/*!
+ * @file
+ * @brief DNS cache shared by all IO-threads.
+ * @since v.0.6.0
+ */
+
+#pragma once
+
+#include <arataga/ip_version.hpp>
+
+#include <asio/ip/address.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace arataga::dns_resolver
+{
+
+//
+// negative_answer_t
+//
+/*!
+ * @brief A cached negative answer from a name server.
+ *
+ * @since v.0.6.0
+ */
+struct negative_answer_t
+{
+	//! Description of the failure.
+	std::string m_description;
+};
+
+//
+// cached_answer_t
+//
+/*!
+ * @brief Type of the result of a lookup in dns_cache_t.
+ *
+ * @since v.0.6.0
+ */
+using cached_answer_t = std::variant< asio::ip::address, negative_answer_t >;
+
+//
+// dns_cache_t
+//
+/*!
+ * @brief Cache for the results of DNS lookups shared by all IO-threads.
+ *
+ * Every IO-thread has its own lookup_conductor-agents. If every
+ * conductor holds its own cache then a popular domain is looked up
+ * once per IO-thread. So there is just one cache for the whole
+ * process.
+ *
+ * The cache is keyed by (name, ip_version). The content is split into
+ * shards by the hash of the name, every shard is protected by its own
+ * mutex. So conductors from different IO-threads rarely wait for each
+ * other.
+ *
+ * Every item lives for the TTL from the DNS response clamped to the
+ * [min, max] range (see set_ttl_limits()). All addresses from the
+ * response are stored and resolve() returns them in round-robin order.
+ *
+ * Negative answers (like NXDOMAIN) are also cached, but for the time set
+ * by set_negative_ttl(). It prevents a flood of lookups for a domain that
+ * can't be resolved.
+ *
+ * @since v.0.6.0
+ */
+class dns_cache_t
+{
+public:
+	//! Type of container for addresses of a domain.
+	using address_container_t = std::vector< asio::ip::address >;
+
+	//! Type of time point used by the cache.
+	using time_point_t = std::chrono::steady_clock::time_point;
+
+	//! Count of shards.
+	static constexpr std::size_t shards_count = 16u;
+
+	dns_cache_t() = default;
+
+	dns_cache_t( const dns_cache_t & ) = delete;
+	dns_cache_t( dns_cache_t && ) = delete;
+
+	//! Set the range for TTL of new items.
+	/*!
+	 * The new range is applied to items added after the call only.
+	 *
+	 * @attention
+	 * @a min_ttl shouldn't be greater than @a max_ttl.
+	 */
+	void
+	set_ttl_limits(
+		std::chrono::seconds min_ttl,
+		std::chrono::seconds max_ttl ) noexcept;
+
+	//! Set the time to live for negative answers.
+	/*!
+	 * Value 0 disables caching of negative answers.
+	 *
+	 * The new value is applied to items added after the call only.
+	 */
+	void
+	set_negative_ttl( std::chrono::seconds ttl ) noexcept;
+
+	/*!
+	 * @brief Perform the resolution of a domain name.
+	 *
+	 * If there are several addresses for the name then the next one
+	 * is returned on every call.
+	 *
+	 * @return IP-address or negative answer if name is present in
+	 * the cache and isn't outdated or empty value otherwise.
+	 */
+	[[nodiscard]]
+	std::optional< cached_answer_t >
+	resolve(
+		//! Domain name to be resolved.
+		const std::string & name,
+		//! The required version of IP.
+		ip_version_t ip_version,
+		//! The current time.
+		time_point_t now );
+
+	/*!
+	 * @brief Add an item to the cache.
+	 *
+	 * An existing item for the same (name, ip_version) is replaced.
+	 *
+	 * Nothing is added if @a addresses is empty or TTL (after
+	 * the clamping) is 0.
+	 */
+	void
+	add_records(
+		//! Domain name to be added.
+		const std::string & name,
+		//! Version of IP for @a addresses.
+		ip_version_t ip_version,
+		//! IP-addresses for that domain.
+		const address_container_t & addresses,
+		//! TTL from DNS response.
+		std::chrono::seconds time_to_live,
+		//! The current time.
+		time_point_t now );
+
+	/*!
+	 * @brief Add a negative answer to the cache.
+	 *
+	 * An existing item for the same (name, ip_version) is replaced.
+	 *
+	 * Nothing is added if TTL for negative answers is 0.
+	 */
+	void
+	add_negative_answer(
+		//! Domain name to be added.
+		const std::string & name,
+		//! The required version of IP.
+		ip_version_t ip_version,
+		//! Description of the failure.
+		std::string description,
+		//! The current time.
+		time_point_t now );
+
+	/*!
+	 * @brief Remove outdated items.
+	 *
+	 * This method is called by every lookup_conductor-agent. But there
+	 * is no need to scan the whole cache several times per
+	 * @a cleanup_period, so the call is ignored if the previous cleanup
+	 * was performed less than @a cleanup_period ago.
+	 *
+	 * @return Count of removed items.
+	 */
+	std::size_t
+	remove_outdated_records(
+		//! The current time.
+		time_point_t now,
+		//! The minimal period between cleanups.
+		std::chrono::milliseconds cleanup_period );
+
+	//! Clear the cache.
+	void
+	clear();
+
+	//! Get the count of items in the cache.
+	/*!
+	 * Outdated items that aren't removed yet are counted too.
+	 */
+	[[nodiscard]]
+	std::size_t
+	size() const;
+
+	void
+	dump( std::ostream & o, time_point_t now ) const;
+
+private:
+	//! The data for one resolved domain name.
+	struct resolve_info_t
+	{
+		//! All addresses from DNS response.
+		/*!
+		 * It's empty for a negative answer.
+		 */
+		address_container_t m_addresses;
+
+		//! Description of the failure for a negative answer.
+		std::string m_failure_description;
+
+		//! The time when that item become outdated.
+		time_point_t m_expires_at;
+
+		//! Index of the address to be returned by the next resolve().
+		std::size_t m_next_address{ 0u };
+	};
+
+	//! Type of map for one version of IP.
+	using map_t = std::unordered_map< std::string, resolve_info_t >;
+
+	//! One shard of the cache.
+	struct alignas(64) shard_t
+	{
+		mutable std::mutex m_lock;
+
+		//! Items for IPv4 and IPv6.
+		std::array< map_t, 2u > m_data;
+
+		[[nodiscard]]
+		map_t &
+		data_for( ip_version_t ip_version ) noexcept
+		{
+			return m_data[ ip_version_t::ip_v4 == ip_version ? 0u : 1u ];
+		}
+	};
+
+	//! Min TTL in seconds.
+	std::atomic< std::chrono::seconds::rep > m_min_ttl{ 5 };
+
+	//! Max TTL in seconds.
+	std::atomic< std::chrono::seconds::rep > m_max_ttl{ 3600 };
+
+	//! TTL for negative answers in seconds.
+	std::atomic< std::chrono::seconds::rep > m_negative_ttl{ 10 };
+
+	//! The time of the last cleanup (in nanoseconds of steady_clock).
+	std::atomic< std::chrono::nanoseconds::rep > m_cleaned_up_at{ 0 };
+
+	std::array< shard_t, shards_count > m_shards;
+
+	[[nodiscard]]
+	shard_t &
+	shard_for( const std::string & name ) noexcept;
+
+	//! Add or replace an item.
+	void
+	store(
+		const std::string & name,
+		ip_version_t ip_version,
+		resolve_info_t info );
+};
+
+} /* namespace arataga::dns_resolver */
+
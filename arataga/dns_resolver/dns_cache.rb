@@ -0,0 +1,10 @@
+require 'mxx_ru/cpp'
+
+MxxRu::Cpp::lib_target {
+
+	target 'lib/dns_cache'
+
+	required_prj 'asio-prj.rb'
+
+	cpp_source 'dns_cache.cpp'
+}
@@ -0,0 +1,129 @@
+/*!
+ * @file
+ * @brief Resolution of domain names without dns_resolver-agent.
+ * @since v.0.6.0
+ */
+
+#pragma once
+
+#include <arataga/dns_resolver/dns_cache.hpp>
+
+#include <arataga/stats/dns/pub.hpp>
+
+#include <asio/ip/address.hpp>
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <variant>
+
+namespace arataga::dns_resolver
+{
+
+//
+// inline_resolver_t
+//
+/*!
+ * @brief Resolution of domain names that don't require a lookup.
+ *
+ * A request to dns_resolver-agent is a message and a reply is another
+ * message. But very often there is no need for a real lookup: a direct
+ * IP-address is specified as a domain name or the name is already in
+ * the DNS cache. Such cases are handled by that class right on the
+ * caller's thread.
+ *
+ * Only successful answers are returned. Negative answers and
+ * IP-version mismatches are left to dns_resolver-agent because they
+ * are rare and the agent logs them.
+ *
+ * There is one object for an IO-thread. It has its own stats for
+ * cache hits.
+ *
+ * @attention
+ * This class isn't thread safe. It is intended to be used only on the
+ * IO-thread it belongs to.
+ *
+ * @since v.0.6.0
+ */
+class inline_resolver_t
+{
+	//! DNS cache shared by all IO-threads.
+	const std::shared_ptr< dns_cache_t > m_cache;
+
+	//! Stats for that IO-thread.
+	std::shared_ptr< ::arataga::stats::dns::dns_stats_t > m_dns_stats;
+	::arataga::stats::dns::auto_reg_t m_dns_stats_reg;
+
+	[[nodiscard]]
+	static std::optional< asio::ip::address >
+	try_use_direct_ip(
+		const std::string & name,
+		ip_version_t ip_version )
+	{
+		asio::error_code ec;
+		const auto addr = asio::ip::make_address( name, ec );
+		if( ec )
+			// It isn't an IP address.
+			return std::nullopt;
+
+		if( ip_version_t::ip_v4 == ip_version && addr.is_v4() )
+			return addr;
+		if( ip_version_t::ip_v6 == ip_version && addr.is_v6() )
+			return addr;
+		if( ip_version_t::ip_v6 == ip_version && addr.is_v4() )
+			return asio::ip::make_address_v6(
+					asio::ip::v4_mapped, addr.to_v4() );
+
+		// IP versions mismatch.
+		return std::nullopt;
+	}
+
+public:
+	inline_resolver_t(
+		std::shared_ptr< dns_cache_t > cache,
+		std::shared_ptr< ::arataga::stats::dns::dns_stats_reference_manager_t >
+			stats_manager )
+		:	m_cache{ std::move(cache) }
+		,	m_dns_stats{
+				std::make_shared< ::arataga::stats::dns::dns_stats_t >()
+			}
+		,	m_dns_stats_reg{ std::move(stats_manager), m_dns_stats }
+	{}
+
+	inline_resolver_t( const inline_resolver_t & ) = delete;
+	inline_resolver_t( inline_resolver_t && ) = delete;
+
+	//! An attempt to resolve a name without a lookup.
+	/*!
+	 * @return empty value if the name has to be resolved by
+	 * dns_resolver-agent.
+	 */
+	[[nodiscard]]
+	std::optional< asio::ip::address >
+	try_resolve(
+		const std::string & name,
+		ip_version_t ip_version )
+	{
+		if( auto direct_ip = try_use_direct_ip( name, ip_version ) )
+			return direct_ip;
+
+		auto cached = m_cache->resolve(
+				name,
+				ip_version,
+				std::chrono::steady_clock::now() );
+		if( !cached )
+			return std::nullopt;
+
+		// NOTE: negative answers are stored in the cache too.
+		if( const auto * addr = std::get_if< asio::ip::address >( &*cached ) )
+		{
+			m_dns_stats->m_dns_cache_hits += 1u;
+			return *addr;
+		}
+
+		return std::nullopt;
+	}
+};
+
+} /* namespace arataga::dns_resolver */
@@ -13,6 +13,9 @@
 
 #include <fmt/ostream.h>
 
+#include <algorithm>
+#include <optional>
+
 namespace arataga::dns_resolver::interactor
 {
 
@@ -27,10 +30,9 @@ a_nameserver_interactor_t::a_nameserver_interactor_t(
 	:	so_5::agent_t{ std::move(ctx) }
 	,	m_app_ctx{ std::move(app_ctx) }
 	,	m_params{ std::move(params) }
-	// NOTE: just a hardcoded value.
-	// The actual value from config will be received after
+	// NOTE: the actual value from config will be received after
 	// the subscription to config_updates_mbox.
-	,	m_dns_resolving_timeout{ std::chrono::seconds{4} }
+	,	m_dns_resolving_timeout{ m_params.m_dns_resolving_timeout }
 	,	m_socket{ m_params.m_io_ctx }
 {
 }
@@ -450,6 +452,9 @@ a_nameserver_interactor_t::try_handle_positive_nameserver_response(
 
 		// Parse and process resource records.
 		successful_lookup_t::address_container_t ips;
+		// The addresses can't be used longer than the minimal TTL
+		// of their records.
+		std::optional< oess_2::uint_t > min_ttl;
 		for( oess_2::ushort_t answer_i{};
 				answer_i < header.m_ancount;
 				++answer_i )
@@ -461,6 +466,7 @@ a_nameserver_interactor_t::try_handle_positive_nameserver_response(
 					qtype_values::AAAA == rr.m_type )
 			{
 				ips.push_back( asio::ip::make_address( rr.m_resource_data ) );
+				min_ttl = std::min( min_ttl.value_or( rr.m_ttl ), rr.m_ttl );
 			}
 		}
 
@@ -484,7 +490,7 @@ a_nameserver_interactor_t::try_handle_positive_nameserver_response(
 
 			so_5::send< lookup_response_t >(
 					it->second.m_reply_to,
-					failed_lookup_t{ "no IPs in name server response" },
+					failed_lookup_t{ "no IPs in name server response", true },
 					it->second.m_result_processor );
 		}
 		else
@@ -493,7 +499,10 @@ a_nameserver_interactor_t::try_handle_positive_nameserver_response(
 
 			so_5::send< lookup_response_t >(
 					it->second.m_reply_to,
-					successful_lookup_t{ std::move(ips) },
+					successful_lookup_t{
+							std::move(ips),
+							std::chrono::seconds{ *min_ttl }
+					},
 					it->second.m_result_processor );
 		}
 	ARATAGA_NOTHROW_BLOCK_END(LOG_THEN_IGNORE)
@@ -541,7 +550,10 @@ a_nameserver_interactor_t::try_handle_negative_nameserver_response(
 				it->second.m_reply_to,
 				failed_lookup_t{
 					fmt::format( "negative name server reply: {}",
-							rcode_values::to_string( header.rcode() ) )
+							rcode_values::to_string( header.rcode() ) ),
+					// Only answers about the domain itself can be cached.
+					rcode_values::name_error == header.rcode() ||
+							rcode_values::server_failure == header.rcode()
 				},
 				it->second.m_result_processor );
 	ARATAGA_NOTHROW_BLOCK_END(LOG_THEN_IGNORE)
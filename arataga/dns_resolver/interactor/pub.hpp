@@ -14,6 +14,7 @@
 
 #include <so_5/all.hpp>
 
+#include <chrono>
 #include <functional>
 #include <variant>
 #include <vector>
@@ -31,6 +32,12 @@ struct successful_lookup_t
 
 	//! The result of domain name resolution.
 	address_container_t m_addresses;
+
+	//! The minimal TTL of records with addresses.
+	/*!
+	 * @since v.0.6.0
+	 */
+	std::chrono::seconds m_time_to_live;
 };
 
 //
@@ -40,6 +47,15 @@ struct successful_lookup_t
 struct failed_lookup_t
 {
 	std::string m_description;
+
+	//! Is it a negative answer from a name server?
+	/*!
+	 * It's true for answers like NXDOMAIN or SERVFAIL that can be cached.
+	 * It's false for timeouts, network errors and so on.
+	 *
+	 * @since v.0.6.0
+	 */
+	bool m_is_negative_answer{ false };
 };
 
 //
@@ -128,6 +144,14 @@ struct params_t
 	 * Intended to be used for logging.
 	 */
 	std::string m_name;
+
+	//! The initial timeout for DNS-lookups.
+	/*!
+	 * It's used until the first config update is received.
+	 *
+	 * @since v.0.6.0
+	 */
+	std::chrono::milliseconds m_dns_resolving_timeout;
 };
 
 //
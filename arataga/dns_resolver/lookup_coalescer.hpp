@@ -0,0 +1,178 @@
+/*!
+ * @file
+ * @brief Coalescing of identical DNS lookups from different IO-threads.
+ * @since v.0.6.0
+ */
+
+#pragma once
+
+#include <arataga/ip_version.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace arataga::dns_resolver
+{
+
+//
+// basic_lookup_coalescer_t
+//
+/*!
+ * @brief Registry of ongoing DNS lookups shared by all IO-threads.
+ *
+ * A lookup_conductor-agent already joins identical requests from its
+ * own IO-thread (see waiting_requests_handler_t). But conductors from
+ * different IO-threads know nothing about each other and every one of
+ * them sends its own request to a name server.
+ *
+ * This class allows only one of them (the leader) to perform the actual
+ * lookup for (name, ip_version). Others become waiters and receive the
+ * result from the leader.
+ *
+ * If a lookup takes too much time (for example, the leader has been
+ * deregistered) the next conductor becomes the new leader. Waiters of
+ * the old leader are kept and will receive the result from the new one.
+ *
+ * A waiter has no guarantee that the result will be delivered. If it
+ * doesn't receive the result during `max_duration` it has to call
+ * try_become_leader() again. It takes over the lookup or waits for
+ * the result of the new leader.
+ *
+ * @tparam Waiter Type of a handle for notification of a waiter.
+ *
+ * @since v.0.6.0
+ */
+template< typename Waiter >
+class basic_lookup_coalescer_t
+{
+public:
+	//! Type of time point used by the coalescer.
+	using time_point_t = std::chrono::steady_clock::time_point;
+
+	//! Type of container for waiters.
+	using waiter_container_t = std::vector< Waiter >;
+
+	basic_lookup_coalescer_t() = default;
+
+	basic_lookup_coalescer_t( const basic_lookup_coalescer_t & ) = delete;
+	basic_lookup_coalescer_t( basic_lookup_coalescer_t && ) = delete;
+
+	/*!
+	 * @brief An attempt to become the leader for a lookup.
+	 *
+	 * If there is no ongoing lookup for (@a name, @a ip_version) or it
+	 * started more than @a max_duration ago the caller becomes the
+	 * leader. Otherwise @a waiter is added to the list of waiters
+	 * (if it isn't there yet).
+	 *
+	 * @return true if the caller has to perform the lookup and then
+	 * call complete().
+	 */
+	[[nodiscard]]
+	bool
+	try_become_leader(
+		const std::string & name,
+		ip_version_t ip_version,
+		Waiter waiter,
+		time_point_t now,
+		std::chrono::milliseconds max_duration )
+	{
+		std::lock_guard< std::mutex > lock{ m_lock };
+
+		auto [it, inserted] = m_lookups.try_emplace(
+				key_t{ name, ip_version } );
+		auto & info = it->second;
+
+		// NOTE: a waiter can come again after the expiration of its wait.
+		auto & waiters = info.m_waiters;
+		const auto it_waiter = std::find(
+				waiters.begin(), waiters.end(), waiter );
+
+		if( inserted || info.m_started_at + max_duration < now )
+		{
+			// The new leader doesn't wait for itself.
+			if( it_waiter != waiters.end() )
+				waiters.erase( it_waiter );
+
+			info.m_started_at = now;
+			return true;
+		}
+
+		if( it_waiter == waiters.end() )
+			waiters.push_back( std::move(waiter) );
+		return false;
+	}
+
+	/*!
+	 * @brief Completion of a lookup.
+	 *
+	 * Info about the lookup is removed.
+	 *
+	 * @note
+	 * The result should be stored in the DNS cache before this call.
+	 * Otherwise another conductor can miss both the cache and the
+	 * coalescer and start a duplicate lookup.
+	 *
+	 * @return waiters to be notified about the result.
+	 */
+	[[nodiscard]]
+	waiter_container_t
+	complete(
+		const std::string & name,
+		ip_version_t ip_version )
+	{
+		waiter_container_t result;
+
+		std::lock_guard< std::mutex > lock{ m_lock };
+
+		const auto it = m_lookups.find( key_t{ name, ip_version } );
+		if( it != m_lookups.end() )
+		{
+			result = std::move( it->second.m_waiters );
+			m_lookups.erase( it );
+		}
+
+		return result;
+	}
+
+	//! Get the count of ongoing lookups.
+	[[nodiscard]]
+	std::size_t
+	size() const
+	{
+		std::lock_guard< std::mutex > lock{ m_lock };
+
+		return m_lookups.size();
+	}
+
+private:
+	//! Type of key for a lookup.
+	using key_t = std::pair< std::string, ip_version_t >;
+
+	//! Info about one ongoing lookup.
+	struct lookup_info_t
+	{
+		//! When the current leader started the lookup.
+		time_point_t m_started_at;
+
+		//! Who waits for the result.
+		waiter_container_t m_waiters;
+	};
+
+	mutable std::mutex m_lock;
+
+	//! Ongoing lookups.
+	/*!
+	 * It holds only lookups that aren't found in the cache, so it is
+	 * expected to be small.
+	 */
+	std::map< key_t, lookup_info_t > m_lookups;
+};
+
+} /* namespace arataga::dns_resolver */
+
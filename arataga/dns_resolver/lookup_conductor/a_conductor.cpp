@@ -18,8 +18,6 @@ namespace arataga::dns_resolver::lookup_conductor
 
 namespace
 {
-	const std::chrono::seconds resolve_info_time_to_live{30};
-
 	[[nodiscard]]
 	std::string
 	to_string( ip_version_t ver )
@@ -36,66 +34,6 @@ namespace
 
 } /* anonymous namespace */
 
-//
-// local_cache_t
-//
-
-std::optional<asio::ip::address>
-local_cache_t::resolve( const std::string & name ) const
-{
-	auto it = m_data.find(name);
-	if( it != m_data.cend() )
-	{
-		return *(it->second.m_addresses.begin());
-	}
-
-	return std::nullopt;
-}
-
-std::size_t
-local_cache_t::remove_outdated_records( const std::chrono::seconds & time_to_live )
-{
-	std::size_t n_removed{};
-
-	for(auto it = m_data.begin(); it != m_data.end(); )
-	{
-		if( it->second.is_outdated(time_to_live) )
-		{
-			it = m_data.erase(it);
-			++n_removed;
-		}
-		else
-			++it;
-	}
-
-	return n_removed;
-}
-
-void
-local_cache_t::add_records(
-	std::string name,
-	const interactor::successful_lookup_t::address_container_t & addresses )
-{
-	m_data.emplace(
-			std::move(name),
-			// NOTE: there can be an exception during the creation of
-			// a copy of `addresses`. That exception will prevent
-			// initialization of new instance of resolve_info_t just
-			// before the call to `emplace`. It means that in the case
-			// of an exception the content of m_data won't be changed.
-			resolve_info_t{
-				// The current timepoint is used as the creation time.
-				std::chrono::steady_clock::now(),
-				addresses
-			} );
-}
-
-void
-local_cache_t::clear()
-{
-	m_data.clear();
-}
-
 //
 // a_dns_resolver
 //
@@ -104,14 +42,20 @@ a_conductor_t::a_conductor_t(
 	application_context_t app_ctx,
 	std::string name,
 	ip_version_t ip_version,
+	std::shared_ptr< dns_cache_t > cache,
+	std::shared_ptr< lookup_coalescer_t > lookup_coalescer,
 	const so_5::mbox_t & incoming_requests_mbox,
-	const so_5::mbox_t & nameserver_interactor_mbox )
+	const so_5::mbox_t & nameserver_interactor_mbox,
+	std::chrono::milliseconds dns_resolving_timeout )
 	:	so_5::agent_t{ std::move(ctx) }
 	,	m_app_ctx{ std::move(app_ctx) }
 	,	m_name{ std::move(name) }
 	,	m_ip_version{ ip_version }
 	,	m_incoming_requests_mbox{ incoming_requests_mbox }
 	,	m_nameserver_interactor_mbox{ nameserver_interactor_mbox }
+	,	m_dns_stats{
+			std::make_shared< ::arataga::stats::dns::dns_stats_t >()
+		}
 	,	m_dns_stats_reg{
 			m_app_ctx.m_dns_stats_manager,
 			m_dns_stats
@@ -120,6 +64,9 @@ a_conductor_t::a_conductor_t(
 	// The actual value from config will be received after
 	// the subscription to config_updates_mbox.
 	,	m_cache_cleanup_period{ std::chrono::seconds{60} }
+	,	m_cache{ std::move(cache) }
+	,	m_lookup_coalescer{ std::move(lookup_coalescer) }
+	,	m_dns_resolving_timeout{ dns_resolving_timeout }
 {}
 
 void
@@ -138,6 +85,10 @@ a_conductor_t::so_define_agent()
 	so_subscribe_self().event( &a_conductor_t::on_clear_cache );
 
 	so_subscribe_self().event( &a_conductor_t::on_lookup_response );
+
+	so_subscribe_self().event( &a_conductor_t::on_coalesced_lookup_result );
+
+	so_subscribe_self().event( &a_conductor_t::on_coalesced_lookup_deadline );
 }
 
 void
@@ -193,34 +144,46 @@ a_conductor_t::on_resolve( const resolve_request_t & msg )
 		// Nothing to do more.
 		return;
 
-	auto resolve = m_cache.resolve( msg.m_name );
+	auto cached = m_cache->resolve(
+			msg.m_name,
+			m_ip_version,
+			std::chrono::steady_clock::now() );
 
-	if( resolve )
+	if( cached )
 	{
+		// NOTE: negative answers are also stored in the cache.
+		forward::resolve_result_t result = std::visit(
+				::arataga::utils::overloaded{
+					[]( const asio::ip::address & addr ) -> forward::resolve_result_t {
+						return forward::successful_resolve_t{ addr };
+					},
+					[]( const negative_answer_t & answer ) -> forward::resolve_result_t {
+						return forward::failed_resolve_t{ answer.m_description };
+					}
+				},
+				*cached );
+
 		::arataga::logging::direct_mode::debug(
 				[&]( auto & logger, auto level )
 				{
 					logger.log(
 							level,
 							"{}: request resolved from cache: id={}, "
-								"name={}, address={}",
+								"name={}, result={}",
 							m_name,
 							msg.m_req_id,
 							msg.m_name,
-							resolve->to_string() );
+							fmt::streamed(result) );
 				} );
 
 		// Update the stats.
-		m_dns_stats.m_dns_cache_hits += 1u;
-
-		forward::successful_resolve_t result{
-			*resolve };
+		m_dns_stats->m_dns_cache_hits += 1u;
 
 		so_5::send< resolve_reply_t >(
 			msg.m_reply_to,
 			msg.m_req_id,
 			msg.m_completion_token,
-			forward::resolve_result_t{ std::move(result) } );
+			std::move(result) );
 
 		::arataga::logging::direct_mode::trace(
 				[&]( auto & logger, auto level )
@@ -245,11 +208,14 @@ a_conductor_t::on_clear_cache( so_5::mhood_t<clear_cache_t> )
 // will be necessary.
 #if 0
 	std::ostringstream o;
-	o << m_cache;
+	m_cache->dump( o, std::chrono::steady_clock::now() );
 #endif
 
-	const auto n_removed = m_cache.remove_outdated_records(
-			resolve_info_time_to_live );
+	// NOTE: the cache is shared by all conductors. Only one of them
+	// will actually do the cleanup during m_cache_cleanup_period.
+	const auto n_removed = m_cache->remove_outdated_records(
+			std::chrono::steady_clock::now(),
+			m_cache_cleanup_period );
 
 	::arataga::logging::direct_mode::debug(
 			[&]( auto & logger, auto level )
@@ -278,6 +244,7 @@ a_conductor_t::on_updated_dns_params(
 			} );
 
 	m_cache_cleanup_period = msg.m_cache_cleanup_period;
+	m_dns_resolving_timeout = msg.m_dns_resolving_timeout;
 }
 
 void
@@ -294,6 +261,133 @@ a_conductor_t::on_lookup_response(
 	ARATAGA_NOTHROW_BLOCK_END(LOG_THEN_IGNORE)
 }
 
+void
+a_conductor_t::on_coalesced_lookup_result(
+	mhood_t< coalesced_lookup_result_t > cmd )
+{
+	ARATAGA_NOTHROW_BLOCK_BEGIN()
+		ARATAGA_NOTHROW_BLOCK_STAGE(log_coalesced_lookup_result)
+
+		::arataga::logging::direct_mode::debug(
+				[&]( auto & logger, auto level )
+				{
+					logger.log(
+							level,
+							"{}: result of coalesced lookup received: name={}",
+							m_name,
+							cmd->m_domain_name );
+				} );
+
+		ARATAGA_NOTHROW_BLOCK_STAGE(complete_waiting_requests)
+
+		complete_waiting_requests( cmd->m_domain_name, cmd->m_result );
+
+		// Just ignore all possible exceptions because a acl_handler
+		// will cancel the current operation because of timeout.
+	ARATAGA_NOTHROW_BLOCK_END(LOG_THEN_IGNORE)
+}
+
+void
+a_conductor_t::on_coalesced_lookup_deadline(
+	mhood_t< coalesced_lookup_deadline_t > cmd )
+{
+	ARATAGA_NOTHROW_BLOCK_BEGIN()
+		ARATAGA_NOTHROW_BLOCK_STAGE(check_coalesced_lookup_deadline)
+
+		// The result could be already received.
+		if( !m_waiting_forward_requests.has_requests( cmd->m_domain_name ) )
+			return;
+
+		::arataga::logging::direct_mode::debug(
+				[&]( auto & logger, auto level )
+				{
+					logger.log(
+							level,
+							"{}: no result of coalesced lookup: name={}",
+							m_name,
+							cmd->m_domain_name );
+				} );
+
+		lead_or_join_lookup( cmd->m_domain_name );
+
+		// Just ignore all possible exceptions because a acl_handler
+		// will cancel the current operation because of timeout.
+	ARATAGA_NOTHROW_BLOCK_END(LOG_THEN_IGNORE)
+}
+
+[[nodiscard]]
+std::chrono::milliseconds
+a_conductor_t::coalesced_lookup_max_duration() const noexcept
+{
+	return m_dns_resolving_timeout * 2;
+}
+
+void
+a_conductor_t::lead_or_join_lookup( const std::string & domain_name )
+{
+	// The same name can be already resolved by a conductor from
+	// another IO-thread. In that case we'll receive the result from it.
+	// If the lookup takes too long we'll do our own.
+	const bool is_leader = m_lookup_coalescer->try_become_leader(
+			domain_name,
+			m_ip_version,
+			so_direct_mbox(),
+			std::chrono::steady_clock::now(),
+			coalesced_lookup_max_duration() );
+	if( !is_leader )
+	{
+		::arataga::logging::direct_mode::debug(
+				[&]( auto & logger, auto level )
+				{
+					logger.log(
+							level,
+							"{}: joined to ongoing lookup: name={}",
+							m_name,
+							domain_name );
+				} );
+
+		// The leader can be lost (for example, it can be deregistered),
+		// so the wait is limited.
+		so_5::send_delayed< coalesced_lookup_deadline_t >(
+				*this,
+				coalesced_lookup_max_duration(),
+				domain_name );
+
+		return;
+	}
+
+	so_5::send< interactor::lookup_request_t >(
+			m_nameserver_interactor_mbox,
+			domain_name,
+			m_ip_version,
+			so_direct_mbox(),
+			// NOTE: there is no need to capture `this` via smart-pointer
+			// because this handler will be returned via message.
+			// That message will be ignored if the agent is already
+			// deregistered.
+			[this, name = domain_name,
+				started_at = std::chrono::steady_clock::now()]
+			( interactor::lookup_result_t lookup_result )
+			{
+				m_dns_stats->m_upstream_rtt.record(
+						std::chrono::steady_clock::now() - started_at );
+
+				handle_lookup_result(
+						std::move(name),
+						std::move(lookup_result) );
+			} );
+
+	::arataga::logging::direct_mode::debug(
+			[&]( auto & logger, auto level )
+			{
+				logger.log(
+						level,
+						"{}: async_resolve initiated: name={}",
+						m_name,
+						domain_name );
+			} );
+}
+
 void
 a_conductor_t::handle_lookup_result(
 	std::string domain_name,
@@ -303,28 +397,12 @@ a_conductor_t::handle_lookup_result(
 	// All exception will go out and will be handled inside
 	// on_lookup_response() event handler.
 
-	auto log_func =
-		[this]( resolve_req_id_t req_id,
-			const forward::resolve_result_t & result )
-		{
-			::arataga::logging::direct_mode::trace(
-					[&]( auto & logger, auto level )
-					{
-						logger.log(
-								level,
-								"{}: resolve reply sent: id={}, result={}",
-								m_name,
-								fmt::streamed(req_id),
-								fmt::streamed(result) );
-					} );
-		};
-
 	const auto success_handler =
-		[this, &domain_name, &log_func]
+		[this, &domain_name]
 		( const interactor::successful_lookup_t & lr )
 		{
 			// The stats for successful DNS lookups has to be updated.
-			m_dns_stats.m_dns_successful_lookups += 1u;
+			m_dns_stats->m_dns_successful_lookups += 1u;
 
 			::arataga::logging::direct_mode::info(
 					[&]( auto & logger, auto level )
@@ -338,26 +416,28 @@ a_conductor_t::handle_lookup_result(
 
 						logger.log(
 								level,
-								"{}: async_resolve success: name={}, results=[{}]",
+								"{}: async_resolve success: name={}, results=[{}], "
+										"ttl={}s",
 								m_name,
 								domain_name,
-								ips );
+								ips,
+								lr.m_time_to_live.count() );
 					} );
 
-			m_cache.add_records( domain_name, lr.m_addresses );
-
-			m_waiting_forward_requests.handle_success(
-				domain_name,
-				lr.m_addresses,
-				log_func );
+			m_cache->add_records(
+					domain_name,
+					m_ip_version,
+					lr.m_addresses,
+					lr.m_time_to_live,
+					std::chrono::steady_clock::now() );
 		};
 
 	const auto failure_handler =
-		[this, &domain_name, &log_func]
+		[this, &domain_name]
 		(const interactor::failed_lookup_t & lr )
 		{
 			// The stats for failed DNS lookups has to be updated.
-			m_dns_stats.m_dns_failed_lookups += 1u;
+			m_dns_stats->m_dns_failed_lookups += 1u;
 
 			::arataga::logging::direct_mode::warn(
 					[&]( auto & logger, auto level )
@@ -370,16 +450,99 @@ a_conductor_t::handle_lookup_result(
 								lr.m_description );
 					} );
 
-			m_waiting_forward_requests.handle_failure(
-				domain_name,
-				forward::failed_resolve_t{ lr.m_description },
-				log_func );
+			// Timeouts and network errors aren't cached, the next
+			// attempt can be successful.
+			if( lr.m_is_negative_answer )
+				m_cache->add_negative_answer(
+						domain_name,
+						m_ip_version,
+						lr.m_description,
+						std::chrono::steady_clock::now() );
+		};
+
+	// The result has to be stored in the cache before the completion
+	// of the coalesced lookup. Otherwise a conductor from another
+	// IO-thread can miss both the cache and the coalescer and start
+	// a duplicate lookup.
+	try
+	{
+		std::visit(
+				::arataga::utils::overloaded{
+						success_handler,
+						failure_handler
+				},
+				lookup_result );
+	}
+	catch( ... )
+	{
+		// Conductors from other IO-threads shouldn't wait for the result
+		// if the cache can't be updated.
+		notify_coalesced_waiters( domain_name, lookup_result );
+		throw;
+	}
+
+	notify_coalesced_waiters( domain_name, lookup_result );
+
+	complete_waiting_requests( domain_name, lookup_result );
+}
+
+void
+a_conductor_t::notify_coalesced_waiters(
+	const std::string & domain_name,
+	const interactor::lookup_result_t & lookup_result )
+{
+	const auto waiters = m_lookup_coalescer->complete(
+			domain_name, m_ip_version );
+
+	for( const auto & mbox : waiters )
+	{
+		// A failure for one waiter shouldn't affect others.
+		ARATAGA_NOTHROW_BLOCK_BEGIN()
+			ARATAGA_NOTHROW_BLOCK_STAGE(send_coalesced_lookup_result)
+
+			so_5::send< coalesced_lookup_result_t >(
+					mbox,
+					domain_name,
+					lookup_result );
+		ARATAGA_NOTHROW_BLOCK_END(LOG_THEN_IGNORE)
+	}
+}
+
+void
+a_conductor_t::complete_waiting_requests(
+	const std::string & domain_name,
+	const interactor::lookup_result_t & lookup_result )
+{
+	auto log_func =
+		[this]( resolve_req_id_t req_id,
+			const forward::resolve_result_t & result )
+		{
+			::arataga::logging::direct_mode::trace(
+					[&]( auto & logger, auto level )
+					{
+						logger.log(
+								level,
+								"{}: resolve reply sent: id={}, result={}",
+								m_name,
+								fmt::streamed(req_id),
+								fmt::streamed(result) );
+					} );
 		};
 
 	std::visit(
 			::arataga::utils::overloaded{
-					success_handler,
-					failure_handler
+				[&]( const interactor::successful_lookup_t & lr ) {
+					m_waiting_forward_requests.handle_success(
+						domain_name,
+						lr.m_addresses,
+						log_func );
+				},
+				[&]( const interactor::failed_lookup_t & lr ) {
+					m_waiting_forward_requests.handle_failure(
+						domain_name,
+						forward::failed_resolve_t{ lr.m_description },
+						log_func );
+				}
 			},
 			lookup_result );
 }
@@ -403,35 +566,7 @@ a_conductor_t::add_to_waiting_and_resolve(
 		req.m_name, req );
 
 	if( need_resolve )
-	{
-		so_5::send< interactor::lookup_request_t >(
-				m_nameserver_interactor_mbox,
-				req.m_name,
-				req.m_ip_version,
-				so_direct_mbox(),
-				// NOTE: there is no need to capture `this` via smart-pointer
-				// because this handler will be returned via message.
-				// That message will be ignored if the agent is already
-				// deregistered.
-				[this, name = req.m_name]
-				( interactor::lookup_result_t lookup_result )
-				{
-					handle_lookup_result(
-							std::move(name),
-							std::move(lookup_result) );
-				} );
-
-		::arataga::logging::direct_mode::debug(
-				[&]( auto & logger, auto level )
-				{
-					logger.log(
-							level,
-							"{}: async_resolve initiated: id={}, name={}",
-							m_name,
-							req.m_req_id,
-							req.m_name );
-				} );
-	}
+		lead_or_join_lookup( req.m_name );
 }
 
 [[nodiscard]]
@@ -533,23 +668,32 @@ add_lookup_conductors_to_coop(
 	so_5::coop_t & coop,
 	application_context_t app_ctx,
 	const std::string & name_prefix,
+	const std::shared_ptr< dns_cache_t > & cache,
+	const std::shared_ptr< lookup_coalescer_t > & lookup_coalescer,
 	const so_5::mbox_t & incoming_requests_mbox,
-	const so_5::mbox_t & nameserver_interactor_mbox )
+	const so_5::mbox_t & nameserver_interactor_mbox,
+	std::chrono::milliseconds dns_resolving_timeout )
 {
 	// For IPv4.
 	coop.make_agent< a_conductor_t >(
 			app_ctx,
 			name_prefix + ".ipv4",
 			ip_version_t::ip_v4,
+			cache,
+			lookup_coalescer,
 			incoming_requests_mbox,
-			nameserver_interactor_mbox );
+			nameserver_interactor_mbox,
+			dns_resolving_timeout );
 	// For IPv6.
 	coop.make_agent< a_conductor_t >(
 			app_ctx,
 			name_prefix + ".ipv6",
 			ip_version_t::ip_v6,
+			cache,
+			lookup_coalescer,
 			incoming_requests_mbox,
-			nameserver_interactor_mbox );
+			nameserver_interactor_mbox,
+			dns_resolving_timeout );
 }
 
 } /* namespace arataga::dns_resolver::lookup_conductor */
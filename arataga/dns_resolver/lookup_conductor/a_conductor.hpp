@@ -6,6 +6,7 @@
 #pragma once
 
 #include <arataga/dns_resolver/pub.hpp>
+#include <arataga/dns_resolver/dns_cache.hpp>
 #include <arataga/dns_resolver/interactor/pub.hpp>
 
 #include <arataga/dns_resolver/lookup_conductor/waiting_requests_handler.hpp>
@@ -16,141 +17,13 @@
 
 #include <asio/ip/tcp.hpp>
 
-#include <map>
 #include <chrono>
 #include <list>
+#include <memory>
 
 namespace arataga::dns_resolver::lookup_conductor
 {
 
-/*!
- * @brief Local cache for resolved domain names.
- *
- * Implemented as a map with the domain name as key. Address and resolution
- * time are stored as values.
- */
-class local_cache_t
-{
-public:
-	local_cache_t() = default;
-	~local_cache_t() = default;
-
-	/*!
-	 * @brief Perform the resolution of a domain name.
-	 *
-	 * @return IP-address if name is present in the cache or empty value
-	 * otherwise.
-	 */
-	[[nodiscard]]
-	std::optional<asio::ip::address>
-	resolve(
-		//! Domain name to be resolved.
-		const std::string & name ) const;
-
-	/*!
-	 * @brief Remove outdated items.
-	 *
-	 * @return Count of removed items.
-	 */
-	std::size_t
-	remove_outdated_records(
-		//! Max age for item in the cache.
-		const std::chrono::seconds & time_to_live );
-
-	/*!
-	 * @brief Add an item to the cache.
-	 */
-	void
-	add_records(
-		//! Domain name to be added.
-		std::string name,
-		//! IP-addresses for that domain.
-		const interactor::successful_lookup_t::address_container_t & addresses );
-
-	/*!
-	 * @brief Clear the cache.
-	 */
-	void
-	clear();
-
-	void dump( std::ostream & o ) const
-	{
-		o << "[";
-
-		for( const auto & elem: m_data )
-		{
-			o << "{" << "{name " << elem.first << "}";
-			o << "{age_sec " << elem.second.age().count() << "}";
-			o << "[";
-
-			for( const auto & addr: elem.second.m_addresses )
-			{
-				o << "{ip " << addr.to_string() << "}";
-			}
-
-			o << "]" << "}";
-		}
-
-		o << "]";
-	}
-
-private:
-
-	/*!
-	 * @brief The data for one resolved domain name.
-	 */
-	struct resolve_info_t
-	{
-		interactor::successful_lookup_t::address_container_t m_addresses;
-
-		std::chrono::steady_clock::time_point m_creation_time;
-
-		resolve_info_t(
-			std::chrono::steady_clock::time_point creation_time,
-			interactor::successful_lookup_t::address_container_t addresses )
-			:	m_addresses{ std::move(addresses) }
-			,	m_creation_time{ std::move(creation_time) }
-		{
-		}
-
-		[[nodiscard]]
-		std::chrono::seconds
-		age() const
-		{
-			return
-				std::chrono::duration_cast<std::chrono::seconds>(
-					std::chrono::steady_clock::now() - m_creation_time );
-		}
-
-		/*!
-		 * @brief Check the age of domain name info.
-		 *
-		 * @return true if domain name info is outdated.
-		 */
-		[[nodiscard]]
-		bool
-		is_outdated( const std::chrono::seconds & time_to_live ) const
-		{
-			return age() >= time_to_live;
-		}
-	};
-
-	/*!
-	 * @brief The map of resolved domain names.
-	 *
-	 * Domain name is used as the key.
-	 */
-	std::map< std::string, resolve_info_t > m_data;
-};
-
-inline std::ostream &
-operator<<( std::ostream & o, const local_cache_t & cache )
-{
-	cache.dump(o);
-
-	return o;
-}
-
 //
 // direct_ip_checking_result_t
 //
@@ -184,10 +57,16 @@ public:
 		std::string name,
 		//! IP version to handle.
 		ip_version_t ip_version,
+		//! DNS cache shared by all conductors.
+		std::shared_ptr< dns_cache_t > cache,
+		//! Registry of ongoing lookups shared by all conductors.
+		std::shared_ptr< lookup_coalescer_t > lookup_coalescer,
 		//! Mbox to be used for subscription to incoming requests.
 		const so_5::mbox_t & incoming_requests_mbox,
 		//! Mbox for outgoing requests to nameserver_interactor.
-		const so_5::mbox_t & nameserver_interactor_mbox );
+		const so_5::mbox_t & nameserver_interactor_mbox,
+		//! The initial timeout for DNS-lookups.
+		std::chrono::milliseconds dns_resolving_timeout );
 
 	void
 	so_define_agent() override;
@@ -202,6 +81,40 @@ private:
 	//! The signal for cache cleanup.
 	struct clear_cache_t final : public so_5::signal_t {};
 
+	//! The result of a lookup performed by another conductor.
+	/*!
+	 * @since v.0.6.0
+	 */
+	struct coalesced_lookup_result_t final : public so_5::message_t
+	{
+		//! Domain name that was resolved.
+		const std::string m_domain_name;
+
+		//! The result of DNS-lookup.
+		const interactor::lookup_result_t m_result;
+
+		coalesced_lookup_result_t(
+			std::string domain_name,
+			interactor::lookup_result_t result )
+			:	m_domain_name{ std::move(domain_name) }
+			,	m_result{ std::move(result) }
+		{}
+	};
+
+	//! The deadline of the wait for a lookup performed by another conductor.
+	/*!
+	 * @since v.0.6.0
+	 */
+	struct coalesced_lookup_deadline_t final : public so_5::message_t
+	{
+		//! Domain name to be resolved.
+		const std::string m_domain_name;
+
+		coalesced_lookup_deadline_t( std::string domain_name )
+			:	m_domain_name{ std::move(domain_name) }
+		{}
+	};
+
 	//! Arataga's context.
 	const application_context_t m_app_ctx;
 
@@ -217,14 +130,32 @@ private:
 	const so_5::mbox_t m_nameserver_interactor_mbox;
 
 	//! Agent's stats.
-	::arataga::stats::dns::dns_stats_t m_dns_stats;
+	std::shared_ptr< ::arataga::stats::dns::dns_stats_t > m_dns_stats;
 	::arataga::stats::dns::auto_reg_t m_dns_stats_reg;
 
 	//! The current period for cache cleanup procedures.
 	std::chrono::milliseconds m_cache_cleanup_period;
 
-	//! The local cache for domain name.
-	local_cache_t m_cache;
+	//! The cache for domain names shared by all conductors.
+	/*!
+	 * @since v.0.6.0
+	 */
+	const std::shared_ptr< dns_cache_t > m_cache;
+
+	//! Registry of ongoing lookups shared by all conductors.
+	/*!
+	 * @since v.0.6.0
+	 */
+	const std::shared_ptr< lookup_coalescer_t > m_lookup_coalescer;
+
+	//! The current timeout for DNS-lookups.
+	/*!
+	 * It's used for the detection of lookups that take too long
+	 * in m_lookup_coalescer (see coalesced_lookup_max_duration()).
+	 *
+	 * @since v.0.6.0
+	 */
+	std::chrono::milliseconds m_dns_resolving_timeout;
 
 	//! List of waiting domain names.
 	waiting_requests_handler_t m_waiting_forward_requests;
@@ -253,6 +184,44 @@ private:
 	on_lookup_response(
 		const interactor::lookup_response_t & msg );
 
+	//! Handler for results of lookups performed by other conductors.
+	/*!
+	 * @since v.0.6.0
+	 */
+	void
+	on_coalesced_lookup_result(
+		mhood_t< coalesced_lookup_result_t > cmd );
+
+	//! Handler for the deadline of the wait for a lookup performed
+	//! by another conductor.
+	/*!
+	 * @since v.0.6.0
+	 */
+	void
+	on_coalesced_lookup_deadline(
+		mhood_t< coalesced_lookup_deadline_t > cmd );
+
+	//! The time after that a lookup performed by another conductor
+	//! is treated as lost.
+	/*!
+	 * @since v.0.6.0
+	 */
+	[[nodiscard]]
+	std::chrono::milliseconds
+	coalesced_lookup_max_duration() const noexcept;
+
+	//! Perform the lookup or wait for the result of another conductor.
+	/*!
+	 * If the lookup for @a domain_name is performed by a conductor from
+	 * another IO-thread, the result will be received from it. But if
+	 * the result isn't received in coalesced_lookup_max_duration()
+	 * there will be another attempt to become the leader.
+	 *
+	 * @since v.0.6.0
+	 */
+	void
+	lead_or_join_lookup( const std::string & domain_name );
+
 	//! The reaction to the result of DNS-lookup.
 	void
 	handle_lookup_result(
@@ -261,6 +230,28 @@ private:
 		//! The result of DNS-lookup.
 		interactor::lookup_result_t lookup_result );
 
+	//! Send the result of DNS-lookup to conductors that wait for it.
+	/*!
+	 * @since v.0.6.0
+	 */
+	void
+	notify_coalesced_waiters(
+		//! Domain name that was resolved.
+		const std::string & domain_name,
+		//! The result of DNS-lookup.
+		const interactor::lookup_result_t & lookup_result );
+
+	//! Send the result of DNS-lookup to all waiting requests.
+	/*!
+	 * @since v.0.6.0
+	 */
+	void
+	complete_waiting_requests(
+		//! Domain name that was resolved.
+		const std::string & domain_name,
+		//! The result of DNS-lookup.
+		const interactor::lookup_result_t & lookup_result );
+
 	/*!
 	 * @brief Add a new request to the waiting list or initiate the resolution.
 	 *
@@ -7,6 +7,8 @@
 
 #include <arataga/application_context.hpp>
 
+#include <arataga/dns_resolver/pub.hpp>
+
 #include <so_5/all.hpp>
 
 namespace arataga::dns_resolver::lookup_conductor
@@ -27,10 +29,17 @@ add_lookup_conductors_to_coop(
 	application_context_t app_ctx,
 	//! Unique prefix for agents names.
 	const std::string & name_prefix,
+	//! DNS cache shared by all conductors.
+	const std::shared_ptr< dns_cache_t > & cache,
+	//! Registry of ongoing lookups shared by all conductors.
+	const std::shared_ptr< lookup_coalescer_t > & lookup_coalescer,
 	//! Mbox to be used for subscription to incoming requests.
 	const so_5::mbox_t & incoming_requests_mbox,
 	//! Mbox for outgoing requests to nameserver_interactor.
-	const so_5::mbox_t & nameserver_interactor_mbox );
+	const so_5::mbox_t & nameserver_interactor_mbox,
+	//! The initial timeout for DNS-lookups.
+	//! The actual value will be received with config updates.
+	std::chrono::milliseconds dns_resolving_timeout );
 
 } /* namespace arataga::dns_resolver::lookup_conductor */
 
@@ -104,6 +104,17 @@ public:
 		return need_resolve;
 	}
 
+	//! Are there requests that wait for the result for @a key?
+	/*!
+	 * @since v.0.6.0
+	 */
+	[[nodiscard]]
+	bool
+	has_requests( const std::string & key ) const
+	{
+		return m_waiting_requests.find( key ) != m_waiting_requests.end();
+	}
+
 	/*!
 	 * @brief Handle the result for all requests with the same params.
 	 *
@@ -145,7 +156,7 @@ public:
 	/*!
 	 * @brief Handle the result for all requests with the same params.
 	 *
-	 * All requests receive the same result.
+	 * Requests receive addresses from @a ips in round-robin order.
 	 *
 	 * @param key Key for the request.
 	 * @param ips The container with IPs for @a key.
@@ -168,11 +179,16 @@ public:
 			auto requests = std::move( find->second );
 			m_waiting_requests.erase( find );
 
-			auto result = arataga::dns_resolver::forward::successful_resolve_t {
-					*(ips.begin())
-				};
+			// Spread the load among all servers of the domain.
+			auto next_ip = ips.begin();
 			for( const auto & req_info : requests )
 			{
+				auto result = arataga::dns_resolver::forward::successful_resolve_t {
+						*next_ip
+					};
+				if( ++next_ip == ips.end() )
+					next_ip = ips.begin();
+
 				so_5::send< resolve_reply_t >(
 						req_info.m_reply_to,
 						req_info.m_req_id,
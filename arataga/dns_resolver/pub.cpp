@@ -33,15 +33,19 @@ introduce_dns_resolver(
 			app_ctx,
 			interactor::params_t{
 					params.m_io_ctx,
-					params.m_name + ".interactor"
+					params.m_name + ".interactor",
+					params.m_dns_resolving_timeout
 			} );
 
 	lookup_conductor::add_lookup_conductors_to_coop(
 			*coop_holder,
 			app_ctx,
 			params.m_name + ".conductor",
+			params.m_cache,
+			params.m_lookup_coalescer,
 			dns_mbox,
-			interactor_mbox );
+			interactor_mbox,
+			params.m_dns_resolving_timeout );
 
 	auto h_coop = env.register_coop( std::move(coop_holder) );
 
@@ -8,12 +8,16 @@
 #include <arataga/application_context.hpp>
 #include <arataga/ip_version.hpp>
 
+#include <arataga/dns_resolver/dns_cache.hpp>
+#include <arataga/dns_resolver/lookup_coalescer.hpp>
+
 #include <arataga/utils/acl_req_id.hpp>
 #include <arataga/utils/overloaded.hpp>
 
 #include <asio/io_context.hpp>
 #include <asio/ip/tcp.hpp>
 
+#include <memory>
 #include <variant>
 
 namespace arataga::dns_resolver
@@ -22,6 +26,18 @@ namespace arataga::dns_resolver
 //! Type of ID of resolution request.
 using resolve_req_id_t = ::arataga::utils::acl_req_id_t;
 
+//
+// lookup_coalescer_t
+//
+/*!
+ * @brief Type of registry of ongoing DNS lookups.
+ *
+ * Waiters are notified via their direct mboxes.
+ *
+ * @since v.0.6.0
+ */
+using lookup_coalescer_t = basic_lookup_coalescer_t< so_5::mbox_t >;
+
 //
 // params_t
 //
@@ -49,6 +65,26 @@ struct params_t
 
 	//! Cache cleanup period.
 	std::chrono::milliseconds m_cache_cleanup_period;
+
+	//! The initial timeout for DNS-lookups.
+	/*!
+	 * It's used until the first config update is received.
+	 *
+	 * @since v.0.6.0
+	 */
+	std::chrono::milliseconds m_dns_resolving_timeout;
+
+	//! DNS cache shared by all dns_resolver-agents.
+	/*!
+	 * @since v.0.6.0
+	 */
+	std::shared_ptr< dns_cache_t > m_cache;
+
+	//! Registry of ongoing lookups shared by all dns_resolver-agents.
+	/*!
+	 * @since v.0.6.0
+	 */
+	std::shared_ptr< lookup_coalescer_t > m_lookup_coalescer;
 };
 
 namespace forward
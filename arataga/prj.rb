@@ -18,6 +18,7 @@ MxxRu::Cpp::exe_target {
 	required_prj 'arataga/config.rb'
 	required_prj 'arataga/logging/logging.rb'
 	required_prj 'arataga/user_list_auth_data.rb'
+	required_prj 'arataga/dns_resolver/dns_cache.rb'
 	required_prj 'arataga/acl_handler/connection_handlers.rb'
 
 	lib 'stdc++fs'
@@ -25,6 +26,7 @@ MxxRu::Cpp::exe_target {
 	cpp_source 'admin_http_entry/pub.cpp'
 
 	cpp_source 'stats_collector/a_stats_collector.cpp'
+	cpp_source 'authentificator/auth_engine.cpp'
 	cpp_source 'authentificator/a_authentificator.cpp'
 
 	cpp_source 'dns_resolver/interactor/a_nameserver_interactor.cpp'
@@ -80,6 +80,17 @@ public:
 				std::move(content) );
 	}
 
+	void
+	user_list_delta(
+		::arataga::admin_http_entry::replier_shptr_t replier,
+		std::string_view content ) override
+	{
+		so_5::send< ::arataga::user_list_processor::user_list_delta_t >(
+				m_app_ctx.m_user_list_processor_mbox,
+				std::move(replier),
+				std::move(content) );
+	}
+
 	void
 	get_current_stats(
 		::arataga::admin_http_entry::replier_shptr_t replier ) override
@@ -89,6 +100,26 @@ public:
 				std::move(replier) );
 	}
 
+	void
+	get_traffic_top(
+		::arataga::admin_http_entry::replier_shptr_t replier,
+		std::size_t top_n ) override
+	{
+		so_5::send< ::arataga::stats_collector::get_traffic_top_t >(
+				m_app_ctx.m_stats_collector_mbox,
+				std::move(replier),
+				top_n );
+	}
+
+	void
+	get_metrics(
+		::arataga::admin_http_entry::replier_shptr_t replier ) override
+	{
+		so_5::send< ::arataga::stats_collector::get_metrics_t >(
+				m_app_ctx.m_stats_collector_mbox,
+				std::move(replier) );
+	}
+
 	void
 	debug_authentificate(
 		::arataga::admin_http_entry::replier_shptr_t replier,
@@ -223,6 +254,12 @@ a_manager_t::make_application_context(
 	result.m_dns_stats_manager = ::arataga::stats::dns::
 			make_std_dns_stats_reference_manager();
 
+	result.m_io_chunk_stats_manager = ::arataga::stats::io_chunks::
+			make_std_io_chunk_stats_reference_manager();
+
+	result.m_traffic_stats_manager = ::arataga::stats::traffic::
+			make_std_traffic_stats_reference_manager();
+
 	return result;
 }
 
@@ -247,7 +284,8 @@ a_manager_t::on_enter_wait_user_list_processor()
 			m_app_ctx,
 			ulp::params_t{
 					m_params.m_local_config_path,
-					so_direct_mbox()
+					so_direct_mbox(),
+					m_params.m_io_threads_count
 			} );
 
 	// Limit the time of user_list_processor startup.
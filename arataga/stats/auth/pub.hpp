@@ -127,21 +127,28 @@ public:
 		auth_stats_reference_manager_t && ) = delete;
 
 	//! Add a new auth_stats to the storage.
+	/*!
+	 * Since v.0.6.0 the storage shares the ownership of the object
+	 * because the object can be used by enumerate() after its removal.
+	 */
 	virtual void
-	add( auth_stats_t & stats_object ) = 0;
+	add( std::shared_ptr< auth_stats_t > stats_object ) = 0;
 
 	//! Remove auth_stats from the storage.
+	/*!
+	 * Since v.0.6.0 the storage receives the ownership of the object
+	 * because the object can still be used by enumerate() that is
+	 * running on another thread.
+	 */
 	virtual void
-	remove( auth_stats_t & stats_object ) noexcept = 0;
+	remove( std::shared_ptr< auth_stats_t > stats_object ) noexcept = 0;
 
 	//! Enumerate all objects from the storage.
 	/*!
-	 * For the safety purposes the storage will be blocked to the end
-	 * of the enumeration. It means that add() and remove() will block
-	 * the caller until enumerate() completes.
-	 *
-	 * It also means that calls to add()/remove() from inside enumerate()
-	 * are prohibited.
+	 * Since v.0.6.0 the enumeration is performed for a stable snapshot
+	 * of the storage. add() and remove() don't wait for the completion
+	 * of enumerate(), and objects added or removed during the
+	 * enumeration don't affect it.
 	 */
 	virtual void
 	enumerate( auth_stats_enumerator_t & enumerator ) = 0;
@@ -157,20 +164,20 @@ public:
 class auto_reg_t
 {
 	std::shared_ptr< auth_stats_reference_manager_t > m_manager;
-	auth_stats_t & m_stats;
+	std::shared_ptr< auth_stats_t > m_stats;
 
 public:
 	auto_reg_t(
 		std::shared_ptr< auth_stats_reference_manager_t > manager,
-		auth_stats_t & stats )
+		std::shared_ptr< auth_stats_t > stats )
 		:	m_manager{ std::move(manager) }
-		,	m_stats{ stats }
+		,	m_stats{ std::move(stats) }
 	{
 		m_manager->add( m_stats );
 	}
 	~auto_reg_t()
 	{
-		m_manager->remove( m_stats );
+		m_manager->remove( std::move(m_stats) );
 	}
 
 	// Objects of that class can't be copied or moved.
@@ -5,8 +5,7 @@
 
 #include <arataga/stats/connections/pub.hpp>
 
-#include <mutex>
-#include <set>
+#include <arataga/stats/snapshot_registry.hpp>
 
 namespace arataga::stats::connections
 {
@@ -37,35 +36,27 @@ namespace
 //
 class manager_t final : public acl_stats_reference_manager_t
 {
-	using set_t = std::set< acl_stats_t * >;
-
-	std::mutex m_lock;
-
-	set_t m_objects;
+	snapshot_registry_t< acl_stats_t > m_objects;
 
 public:
 	void
-	add( acl_stats_t & stats_object ) override
+	add( std::shared_ptr< acl_stats_t > stats_object ) override
 	{
-		std::lock_guard< std::mutex > lock{ m_lock };
-
-		m_objects.insert( &stats_object );
+		m_objects.add( std::move(stats_object) );
 	}
 
 	void
-	remove( acl_stats_t & stats_object ) noexcept override
+	remove( std::shared_ptr< acl_stats_t > stats_object ) noexcept override
 	{
-		std::lock_guard< std::mutex > lock{ m_lock };
-
-		m_objects.erase( &stats_object );
+		m_objects.remove( std::move(stats_object) );
 	}
 
 	void
 	enumerate( acl_stats_enumerator_t & enumerator ) override
 	{
-		std::lock_guard< std::mutex > lock{ m_lock };
+		const auto snapshot = m_objects.snapshot();
 
-		for( auto * o : m_objects )
+		for( const auto & o : snapshot.objects() )
 		{
 			const auto r = enumerator.on_next( *o );
 			switch( r )
@@ -5,19 +5,68 @@
 
 #pragma once
 
+#include <arataga/stats/latency_histogram.hpp>
+
+#include <array>
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <string>
 
 namespace arataga::stats::connections
 {
 
+//
+// setup_stage_t
+//
+/*!
+ * @brief Stages of the setup of a connection to a target host.
+ *
+ * @since v.0.6.0
+ */
+enum class setup_stage_t : std::size_t
+{
+	//! From the acceptance of a connection to the detection of
+	//! the protocol.
+	protocol_detection,
+	//! From the acceptance of a connection (or from the start of
+	//! the next request in an HTTP keep-alive connection) to the
+	//! complete parsing of a SOCKS5 command or an HTTP request.
+	/*!
+	 * The time of protocol detection is included.
+	 */
+	handshake,
+	//! DNS lookup for the target host.
+	dns_lookup,
+	//! Authentification of a client.
+	authentification,
+	//! Connection to the target host.
+	connect_target
+};
+
+//! The number of items in setup_stage_t.
+/*!
+ * @since v.0.6.0
+ */
+inline constexpr std::size_t setup_stages_count =
+		static_cast< std::size_t >( setup_stage_t::connect_target ) + 1u;
+
 //
 // acl_stats_t
 //
 //! Stats for a single ACL.
 struct acl_stats_t
 {
+	//! Name of the ACL.
+	/*!
+	 * Several acl_stats objects with the same name can exist if
+	 * the ACL is served by several IO-threads.
+	 *
+	 * @since v.0.6.0
+	 */
+	const std::string m_acl_name;
+
 	//! Total number of connections.
 	std::atomic< std::uint64_t > m_total_connections{};
 	//! Number of connections by HTTP protocol.
@@ -49,6 +98,36 @@ struct acl_stats_t
 	/*!
 	 * @}
 	 */
+
+	//! Latencies of the connection setup stages.
+	/*!
+	 * Items are indexed by setup_stage_t.
+	 *
+	 * @since v.0.6.0
+	 */
+	std::array< latency_histogram_t, setup_stages_count > m_setup_latencies;
+
+	acl_stats_t( std::string acl_name )
+		:	m_acl_name{ std::move(acl_name) }
+	{}
+
+	//! Get the histogram for the @a stage.
+	/*!
+	 * @since v.0.6.0
+	 */
+	[[nodiscard]]
+	latency_histogram_t &
+	setup_latency( setup_stage_t stage ) noexcept
+	{
+		return m_setup_latencies[ static_cast< std::size_t >(stage) ];
+	}
+
+	[[nodiscard]]
+	const latency_histogram_t &
+	setup_latency( setup_stage_t stage ) const noexcept
+	{
+		return m_setup_latencies[ static_cast< std::size_t >(stage) ];
+	}
 };
 
 //
@@ -137,21 +216,28 @@ public:
 		acl_stats_reference_manager_t && ) = delete;
 
 	//! Add a new acl_stats to the storage.
+	/*!
+	 * Since v.0.6.0 the storage shares the ownership of the object
+	 * because the object can be used by enumerate() after its removal.
+	 */
 	virtual void
-	add( acl_stats_t & stats_object ) = 0;
+	add( std::shared_ptr< acl_stats_t > stats_object ) = 0;
 
 	//! Remove acl_stats from the storage.
+	/*!
+	 * Since v.0.6.0 the storage receives the ownership of the object
+	 * because the object can still be used by enumerate() that is
+	 * running on another thread.
+	 */
 	virtual void
-	remove( acl_stats_t & stats_object ) noexcept = 0;
+	remove( std::shared_ptr< acl_stats_t > stats_object ) noexcept = 0;
 
 	//! Enumerate all objects from the storage.
 	/*!
-	 * For the safety purposes the storage will be blocked to the end
-	 * of the enumeration. It means that add() and remove() will block
-	 * the caller until enumerate() completes.
-	 *
-	 * It also means that calls to add()/remove() from inside enumerate()
-	 * are prohibited.
+	 * Since v.0.6.0 the enumeration is performed for a stable snapshot
+	 * of the storage. add() and remove() don't wait for the completion
+	 * of enumerate(), and objects added or removed during the
+	 * enumeration don't affect it.
 	 */
 	virtual void
 	enumerate( acl_stats_enumerator_t & enumerator ) = 0;
@@ -167,20 +253,20 @@ public:
 class auto_reg_t
 {
 	std::shared_ptr< acl_stats_reference_manager_t > m_manager;
-	acl_stats_t & m_stats;
+	std::shared_ptr< acl_stats_t > m_stats;
 
 public:
 	auto_reg_t(
 		std::shared_ptr< acl_stats_reference_manager_t > manager,
-		acl_stats_t & stats )
+		std::shared_ptr< acl_stats_t > stats )
 		:	m_manager{ std::move(manager) }
-		,	m_stats{ stats }
+		,	m_stats{ std::move(stats) }
 	{
 		m_manager->add( m_stats );
 	}
 	~auto_reg_t()
 	{
-		m_manager->remove( m_stats );
+		m_manager->remove( std::move(m_stats) );
 	}
 
 	// Objects of that class can't be copied or moved.
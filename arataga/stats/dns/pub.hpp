@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <arataga/stats/latency_histogram.hpp>
+
 #include <atomic>
 #include <cstdint>
 #include <memory>
@@ -24,6 +26,12 @@ struct dns_stats_t
 	std::atomic< std::uint64_t > m_dns_successful_lookups{};
 	//! Counter for failed lookups.
 	std::atomic< std::uint64_t > m_dns_failed_lookups{};
+
+	//! Round-trip times of lookups performed by name servers.
+	/*!
+	 * @since v.0.6.0
+	 */
+	latency_histogram_t m_upstream_rtt;
 };
 
 //
@@ -113,21 +121,28 @@ public:
 		dns_stats_reference_manager_t && ) = delete;
 
 	//! Add a new dns_stats to the storage.
+	/*!
+	 * Since v.0.6.0 the storage shares the ownership of the object
+	 * because the object can be used by enumerate() after its removal.
+	 */
 	virtual void
-	add( dns_stats_t & stats_object ) = 0;
+	add( std::shared_ptr< dns_stats_t > stats_object ) = 0;
 
 	//! Remove dns_stats from the storage.
+	/*!
+	 * Since v.0.6.0 the storage receives the ownership of the object
+	 * because the object can still be used by enumerate() that is
+	 * running on another thread.
+	 */
 	virtual void
-	remove( dns_stats_t & stats_object ) noexcept = 0;
+	remove( std::shared_ptr< dns_stats_t > stats_object ) noexcept = 0;
 
 	//! Enumerate all objects from the storage.
 	/*!
-	 * For the safety purposes the storage will be blocked to the end
-	 * of the enumeration. It means that add() and remove() will block
-	 * the caller until enumerate() completes.
-	 *
-	 * It also means that calls to add()/remove() from inside enumerate()
-	 * are prohibited.
+	 * Since v.0.6.0 the enumeration is performed for a stable snapshot
+	 * of the storage. add() and remove() don't wait for the completion
+	 * of enumerate(), and objects added or removed during the
+	 * enumeration don't affect it.
 	 */
 	virtual void
 	enumerate( dns_stats_enumerator_t & enumerator ) = 0;
@@ -143,20 +158,20 @@ public:
 class auto_reg_t
 {
 	std::shared_ptr< dns_stats_reference_manager_t > m_manager;
-	dns_stats_t & m_stats;
+	std::shared_ptr< dns_stats_t > m_stats;
 
 public:
 	auto_reg_t(
 		std::shared_ptr< dns_stats_reference_manager_t > manager,
-		dns_stats_t & stats )
+		std::shared_ptr< dns_stats_t > stats )
 		:	m_manager{ std::move(manager) }
-		,	m_stats{ stats }
+		,	m_stats{ std::move(stats) }
 	{
 		m_manager->add( m_stats );
 	}
 	~auto_reg_t()
 	{
-		m_manager->remove( m_stats );
+		m_manager->remove( std::move(m_stats) );
 	}
 
 	// Objects of that class can't be copied or moved.
@@ -0,0 +1,95 @@
+/*!
+ * @file
+ * @brief Stuff for collecting stats of pools of I/O chunks.
+ */
+
+#include <arataga/stats/io_chunks/pub.hpp>
+
+#include <mutex>
+#include <set>
+
+namespace arataga::stats::io_chunks
+{
+
+//
+// io_chunk_stats_enumerator_t
+//
+io_chunk_stats_enumerator_t::io_chunk_stats_enumerator_t()
+{}
+
+io_chunk_stats_enumerator_t::~io_chunk_stats_enumerator_t()
+{}
+
+//
+// io_chunk_stats_reference_manager_t
+//
+io_chunk_stats_reference_manager_t::io_chunk_stats_reference_manager_t()
+{}
+
+io_chunk_stats_reference_manager_t::~io_chunk_stats_reference_manager_t()
+{}
+
+namespace
+{
+
+//
+// manager_t
+//
+class manager_t final : public io_chunk_stats_reference_manager_t
+{
+	using set_t = std::set< io_chunk_stats_t * >;
+
+	std::mutex m_lock;
+
+	set_t m_objects;
+
+public:
+	void
+	add( io_chunk_stats_t & stats_object ) override
+	{
+		std::lock_guard< std::mutex > lock{ m_lock };
+
+		m_objects.insert( &stats_object );
+	}
+
+	void
+	remove( io_chunk_stats_t & stats_object ) noexcept override
+	{
+		std::lock_guard< std::mutex > lock{ m_lock };
+
+		m_objects.erase( &stats_object );
+	}
+
+	void
+	enumerate( io_chunk_stats_enumerator_t & enumerator ) override
+	{
+		std::lock_guard< std::mutex > lock{ m_lock };
+
+		for( auto * o : m_objects )
+		{
+			const auto r = enumerator.on_next( *o );
+			switch( r )
+			{
+				case io_chunk_stats_enumerator_t::go_next: /* Nothing to do. */
+				break;
+
+				case io_chunk_stats_enumerator_t::stop: return;
+			}
+		}
+	}
+};
+
+} /* namespace anonymous */
+
+//
+// make_std_io_chunk_stats_reference_manager
+//
+[[nodiscard]]
+std::shared_ptr< io_chunk_stats_reference_manager_t >
+make_std_io_chunk_stats_reference_manager()
+{
+	return std::make_shared< manager_t >();
+}
+
+} /* namespace arataga::stats::io_chunks */
+
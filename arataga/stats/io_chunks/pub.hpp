@@ -0,0 +1,183 @@
+/*!
+ * @file
+ * @brief Stuff for collecting stats of pools of I/O chunks.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace arataga::stats::io_chunks
+{
+
+//
+// io_chunk_stats_t
+//
+//! Stats for a single pool of I/O chunks.
+/*!
+ * @since v.0.6.0
+ */
+struct io_chunk_stats_t
+{
+	//! Count of chunks that are lent to connection-handlers at the moment.
+	std::atomic< std::uint64_t > m_chunks_in_use{};
+	//! Total size of chunks that are lent at the moment (in bytes).
+	std::atomic< std::uint64_t > m_bytes_in_use{};
+	//! Count of free chunks held in the pool at the moment.
+	std::atomic< std::uint64_t > m_chunks_cached{};
+	//! Total size of free chunks held in the pool (in bytes).
+	std::atomic< std::uint64_t > m_bytes_cached{};
+	//! Counter of chunks allocated from the heap.
+	std::atomic< std::uint64_t > m_chunks_allocated{};
+	//! Counter of chunks taken from the pool without an allocation.
+	std::atomic< std::uint64_t > m_chunks_reused{};
+};
+
+//
+// io_chunk_stats_enumerator_t
+//
+class io_chunk_stats_enumerator_t
+{
+public:
+	enum class result_t
+	{
+		go_next,
+		stop
+	};
+
+	static constexpr auto go_next = result_t::go_next;
+	static constexpr auto stop = result_t::stop;
+
+	io_chunk_stats_enumerator_t();
+	virtual ~io_chunk_stats_enumerator_t();
+
+	[[nodiscard]]
+	virtual result_t
+	on_next( const io_chunk_stats_t & stats_object ) = 0;
+};
+
+namespace impl
+{
+
+//
+// enumerator_from_lambda_t
+//
+template< typename Lambda >
+class enumerator_from_lambda_t final : public io_chunk_stats_enumerator_t
+{
+	Lambda m_lambda;
+
+public:
+	enumerator_from_lambda_t( Lambda lambda ) : m_lambda{ std::move(lambda) }
+	{}
+
+	[[nodiscard]]
+	result_t
+	on_next( const io_chunk_stats_t & stats_object ) override
+	{
+		return m_lambda( stats_object );
+	}
+};
+
+} /* namespace impl */
+
+//
+// lambda_as_enumerator
+//
+template< typename Lambda >
+[[nodiscard]]
+auto
+lambda_as_enumerator( Lambda && lambda )
+{
+	using actual_lambda_type = std::decay_t<Lambda>;
+	return impl::enumerator_from_lambda_t<actual_lambda_type>{
+			std::forward<Lambda>(lambda)
+		};
+}
+
+//
+// io_chunk_stats_reference_manager_t
+//
+/*!
+ * @brief An interface of holder of references to io_chunk_stats objects.
+ *
+ * An object of io_chunk_stats_t is owned by a pool of I/O chunks.
+ * But a reference to that object should be available to stats_collector.
+ * The pool passes that reference to io_chunk_stats_reference_manager
+ * at the beginning, then removes that references at the end.
+ */
+class io_chunk_stats_reference_manager_t
+{
+public:
+	io_chunk_stats_reference_manager_t();
+	virtual ~io_chunk_stats_reference_manager_t();
+
+	// Objects of that type can't be moved or copied.
+	io_chunk_stats_reference_manager_t(
+		const io_chunk_stats_reference_manager_t & ) = delete;
+	io_chunk_stats_reference_manager_t(
+		io_chunk_stats_reference_manager_t && ) = delete;
+
+	//! Add a new io_chunk_stats to the storage.
+	virtual void
+	add( io_chunk_stats_t & stats_object ) = 0;
+
+	//! Remove io_chunk_stats from the storage.
+	virtual void
+	remove( io_chunk_stats_t & stats_object ) noexcept = 0;
+
+	//! Enumerate all objects from the storage.
+	/*!
+	 * For the safety purposes the storage will be blocked to the end
+	 * of the enumeration. It means that add() and remove() will block
+	 * the caller until enumerate() completes.
+	 *
+	 * It also means that calls to add()/remove() from inside enumerate()
+	 * are prohibited.
+	 */
+	virtual void
+	enumerate( io_chunk_stats_enumerator_t & enumerator ) = 0;
+};
+
+//
+// auto_reg_t
+//
+/*!
+ * @brief Helper for adding/removing references to io_chunk_stats
+ * objects in RAII style.
+ */
+class auto_reg_t
+{
+	std::shared_ptr< io_chunk_stats_reference_manager_t > m_manager;
+	io_chunk_stats_t & m_stats;
+
+public:
+	auto_reg_t(
+		std::shared_ptr< io_chunk_stats_reference_manager_t > manager,
+		io_chunk_stats_t & stats )
+		:	m_manager{ std::move(manager) }
+		,	m_stats{ stats }
+	{
+		m_manager->add( m_stats );
+	}
+	~auto_reg_t()
+	{
+		m_manager->remove( m_stats );
+	}
+
+	// Objects of that class can't be copied or moved.
+	auto_reg_t( const auto_reg_t & ) = delete;
+	auto_reg_t( auto_reg_t && ) = delete;
+};
+
+//
+// make_std_io_chunk_stats_reference_manager
+//
+[[nodiscard]]
+std::shared_ptr< io_chunk_stats_reference_manager_t >
+make_std_io_chunk_stats_reference_manager();
+
+} /* namespace arataga::stats::io_chunks */
+
@@ -0,0 +1,261 @@
+/*!
+ * @file
+ * @brief Histograms for latencies of various operations.
+ * @since v.0.6.0
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace arataga::stats
+{
+
+//
+// latency_buckets
+//
+/*!
+ * @brief The layout of buckets for latency histograms.
+ *
+ * Values are microseconds. The layout is log-linear (like in
+ * HdrHistogram): values less than 2^sub_bucket_bits have their own
+ * buckets, every next power of two is split into 2^sub_bucket_bits
+ * buckets of the same width. So the relative error of a value taken
+ * from a bucket is no more than 1/2^sub_bucket_bits (12.5%).
+ *
+ * Values greater than max_value are counted in the last bucket.
+ *
+ * @since v.0.6.0
+ */
+namespace latency_buckets
+{
+
+//! The number of bits for the linear part of a bucket index.
+inline constexpr unsigned sub_bucket_bits = 3u;
+
+//! The number of buckets for one power of two.
+inline constexpr std::size_t sub_buckets = std::size_t{1u} << sub_bucket_bits;
+
+//! The index of the highest bit of the max value.
+/*!
+ * 2^24 microseconds is approximately 16.7 seconds. It's bigger than
+ * any sensible timeout for connection-setup operations.
+ */
+inline constexpr unsigned max_magnitude = 23u;
+
+//! The max value that has its own bucket.
+inline constexpr std::uint64_t max_value =
+		(std::uint64_t{1u} << (max_magnitude + 1u)) - 1u;
+
+//! The total number of buckets.
+inline constexpr std::size_t count =
+		sub_buckets + (max_magnitude + 1u - sub_bucket_bits) * sub_buckets;
+
+//! Get the index of a bucket for the @a value.
+[[nodiscard]]
+inline constexpr std::size_t
+index_of( std::uint64_t value ) noexcept
+{
+	if( value > max_value )
+		value = max_value;
+
+	if( value < sub_buckets )
+		return static_cast< std::size_t >( value );
+
+	unsigned magnitude = sub_bucket_bits;
+	while( (value >> (magnitude + 1u)) != 0u )
+		++magnitude;
+
+	const unsigned shift = magnitude - sub_bucket_bits;
+	return sub_buckets
+			+ (magnitude - sub_bucket_bits) * sub_buckets
+			+ static_cast< std::size_t >( (value >> shift) - sub_buckets );
+}
+
+//! Get the max value that goes into the bucket with @a index.
+[[nodiscard]]
+inline constexpr std::uint64_t
+highest_value_of( std::size_t index ) noexcept
+{
+	if( index < sub_buckets )
+		return index;
+
+	const auto magnitude = static_cast< unsigned >(
+			(index - sub_buckets) / sub_buckets ) + sub_bucket_bits;
+	const unsigned shift = magnitude - sub_bucket_bits;
+	const std::uint64_t sub_index = (index - sub_buckets) % sub_buckets;
+
+	return ((sub_buckets + sub_index + 1u) << shift) - 1u;
+}
+
+} /* namespace latency_buckets */
+
+//
+// latency_histogram_t
+//
+/*!
+ * @brief Histogram of latencies that can be updated from several threads.
+ *
+ * A histogram is updated by IO-threads on every connection setup, so
+ * all counters are atomic and record() is lock-free. The content of
+ * a histogram is read by stats_collector via latency_snapshot_t.
+ *
+ * @since v.0.6.0
+ */
+class latency_histogram_t
+{
+	std::array< std::atomic< std::uint64_t >, latency_buckets::count >
+			m_buckets{};
+
+	//! The sum of all values in microseconds.
+	/*!
+	 * Values greater than latency_buckets::max_value are added as is.
+	 */
+	std::atomic< std::uint64_t > m_sum{};
+
+public:
+	latency_histogram_t() = default;
+
+	latency_histogram_t( const latency_histogram_t & ) = delete;
+	latency_histogram_t( latency_histogram_t && ) = delete;
+
+	//! Add a value in microseconds.
+	void
+	record_microseconds( std::uint64_t value ) noexcept
+	{
+		m_buckets[ latency_buckets::index_of( value ) ].fetch_add(
+				1u, std::memory_order_relaxed );
+		m_sum.fetch_add( value, std::memory_order_relaxed );
+	}
+
+	//! Add a duration.
+	/*!
+	 * Negative durations are counted as zeros.
+	 */
+	template< typename Rep, typename Period >
+	void
+	record( std::chrono::duration< Rep, Period > duration ) noexcept
+	{
+		const auto us = std::chrono::duration_cast<
+				std::chrono::microseconds >( duration ).count();
+
+		record_microseconds( us > 0 ? static_cast< std::uint64_t >(us) : 0u );
+	}
+
+	//! Get the number of values in the bucket with @a index.
+	[[nodiscard]]
+	std::uint64_t
+	bucket_value( std::size_t index ) const noexcept
+	{
+		return m_buckets[ index ].load( std::memory_order_relaxed );
+	}
+
+	//! Get the sum of all values in microseconds.
+	[[nodiscard]]
+	std::uint64_t
+	sum() const noexcept
+	{
+		return m_sum.load( std::memory_order_relaxed );
+	}
+};
+
+//
+// latency_snapshot_t
+//
+/*!
+ * @brief A non-atomic copy of one or several latency histograms.
+ *
+ * It's used by stats_collector for merging histograms from different
+ * IO-threads and for calculation of percentiles.
+ *
+ * @since v.0.6.0
+ */
+class latency_snapshot_t
+{
+	std::array< std::uint64_t, latency_buckets::count > m_buckets{};
+
+	std::uint64_t m_total{};
+
+	std::uint64_t m_sum{};
+
+public:
+	//! Add the current content of @a histogram.
+	void
+	merge( const latency_histogram_t & histogram ) noexcept
+	{
+		for( std::size_t i = 0u; i != m_buckets.size(); ++i )
+		{
+			const auto v = histogram.bucket_value( i );
+			m_buckets[ i ] += v;
+			m_total += v;
+		}
+		m_sum += histogram.sum();
+	}
+
+	//! Add the content of another snapshot.
+	void
+	merge( const latency_snapshot_t & other ) noexcept
+	{
+		for( std::size_t i = 0u; i != m_buckets.size(); ++i )
+			m_buckets[ i ] += other.m_buckets[ i ];
+		m_total += other.m_total;
+		m_sum += other.m_sum;
+	}
+
+	//! The total number of values.
+	[[nodiscard]]
+	std::uint64_t
+	total() const noexcept { return m_total; }
+
+	//! The sum of all values in microseconds.
+	[[nodiscard]]
+	std::uint64_t
+	sum() const noexcept { return m_sum; }
+
+	//! Get the number of values in the bucket with @a index.
+	[[nodiscard]]
+	std::uint64_t
+	bucket_value( std::size_t index ) const noexcept
+	{
+		return m_buckets[ index ];
+	}
+
+	//! Get a percentile in microseconds.
+	/*!
+	 * @a quantile is in the range [0.0, 1.0]. For example, 0.99 for p99.
+	 *
+	 * The result is the max value of the bucket that contains the
+	 * requested percentile. Zero is returned for the empty snapshot.
+	 */
+	[[nodiscard]]
+	std::uint64_t
+	percentile( double quantile ) const noexcept
+	{
+		if( !m_total )
+			return 0u;
+
+		// The rank of the value (nearest-rank method).
+		// It can't be less than 1.
+		auto rank = static_cast< std::uint64_t >(
+				std::ceil( quantile * static_cast< double >(m_total) ) );
+		if( !rank )
+			rank = 1u;
+
+		std::uint64_t seen{};
+		for( std::size_t i = 0u; i != m_buckets.size(); ++i )
+		{
+			seen += m_buckets[ i ];
+			if( seen >= rank )
+				return latency_buckets::highest_value_of( i );
+		}
+
+		return latency_buckets::max_value;
+	}
+};
+
+} /* namespace arataga::stats */
@@ -9,5 +9,7 @@ MxxRu::Cpp::lib_target {
 	cpp_source 'auth/pub.cpp'
 	cpp_source 'connections/pub.cpp'
 	cpp_source 'dns/pub.cpp'
+	cpp_source 'io_chunks/pub.cpp'
+	cpp_source 'traffic/pub.cpp'
 }
 
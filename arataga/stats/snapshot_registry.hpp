@@ -0,0 +1,231 @@
+/*!
+ * @file
+ * @brief A registry of stats objects with lock-free enumeration.
+ * @since v.0.6.0
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace arataga::stats
+{
+
+//
+// snapshot_registry_t
+//
+/*!
+ * @brief A registry of stats objects.
+ *
+ * The list of objects is immutable. A reader takes the current list by
+ * std::atomic_load() and works with it without any locks. So add() and
+ * remove() never wait for the completion of enumerations.
+ *
+ * add() and remove() don't make a new list, they only queue the change.
+ * Queued changes are folded into a new list when the next snapshot is
+ * taken (or when there are more queued changes than objects in the
+ * current list). So a config reload that starts or stops thousands of
+ * ACLs costs amortized O(1) per ACL, not O(N). The mutex inside the
+ * registry protects the queue of changes.
+ *
+ * An object removed from the registry can still be used by readers of
+ * older lists. Because of that the lists hold objects by shared_ptr.
+ * A list holds only its own objects, so a reader that works with an old
+ * list for a long time doesn't keep lists created after it.
+ *
+ * @since v.0.6.0
+ */
+template< typename T >
+class snapshot_registry_t
+{
+public:
+	//! Type of the list of registered objects.
+	using objects_t = std::vector< std::shared_ptr< T > >;
+
+private:
+	//! The min number of queued changes that cause folding by writers.
+	static constexpr std::size_t min_changes_to_fold{ 64u };
+
+	//! The lock for the queue of changes.
+	std::mutex m_lock;
+
+	//! The current list.
+	/*!
+	 * It's accessed only via std::atomic_load() and std::atomic_store().
+	 */
+	std::shared_ptr< const objects_t > m_current{
+			std::make_shared< const objects_t >()
+		};
+
+	//! Are there queued changes?
+	/*!
+	 * It allows to take a snapshot without the lock if there are
+	 * no changes.
+	 */
+	std::atomic< bool > m_has_changes{ false };
+
+	//! Objects added since the last folding.
+	/*!
+	 * NOTE: it's accessed only with m_lock acquired.
+	 */
+	objects_t m_added;
+
+	//! Objects removed since the last folding.
+	/*!
+	 * An object can't be destroyed while it's in m_current or in
+	 * m_added, so its address can't be reused until the folding.
+	 *
+	 * add() reserves the capacity for all registered objects, so
+	 * remove() never allocates memory for this container.
+	 *
+	 * NOTE: it's accessed only with m_lock acquired.
+	 */
+	std::vector< const T * > m_removed;
+
+	// NOTE: this method has to be called with m_lock acquired.
+	[[nodiscard]]
+	std::size_t
+	changes_count() const noexcept
+	{
+		return m_added.size() + m_removed.size();
+	}
+
+	// NOTE: this method has to be called with m_lock acquired.
+	//
+	// If there is no memory for a new list then the current list
+	// is kept and changes remain queued.
+	void
+	fold_changes() noexcept
+	{
+		try
+		{
+			const auto current = std::atomic_load( &m_current );
+
+			std::sort( m_removed.begin(), m_removed.end() );
+			const auto should_be_kept = [this]( const T * o ) {
+				return !std::binary_search(
+						m_removed.begin(), m_removed.end(), o );
+			};
+
+			auto updated = std::make_shared< objects_t >();
+			updated->reserve( current->size() + m_added.size() );
+			for( const auto & o : *current )
+				if( should_be_kept( o.get() ) )
+					updated->push_back( o );
+			for( auto & o : m_added )
+				if( should_be_kept( o.get() ) )
+					updated->push_back( std::move(o) );
+
+			std::atomic_store( &m_current,
+					std::shared_ptr< const objects_t >{ std::move(updated) } );
+
+			m_added.clear();
+			m_removed.clear();
+			m_has_changes.store( false, std::memory_order_release );
+		}
+		catch( const std::bad_alloc & )
+		{
+			// Changes will be folded next time.
+		}
+	}
+
+	// NOTE: this method has to be called with m_lock acquired.
+	void
+	fold_changes_if_too_many() noexcept
+	{
+		const auto count = changes_count();
+		if( count >= min_changes_to_fold &&
+				count >= std::atomic_load( &m_current )->size() )
+			fold_changes();
+	}
+
+public:
+	//! A stable list of registered objects.
+	class snapshot_t
+	{
+		std::shared_ptr< const objects_t > m_objects;
+
+	public:
+		snapshot_t( std::shared_ptr< const objects_t > objects ) noexcept
+			:	m_objects{ std::move(objects) }
+		{}
+
+		[[nodiscard]]
+		const objects_t &
+		objects() const noexcept { return *m_objects; }
+	};
+
+	snapshot_registry_t() = default;
+
+	snapshot_registry_t( const snapshot_registry_t & ) = delete;
+	snapshot_registry_t( snapshot_registry_t && ) = delete;
+
+	//! Add an object.
+	/*!
+	 * The object becomes visible to readers with the next snapshot.
+	 */
+	void
+	add( std::shared_ptr< T > object )
+	{
+		std::lock_guard< std::mutex > lock{ m_lock };
+
+		// Every registered object can be removed without an allocation.
+		const auto registered =
+				std::atomic_load( &m_current )->size() + m_added.size() + 1u;
+		if( m_removed.capacity() < registered )
+			m_removed.reserve( std::max( registered, m_removed.capacity() * 2u ) );
+
+		m_added.push_back( std::move(object) );
+		m_has_changes.store( true, std::memory_order_release );
+
+		fold_changes_if_too_many();
+	}
+
+	//! Remove an object.
+	/*!
+	 * The object remains visible to readers until the next snapshot.
+	 * It is destroyed when it isn't used by readers anymore.
+	 */
+	void
+	remove( std::shared_ptr< T > object ) noexcept
+	{
+		std::lock_guard< std::mutex > lock{ m_lock };
+
+		// The capacity is already reserved by add(), there won't
+		// be an allocation.
+		m_removed.push_back( object.get() );
+		m_has_changes.store( true, std::memory_order_release );
+
+		// The reference has to be released before the folding.
+		// Otherwise the object can't be destroyed by it.
+		object.reset();
+
+		fold_changes_if_too_many();
+	}
+
+	//! Get the current list of objects.
+	/*!
+	 * Queued changes are applied here.
+	 */
+	[[nodiscard]]
+	snapshot_t
+	snapshot()
+	{
+		if( m_has_changes.load( std::memory_order_acquire ) )
+		{
+			std::lock_guard< std::mutex > lock{ m_lock };
+			if( m_has_changes.load( std::memory_order_relaxed ) )
+				fold_changes();
+		}
+
+		return { std::atomic_load( &m_current ) };
+	}
+};
+
+} /* namespace arataga::stats */
@@ -0,0 +1,332 @@
+/*!
+ * @file
+ * @brief Stuff for collecting stats of transferred data.
+ * @since v.0.6.0
+ */
+
+#include <arataga/stats/traffic/pub.hpp>
+
+#include <mutex>
+#include <set>
+
+namespace arataga::stats::traffic
+{
+
+//
+// counters_ref_t
+//
+counters_ref_t::~counters_ref_t()
+{
+	reset();
+}
+
+counters_ref_t::counters_ref_t( const counters_ref_t & other )
+	:	m_owner{ other.m_owner }
+	,	m_slot{ other.m_slot }
+{
+	if( m_slot )
+		m_owner->add_reference( *m_slot );
+}
+
+counters_ref_t::counters_ref_t( counters_ref_t && other ) noexcept
+	:	m_owner{ std::move(other.m_owner) }
+	,	m_slot{ std::exchange( other.m_slot, nullptr ) }
+{}
+
+counters_ref_t &
+counters_ref_t::operator=( counters_ref_t other ) noexcept
+{
+	reset();
+
+	m_owner = std::move(other.m_owner);
+	m_slot = std::exchange( other.m_slot, nullptr );
+
+	return *this;
+}
+
+void
+counters_ref_t::update_limits( const bandlim_config_t & limits ) const noexcept
+{
+	m_slot->m_limit_in.store( limits.m_in, std::memory_order_relaxed );
+	m_slot->m_limit_out.store( limits.m_out, std::memory_order_relaxed );
+}
+
+void
+counters_ref_t::reset() noexcept
+{
+	if( m_slot )
+	{
+		m_owner->remove_reference( *m_slot );
+		m_slot = nullptr;
+		m_owner.reset();
+	}
+}
+
+//
+// traffic_stats_t
+//
+traffic_stats_t::traffic_stats_t(
+	std::shared_ptr< traffic_stats_reference_manager_t > manager )
+	:	m_manager{ std::move(manager) }
+{
+	m_manager->add( *this );
+}
+
+traffic_stats_t::~traffic_stats_t()
+{
+	m_manager->remove( *this );
+
+	// There are no references to slots, all of them can be deleted.
+	auto * slot = m_slots.load( std::memory_order_acquire );
+	while( slot )
+		delete std::exchange( slot, slot->m_next );
+}
+
+template< typename Map, typename Key >
+[[nodiscard]]
+counters_ref_t
+traffic_stats_t::acquire( Map & map, const Key & key )
+{
+	auto self = shared_from_this();
+
+	auto it = map.find( key );
+	if( it == map.end() )
+	{
+		auto slot = std::make_unique< counters_slot_t >(
+				counters_slot_t::key_t{ key } );
+		it = map.emplace( key, slot.get() ).first;
+
+		// The slot becomes visible to stats_collector.
+		// There can't be exceptions after that point.
+		slot->m_next = m_slots.load( std::memory_order_relaxed );
+		while( !m_slots.compare_exchange_weak(
+				slot->m_next,
+				slot.get(),
+				std::memory_order_release,
+				std::memory_order_relaxed ) )
+		{}
+		slot.release();
+	}
+
+	it->second->m_references += 1u;
+
+	return { std::move(self), it->second };
+}
+
+void
+traffic_stats_t::add_reference( counters_slot_t & slot ) noexcept
+{
+	slot.m_references += 1u;
+}
+
+void
+traffic_stats_t::remove_reference( counters_slot_t & slot ) noexcept
+{
+	slot.m_references -= 1u;
+	if( slot.m_references )
+		return;
+
+	// The slot isn't needed for new references anymore.
+	// It will be removed by collect().
+	if( const auto * user_id = std::get_if< std::uint64_t >( &slot.m_key ) )
+		m_users.erase( *user_id );
+	else
+		m_acls.erase( std::get< std::string >( slot.m_key ) );
+
+	// NOTE: the release order makes the final values of the counters
+	// visible for collect().
+	slot.m_released.store( true, std::memory_order_release );
+}
+
+void
+traffic_stats_t::unlink(
+	counters_slot_t * prev,
+	counters_slot_t * slot ) noexcept
+{
+	if( prev )
+	{
+		prev->m_next = slot->m_next;
+		return;
+	}
+
+	// The slot was the head of the list. New slots can be added before
+	// it by the owning IO-thread at the same time.
+	auto * head = slot;
+	if( m_slots.compare_exchange_strong(
+			head,
+			slot->m_next,
+			std::memory_order_acq_rel,
+			std::memory_order_acquire ) )
+		return;
+
+	// New slots have been added, the slot has to be found after them.
+	while( head->m_next != slot )
+		head = head->m_next;
+	head->m_next = slot->m_next;
+}
+
+[[nodiscard]]
+counters_ref_t
+traffic_stats_t::acquire_user_counters( std::uint64_t user_id )
+{
+	return acquire( m_users, user_id );
+}
+
+[[nodiscard]]
+counters_ref_t
+traffic_stats_t::acquire_acl_counters( const std::string & acl_name )
+{
+	return acquire( m_acls, acl_name );
+}
+
+namespace
+{
+
+// Add the traffic since the previous collection to the result.
+void
+collect_from( counters_slot_t & slot, collected_traffic_t & result )
+{
+	const auto current = slot.m_counters.load();
+	const traffic_totals_t diff{
+		current.m_bytes_from_user - slot.m_collected.m_bytes_from_user,
+		current.m_bytes_from_target - slot.m_collected.m_bytes_from_target,
+		current.m_chunks_from_user - slot.m_collected.m_chunks_from_user,
+		current.m_chunks_from_target - slot.m_collected.m_chunks_from_target
+	};
+
+	if( !diff.empty() )
+	{
+		if( const auto * user_id = std::get_if< std::uint64_t >( &slot.m_key ) )
+			result.m_users.push_back( user_traffic_t{
+					*user_id,
+					diff,
+					bandlim_config_t{
+						slot.m_limit_in.load( std::memory_order_relaxed ),
+						slot.m_limit_out.load( std::memory_order_relaxed )
+					}
+				} );
+		else
+			result.m_acls.emplace_back(
+					std::get< std::string >( slot.m_key ), diff );
+	}
+
+	// NOTE: it's updated only after the successful addition to the result,
+	// the data will be collected next time in the case of an exception.
+	slot.m_collected = current;
+}
+
+} /* namespace anonymous */
+
+[[nodiscard]]
+collected_traffic_t
+traffic_stats_t::collect()
+{
+	collected_traffic_t result;
+
+	counters_slot_t * prev = nullptr;
+	auto * slot = m_slots.load( std::memory_order_acquire );
+	while( slot )
+	{
+		// NOTE: the flag is checked before the collection, so the final
+		// values of the counters of a released slot are collected.
+		const bool released = slot->m_released.load(
+				std::memory_order_acquire );
+
+		collect_from( *slot, result );
+
+		auto * next = slot->m_next;
+		if( released )
+		{
+			unlink( prev, slot );
+			delete slot;
+		}
+		else
+			prev = slot;
+
+		slot = next;
+	}
+
+	return result;
+}
+
+//
+// traffic_stats_enumerator_t
+//
+traffic_stats_enumerator_t::traffic_stats_enumerator_t()
+{}
+
+traffic_stats_enumerator_t::~traffic_stats_enumerator_t()
+{}
+
+//
+// traffic_stats_reference_manager_t
+//
+traffic_stats_reference_manager_t::traffic_stats_reference_manager_t()
+{}
+
+traffic_stats_reference_manager_t::~traffic_stats_reference_manager_t()
+{}
+
+namespace
+{
+
+//
+// manager_t
+//
+class manager_t final : public traffic_stats_reference_manager_t
+{
+	using set_t = std::set< traffic_stats_t * >;
+
+	std::mutex m_lock;
+
+	set_t m_objects;
+
+public:
+	void
+	add( traffic_stats_t & stats_object ) override
+	{
+		std::lock_guard< std::mutex > lock{ m_lock };
+
+		m_objects.insert( &stats_object );
+	}
+
+	void
+	remove( traffic_stats_t & stats_object ) noexcept override
+	{
+		std::lock_guard< std::mutex > lock{ m_lock };
+
+		m_objects.erase( &stats_object );
+	}
+
+	void
+	enumerate( traffic_stats_enumerator_t & enumerator ) override
+	{
+		std::lock_guard< std::mutex > lock{ m_lock };
+
+		for( auto * o : m_objects )
+		{
+			const auto r = enumerator.on_next( *o );
+			switch( r )
+			{
+				case traffic_stats_enumerator_t::go_next: /* Nothing to do. */
+				break;
+
+				case traffic_stats_enumerator_t::stop: return;
+			}
+		}
+	}
+};
+
+} /* namespace anonymous */
+
+//
+// make_std_traffic_stats_reference_manager
+//
+[[nodiscard]]
+std::shared_ptr< traffic_stats_reference_manager_t >
+make_std_traffic_stats_reference_manager()
+{
+	return std::make_shared< manager_t >();
+}
+
+} /* namespace arataga::stats::traffic */
@@ -0,0 +1,479 @@
+/*!
+ * @file
+ * @brief Stuff for collecting stats of transferred data.
+ * @since v.0.6.0
+ */
+
+#pragma once
+
+#include <arataga/bandlim_config.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace arataga::stats::traffic
+{
+
+//
+// cache_line_size
+//
+//! The size of a cache line to be used for padding of counters.
+/*!
+ * std::hardware_destructive_interference_size isn't available in
+ * all supported compilers, so the usual value is used.
+ */
+inline constexpr std::size_t cache_line_size = 64u;
+
+//
+// traffic_totals_t
+//
+//! Values of traffic counters at some moment (or a difference of them).
+struct traffic_totals_t
+{
+	std::uint64_t m_bytes_from_user{};
+	std::uint64_t m_bytes_from_target{};
+	std::uint64_t m_chunks_from_user{};
+	std::uint64_t m_chunks_from_target{};
+
+	[[nodiscard]]
+	std::uint64_t
+	total_bytes() const noexcept
+	{
+		return m_bytes_from_user + m_bytes_from_target;
+	}
+
+	// NOTE: all values are checked because counters are read one by one
+	// and a difference can have bytes without chunks.
+	[[nodiscard]]
+	bool
+	empty() const noexcept
+	{
+		return 0u == m_bytes_from_user && 0u == m_bytes_from_target &&
+				0u == m_chunks_from_user && 0u == m_chunks_from_target;
+	}
+
+	traffic_totals_t &
+	operator+=( const traffic_totals_t & o ) noexcept
+	{
+		m_bytes_from_user += o.m_bytes_from_user;
+		m_bytes_from_target += o.m_bytes_from_target;
+		m_chunks_from_user += o.m_chunks_from_user;
+		m_chunks_from_target += o.m_chunks_from_target;
+		return *this;
+	}
+};
+
+//
+// traffic_counters_t
+//
+/*!
+ * @brief Counters of data transferred by connections of one IO-thread.
+ *
+ * Counters are updated on every read, so they are modified only by
+ * the owning IO-thread and don't require atomic read-modify-write
+ * operations (with lock prefix on x86). Atomics are used only for
+ * relaxed loads and stores, because values are read by stats_collector
+ * from another thread.
+ *
+ * Objects are aligned to the cache line size, so counters of different
+ * users and ACLs don't share cache lines.
+ */
+struct alignas(cache_line_size) traffic_counters_t
+{
+	std::atomic< std::uint64_t > m_bytes_from_user{};
+	std::atomic< std::uint64_t > m_bytes_from_target{};
+	std::atomic< std::uint64_t > m_chunks_from_user{};
+	std::atomic< std::uint64_t > m_chunks_from_target{};
+
+	//! Increment a counter by the only writer.
+	static void
+	increment(
+		std::atomic< std::uint64_t > & counter,
+		std::uint64_t value ) noexcept
+	{
+		counter.store(
+				counter.load( std::memory_order_relaxed ) + value,
+				std::memory_order_relaxed );
+	}
+
+	//! Register data read from the user.
+	void
+	add_from_user( std::size_t bytes ) noexcept
+	{
+		increment( m_bytes_from_user, bytes );
+		increment( m_chunks_from_user, 1u );
+	}
+
+	//! Register data read from the target host.
+	void
+	add_from_target( std::size_t bytes ) noexcept
+	{
+		increment( m_bytes_from_target, bytes );
+		increment( m_chunks_from_target, 1u );
+	}
+
+	[[nodiscard]]
+	traffic_totals_t
+	load() const noexcept
+	{
+		return {
+			m_bytes_from_user.load( std::memory_order_relaxed ),
+			m_bytes_from_target.load( std::memory_order_relaxed ),
+			m_chunks_from_user.load( std::memory_order_relaxed ),
+			m_chunks_from_target.load( std::memory_order_relaxed )
+		};
+	}
+};
+
+//
+// user_traffic_t
+//
+//! Traffic of a user since the previous collection.
+struct user_traffic_t
+{
+	std::uint64_t m_user_id{};
+	traffic_totals_t m_totals{};
+	//! Bandwidth limits of the user at the time of the latest
+	//! authentification.
+	bandlim_config_t m_limits{};
+};
+
+//
+// collected_traffic_t
+//
+//! Traffic transferred since the previous collection.
+struct collected_traffic_t
+{
+	std::vector< user_traffic_t > m_users;
+	std::vector< std::pair< std::string, traffic_totals_t > > m_acls;
+};
+
+//
+// counters_slot_t
+//
+/*!
+ * @brief Counters with the info for their collection.
+ *
+ * Slots form a singly linked list. The owning IO-thread adds new slots
+ * to the head of the list, stats_collector removes released slots
+ * after the collection of their last data.
+ *
+ * @note
+ * It's an implementation detail of traffic_stats_t.
+ */
+struct counters_slot_t
+{
+	//! User ID or ACL name.
+	using key_t = std::variant< std::uint64_t, std::string >;
+
+	traffic_counters_t m_counters;
+
+	const key_t m_key;
+
+	//! Limits of the user.
+	/*!
+	 * They are written by the owning IO-thread and read by stats_collector.
+	 * Values aren't used for ACLs.
+	 */
+	std::atomic< bandlim_config_t::value_t > m_limit_in{
+			bandlim_config_t::unlimited };
+	std::atomic< bandlim_config_t::value_t > m_limit_out{
+			bandlim_config_t::unlimited };
+
+	//! Number of counters_ref_t objects for that slot.
+	/*!
+	 * It's used only by the owning IO-thread.
+	 */
+	std::size_t m_references{};
+
+	//! Is set when the last reference is removed.
+	/*!
+	 * The owning IO-thread doesn't touch the slot after that.
+	 */
+	std::atomic< bool > m_released{ false };
+
+	//! The next slot in the list.
+	/*!
+	 * It's set by the owning IO-thread before the slot is added to
+	 * the list. After that it's used only by stats_collector.
+	 */
+	counters_slot_t * m_next{ nullptr };
+
+	//! The values at the time of the previous collection.
+	/*!
+	 * It's used only by stats_collector.
+	 */
+	traffic_totals_t m_collected{};
+
+	explicit counters_slot_t( key_t key )
+		:	m_key{ std::move(key) }
+	{}
+};
+
+class traffic_stats_t;
+
+//
+// counters_ref_t
+//
+/*!
+ * @brief A reference to counters for a user or for an ACL.
+ *
+ * Counters are held by traffic_stats_t while there are references
+ * to them.
+ */
+class counters_ref_t
+{
+	friend class traffic_stats_t;
+
+	std::shared_ptr< traffic_stats_t > m_owner;
+	counters_slot_t * m_slot{ nullptr };
+
+	counters_ref_t(
+		std::shared_ptr< traffic_stats_t > owner,
+		counters_slot_t * slot ) noexcept
+		:	m_owner{ std::move(owner) }
+		,	m_slot{ slot }
+	{}
+
+	void
+	reset() noexcept;
+
+public:
+	counters_ref_t() = default;
+	~counters_ref_t();
+
+	counters_ref_t( const counters_ref_t & other );
+	counters_ref_t( counters_ref_t && other ) noexcept;
+
+	counters_ref_t &
+	operator=( counters_ref_t other ) noexcept;
+
+	[[nodiscard]]
+	explicit operator bool() const noexcept { return nullptr != m_slot; }
+
+	[[nodiscard]]
+	traffic_counters_t *
+	operator->() const noexcept { return &(m_slot->m_counters); }
+
+	//! Set the bandwidth limits of the user to be reported with
+	//! the traffic of the user.
+	void
+	update_limits( const bandlim_config_t & limits ) const noexcept;
+};
+
+class traffic_stats_reference_manager_t;
+
+//
+// traffic_stats_t
+//
+/*!
+ * @brief Traffic counters of one IO-thread.
+ *
+ * Counters for users and ACLs are created on demand and are held while
+ * there are references to them. Counters without references are removed
+ * after the next collection, so the last portion of data isn't lost.
+ *
+ * There are no locks. The owning IO-thread looks for counters in its
+ * own maps and adds new counters to the head of a lock-free list.
+ * When the last reference to counters is removed the owning IO-thread
+ * only marks them as released. stats_collector walks the list in
+ * collect() and removes released counters from it.
+ *
+ * @attention
+ * Objects have to be created by std::make_shared().
+ *
+ * @attention
+ * Counters have to be acquired and counters_ref_t objects have to be
+ * copied and destroyed only on the owning IO-thread. collect() can be
+ * called from another thread, but only by one thread at a time.
+ */
+class traffic_stats_t
+	:	public std::enable_shared_from_this< traffic_stats_t >
+{
+	friend class counters_ref_t;
+
+	std::shared_ptr< traffic_stats_reference_manager_t > m_manager;
+
+	//! Counters by user ID.
+	/*!
+	 * It's used only by the owning IO-thread.
+	 */
+	std::map< std::uint64_t, counters_slot_t * > m_users;
+	//! Counters by ACL name.
+	/*!
+	 * It's used only by the owning IO-thread.
+	 */
+	std::map< std::string, counters_slot_t *, std::less<> > m_acls;
+
+	//! The head of the list of all slots.
+	std::atomic< counters_slot_t * > m_slots{ nullptr };
+
+	template< typename Map, typename Key >
+	[[nodiscard]]
+	counters_ref_t
+	acquire( Map & map, const Key & key );
+
+	void
+	add_reference( counters_slot_t & slot ) noexcept;
+
+	void
+	remove_reference( counters_slot_t & slot ) noexcept;
+
+	//! Remove a released slot from the list.
+	void
+	unlink( counters_slot_t * prev, counters_slot_t * slot ) noexcept;
+
+public:
+	explicit traffic_stats_t(
+		std::shared_ptr< traffic_stats_reference_manager_t > manager );
+	~traffic_stats_t();
+
+	traffic_stats_t( const traffic_stats_t & ) = delete;
+	traffic_stats_t( traffic_stats_t && ) = delete;
+
+	//! Get counters for the user.
+	[[nodiscard]]
+	counters_ref_t
+	acquire_user_counters( std::uint64_t user_id );
+
+	//! Get counters for the ACL.
+	[[nodiscard]]
+	counters_ref_t
+	acquire_acl_counters( const std::string & acl_name );
+
+	//! Get the traffic since the previous call to collect().
+	/*!
+	 * Counters without references are removed after the collection
+	 * of their data.
+	 *
+	 * @note
+	 * It's intended to be called by stats_collector only.
+	 */
+	[[nodiscard]]
+	collected_traffic_t
+	collect();
+};
+
+//
+// traffic_stats_enumerator_t
+//
+class traffic_stats_enumerator_t
+{
+public:
+	enum class result_t
+	{
+		go_next,
+		stop
+	};
+
+	static constexpr auto go_next = result_t::go_next;
+	static constexpr auto stop = result_t::stop;
+
+	traffic_stats_enumerator_t();
+	virtual ~traffic_stats_enumerator_t();
+
+	// NOTE: the object isn't const because the collection of
+	// the traffic modifies it.
+	[[nodiscard]]
+	virtual result_t
+	on_next( traffic_stats_t & stats_object ) = 0;
+};
+
+namespace impl
+{
+
+//
+// enumerator_from_lambda_t
+//
+template< typename Lambda >
+class enumerator_from_lambda_t final : public traffic_stats_enumerator_t
+{
+	Lambda m_lambda;
+
+public:
+	enumerator_from_lambda_t( Lambda lambda ) : m_lambda{ std::move(lambda) }
+	{}
+
+	[[nodiscard]]
+	result_t
+	on_next( traffic_stats_t & stats_object ) override
+	{
+		return m_lambda( stats_object );
+	}
+};
+
+} /* namespace impl */
+
+//
+// lambda_as_enumerator
+//
+template< typename Lambda >
+[[nodiscard]]
+auto
+lambda_as_enumerator( Lambda && lambda )
+{
+	using actual_lambda_type = std::decay_t<Lambda>;
+	return impl::enumerator_from_lambda_t<actual_lambda_type>{
+			std::forward<Lambda>(lambda)
+		};
+}
+
+//
+// traffic_stats_reference_manager_t
+//
+/*!
+ * @brief An interface of holder of references to traffic_stats objects.
+ *
+ * An object of traffic_stats_t is created for every IO-thread.
+ * A reference to that object should be available to stats_collector.
+ * traffic_stats_t passes that reference to the manager in its
+ * constructor and removes it in the destructor.
+ */
+class traffic_stats_reference_manager_t
+{
+public:
+	traffic_stats_reference_manager_t();
+	virtual ~traffic_stats_reference_manager_t();
+
+	// Objects of that type can't be moved or copied.
+	traffic_stats_reference_manager_t(
+		const traffic_stats_reference_manager_t & ) = delete;
+	traffic_stats_reference_manager_t(
+		traffic_stats_reference_manager_t && ) = delete;
+
+	//! Add a new traffic_stats to the storage.
+	virtual void
+	add( traffic_stats_t & stats_object ) = 0;
+
+	//! Remove traffic_stats from the storage.
+	virtual void
+	remove( traffic_stats_t & stats_object ) noexcept = 0;
+
+	//! Enumerate all objects from the storage.
+	/*!
+	 * For the safety purposes the storage will be blocked to the end
+	 * of the enumeration. It means that add() and remove() will block
+	 * the caller until enumerate() completes.
+	 *
+	 * It also means that calls to add()/remove() from inside enumerate()
+	 * are prohibited.
+	 */
+	virtual void
+	enumerate( traffic_stats_enumerator_t & enumerator ) = 0;
+};
+
+//
+// make_std_traffic_stats_reference_manager
+//
+[[nodiscard]]
+std::shared_ptr< traffic_stats_reference_manager_t >
+make_std_traffic_stats_reference_manager();
+
+} /* namespace arataga::stats::traffic */
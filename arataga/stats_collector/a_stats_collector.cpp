@@ -9,7 +9,10 @@
 
 #include <fmt/ostream.h>
 
+#include <algorithm>
+#include <iterator>
 #include <sstream>
+#include <vector>
 
 namespace arataga::stats_collector
 {
@@ -24,6 +27,252 @@ value_of( const Atomic & from )
 	return from.load( std::memory_order_acquire );
 }
 
+// Names of connection setup stages in the order of setup_stage_t.
+//
+// Since v.0.6.0.
+constexpr std::array< std::string_view,
+		::arataga::stats::connections::setup_stages_count > setup_stage_names{
+	"protocol_detection",
+	"handshake",
+	"dns_lookup",
+	"authentification",
+	"connect_target"
+};
+
+// Print top_n items with the highest throughput.
+//
+// Additional values for an item are printed by extra_formatter.
+//
+// Since v.0.6.0.
+template< typename Totals_Map, typename Extra_Formatter >
+void
+format_traffic_top(
+	std::ostream & to,
+	std::string_view name,
+	std::string_view key_name,
+	const Totals_Map & totals,
+	std::size_t seconds,
+	std::size_t top_n,
+	Extra_Formatter && extra_formatter )
+{
+	std::vector< const typename Totals_Map::value_type * > items;
+	items.reserve( totals.size() );
+	for( const auto & item : totals )
+		items.push_back( &item );
+
+	const auto count = std::min( top_n, items.size() );
+	std::partial_sort(
+			items.begin(), items.begin() + count, items.end(),
+			[]( const auto * a, const auto * b ) {
+				return a->second.total_bytes() > b->second.total_bytes();
+			} );
+
+	for( std::size_t i = 0u; i != count; ++i )
+	{
+		const auto & [key, t] = *(items[ i ]);
+		fmt::print( to,
+				"{}[{}]: {}={} bytes_per_sec={} bytes_from_user={} "
+						"bytes_from_target={} chunks_from_user={} "
+						"chunks_from_target={}",
+				name,
+				i + 1u,
+				key_name,
+				key,
+				t.total_bytes() / seconds,
+				t.m_bytes_from_user,
+				t.m_bytes_from_target,
+				t.m_chunks_from_user,
+				t.m_chunks_from_target );
+		extra_formatter( to, key, t, seconds );
+		to << "\r\n";
+	}
+}
+
+// Print a bandwidth limit of a user and the share of it in use.
+//
+// Since v.0.6.0.
+void
+format_bandlim_usage(
+	std::ostream & to,
+	std::string_view direction,
+	::arataga::bandlim_config_t::value_t limit,
+	std::uint64_t bytes_per_sec )
+{
+	if( ::arataga::bandlim_config_t::is_unlimited( limit ) )
+		fmt::print( to, " bandlim_{}=unlimited", direction );
+	else
+		fmt::print( to, " bandlim_{}={} bandlim_{}_usage={}%",
+				direction,
+				limit,
+				direction,
+				bytes_per_sec * 100u / limit );
+}
+
+// Add values of connection counters from @a from to @a to.
+//
+// Since v.0.6.0.
+template< typename Counters >
+void
+add_connection_counters(
+	Counters & to,
+	const ::arataga::stats::connections::acl_stats_t & from )
+{
+	using ::arataga::stats::connections::acl_stats_t;
+
+	using dest_t = decltype(&Counters::m_total_connections);
+	using src_t = decltype(&acl_stats_t::m_total_connections);
+	using ptr_pair_t = std::pair<dest_t, src_t>;
+
+	static constexpr std::initializer_list<ptr_pair_t> ptr_pairs{
+		std::pair(
+				&Counters::m_total_connections,
+				&acl_stats_t::m_total_connections ),
+		std::pair(
+				&Counters::m_http_connections,
+				&acl_stats_t::m_http_connections ),
+		std::pair(
+				&Counters::m_socks5_connections,
+				&acl_stats_t::m_socks5_connections ),
+		std::pair(
+				&Counters::m_remove_reason_normal_completion,
+				&acl_stats_t::m_remove_reason_normal_completion ),
+		std::pair(
+				&Counters::m_remove_reason_io_error,
+				&acl_stats_t::m_remove_reason_io_error ),
+		std::pair(
+				&Counters::m_remove_reason_current_operation_timed_out,
+				&acl_stats_t::m_remove_reason_current_operation_timed_out ),
+		std::pair(
+				&Counters::m_remove_reason_unsupported_protocol,
+				&acl_stats_t::m_remove_reason_unsupported_protocol ),
+		std::pair(
+				&Counters::m_remove_reason_protocol_error,
+				&acl_stats_t::m_remove_reason_protocol_error ),
+		std::pair(
+				&Counters::m_remove_reason_unexpected_error,
+				&acl_stats_t::m_remove_reason_unexpected_error ),
+		std::pair(
+				&Counters::m_remove_reason_no_activity_for_too_long,
+				&acl_stats_t::m_remove_reason_no_activity_for_too_long ),
+		std::pair(
+				&Counters::m_remove_reason_current_operation_canceled,
+				&acl_stats_t::m_remove_reason_current_operation_canceled ),
+		std::pair(
+				&Counters::m_remove_reason_unhandled_exception,
+				&acl_stats_t::m_remove_reason_unhandled_exception ),
+		std::pair(
+				&Counters::m_remove_reason_ip_version_mismatch,
+				&acl_stats_t::m_remove_reason_ip_version_mismatch ),
+		std::pair(
+				&Counters::m_remove_reason_access_denied,
+				&acl_stats_t::m_remove_reason_access_denied ),
+		std::pair(
+				&Counters::m_remove_reason_unresolved_target,
+				&acl_stats_t::m_remove_reason_unresolved_target ),
+		std::pair(
+				&Counters::m_remove_reason_target_end_broken,
+				&acl_stats_t::m_remove_reason_target_end_broken ),
+		std::pair(
+				&Counters::m_remove_reason_user_end_broken,
+				&acl_stats_t::m_remove_reason_user_end_broken ),
+		std::pair(
+				&Counters::m_remove_reason_early_http_response,
+				&acl_stats_t::m_remove_reason_early_http_response ),
+		std::pair(
+				&Counters::m_remove_reason_user_end_closed_by_client,
+				&acl_stats_t::m_remove_reason_user_end_closed_by_client ),
+		std::pair(
+				&Counters::m_remove_reason_http_no_incoming_request,
+				&acl_stats_t::m_remove_reason_http_no_incoming_request )
+	};
+
+	for( const auto & [d, s] : ptr_pairs )
+	{
+		(to.*d) += value_of( (from.*s) );
+	}
+}
+
+// Write samples for reasons of connection removal of one ACL.
+template< typename Counters >
+void
+metric_remove_reasons(
+	std::string & to,
+	std::string_view acl_name,
+	const Counters & counters )
+{
+	using namespace std::string_view_literals;
+
+	using pair_t = std::pair<
+			decltype(&Counters::m_remove_reason_normal_completion),
+			std::string_view
+		>;
+
+	static constexpr std::initializer_list< pair_t > pairs{
+		std::pair{
+			&Counters::m_remove_reason_normal_completion,
+			"normal_completion"sv },
+		std::pair{
+			&Counters::m_remove_reason_io_error,
+			"io_error"sv },
+		std::pair{
+			&Counters::m_remove_reason_current_operation_timed_out,
+			"current_operation_timed_out"sv },
+		std::pair{
+			&Counters::m_remove_reason_unsupported_protocol,
+			"unsupported_protocol"sv },
+		std::pair{
+			&Counters::m_remove_reason_protocol_error,
+			"protocol_error"sv },
+		std::pair{
+			&Counters::m_remove_reason_unexpected_error,
+			"unexpected_error"sv },
+		std::pair{
+			&Counters::m_remove_reason_no_activity_for_too_long,
+			"no_activity_for_too_long"sv },
+		std::pair{
+			&Counters::m_remove_reason_current_operation_canceled,
+			"current_operation_canceled"sv },
+		std::pair{
+			&Counters::m_remove_reason_unhandled_exception,
+			"unhandled_exception"sv },
+		std::pair{
+			&Counters::m_remove_reason_ip_version_mismatch,
+			"ip_version_mismatch"sv },
+		std::pair{
+			&Counters::m_remove_reason_access_denied,
+			"access_denied"sv },
+		std::pair{
+			&Counters::m_remove_reason_unresolved_target,
+			"unresolved_target"sv },
+		std::pair{
+			&Counters::m_remove_reason_target_end_broken,
+			"target_end_broken"sv },
+		std::pair{
+			&Counters::m_remove_reason_user_end_broken,
+			"user_end_broken"sv },
+		std::pair{
+			&Counters::m_remove_reason_early_http_response,
+			"early_http_response"sv },
+		std::pair{
+			&Counters::m_remove_reason_user_end_closed_by_client,
+			"user_end_closed_by_client"sv },
+		std::pair{
+			&Counters::m_remove_reason_http_no_incoming_request,
+			"http_no_incoming_request"sv }
+	};
+
+	for( const auto & [v, reason] : pairs )
+	{
+		// Zero values are skipped, otherwise there will be too many
+		// lines for thousands of ACLs.
+		if( const auto value = (counters.*v); value )
+			fmt::format_to( std::back_inserter(to),
+					"arataga_connections_removed_total"
+							"{{acl=\"{}\",reason=\"{}\"}} {}\n",
+					acl_name, reason, value );
+	}
+}
+
 } /* namespace anonymous */
 
 //
@@ -41,6 +290,12 @@ a_stats_collector_t::so_define_agent()
 {
 	so_subscribe( m_app_ctx.m_stats_collector_mbox )
 		.event( &a_stats_collector_t::on_get_current_stats )
+		.event( &a_stats_collector_t::on_get_traffic_top )
+		.event( &a_stats_collector_t::on_get_metrics )
+		;
+
+	so_subscribe( m_app_ctx.m_global_timer_mbox )
+		.event( &a_stats_collector_t::on_one_second_timer )
 		;
 }
 
@@ -51,7 +306,9 @@ a_stats_collector_t::on_get_current_stats(
 	std::ostringstream ss;
 
 	{
-		format_connection_stats( ss, get_current_connections_stats() );
+		const auto connections_stats = get_current_connections_stats();
+		format_connection_stats( ss, connections_stats );
+		format_setup_latencies( ss, connections_stats );
 	}
 
 	{
@@ -80,6 +337,24 @@ a_stats_collector_t::on_get_current_stats(
 				dns_stats.m_dns_cache_hits,
 				dns_stats.m_dns_successful_lookups,
 				dns_stats.m_dns_failed_lookups );
+		format_latency( ss, "DNS_UPSTREAM_RTT", dns_stats.m_upstream_rtt );
+	}
+
+	{
+		const auto io_chunk_stats = get_current_io_chunk_stats();
+		fmt::print( ss,
+				"IO_CHUNKS_IN_USE: {}\r\n"
+				"IO_CHUNK_BYTES_IN_USE: {}\r\n"
+				"IO_CHUNKS_CACHED: {}\r\n"
+				"IO_CHUNK_BYTES_CACHED: {}\r\n"
+				"IO_CHUNKS_ALLOCATED: {}\r\n"
+				"IO_CHUNKS_REUSED: {}\r\n",
+				io_chunk_stats.m_chunks_in_use,
+				io_chunk_stats.m_bytes_in_use,
+				io_chunk_stats.m_chunks_cached,
+				io_chunk_stats.m_bytes_cached,
+				io_chunk_stats.m_chunks_allocated,
+				io_chunk_stats.m_chunks_reused );
 	}
 
 	{
@@ -108,6 +383,126 @@ a_stats_collector_t::on_get_current_stats(
 			ss.str() );
 }
 
+void
+a_stats_collector_t::on_get_traffic_top(
+	mhood_t< get_traffic_top_t > cmd )
+{
+	using totals_t = ::arataga::stats::traffic::traffic_totals_t;
+
+	// Periods (in seconds) for those tops are built.
+	static constexpr std::array< std::size_t, 3 > periods{ 1u, 10u, 60u };
+
+	std::ostringstream ss;
+
+	for( const auto period : periods )
+	{
+		// There can be less history just after the start.
+		const auto seconds = std::min( period, m_traffic_history.size() );
+		if( !seconds )
+			break;
+
+		std::map< std::uint64_t, totals_t > users;
+		std::map< std::uint64_t, ::arataga::bandlim_config_t > user_limits;
+		std::map< std::string_view, totals_t > acls;
+		for( std::size_t i = 0u; i != seconds; ++i )
+		{
+			const auto & second = m_traffic_history[ i ];
+			for( const auto & [user_id, t] : second.m_users )
+				users[ user_id ] += t;
+			// NOTE: the history goes from the latest second, so
+			// the latest limits are kept.
+			for( const auto & [user_id, limits] : second.m_user_limits )
+				user_limits.try_emplace( user_id, limits );
+			for( const auto & [acl_name, t] : second.m_acls )
+				acls[ acl_name ] += t;
+		}
+
+		format_traffic_top( ss,
+				fmt::format( "TOP_USERS_{}S", period ),
+				"user_id",
+				users,
+				seconds,
+				cmd->m_top_n,
+				[&user_limits](
+					std::ostream & to,
+					std::uint64_t user_id,
+					const totals_t & t,
+					std::size_t duration )
+				{
+					const auto it = user_limits.find( user_id );
+					if( it == user_limits.end() )
+						return;
+
+					format_bandlim_usage( to, "in",
+							it->second.m_in,
+							t.m_bytes_from_target / duration );
+					format_bandlim_usage( to, "out",
+							it->second.m_out,
+							t.m_bytes_from_user / duration );
+				} );
+		format_traffic_top( ss,
+				fmt::format( "TOP_ACLS_{}S", period ),
+				"acl",
+				acls,
+				seconds,
+				cmd->m_top_n,
+				[]( std::ostream &, std::string_view, const totals_t &,
+					std::size_t ) {} );
+	}
+
+	cmd->m_replier->reply(
+			::arataga::admin_http_entry::status_ok,
+			ss.str() );
+}
+
+void
+a_stats_collector_t::on_get_metrics(
+	mhood_t< get_metrics_t > cmd )
+{
+	std::string body;
+	body.reserve( m_metrics_size_hint );
+	format_metrics( body );
+	m_metrics_size_hint = body.size();
+
+	// NOTE: the body is moved to the response without copying.
+	cmd->m_replier->reply(
+			::arataga::admin_http_entry::status_ok,
+			std::move(body) );
+}
+
+void
+a_stats_collector_t::on_one_second_timer(
+	mhood_t< one_second_timer_t > )
+{
+	using namespace ::arataga::stats::traffic;
+
+	traffic_second_t current;
+
+	// NOTE: the lambda isn't noexcept because of the insertion to maps.
+	auto collector = lambda_as_enumerator(
+			[&current]( traffic_stats_t & traffic_stats ) {
+				const auto collected = traffic_stats.collect();
+
+				// A user or an ACL can be served by several IO-threads,
+				// the data from all of them are merged.
+				for( const auto & u : collected.m_users )
+				{
+					current.m_users[ u.m_user_id ] += u.m_totals;
+					current.m_user_limits[ u.m_user_id ] = u.m_limits;
+				}
+				for( const auto & [acl_name, t] : collected.m_acls )
+					current.m_acls[ acl_name ] += t;
+
+				return traffic_stats_enumerator_t::go_next;
+			} );
+
+	m_app_ctx.m_traffic_stats_manager->enumerate( collector );
+
+	m_traffic_history.push_front( std::move(current) );
+	if( m_traffic_history.size() > traffic_history_depth )
+		m_traffic_history.pop_back();
+}
+
 [[nodiscard]]
 a_stats_collector_t::connections_stats_t
 a_stats_collector_t::get_current_connections_stats() const
@@ -116,79 +511,21 @@ a_stats_collector_t::get_current_connections_stats() const
 
 	connections_stats_t result{};
 
+	// NOTE: the lambda isn't noexcept because of the insertion to
+	// m_acl_setup_latencies.
 	auto collector = lambda_as_enumerator(
-		[&result]( const auto & acl_stats ) noexcept {
-			using dest_t = decltype(&connections_stats_t::m_total_connections);
-			using src_t = decltype(&acl_stats_t::m_total_connections);
-			using ptr_pair_t = std::pair<dest_t, src_t>;
-
-			static constexpr std::initializer_list<ptr_pair_t> ptr_pairs{
-				std::pair(
-						&connections_stats_t::m_total_connections,
-						&acl_stats_t::m_total_connections ),
-				std::pair(
-						&connections_stats_t::m_http_connections,
-						&acl_stats_t::m_http_connections ),
-				std::pair(
-						&connections_stats_t::m_socks5_connections,
-						&acl_stats_t::m_socks5_connections ),
-				std::pair(
-						&connections_stats_t::m_remove_reason_normal_completion,
-						&acl_stats_t::m_remove_reason_normal_completion ),
-				std::pair(
-						&connections_stats_t::m_remove_reason_io_error,
-						&acl_stats_t::m_remove_reason_io_error ),
-				std::pair(
-						&connections_stats_t::m_remove_reason_current_operation_timed_out,
-						&acl_stats_t::m_remove_reason_current_operation_timed_out ),
-				std::pair(
-						&connections_stats_t::m_remove_reason_unsupported_protocol,
-						&acl_stats_t::m_remove_reason_unsupported_protocol ),
-				std::pair(
-						&connections_stats_t::m_remove_reason_protocol_error,
-						&acl_stats_t::m_remove_reason_protocol_error ),
-				std::pair(
-						&connections_stats_t::m_remove_reason_unexpected_error,
-						&acl_stats_t::m_remove_reason_unexpected_error ),
-				std::pair(
-						&connections_stats_t::m_remove_reason_no_activity_for_too_long,
-						&acl_stats_t::m_remove_reason_no_activity_for_too_long ),
-				std::pair(
-						&connections_stats_t::m_remove_reason_current_operation_canceled,
-						&acl_stats_t::m_remove_reason_current_operation_canceled ),
-				std::pair(
-						&connections_stats_t::m_remove_reason_unhandled_exception,
-						&acl_stats_t::m_remove_reason_unhandled_exception ),
-				std::pair(
-						&connections_stats_t::m_remove_reason_ip_version_mismatch,
-						&acl_stats_t::m_remove_reason_ip_version_mismatch ),
-				std::pair(
-						&connections_stats_t::m_remove_reason_access_denied,
-						&acl_stats_t::m_remove_reason_access_denied ),
-				std::pair(
-						&connections_stats_t::m_remove_reason_unresolved_target,
-						&acl_stats_t::m_remove_reason_unresolved_target ),
-				std::pair(
-						&connections_stats_t::m_remove_reason_target_end_broken,
-						&acl_stats_t::m_remove_reason_target_end_broken ),
-				std::pair(
-						&connections_stats_t::m_remove_reason_user_end_broken,
-						&acl_stats_t::m_remove_reason_user_end_broken ),
-				std::pair(
-						&connections_stats_t::m_remove_reason_early_http_response,
-						&acl_stats_t::m_remove_reason_early_http_response ),
-				std::pair(
-						&connections_stats_t::m_remove_reason_user_end_closed_by_client,
-						&acl_stats_t::m_remove_reason_user_end_closed_by_client ),
-				std::pair(
-						&connections_stats_t::m_remove_reason_http_no_incoming_request,
-						&acl_stats_t::m_remove_reason_http_no_incoming_request )
-
-			};
-
-			for( const auto & [d, s] : ptr_pairs )
+		[&result]( const auto & acl_stats ) {
+			add_connection_counters( result, acl_stats );
+
+			// An ACL can be served by several IO-threads, the latencies
+			// from all of them are merged by the name of ACL.
+			auto & acl_latencies =
+					result.m_acl_setup_latencies[ acl_stats.m_acl_name ];
+			for( std::size_t i = 0u; i != setup_stages_count; ++i )
 			{
-				(result.*d) += value_of( (acl_stats.*s) );
+				acl_latencies[ i ].merge( acl_stats.m_setup_latencies[ i ] );
+				result.m_setup_latencies[ i ].merge(
+						acl_stats.m_setup_latencies[ i ] );
 			}
 
 			return acl_stats_enumerator_t::go_next;
@@ -254,6 +591,8 @@ a_stats_collector_t::get_current_dns_stats() const
 				result.m_dns_failed_lookups += value_of(
 						dns_stats.m_dns_failed_lookups );
 
+				result.m_upstream_rtt.merge( dns_stats.m_upstream_rtt );
+
 				return dns_stats_enumerator_t::go_next;
 			} );
 
@@ -262,6 +601,244 @@ a_stats_collector_t::get_current_dns_stats() const
 	return result;
 }
 
+[[nodiscard]]
+a_stats_collector_t::io_chunk_stats_t
+a_stats_collector_t::get_current_io_chunk_stats() const
+{
+	using namespace ::arataga::stats::io_chunks;
+
+	io_chunk_stats_t result{};
+
+	auto collector = lambda_as_enumerator(
+			[&result]( const auto & io_chunk_stats ) noexcept {
+				result.m_chunks_in_use += value_of(
+						io_chunk_stats.m_chunks_in_use );
+				result.m_bytes_in_use += value_of(
+						io_chunk_stats.m_bytes_in_use );
+				result.m_chunks_cached += value_of(
+						io_chunk_stats.m_chunks_cached );
+				result.m_bytes_cached += value_of(
+						io_chunk_stats.m_bytes_cached );
+				result.m_chunks_allocated += value_of(
+						io_chunk_stats.m_chunks_allocated );
+				result.m_chunks_reused += value_of(
+						io_chunk_stats.m_chunks_reused );
+
+				return io_chunk_stats_enumerator_t::go_next;
+			} );
+
+	m_app_ctx.m_io_chunk_stats_manager->enumerate( collector );
+
+	return result;
+}
+
+void
+a_stats_collector_t::update_acl_metrics()
+{
+	using namespace ::arataga::stats::connections;
+
+	// Values are reset, but items are kept for the next use.
+	for( auto & [acl_name, m] : m_acl_metrics )
+		m = acl_metrics_t{};
+
+	// NOTE: the lambda isn't noexcept because of the insertion of
+	// new ACLs. All other work (including the serialization) is
+	// performed outside of the enumeration, so the manager is locked
+	// only for copying of values.
+	auto collector = lambda_as_enumerator(
+		[this]( const auto & acl_stats ) {
+			// An ACL can be served by several IO-threads, the stats
+			// from all of them are merged by the name of ACL.
+			auto & acl_metrics = m_acl_metrics[ acl_stats.m_acl_name ];
+			acl_metrics.m_active = true;
+
+			add_connection_counters( acl_metrics.m_connections, acl_stats );
+			for( std::size_t i = 0u; i != setup_stages_count; ++i )
+				acl_metrics.m_setup_latencies[ i ].merge(
+						acl_stats.m_setup_latencies[ i ] );
+
+			return acl_stats_enumerator_t::go_next;
+		} );
+
+	m_app_ctx.m_acl_stats_manager->enumerate( collector );
+
+	for( auto it = m_acl_metrics.begin(); it != m_acl_metrics.end(); )
+	{
+		if( it->second.m_active )
+			++it;
+		else
+			it = m_acl_metrics.erase( it );
+	}
+}
+
+void
+a_stats_collector_t::format_metrics( std::string & to )
+{
+	// Samples of one family have to be grouped together, so every
+	// family requires a separate pass over the ACLs.
+	{
+		update_acl_metrics();
+		const auto & acls = m_acl_metrics;
+
+		metric_family( to, "arataga_connections", "counter",
+				"Accepted connections." );
+		for( const auto & [acl_name, m] : acls )
+			fmt::format_to( std::back_inserter(to),
+					"arataga_connections_total{{acl=\"{}\"}} {}\n",
+					acl_name, m.m_connections.m_total_connections );
+
+		metric_family( to, "arataga_proxy_connections", "counter",
+				"Connections by the detected protocol." );
+		for( const auto & [acl_name, m] : acls )
+			fmt::format_to( std::back_inserter(to),
+					"arataga_proxy_connections_total"
+							"{{acl=\"{0}\",protocol=\"http\"}} {1}\n"
+					"arataga_proxy_connections_total"
+							"{{acl=\"{0}\",protocol=\"socks5\"}} {2}\n",
+					acl_name,
+					m.m_connections.m_http_connections,
+					m.m_connections.m_socks5_connections );
+
+		metric_family( to, "arataga_connections_removed", "counter",
+				"Removed connections by the reason." );
+		for( const auto & [acl_name, m] : acls )
+			metric_remove_reasons( to, acl_name, m.m_connections );
+
+		metric_family( to, "arataga_setup_latency_seconds", "histogram",
+				"Latencies of connection setup stages." );
+		std::string labels;
+		for( const auto & [acl_name, m] : acls )
+			for( std::size_t i = 0u; i != setup_stage_names.size(); ++i )
+			{
+				const auto & latency = m.m_setup_latencies[ i ];
+				// Stages without values are skipped like in /stats.
+				if( !latency.count() )
+					continue;
+
+				labels.clear();
+				fmt::format_to( std::back_inserter(labels),
+						"acl=\"{}\",stage=\"{}\"",
+						acl_name, setup_stage_names[ i ] );
+				metric_histogram( to, "arataga_setup_latency_seconds",
+						labels, latency );
+			}
+	}
+
+	{
+		const auto auth_stats = get_current_auth_stats();
+
+		metric_family( to, "arataga_auth_requests", "counter",
+				"Authentification requests." );
+		metric_sample( to, "arataga_auth_requests_total", {},
+				auth_stats.m_auth_total_count );
+
+		metric_family( to, "arataga_auth", "counter",
+				"Authentifications by the method." );
+		metric_sample( to, "arataga_auth_total", R"(method="ip")",
+				auth_stats.m_auth_by_ip_count );
+		metric_sample( to, "arataga_auth_total", R"(method="login")",
+				auth_stats.m_auth_by_login_count );
+
+		metric_family( to, "arataga_auth_rejected", "counter",
+				"Rejected authentifications by the reason." );
+		metric_sample( to, "arataga_auth_rejected_total",
+				R"(reason="invalid_ip")",
+				auth_stats.m_failed_auth_by_ip_count );
+		metric_sample( to, "arataga_auth_rejected_total",
+				R"(reason="invalid_login")",
+				auth_stats.m_failed_auth_by_login_count );
+		metric_sample( to, "arataga_auth_rejected_total",
+				R"(reason="denied_port")",
+				auth_stats.m_failed_authorization_denied_port );
+	}
+
+	{
+		const auto dns_stats = get_current_dns_stats();
+
+		metric_family( to, "arataga_dns_cache_hits", "counter",
+				"Domain names resolved from the DNS cache." );
+		metric_sample( to, "arataga_dns_cache_hits_total", {},
+				dns_stats.m_dns_cache_hits );
+
+		metric_family( to, "arataga_dns_lookups", "counter",
+				"DNS lookups by the result." );
+		metric_sample( to, "arataga_dns_lookups_total",
+				R"(result="success")",
+				dns_stats.m_dns_successful_lookups );
+		metric_sample( to, "arataga_dns_lookups_total",
+				R"(result="failure")",
+				dns_stats.m_dns_failed_lookups );
+
+		metrics_histogram_t rtt;
+		rtt.merge( dns_stats.m_upstream_rtt );
+
+		metric_family( to, "arataga_dns_upstream_rtt_seconds", "histogram",
+				"Round-trip time of lookups made to name servers." );
+		metric_histogram( to, "arataga_dns_upstream_rtt_seconds", {}, rtt );
+	}
+
+	{
+		const auto io_chunk_stats = get_current_io_chunk_stats();
+
+		metric_family( to, "arataga_io_chunks_in_use", "gauge",
+				"I/O chunks used by connections." );
+		metric_sample( to, "arataga_io_chunks_in_use", {},
+				io_chunk_stats.m_chunks_in_use );
+
+		metric_family( to, "arataga_io_chunk_bytes_in_use", "gauge",
+				"Size of I/O chunks used by connections." );
+		metric_sample( to, "arataga_io_chunk_bytes_in_use", {},
+				io_chunk_stats.m_bytes_in_use );
+
+		metric_family( to, "arataga_io_chunks_cached", "gauge",
+				"Free I/O chunks kept in pools." );
+		metric_sample( to, "arataga_io_chunks_cached", {},
+				io_chunk_stats.m_chunks_cached );
+
+		metric_family( to, "arataga_io_chunk_bytes_cached", "gauge",
+				"Size of free I/O chunks kept in pools." );
+		metric_sample( to, "arataga_io_chunk_bytes_cached", {},
+				io_chunk_stats.m_bytes_cached );
+
+		metric_family( to, "arataga_io_chunks_allocated", "counter",
+				"Allocations of new I/O chunks." );
+		metric_sample( to, "arataga_io_chunks_allocated_total", {},
+				io_chunk_stats.m_chunks_allocated );
+
+		metric_family( to, "arataga_io_chunks_reused", "counter",
+				"I/O chunks taken from pools." );
+		metric_sample( to, "arataga_io_chunks_reused_total", {},
+				io_chunk_stats.m_chunks_reused );
+	}
+
+	{
+		const auto & cnts = ::arataga::logging::counters();
+
+		metric_family( to, "arataga_log_messages", "counter",
+				"Log messages by the level." );
+		metric_sample( to, "arataga_log_messages_total", R"(level="trace")",
+				value_of( cnts.m_level_trace_count ) );
+		metric_sample( to, "arataga_log_messages_total", R"(level="debug")",
+				value_of( cnts.m_level_debug_count ) );
+		metric_sample( to, "arataga_log_messages_total", R"(level="info")",
+				value_of( cnts.m_level_info_count ) );
+		metric_sample( to, "arataga_log_messages_total", R"(level="warn")",
+				value_of( cnts.m_level_warn_count ) );
+		metric_sample( to, "arataga_log_messages_total", R"(level="error")",
+				value_of( cnts.m_level_error_count ) );
+		metric_sample( to, "arataga_log_messages_total",
+				R"(level="critical")",
+				value_of( cnts.m_level_critical_count ) );
+
+		metric_family( to, "arataga_log_exceptions", "counter",
+				"Exceptions thrown during logging." );
+		metric_sample( to, "arataga_log_exceptions_total", {},
+				value_of( cnts.m_exceptions_during_logging ) );
+	}
+
+	metrics_eof( to );
+}
+
 void
 a_stats_collector_t::format_connection_stats(
 	std::ostream & to,
@@ -343,6 +920,64 @@ a_stats_collector_t::format_connection_stats(
 	}
 }
 
+void
+a_stats_collector_t::format_setup_latencies(
+	std::ostream & to,
+	const connections_stats_t & stats )
+{
+	const auto & stage_names = setup_stage_names;
+
+	for( std::size_t i = 0u; i != stage_names.size(); ++i )
+	{
+		format_latency( to,
+				fmt::format( "SETUP_LATENCY_{}", stage_names[ i ] ),
+				stats.m_setup_latencies[ i ] );
+	}
+
+	// There can be thousands of ACLs, so there is just one line
+	// for a stage of an ACL, and stages without values are skipped.
+	for( const auto & [acl_name, latencies] : stats.m_acl_setup_latencies )
+	{
+		for( std::size_t i = 0u; i != stage_names.size(); ++i )
+		{
+			const auto & l = latencies[ i ];
+			if( !l.total() )
+				continue;
+
+			fmt::print( to,
+					"ACL_SETUP_LATENCY_{}[{}]: count={} p50={} p90={} "
+							"p99={} p999={}\r\n",
+					stage_names[ i ],
+					acl_name,
+					l.total(),
+					l.percentile( 0.5 ),
+					l.percentile( 0.9 ),
+					l.percentile( 0.99 ),
+					l.percentile( 0.999 ) );
+		}
+	}
+}
+
+void
+a_stats_collector_t::format_latency(
+	std::ostream & to,
+	std::string_view name,
+	const ::arataga::stats::latency_snapshot_t & latency )
+{
+	fmt::print( to,
+			"{0}_COUNT: {1}\r\n"
+			"{0}_P50_US: {2}\r\n"
+			"{0}_P90_US: {3}\r\n"
+			"{0}_P99_US: {4}\r\n"
+			"{0}_P999_US: {5}\r\n",
+			name,
+			latency.total(),
+			latency.percentile( 0.5 ),
+			latency.percentile( 0.9 ),
+			latency.percentile( 0.99 ),
+			latency.percentile( 0.999 ) );
+}
+
 //
 // introduce_stats_collector
 //
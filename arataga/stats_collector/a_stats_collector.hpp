@@ -7,6 +7,18 @@
 
 #include <arataga/stats_collector/introduce_stats_collector.hpp>
 #include <arataga/stats_collector/msg_get_stats.hpp>
+#include <arataga/stats_collector/openmetrics.hpp>
+
+#include <arataga/stats/connections/pub.hpp>
+#include <arataga/stats/traffic/pub.hpp>
+
+#include <arataga/one_second_timer.hpp>
+
+#include <array>
+#include <deque>
+#include <map>
+#include <string>
+#include <string_view>
 
 namespace arataga::stats_collector
 {
@@ -28,8 +40,19 @@ private:
 	//! Type for stats counters.
 	using counter_t = std::uint_fast64_t;
 
-	//! Type of stats for connections.
-	struct connections_stats_t
+	//! Type of merged latencies of all connection setup stages.
+	/*!
+	 * @since v.0.6.0
+	 */
+	using setup_latencies_t = std::array<
+			::arataga::stats::latency_snapshot_t,
+			::arataga::stats::connections::setup_stages_count >;
+
+	//! Type of counters for connections.
+	/*!
+	 * @since v.0.6.0
+	 */
+	struct connection_counters_t
 	{
 		counter_t m_total_connections{};
 		counter_t m_http_connections{};
@@ -53,6 +76,23 @@ private:
 		counter_t m_remove_reason_http_no_incoming_request{};
 	};
 
+	//! Type of stats for connections.
+	struct connections_stats_t : public connection_counters_t
+	{
+		/*!
+		 * @since v.0.6.0
+		 */
+		setup_latencies_t m_setup_latencies{};
+
+		//! Latencies for every ACL.
+		/*!
+		 * The key is the name of ACL.
+		 *
+		 * @since v.0.6.0
+		 */
+		std::map< std::string, setup_latencies_t > m_acl_setup_latencies;
+	};
+
 	//! Type of stats for authentifications.
 	struct auth_stats_t
 	{
@@ -70,13 +110,118 @@ private:
 		counter_t m_dns_cache_hits{};
 		counter_t m_dns_successful_lookups{};
 		counter_t m_dns_failed_lookups{};
+
+		/*!
+		 * @since v.0.6.0
+		 */
+		::arataga::stats::latency_snapshot_t m_upstream_rtt{};
+	};
+
+	/*!
+	 * @since v.0.6.0
+	 */
+	struct io_chunk_stats_t
+	{
+		counter_t m_chunks_in_use{};
+		counter_t m_bytes_in_use{};
+		counter_t m_chunks_cached{};
+		counter_t m_bytes_cached{};
+		counter_t m_chunks_allocated{};
+		counter_t m_chunks_reused{};
+	};
+
+	//! Traffic transferred during one second.
+	/*!
+	 * @since v.0.6.0
+	 */
+	struct traffic_second_t
+	{
+		std::map< std::uint64_t, ::arataga::stats::traffic::traffic_totals_t >
+				m_users;
+		std::map< std::string, ::arataga::stats::traffic::traffic_totals_t >
+				m_acls;
+		//! Bandwidth limits of users from m_users.
+		std::map< std::uint64_t, ::arataga::bandlim_config_t > m_user_limits;
+	};
+
+	//! How many seconds of traffic history are kept.
+	/*!
+	 * It's the longest period reported by /stats/top.
+	 *
+	 * @since v.0.6.0
+	 */
+	static constexpr std::size_t traffic_history_depth{ 60u };
+
+	//! Stats of one ACL for OpenMetrics output.
+	/*!
+	 * @since v.0.6.0
+	 */
+	struct acl_metrics_t
+	{
+		//! Is the ACL found during the current update?
+		bool m_active{};
+
+		connection_counters_t m_connections{};
+
+		std::array<
+				metrics_histogram_t,
+				::arataga::stats::connections::setup_stages_count >
+			m_setup_latencies{};
 	};
 
 	const application_context_t m_app_ctx;
 
+	//! The stats of every ACL for OpenMetrics output.
+	/*!
+	 * The key is the name of ACL.
+	 *
+	 * Items are reused by every request, so the memory is allocated
+	 * only for new ACLs.
+	 *
+	 * @since v.0.6.0
+	 */
+	std::map< std::string, acl_metrics_t > m_acl_metrics;
+
+	//! The size of the previous output in OpenMetrics format.
+	/*!
+	 * The memory for the next output is reserved in advance.
+	 * The output itself is passed to the response as is, so it
+	 * can't be reused.
+	 *
+	 * @since v.0.6.0
+	 */
+	std::size_t m_metrics_size_hint{};
+
+	//! Traffic for the last seconds.
+	/*!
+	 * The data for the latest second is at the front.
+	 *
+	 * @since v.0.6.0
+	 */
+	std::deque< traffic_second_t > m_traffic_history;
+
 	void
 	on_get_current_stats( mhood_t< get_current_stats_t > cmd );
 
+	/*!
+	 * @since v.0.6.0
+	 */
+	void
+	on_get_traffic_top( mhood_t< get_traffic_top_t > cmd );
+
+	/*!
+	 * @since v.0.6.0
+	 */
+	void
+	on_get_metrics( mhood_t< get_metrics_t > cmd );
+
+	//! Collect the traffic of all IO-threads for the last second.
+	/*!
+	 * @since v.0.6.0
+	 */
+	void
+	on_one_second_timer( mhood_t< one_second_timer_t > );
+
 	[[nodiscard]]
 	connections_stats_t
 	get_current_connections_stats() const;
@@ -89,10 +234,51 @@ private:
 	dns_stats_t
 	get_current_dns_stats() const;
 
+	/*!
+	 * @since v.0.6.0
+	 */
+	[[nodiscard]]
+	io_chunk_stats_t
+	get_current_io_chunk_stats() const;
+
+	//! Update m_acl_metrics with the current stats of every ACL.
+	/*!
+	 * Items for ACLs that don't exist anymore are removed.
+	 *
+	 * @since v.0.6.0
+	 */
+	void
+	update_acl_metrics();
+
+	//! Serialize all stats in OpenMetrics format.
+	/*!
+	 * @since v.0.6.0
+	 */
+	void
+	format_metrics( std::string & to );
+
 	static void
 	format_connection_stats(
 		std::ostream & to,
 		const connections_stats_t & stats );
+
+	/*!
+	 * @since v.0.6.0
+	 */
+	static void
+	format_setup_latencies(
+		std::ostream & to,
+		const connections_stats_t & stats );
+
+	//! Print count and percentiles as separate lines.
+	/*!
+	 * @since v.0.6.0
+	 */
+	static void
+	format_latency(
+		std::ostream & to,
+		std::string_view name,
+		const ::arataga::stats::latency_snapshot_t & latency );
 };
 
 } /* namespace arataga::stats_collector */
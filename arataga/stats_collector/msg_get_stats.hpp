@@ -24,5 +24,44 @@ struct get_current_stats_t final : public so_5::message_t
 	{}
 };
 
+//
+// get_traffic_top_t
+//
+/*!
+ * @since v.0.6.0
+ */
+struct get_traffic_top_t final : public so_5::message_t
+{
+	::arataga::admin_http_entry::replier_shptr_t m_replier;
+
+	//! How many users and ACLs should be reported for every period.
+	std::size_t m_top_n;
+
+	get_traffic_top_t(
+		::arataga::admin_http_entry::replier_shptr_t replier,
+		std::size_t top_n )
+		:	m_replier{ replier }
+		,	m_top_n{ top_n }
+	{}
+};
+
+//
+// get_metrics_t
+//
+/*!
+ * @brief A request for the current stats in OpenMetrics format.
+ *
+ * @since v.0.6.0
+ */
+struct get_metrics_t final : public so_5::message_t
+{
+	::arataga::admin_http_entry::replier_shptr_t m_replier;
+
+	get_metrics_t(
+		::arataga::admin_http_entry::replier_shptr_t replier )
+		:	m_replier{ replier }
+	{}
+};
+
 } /* namespace arataga::stats_collector */
 
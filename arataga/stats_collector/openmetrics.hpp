@@ -0,0 +1,198 @@
+/*!
+ * @file
+ * @brief Helpers for the serialization of stats in OpenMetrics format.
+ * @since v.0.6.0
+ */
+
+#pragma once
+
+#include <arataga/stats/latency_histogram.hpp>
+
+#include <fmt/format.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+namespace arataga::stats_collector
+{
+
+//
+// metrics_histogram_t
+//
+//! Latencies in the form suitable for OpenMetrics histograms.
+/*!
+ * Bounds of buckets are powers of two in microseconds, from
+ * 2^first_bound_bits to 2^latency_buckets::max_magnitude. It's much
+ * less than the number of buckets in latency_histogram_t, so
+ * the output for thousands of ACLs has a reasonable size.
+ */
+struct metrics_histogram_t
+{
+	static constexpr unsigned first_bound_bits = 4u;
+
+	static constexpr std::size_t bounds_count =
+			::arataga::stats::latency_buckets::max_magnitude + 1u
+			- first_bound_bits;
+
+	//! Non-cumulative counts of values for every bound.
+	/*!
+	 * The last item is for values greater than the last bound.
+	 */
+	std::array< std::uint64_t, bounds_count + 1u > m_buckets{};
+
+	//! The sum of all values in microseconds.
+	std::uint64_t m_sum{};
+
+	//! Get the bound with @a index in microseconds.
+	[[nodiscard]]
+	static constexpr std::uint64_t
+	bound( std::size_t index ) noexcept
+	{
+		return std::uint64_t{1u} << (index + first_bound_bits);
+	}
+
+	//! Add values from latency_histogram_t or latency_snapshot_t.
+	/*!
+	 * A bucket of the source goes to the first bound that isn't less
+	 * than the highest value of the bucket.
+	 */
+	template< typename Source >
+	void
+	merge( const Source & source ) noexcept
+	{
+		namespace lb = ::arataga::stats::latency_buckets;
+
+		// The index in m_buckets for every bucket of the source.
+		static const auto indexes = [] {
+			std::array< std::size_t, lb::count > result{};
+			for( std::size_t i = 0u; i != result.size(); ++i )
+			{
+				const auto highest = lb::highest_value_of( i );
+
+				std::size_t b = 0u;
+				while( b != bounds_count && highest > bound( b ) )
+					++b;
+
+				result[ i ] = b;
+			}
+			return result;
+		}();
+
+		for( std::size_t i = 0u; i != indexes.size(); ++i )
+			m_buckets[ indexes[ i ] ] += source.bucket_value( i );
+
+		m_sum += source.sum();
+	}
+
+	//! The total number of values.
+	[[nodiscard]]
+	std::uint64_t
+	count() const noexcept
+	{
+		std::uint64_t result{};
+		for( const auto v : m_buckets )
+			result += v;
+		return result;
+	}
+};
+
+//
+// Helpers for OpenMetrics format.
+//
+// NOTE: names of ACLs contain only an IP-address and a port, so values
+// of labels aren't escaped.
+//
+
+//! Write the description of a metric family.
+inline void
+metric_family(
+	std::string & to,
+	std::string_view name,
+	std::string_view type,
+	std::string_view help )
+{
+	fmt::format_to( std::back_inserter(to),
+			"# TYPE {0} {1}\n"
+			"# HELP {0} {2}\n",
+			name, type, help );
+}
+
+//! Write a sample.
+/*!
+ * @a labels are empty or like `a="b",c="d"`.
+ */
+inline void
+metric_sample(
+	std::string & to,
+	std::string_view name,
+	std::string_view labels,
+	std::uint64_t value )
+{
+	if( labels.empty() )
+		fmt::format_to( std::back_inserter(to), "{} {}\n", name, value );
+	else
+		fmt::format_to( std::back_inserter(to),
+				"{}{{{}}} {}\n", name, labels, value );
+}
+
+//! Write all samples of a histogram.
+/*!
+ * @a labels are empty or like `a="b",c="d"`.
+ */
+inline void
+metric_histogram(
+	std::string & to,
+	std::string_view name,
+	std::string_view labels,
+	const metrics_histogram_t & histogram )
+{
+	// Values of `le` are in seconds.
+	static const auto bounds = [] {
+		std::array< std::string, metrics_histogram_t::bounds_count > result;
+		for( std::size_t i = 0u; i != result.size(); ++i )
+			result[ i ] = fmt::format( "{}",
+					static_cast< double >(metrics_histogram_t::bound( i )) / 1e6 );
+		return result;
+	}();
+
+	const std::string_view separator = labels.empty() ? "" : ",";
+
+	std::uint64_t cumulative{};
+	for( std::size_t i = 0u; i != bounds.size(); ++i )
+	{
+		cumulative += histogram.m_buckets[ i ];
+		fmt::format_to( std::back_inserter(to),
+				"{}_bucket{{{}{}le=\"{}\"}} {}\n",
+				name, labels, separator, bounds[ i ], cumulative );
+	}
+
+	cumulative += histogram.m_buckets.back();
+	fmt::format_to( std::back_inserter(to),
+			"{}_bucket{{{}{}le=\"+Inf\"}} {}\n",
+			name, labels, separator, cumulative );
+
+	const auto sum = static_cast< double >(histogram.m_sum) / 1e6;
+	if( labels.empty() )
+		fmt::format_to( std::back_inserter(to),
+				"{0}_count {1}\n"
+				"{0}_sum {2}\n",
+				name, cumulative, sum );
+	else
+		fmt::format_to( std::back_inserter(to),
+				"{0}_count{{{1}}} {2}\n"
+				"{0}_sum{{{1}}} {3}\n",
+				name, labels, cumulative, sum );
+}
+
+//! Finish the output.
+inline void
+metrics_eof( std::string & to )
+{
+	to += "# EOF\n";
+}
+
+} /* namespace arataga::stats_collector */
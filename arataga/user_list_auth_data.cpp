@@ -6,6 +6,7 @@
 #include <arataga/user_list_auth_data.hpp>
 
 #include <arataga/utils/ensure_successful_syscall.hpp>
+#include <arataga/utils/line_extractor.hpp>
 #include <arataga/utils/line_reader.hpp>
 #include <arataga/utils/load_file_into_memory.hpp>
 #include <arataga/utils/overloaded.hpp>
@@ -19,6 +20,8 @@
 
 #include <algorithm>
 #include <cctype>
+#include <future>
+#include <iterator>
 #include <variant>
 
 namespace arataga::user_list_auth {
@@ -512,13 +515,269 @@ make_line_parser()
 	);
 }
 
+[[noreturn]]
+void
+throw_parsing_error(
+	unsigned long line_number,
+	std::string_view description )
+{
+	throw std::runtime_error{
+			fmt::format( "unable to parse line #{}: {}",
+					line_number,
+					description )
+		};
+}
+
+// Returns a description of an error if the line can't be parsed.
 template< typename Line_Parser >
+[[nodiscard]]
+std::optional< std::string >
+try_analyze_line_read(
+	std::string_view line,
+	Line_Parser & parser,
+	auth_data_t & result)
+{
+	using namespace restinio::http_field_parsers;
+
+	auto parse_result = try_parse( line, parser );
+	if( !parse_result )
+	{
+		return make_error_description( parse_result.error(), line );
+	}
+
+	std::visit(
+		::arataga::utils::overloaded{
+			[&result]( by_ip_data_t & v ) {
+				result.m_by_ip.emplace(
+						std::move(v.m_key), std::move(v.m_data) );
+			},
+			[&result]( by_login_data_t & v ) {
+				result.m_by_login.emplace(
+						std::move(v.m_key), std::move(v.m_data) );
+			},
+			[&result]( limits_data_t & v ) {
+				result.m_site_limits.emplace(
+						std::move(v.m_key), std::move(v.m_data) );
+			}
+		},
+		*parse_result );
+
+	return std::nullopt;
+}
+
+//
+// chunk_parsing_result_t
+//
+/*
+ * The result of parsing of one part of user-list file.
+ *
+ * Since v.0.6.0 a big user-list is split into several parts that are
+ * parsed in parallel.
+ */
+struct chunk_parsing_result_t
+{
+	using line_number_t = ::arataga::utils::line_extractor_t::line_number_t;
+
+	// Description of a parsing error.
+	struct error_t
+	{
+		// The number of the wrong line inside the part.
+		line_number_t m_line_number;
+		std::string m_description;
+	};
+
+	// Items from that part.
+	auth_data_t m_data;
+
+	// The number of line breaks in that part.
+	// It's necessary for the calculation of line numbers in
+	// the next parts.
+	line_number_t m_line_breaks{ 0u };
+
+	// The first parsing error (if any).
+	// Parsing is stopped at the first error.
+	std::optional< error_t > m_error;
+};
+
+[[nodiscard]]
+chunk_parsing_result_t
+parse_chunk( std::string_view chunk )
+{
+	chunk_parsing_result_t result;
+
+	// A parser for lines from user-list file.
+	auto parser = make_line_parser();
+
+	::arataga::utils::line_extractor_t extractor{ chunk };
+	while( const auto line = extractor.get_next() )
+	{
+		if( auto error = try_analyze_line_read( *line, parser, result.m_data ) )
+		{
+			result.m_error = chunk_parsing_result_t::error_t{
+					extractor.line_number(),
+					std::move(*error)
+				};
+			return result;
+		}
+	}
+
+	result.m_line_breaks = extractor.line_number() - 1u;
+
+	return result;
+}
+
+//
+// min_chunk_size
+//
+/*
+ * The minimal size of a part of user-list that is parsed by
+ * a separate thread. Smaller user-lists are parsed on the caller's
+ * thread because the start of a thread costs more.
+ */
+constexpr std::size_t min_chunk_size{ 1024u * 1024u };
+
+//
+// split_into_chunks
+//
+/*
+ * Split the content of user-list file into parts of approximately
+ * the same size.
+ *
+ * A part ends with '\n' and the next part starts with a symbol that
+ * isn't '\r' or '\n'. So line_extractor_t for a part sees the same
+ * lines as line_extractor_t for the whole content would see (including
+ * the counting of line breaks).
+ */
+[[nodiscard]]
+std::vector< std::string_view >
+split_into_chunks(
+	std::string_view content,
+	unsigned int threads_count )
+{
+	const std::size_t chunks_count = std::max< std::size_t >( 1u,
+			std::min< std::size_t >(
+					threads_count, content.size() / min_chunk_size ) );
+	const std::size_t desired_size = content.size() / chunks_count;
+
+	std::vector< std::string_view > result;
+	result.reserve( chunks_count );
+
+	while( result.size() + 1u < chunks_count && desired_size < content.size() )
+	{
+		auto pos = content.find( '\n', desired_size );
+		while( std::string_view::npos != pos && pos + 1u < content.size() &&
+				('\n' == content[ pos + 1u ] || '\r' == content[ pos + 1u ]) )
+			pos = content.find( '\n', pos + 1u );
+
+		if( std::string_view::npos == pos || pos + 1u >= content.size() )
+			break;
+
+		result.push_back( content.substr( 0u, pos + 1u ) );
+		content.remove_prefix( pos + 1u );
+	}
+
+	result.push_back( content );
+
+	return result;
+}
+
+//
+// merge_parsed_items
+//
+/*
+ * Move items from @a from to @a to. If an item is present in both
+ * containers then the item from @a to is kept, as it's done by
+ * the sequential parsing (the first occurrence wins).
+ */
 void
-analyze_line_read(
+merge_parsed_items( auth_data_t & to, auth_data_t & from )
+{
+	to.m_by_ip.merge( from.m_by_ip );
+	to.m_by_login.merge( from.m_by_login );
+	to.m_site_limits.merge( from.m_site_limits );
+}
+
+//
+// removed_item_t
+//
+/*
+ * A value that has to be produced as the result of the parsing of the rule:
+ *
+ * '-' (auth_by_login | auth_by_ip | site_limits_id)
+ *
+ * NOTE: auth_by_login is checked before auth_by_ip because
+ * auth_by_ip is a prefix of auth_by_login.
+ */
+struct removed_item_t
+{
+	using key_t = std::variant<
+		auth_by_ip_key_t,
+		auth_by_login_key_t,
+		site_limits_key_t >;
+
+	key_t m_key;
+
+	[[nodiscard]]
+	static auto
+	make_producer()
+	{
+		using namespace restinio::http_field_parsers;
+
+		return produce< removed_item_t >(
+				symbol( '-' ),
+				ows(),
+				produce< key_t >(
+					alternatives(
+						auth_by_login_p() >> as_result(),
+						auth_by_ip_p() >> as_result(),
+						site_limits_key_p() >> as_result()
+					)
+				) >> &removed_item_t::m_key );
+	}
+};
+
+//
+// delta_line_content_t
+//
+/*
+ * A type for holding the result of parsing a single line of user-list
+ * delta.
+ */
+using delta_line_content_t = std::variant<
+	by_ip_data_t,
+	by_login_data_t,
+	limits_data_t,
+	removed_item_t >;
+
+//
+// make_delta_line_parser
+//
+/*!
+ * @brief Makes a producer for delta_line_content_t values.
+ */
+[[nodiscard]]
+auto
+make_delta_line_parser()
+{
+	using namespace restinio::http_field_parsers;
+
+	return produce< delta_line_content_t >(
+		alternatives(
+			removed_item_t::make_producer() >> as_result(),
+			by_ip_data_t::make_producer() >> as_result(),
+			by_login_data_t::make_producer() >> as_result(),
+			limits_data_t::make_producer() >> as_result()
+		)
+	);
+}
+
+template< typename Line_Parser >
+void
+analyze_delta_line_read(
 	std::string_view line,
 	unsigned long line_number,
 	Line_Parser & parser,
-	auth_data_t & result)
+	auth_data_delta_t & result)
 {
 	using namespace restinio::http_field_parsers;
 
@@ -532,24 +791,85 @@ analyze_line_read(
 			};
 	}
 
+	// NOTE: the last change for a key wins.
 	std::visit(
 		::arataga::utils::overloaded{
 			[&result]( by_ip_data_t & v ) {
-				result.m_by_ip.emplace(
+				result.m_by_ip.insert_or_assign(
 						std::move(v.m_key), std::move(v.m_data) );
 			},
 			[&result]( by_login_data_t & v ) {
-				result.m_by_login.emplace(
+				result.m_by_login.insert_or_assign(
 						std::move(v.m_key), std::move(v.m_data) );
 			},
 			[&result]( limits_data_t & v ) {
-				result.m_site_limits.emplace(
+				result.m_site_limits.insert_or_assign(
 						std::move(v.m_key), std::move(v.m_data) );
+			},
+			[&result]( removed_item_t & v ) {
+				std::visit(
+					::arataga::utils::overloaded{
+						[&result]( auth_by_ip_key_t & k ) {
+							result.m_by_ip.insert_or_assign(
+									std::move(k), std::nullopt );
+						},
+						[&result]( auth_by_login_key_t & k ) {
+							result.m_by_login.insert_or_assign(
+									std::move(k), std::nullopt );
+						},
+						[&result]( site_limits_key_t & k ) {
+							result.m_site_limits.insert_or_assign(
+									std::move(k), std::nullopt );
+						}
+					},
+					v.m_key );
 			}
 		},
 		*parse_result );
 }
 
+// Helper for merging of one dictionary of changes.
+template< typename Map >
+void
+merge_changes( Map & to, const Map & from )
+{
+	for( const auto & [k, v] : from )
+		to.insert_or_assign( k, v );
+}
+
+// Helper for applying of one dictionary of changes.
+template< typename Map, typename Changes >
+void
+apply_changes( Map & to, const Changes & changes )
+{
+	for( const auto & [k, v] : changes )
+	{
+		if( v )
+			to.insert_or_assign( k, *v );
+		else
+			to.erase( k );
+	}
+}
+
+// Helper for formatting of band-limits in the form that is accepted
+// by bandlim_p().
+void
+format_bandlims( std::string & to, const bandlim_config_t & v )
+{
+	fmt::format_to( std::back_inserter( to ), "{} {}", v.m_in, v.m_out );
+}
+
+// Helper for formatting of user_data in the form that is accepted
+// by user_data_p().
+void
+format_user_data( std::string & to, const user_data_t & v )
+{
+	format_bandlims( to, v.m_bandlims );
+	fmt::format_to( std::back_inserter( to ), " {} {}\n",
+			v.m_site_limits_id,
+			v.m_user_id );
+}
+
 } /* namespace anonymous */
 
 //
@@ -560,18 +880,75 @@ auth_data_t
 parse_auth_data(
 	std::string_view user_list_content )
 {
-	auth_data_t result;
+	auto result = parse_chunk( user_list_content );
+	if( result.m_error )
+		throw_parsing_error(
+				result.m_error->m_line_number,
+				result.m_error->m_description );
 
-	// A parser for lines from user-list file.
-	auto parser = make_line_parser();
+	return std::move(result.m_data);
+}
 
-	::arataga::utils::line_reader_t content_reader{ user_list_content };
+//
+// parse_auth_data_in_parallel
+//
+[[nodiscard]]
+auth_data_t
+parse_auth_data_in_parallel(
+	std::string_view user_list_content,
+	unsigned int threads_count )
+{
+	const auto chunks = split_into_chunks( user_list_content, threads_count );
+	if( chunks.size() < 2u )
+		return parse_auth_data( user_list_content );
+
+	// The first part is parsed on the caller's thread.
+	std::vector< std::future< chunk_parsing_result_t > > parsing;
+	parsing.reserve( chunks.size() - 1u );
+	for( auto it = std::next( chunks.begin() ); it != chunks.end(); ++it )
+		parsing.push_back( std::async( std::launch::async,
+				[chunk = *it] { return parse_chunk( chunk ); } ) );
+
+	std::vector< chunk_parsing_result_t > results;
+	results.reserve( chunks.size() );
+	results.push_back( parse_chunk( chunks.front() ) );
+	for( auto & f : parsing )
+		results.push_back( f.get() );
+
+	// The error in the first wrong part is reported, so it's the same
+	// error as for the sequential parsing.
+	chunk_parsing_result_t::line_number_t line_breaks{ 0u };
+	for( const auto & r : results )
+	{
+		if( r.m_error )
+			throw_parsing_error(
+					line_breaks + r.m_error->m_line_number,
+					r.m_error->m_description );
 
-	content_reader.for_each_line( [&result, &parser]( const auto & line ) {
-			analyze_line_read( line.content(), line.number(), parser, result );
-		} );
+		line_breaks += r.m_line_breaks;
+	}
 
-	return result;
+	// Results are merged by pairs in parallel. The order of parts is
+	// preserved, so the first occurrence of a key wins.
+	while( results.size() > 1u )
+	{
+		std::vector< std::future< void > > merging;
+		merging.reserve( results.size() / 2u );
+		for( std::size_t i = 0u; i + 1u < results.size(); i += 2u )
+			merging.push_back( std::async( std::launch::async,
+					[&to = results[ i ].m_data, &from = results[ i + 1u ].m_data] {
+						merge_parsed_items( to, from );
+					} ) );
+		for( auto & f : merging )
+			f.get();
+
+		std::size_t merged{ 0u };
+		for( std::size_t i = 0u; i < results.size(); i += 2u )
+			results[ merged++ ] = std::move( results[ i ] );
+		results.resize( merged );
+	}
+
+	return std::move(results.front().m_data);
 }
 
 //
@@ -593,5 +970,113 @@ load_auth_data(
 	return result;
 }
 
-} /* namespace arataga::user_list_auth */
+//
+// parse_auth_data_delta
+//
+[[nodiscard]]
+auth_data_delta_t
+parse_auth_data_delta(
+	std::string_view delta_content )
+{
+	auth_data_delta_t result;
+
+	// A parser for lines of the delta.
+	auto parser = make_delta_line_parser();
+
+	::arataga::utils::line_reader_t content_reader{ delta_content };
+
+	content_reader.for_each_line( [&result, &parser]( const auto & line ) {
+			analyze_delta_line_read(
+					line.content(), line.number(), parser, result );
+		} );
+
+	return result;
+}
+
+//
+// complete_journal_records
+//
+[[nodiscard]]
+std::string_view
+complete_journal_records(
+	std::string_view journal_content ) noexcept
+{
+	const auto last_eol = journal_content.rfind( '\n' );
+	if( std::string_view::npos == last_eol )
+		return journal_content.substr( 0u, 0u );
+
+	return journal_content.substr( 0u, last_eol + 1u );
+}
+
+//
+// merge_auth_data_delta
+//
+void
+merge_auth_data_delta(
+	auth_data_delta_t & to,
+	const auth_data_delta_t & from )
+{
+	merge_changes( to.m_by_ip, from.m_by_ip );
+	merge_changes( to.m_by_login, from.m_by_login );
+	merge_changes( to.m_site_limits, from.m_site_limits );
+}
 
+//
+// apply_auth_data_delta
+//
+void
+apply_auth_data_delta(
+	auth_data_t & to,
+	const auth_data_delta_t & delta )
+{
+	apply_changes( to.m_by_ip, delta.m_by_ip );
+	apply_changes( to.m_by_login, delta.m_by_login );
+	apply_changes( to.m_site_limits, delta.m_site_limits );
+}
+
+//
+// make_auth_data_content
+//
+[[nodiscard]]
+std::string
+make_auth_data_content(
+	const auth_data_t & data )
+{
+	std::string result;
+
+	for( const auto & [k, v] : data.m_by_ip )
+	{
+		fmt::format_to( std::back_inserter( result ), "{} {} {} = ",
+				k.m_proxy_in_addr.to_string(),
+				k.m_proxy_port,
+				k.m_user_ip.to_string() );
+		format_user_data( result, v );
+	}
+
+	for( const auto & [k, v] : data.m_by_login )
+	{
+		fmt::format_to( std::back_inserter( result ), "{} {} {} {} = ",
+				k.m_proxy_in_addr.to_string(),
+				k.m_proxy_port,
+				k.m_username,
+				k.m_password );
+		format_user_data( result, v );
+	}
+
+	for( const auto & [k, v] : data.m_site_limits )
+	{
+		fmt::format_to( std::back_inserter( result ), "{} =",
+				k.m_site_limits_id );
+		for( const auto & l : v.m_limits )
+		{
+			fmt::format_to( std::back_inserter( result ), " {} ",
+					l.m_domain.value() );
+			format_bandlims( result, l.m_bandlims );
+		}
+		result += '\n';
+	}
+
+	return result;
+}
+
+} /* namespace arataga::user_list_auth */
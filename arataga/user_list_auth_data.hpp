@@ -309,6 +309,10 @@ struct site_limits_data_t
 	 * if m_limits contains "v2.api.vk.com", "api.vk.com" and
 	 * "vk.com", and @a host contains "v1.api.vk.com" then
 	 * the limit for "api.vk.com" will be selected.
+	 *
+	 * @note
+	 * This method scans the whole list. Since v.0.6.0 authentificators
+	 * use auth_data_index_t::find_domain_limits() instead.
 	 */
 	[[nodiscard]]
 	std::optional< one_limit_t >
@@ -354,6 +358,58 @@ struct auth_data_t
 	site_limits_map_t m_site_limits;
 };
 
+//
+// auth_data_delta_t
+//
+/*!
+ * @brief Changes for a user-list.
+ *
+ * A value for a key is a new value of the item (an item is added or
+ * replaced). An empty value means that the item has to be removed.
+ *
+ * @since v.0.6.0
+ */
+struct auth_data_delta_t
+{
+	//! Type of a dictionary of changes for authentification by IP.
+	using by_ip_map_t =
+			std::map<auth_by_ip_key_t, std::optional<user_data_t>>;
+
+	//! Type of a dictionary of changes for authentification by
+	//! login/password.
+	using by_login_map_t =
+			std::map<auth_by_login_key_t, std::optional<user_data_t>>;
+
+	//! Type of a dictionary of changes for personal limits.
+	using site_limits_map_t =
+			std::map<site_limits_key_t, std::optional<site_limits_data_t>>;
+
+	//! Changes for authentification by IP.
+	by_ip_map_t m_by_ip;
+
+	//! Changes for authentification by login/password.
+	by_login_map_t m_by_login;
+
+	//! Changes for personal limits.
+	site_limits_map_t m_site_limits;
+
+	//! Is there any change?
+	[[nodiscard]]
+	bool
+	empty() const noexcept
+	{
+		return m_by_ip.empty() && m_by_login.empty() && m_site_limits.empty();
+	}
+
+	//! The total number of changed items.
+	[[nodiscard]]
+	std::size_t
+	size() const noexcept
+	{
+		return m_by_ip.size() + m_by_login.size() + m_site_limits.size();
+	}
+};
+
 //
 // parse_auth_data
 //
@@ -367,6 +423,32 @@ auth_data_t
 parse_auth_data(
 	std::string_view user_list_content );
 
+//
+// parse_auth_data_in_parallel
+//
+/*!
+ * @brief Parsing of already loaded content of user-list file on
+ * several threads.
+ *
+ * The content is split at line boundaries into parts that are parsed
+ * on separate threads, then the results are merged. The result is the
+ * same as for parse_auth_data(): if there are several items with the
+ * same key the first one is used, and in the case of an error the
+ * first wrong line is reported with the same description.
+ *
+ * A small content is parsed on the caller's thread.
+ *
+ * @throw std::runtime_error In the case of parsing error.
+ *
+ * @since v.0.6.0
+ */
+[[nodiscard]]
+auth_data_t
+parse_auth_data_in_parallel(
+	std::string_view user_list_content,
+	//! The max number of threads to be used.
+	unsigned int threads_count );
+
 //
 // load_auth_data
 //
@@ -380,5 +462,101 @@ auth_data_t
 load_auth_data(
 	const std::filesystem::path & file_name);
 
+//
+// parse_auth_data_delta
+//
+/*!
+ * @brief Parsing of changes for a user-list.
+ *
+ * Every line has the same format as a line of user-list file (such
+ * an item is added or replaced) or is a key of an item with the leading
+ * '-' (such an item is removed):
+ *
+ * @code
+ * # Add or replace items.
+ * 127.0.0.1 3000 10.0.0.1 = 1MiB 1MiB 0 1
+ * 127.0.0.1 3000 user 12345 = 0 0 1 2
+ * 1 = vk.com 2MiB 2MiB
+ * # Remove items.
+ * - 127.0.0.1 3000 10.0.0.2
+ * - 127.0.0.1 3000 another-user 54321
+ * - 2
+ * @endcode
+ *
+ * If there are several changes for the same key then the last one wins.
+ *
+ * @throw std::runtime_error In the case of parsing error.
+ *
+ * @since v.0.6.0
+ */
+[[nodiscard]]
+auth_data_delta_t
+parse_auth_data_delta(
+	std::string_view delta_content );
+
+//
+// complete_journal_records
+//
+/*!
+ * @brief Get the part of a journal of changes that consists of
+ * complete records.
+ *
+ * Changes are appended to the journal line by line, every record ends
+ * with a new line. If the application is stopped during an append then
+ * the last line can be incomplete. Such a line is dropped, all previous
+ * records are returned.
+ *
+ * @since v.0.6.0
+ */
+[[nodiscard]]
+std::string_view
+complete_journal_records(
+	std::string_view journal_content ) noexcept;
+
+//
+// merge_auth_data_delta
+//
+/*!
+ * @brief Merge changes from @a from into @a to.
+ *
+ * Changes from @a from replace changes for the same keys in @a to.
+ *
+ * @since v.0.6.0
+ */
+void
+merge_auth_data_delta(
+	auth_data_delta_t & to,
+	const auth_data_delta_t & from );
+
+//
+// apply_auth_data_delta
+//
+/*!
+ * @brief Apply changes to a user-list.
+ *
+ * Removal of an item that isn't in @a to is not an error.
+ *
+ * @since v.0.6.0
+ */
+void
+apply_auth_data_delta(
+	auth_data_t & to,
+	const auth_data_delta_t & delta );
+
+//
+// make_auth_data_content
+//
+/*!
+ * @brief Make the content of user-list file for @a data.
+ *
+ * The result can be parsed by parse_auth_data().
+ *
+ * @since v.0.6.0
+ */
+[[nodiscard]]
+std::string
+make_auth_data_content(
+	const auth_data_t & data );
+
 } /* namespace arataga::user_list_auth */
 
@@ -8,5 +8,7 @@ MxxRu::Cpp::lib_target {
 	required_prj 'fmt-prj.rb'
 
 	cpp_source 'user_list_auth_data.cpp'
+	cpp_source 'user_list_auth_index.cpp'
+	cpp_source 'user_list_auth_snapshot.cpp'
 }
 
@@ -0,0 +1,309 @@
+/*!
+ * @file
+ * @brief Index for fast lookups in a user-list.
+ * @since v.0.6.0
+ */
+
+#include <arataga/user_list_auth_index.hpp>
+
+#include <functional>
+
+namespace arataga::user_list_auth
+{
+
+namespace
+{
+
+//! Mixing function from SplitMix64.
+[[nodiscard]]
+std::uint64_t
+mix( std::uint64_t v ) noexcept
+{
+	v += 0x9e3779b97f4a7c15ull;
+	v = (v ^ (v >> 30)) * 0xbf58476d1ce4e5b9ull;
+	v = (v ^ (v >> 27)) * 0x94d049bb133111ebull;
+	return v ^ (v >> 31);
+}
+
+//! Hash value 0 is reserved for empty slots.
+[[nodiscard]]
+std::uint64_t
+make_non_zero_hash( std::uint64_t v ) noexcept
+{
+	return 0u == v ? 1u : v;
+}
+
+[[nodiscard]]
+std::uint64_t
+endpoint_hash(
+	std::uint32_t proxy_in_addr,
+	ip_port_t proxy_port ) noexcept
+{
+	return mix( (static_cast< std::uint64_t >(proxy_in_addr) << 16) |
+			proxy_port );
+}
+
+[[nodiscard]]
+std::uint64_t
+by_ip_hash(
+	std::uint32_t proxy_in_addr,
+	ip_port_t proxy_port,
+	std::uint32_t user_ip ) noexcept
+{
+	return make_non_zero_hash(
+			mix( endpoint_hash( proxy_in_addr, proxy_port ) ^ user_ip ) );
+}
+
+[[nodiscard]]
+std::uint64_t
+by_login_hash(
+	std::uint32_t proxy_in_addr,
+	ip_port_t proxy_port,
+	std::string_view username,
+	std::string_view password ) noexcept
+{
+	const std::hash< std::string_view > hasher;
+
+	auto h = endpoint_hash( proxy_in_addr, proxy_port );
+	h = mix( h ^ hasher( username ) );
+	h = mix( h ^ hasher( password ) );
+
+	return make_non_zero_hash( h );
+}
+
+[[nodiscard]]
+std::uint64_t
+site_limits_hash( std::uint32_t site_limits_id ) noexcept
+{
+	return make_non_zero_hash( mix( site_limits_id ) );
+}
+
+[[nodiscard]]
+std::uint64_t
+domain_limit_hash(
+	std::uint32_t site_limits_id,
+	std::string_view domain ) noexcept
+{
+	const std::hash< std::string_view > hasher;
+
+	return make_non_zero_hash(
+			mix( mix( site_limits_id ) ^ hasher( domain ) ) );
+}
+
+} /* namespace anonymous */
+
+auth_data_index_t::auth_data_index_t( const auth_data_t & data )
+{
+	m_by_ip.reset( data.m_by_ip.size() );
+	for( const auto & [key, user] : data.m_by_ip )
+	{
+		const auto proxy_in_addr = key.m_proxy_in_addr.to_uint();
+		const auto user_ip = key.m_user_ip.to_uint();
+
+		const auto hash = by_ip_hash(
+				proxy_in_addr, key.m_proxy_port, user_ip );
+
+		auto & slot = m_by_ip.slot_for_insertion( hash );
+		slot.m_hash = hash;
+		slot.m_proxy_in_addr = proxy_in_addr;
+		slot.m_user_ip = user_ip;
+		slot.m_proxy_port = key.m_proxy_port;
+		slot.m_user = user;
+	}
+
+	// The size of string storage is calculated first to avoid
+	// reallocations.
+	std::size_t strings_size = 0u;
+	for( const auto & [key, user] : data.m_by_login )
+		strings_size += key.m_username.size() + key.m_password.size();
+	m_strings.reserve( strings_size );
+
+	m_by_login.reset( data.m_by_login.size() );
+	for( const auto & [key, user] : data.m_by_login )
+	{
+		const auto proxy_in_addr = key.m_proxy_in_addr.to_uint();
+		const auto hash = by_login_hash(
+				proxy_in_addr, key.m_proxy_port,
+				key.m_username, key.m_password );
+
+		auto & slot = m_by_login.slot_for_insertion( hash );
+		slot.m_hash = hash;
+		slot.m_proxy_in_addr = proxy_in_addr;
+		slot.m_proxy_port = key.m_proxy_port;
+		slot.m_username_size = static_cast< std::uint32_t >(
+				key.m_username.size() );
+		slot.m_password_size = static_cast< std::uint32_t >(
+				key.m_password.size() );
+		slot.m_strings_offset = m_strings.size();
+		slot.m_user = user;
+
+		m_strings += key.m_username;
+		m_strings += key.m_password;
+	}
+
+	// The total count of domains is necessary for the preparation
+	// of the table for domains.
+	std::size_t domains_count = 0u;
+	for( const auto & [key, limits] : data.m_site_limits )
+		domains_count += limits.m_limits.size();
+	m_domain_limits.reset( domains_count );
+
+	m_site_limits.reserve( data.m_site_limits.size() );
+	m_site_limits_index.reset( data.m_site_limits.size() );
+	for( const auto & [key, limits] : data.m_site_limits )
+	{
+		const auto hash = site_limits_hash( key.m_site_limits_id );
+
+		auto & slot = m_site_limits_index.slot_for_insertion( hash );
+		slot.m_hash = hash;
+		slot.m_site_limits_id = key.m_site_limits_id;
+		slot.m_index = m_site_limits.size();
+
+		m_site_limits.push_back( limits );
+
+		for( std::size_t i = 0u; i != limits.m_limits.size(); ++i )
+			add_domain_limit(
+					key.m_site_limits_id,
+					slot.m_index,
+					i,
+					limits.m_limits[ i ].m_domain.value() );
+	}
+}
+
+void
+auth_data_index_t::add_domain_limit(
+	std::uint32_t site_limits_id,
+	std::size_t site_limits_index,
+	std::size_t limit_index,
+	std::string_view domain )
+{
+	const auto hash = domain_limit_hash( site_limits_id, domain );
+
+	// The same domain can be listed several times. The last
+	// occurrence wins as it was in site_limits_data_t::try_find_limits_for.
+	auto & slot = m_domain_limits.slot_for_insertion( hash,
+			[&]( const index_details::domain_limit_slot_t & s ) {
+				return s.m_site_limits_id == site_limits_id &&
+						stored_string( s.m_domain_offset, s.m_domain_size ) ==
+								domain;
+			} );
+	if( 0u == slot.m_hash )
+	{
+		// It's a new domain.
+		slot.m_hash = hash;
+		slot.m_site_limits_id = site_limits_id;
+		slot.m_domain_size = static_cast< std::uint32_t >( domain.size() );
+		slot.m_domain_offset = m_strings.size();
+
+		m_strings += domain;
+	}
+
+	slot.m_site_limits_index = site_limits_index;
+	slot.m_limit_index = limit_index;
+}
+
+std::string_view
+auth_data_index_t::stored_string(
+	std::size_t offset,
+	std::size_t size ) const noexcept
+{
+	return { m_strings.data() + offset, size };
+}
+
+const user_data_t *
+auth_data_index_t::find_by_ip(
+	const ipv4_address_t & proxy_in_addr,
+	ip_port_t proxy_port,
+	const ipv4_address_t & user_ip ) const noexcept
+{
+	const auto proxy_in_addr_v = proxy_in_addr.to_uint();
+	const auto user_ip_v = user_ip.to_uint();
+
+	const auto * slot = m_by_ip.find(
+			by_ip_hash( proxy_in_addr_v, proxy_port, user_ip_v ),
+			[&]( const index_details::by_ip_slot_t & s ) {
+				return s.m_proxy_in_addr == proxy_in_addr_v &&
+						s.m_proxy_port == proxy_port &&
+						s.m_user_ip == user_ip_v;
+			} );
+
+	return slot ? &(slot->m_user) : nullptr;
+}
+
+const user_data_t *
+auth_data_index_t::find_by_login(
+	const ipv4_address_t & proxy_in_addr,
+	ip_port_t proxy_port,
+	std::string_view username,
+	std::string_view password ) const noexcept
+{
+	const auto proxy_in_addr_v = proxy_in_addr.to_uint();
+
+	const auto * slot = m_by_login.find(
+			by_login_hash( proxy_in_addr_v, proxy_port, username, password ),
+			[&]( const index_details::by_login_slot_t & s ) {
+				if( s.m_proxy_in_addr != proxy_in_addr_v ||
+						s.m_proxy_port != proxy_port ||
+						s.m_username_size != username.size() ||
+						s.m_password_size != password.size() )
+					return false;
+
+				const auto stored = stored_string(
+						s.m_strings_offset,
+						username.size() + password.size() );
+				return stored.substr( 0u, username.size() ) == username &&
+						stored.substr( username.size() ) == password;
+			} );
+
+	return slot ? &(slot->m_user) : nullptr;
+}
+
+const site_limits_data_t *
+auth_data_index_t::find_site_limits(
+	std::uint32_t site_limits_id ) const noexcept
+{
+	const auto * slot = m_site_limits_index.find(
+			site_limits_hash( site_limits_id ),
+			[&]( const index_details::site_limits_slot_t & s ) {
+				return s.m_site_limits_id == site_limits_id;
+			} );
+
+	return slot ? &(m_site_limits[ slot->m_index ]) : nullptr;
+}
+
+const site_limits_data_t::one_limit_t *
+auth_data_index_t::find_domain_limits(
+	std::uint32_t site_limits_id,
+	const domain_name_t & host ) const noexcept
+{
+	// Most users have no personal limits, there is no need
+	// to check every suffix of the host for them.
+	if( !find_site_limits( site_limits_id ) )
+		return nullptr;
+
+	// Suffixes are checked from the longest to the shortest, so
+	// the first match is the most specific domain.
+	std::string_view suffix{ host.value() };
+	for(;;)
+	{
+		const auto * slot = m_domain_limits.find(
+				domain_limit_hash( site_limits_id, suffix ),
+				[&]( const index_details::domain_limit_slot_t & s ) {
+					return s.m_site_limits_id == site_limits_id &&
+							stored_string( s.m_domain_offset, s.m_domain_size ) ==
+									suffix;
+				} );
+		if( slot )
+			return &(m_site_limits[ slot->m_site_limits_index ]
+					.m_limits[ slot->m_limit_index ]);
+
+		const auto dot_pos = suffix.find( '.' );
+		if( std::string_view::npos == dot_pos )
+			return nullptr;
+
+		suffix.remove_prefix( dot_pos + 1u );
+	}
+}
+
+} /* namespace arataga::user_list_auth */
+
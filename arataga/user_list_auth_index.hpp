@@ -0,0 +1,338 @@
+/*!
+ * @file
+ * @brief Index for fast lookups in a user-list.
+ * @since v.0.6.0
+ */
+
+#pragma once
+
+#include <arataga/user_list_auth_data.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace arataga::user_list_auth
+{
+
+namespace index_details
+{
+
+//
+// flat_hash_table_t
+//
+/*!
+ * @brief A simple open-addressing hash table with linear probing.
+ *
+ * This table is filled once and is never modified after that. So
+ * there is no support for removal of items.
+ *
+ * Slot should have `m_hash` field of type std::uint64_t. Value 0 of
+ * that field means an empty slot, so hash values should never be 0
+ * (see make_non_zero_hash()).
+ *
+ * @since v.0.6.0
+ */
+template< typename Slot >
+class flat_hash_table_t
+{
+	//! Slots of the table.
+	/*!
+	 * The size is always a power of 2.
+	 */
+	std::vector< Slot > m_slots;
+
+	//! Mask for the calculation of a slot index.
+	std::size_t m_mask{ 0u };
+
+public:
+	flat_hash_table_t() = default;
+
+	//! Prepare the table for @a items_count items.
+	/*!
+	 * The load factor is kept not greater than 0.5.
+	 */
+	void
+	reset( std::size_t items_count )
+	{
+		std::size_t capacity = 8u;
+		while( capacity < items_count * 2u )
+			capacity *= 2u;
+
+		m_slots.assign( capacity, Slot{} );
+		m_mask = capacity - 1u;
+	}
+
+	//! Find a slot for a new item with @a hash.
+	/*!
+	 * @attention
+	 * The table should be prepared by reset() and keys should be unique.
+	 */
+	[[nodiscard]]
+	Slot &
+	slot_for_insertion( std::uint64_t hash ) noexcept
+	{
+		auto index = static_cast< std::size_t >( hash ) & m_mask;
+		while( 0u != m_slots[ index ].m_hash )
+			index = (index + 1u) & m_mask;
+
+		return m_slots[ index ];
+	}
+
+	//! Find a slot for an item with @a hash that can be a duplicate.
+	/*!
+	 * If there is already an item with the same key then its slot is
+	 * returned. Otherwise an empty slot is returned.
+	 *
+	 * @attention
+	 * The table should be prepared by reset().
+	 */
+	template< typename Predicate >
+	[[nodiscard]]
+	Slot &
+	slot_for_insertion( std::uint64_t hash, Predicate && same_key ) noexcept
+	{
+		auto index = static_cast< std::size_t >( hash ) & m_mask;
+		for(;;)
+		{
+			Slot & slot = m_slots[ index ];
+			if( 0u == slot.m_hash ||
+					(hash == slot.m_hash && same_key( slot )) )
+				return slot;
+
+			index = (index + 1u) & m_mask;
+		}
+	}
+
+	//! Find an item with @a hash.
+	/*!
+	 * @a same_key is called only for slots with the same hash.
+	 *
+	 * @return nullptr if there is no such item.
+	 */
+	template< typename Predicate >
+	[[nodiscard]]
+	const Slot *
+	find( std::uint64_t hash, Predicate && same_key ) const noexcept
+	{
+		if( m_slots.empty() )
+			return nullptr;
+
+		auto index = static_cast< std::size_t >( hash ) & m_mask;
+		for(;;)
+		{
+			const Slot & slot = m_slots[ index ];
+			if( 0u == slot.m_hash )
+				return nullptr;
+			if( hash == slot.m_hash && same_key( slot ) )
+				return &slot;
+
+			index = (index + 1u) & m_mask;
+		}
+	}
+};
+
+//! Slot for authentification by IP.
+struct by_ip_slot_t
+{
+	std::uint64_t m_hash{ 0u };
+	std::uint32_t m_proxy_in_addr{ 0u };
+	std::uint32_t m_user_ip{ 0u };
+	ip_port_t m_proxy_port{ 0u };
+	user_data_t m_user{};
+};
+
+//! Slot for authentification by login/password.
+/*!
+ * Username and password are stored in the common string storage
+ * one after another.
+ */
+struct by_login_slot_t
+{
+	std::uint64_t m_hash{ 0u };
+	std::uint32_t m_proxy_in_addr{ 0u };
+	ip_port_t m_proxy_port{ 0u };
+	std::uint32_t m_username_size{ 0u };
+	std::uint32_t m_password_size{ 0u };
+	std::size_t m_strings_offset{ 0u };
+	user_data_t m_user{};
+};
+
+//! Slot for personal limits.
+struct site_limits_slot_t
+{
+	std::uint64_t m_hash{ 0u };
+	std::uint32_t m_site_limits_id{ 0u };
+	//! Index in the vector of site limits.
+	std::size_t m_index{ 0u };
+};
+
+//! Slot for a limit for one domain.
+/*!
+ * The key is a pair of the ID of personal limits and the domain name.
+ * The domain name is stored in the common string storage.
+ */
+struct domain_limit_slot_t
+{
+	std::uint64_t m_hash{ 0u };
+	std::uint32_t m_site_limits_id{ 0u };
+	std::uint32_t m_domain_size{ 0u };
+	std::size_t m_domain_offset{ 0u };
+	//! Index in the vector of site limits.
+	std::size_t m_site_limits_index{ 0u };
+	//! Index in site_limits_data_t::m_limits.
+	std::size_t m_limit_index{ 0u };
+};
+
+} /* namespace index_details */
+
+//
+// auth_data_index_t
+//
+/*!
+ * @brief A read-only form of a user-list optimized for lookups.
+ *
+ * auth_data_t uses std::map with std::string inside keys. Every lookup
+ * is a walk over a tree with string comparisons and a lot of cache
+ * misses.
+ *
+ * auth_data_index_t is compiled from auth_data_t once and then is used
+ * by all authentificators. It uses open-addressing hash tables with
+ * precomputed hashes. All usernames and passwords are stored in one
+ * contiguous string. So a lookup usually takes one or two cache misses
+ * and doesn't allocate memory.
+ *
+ * Limits for particular domains are stored in a hashed table of domain
+ * names. A search for the most specific domain for a host is a lookup
+ * for every suffix of the host that starts at a label boundary (from the
+ * longest to the shortest). So it takes O(labels) lookups regardless of
+ * the size of the list of domains.
+ *
+ * @since v.0.6.0
+ */
+class auth_data_index_t
+{
+	//! Table for authentification by IP.
+	index_details::flat_hash_table_t< index_details::by_ip_slot_t >
+			m_by_ip;
+
+	//! Table for authentification by login/password.
+	index_details::flat_hash_table_t< index_details::by_login_slot_t >
+			m_by_login;
+
+	//! Storage for usernames, passwords and domain names.
+	std::string m_strings;
+
+	//! Table for personal limits.
+	index_details::flat_hash_table_t< index_details::site_limits_slot_t >
+			m_site_limits_index;
+
+	//! Personal limits.
+	std::vector< site_limits_data_t > m_site_limits;
+
+	//! Table for limits for particular domains of all personal limits.
+	index_details::flat_hash_table_t< index_details::domain_limit_slot_t >
+			m_domain_limits;
+
+	//! Add a limit for one domain to m_domain_limits.
+	void
+	add_domain_limit(
+		std::uint32_t site_limits_id,
+		std::size_t site_limits_index,
+		std::size_t limit_index,
+		std::string_view domain );
+
+	//! Get a string from the common string storage.
+	[[nodiscard]]
+	std::string_view
+	stored_string( std::size_t offset, std::size_t size ) const noexcept;
+
+public:
+	//! Make an empty index.
+	auth_data_index_t() = default;
+
+	//! Make an index for the content of @a data.
+	explicit auth_data_index_t( const auth_data_t & data );
+
+	//! Find a user to be authentificated by IP.
+	/*!
+	 * @return nullptr if there is no such user.
+	 */
+	[[nodiscard]]
+	const user_data_t *
+	find_by_ip(
+		const ipv4_address_t & proxy_in_addr,
+		ip_port_t proxy_port,
+		const ipv4_address_t & user_ip ) const noexcept;
+
+	//! Find a user to be authentificated by login/password.
+	/*!
+	 * @return nullptr if there is no such user.
+	 */
+	[[nodiscard]]
+	const user_data_t *
+	find_by_login(
+		const ipv4_address_t & proxy_in_addr,
+		ip_port_t proxy_port,
+		std::string_view username,
+		std::string_view password ) const noexcept;
+
+	//! Find personal limits by ID.
+	/*!
+	 * @return nullptr if there are no such limits.
+	 */
+	[[nodiscard]]
+	const site_limits_data_t *
+	find_site_limits( std::uint32_t site_limits_id ) const noexcept;
+
+	//! Find the limit for a particular domain.
+	/*!
+	 * It is the same as site_limits_data_t::try_find_limits_for()
+	 * for the personal limits with @a site_limits_id, but doesn't
+	 * scan the whole list of domains.
+	 *
+	 * @return nullptr if there is no limit for @a host.
+	 */
+	[[nodiscard]]
+	const site_limits_data_t::one_limit_t *
+	find_domain_limits(
+		std::uint32_t site_limits_id,
+		const domain_name_t & host ) const noexcept;
+};
+
+//
+// auth_data_snapshot_t
+//
+/*!
+ * @brief Type of an immutable snapshot of authentification info.
+ *
+ * A new user-list is parsed and indexed once and then is shared by all
+ * authentificator-agents. The content of a snapshot is never modified,
+ * so it can be read from several IO-threads without any locks. An
+ * update of the user-list is just a replacement of the pointer.
+ *
+ * @since v.0.6.0
+ */
+using auth_data_snapshot_t = std::shared_ptr< const auth_data_index_t >;
+
+//
+// auth_data_delta_snapshot_t
+//
+/*!
+ * @brief Type of an immutable set of changes for a snapshot of
+ * authentification info.
+ *
+ * Small changes of the user-list are not compiled into a new
+ * auth_data_index_t. They are collected into an auth_data_delta_t
+ * that is checked before the index. Like auth_data_snapshot_t
+ * the content is never modified: a new change produces a new object.
+ *
+ * @since v.0.6.0
+ */
+using auth_data_delta_snapshot_t = std::shared_ptr< const auth_data_delta_t >;
+
+} /* namespace arataga::user_list_auth */
+
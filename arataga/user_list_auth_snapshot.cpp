@@ -0,0 +1,514 @@
+/*!
+ * @file
+ * @brief Binary snapshot of a user-list.
+ * @since v.0.6.0
+ */
+
+#include <arataga/user_list_auth_snapshot.hpp>
+
+#include <arataga/utils/ensure_successful_syscall.hpp>
+
+#include <fmt/format.h>
+#include <fmt/std.h>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace arataga::user_list_auth {
+
+namespace snapshot_details
+{
+
+/*!
+ * @name The format of the snapshot.
+ *
+ * The snapshot consists of the header and the payload. All values
+ * are stored in the native byte order of the host, the snapshot isn't
+ * intended to be moved between hosts. A snapshot with a foreign byte
+ * order is detected by the byte order marker in the header and is
+ * rejected.
+ *
+ * The payload is:
+ *
+ * - u64 count of items for auth by IP, then every item as:
+ *   u32 proxy_in_addr, u16 proxy_port, u32 user_ip, user_data;
+ * - u64 count of items for auth by login, then every item as:
+ *   u32 proxy_in_addr, u16 proxy_port, string username,
+ *   string password, user_data;
+ * - u64 count of personal limits, then every item as:
+ *   u32 site_limits_id, u64 count of domains, then every domain as:
+ *   string domain, u64 in, u64 out.
+ *
+ * Where user_data is: u64 in, u64 out, u32 site_limits_id, u32 user_id.
+ * And string is: u32 length, then the characters.
+ *
+ * Items are stored in the order of keys. So they can be added to
+ * std::map with a hint without any searching.
+ *
+ * @{
+ */
+constexpr std::array< char, 8 > magic{ 'A', 'R', 'T', 'G', 'U', 'L', 'S', 'T' };
+
+//! The version of the format.
+/*!
+ * Should be incremented on every change of the format.
+ */
+constexpr std::uint32_t current_version = 2u;
+
+//! The byte order marker.
+/*!
+ * It's read as a different value on a host with another byte order.
+ */
+constexpr std::uint32_t byte_order_marker = 0x01020304u;
+
+struct header_t
+{
+	std::array< char, 8 > m_magic;
+	//! Should be byte_order_marker.
+	/*!
+	 * It's placed before the version because the version can't be
+	 * read correctly if the byte order is foreign.
+	 */
+	std::uint32_t m_byte_order;
+	std::uint32_t m_version;
+	//! Checksum of the text form of the user-list.
+	std::uint64_t m_content_checksum;
+	std::uint64_t m_payload_size;
+	std::uint64_t m_payload_checksum;
+};
+
+static_assert( std::is_trivially_copyable_v< header_t > );
+/*!
+ * @}
+ */
+
+// FNV-1a.
+[[nodiscard]]
+std::uint64_t
+calculate_checksum( const char * data, std::size_t size ) noexcept
+{
+	std::uint64_t result = 14695981039346656037ull;
+	for( std::size_t i = 0u; i != size; ++i )
+	{
+		result ^= static_cast< unsigned char >( data[ i ] );
+		result *= 1099511628211ull;
+	}
+
+	return result;
+}
+
+//
+// writer_t
+//
+//! Helper for serialization of the payload.
+class writer_t
+{
+	std::string m_buffer;
+
+public:
+	template< typename T >
+	void
+	put( T v )
+	{
+		static_assert( std::is_trivially_copyable_v< T > );
+		m_buffer.append( reinterpret_cast< const char * >(&v), sizeof(v) );
+	}
+
+	void
+	put( const std::string & v )
+	{
+		put( static_cast< std::uint32_t >( v.size() ) );
+		m_buffer.append( v );
+	}
+
+	void
+	put( const ipv4_address_t & v )
+	{
+		put( static_cast< std::uint32_t >( v.to_uint() ) );
+	}
+
+	void
+	put( const user_data_t & v )
+	{
+		put( static_cast< std::uint64_t >( v.m_bandlims.m_in ) );
+		put( static_cast< std::uint64_t >( v.m_bandlims.m_out ) );
+		put( static_cast< std::uint32_t >( v.m_site_limits_id ) );
+		put( static_cast< std::uint32_t >( v.m_user_id ) );
+	}
+
+	[[nodiscard]]
+	const std::string &
+	buffer() const noexcept { return m_buffer; }
+};
+
+//
+// reader_t
+//
+//! Helper for deserialization of the payload.
+class reader_t
+{
+	const char * m_current;
+	const char * const m_end;
+
+	void
+	ensure_available( std::size_t size ) const
+	{
+		if( static_cast< std::size_t >( m_end - m_current ) < size )
+			throw std::runtime_error{ "unexpected end of snapshot payload" };
+	}
+
+public:
+	reader_t( const char * data, std::size_t size ) noexcept
+		:	m_current{ data }
+		,	m_end{ data + size }
+	{}
+
+	[[nodiscard]]
+	bool
+	is_completed() const noexcept { return m_current == m_end; }
+
+	template< typename T >
+	[[nodiscard]]
+	T
+	get()
+	{
+		static_assert( std::is_trivially_copyable_v< T > );
+		ensure_available( sizeof(T) );
+
+		T result;
+		std::memcpy( &result, m_current, sizeof(T) );
+		m_current += sizeof(T);
+
+		return result;
+	}
+
+	[[nodiscard]]
+	std::string
+	get_string()
+	{
+		const auto size = get< std::uint32_t >();
+		ensure_available( size );
+
+		std::string result{ m_current, size };
+		m_current += size;
+
+		return result;
+	}
+
+	[[nodiscard]]
+	ipv4_address_t
+	get_address()
+	{
+		return ipv4_address_t{ get< std::uint32_t >() };
+	}
+
+	[[nodiscard]]
+	user_data_t
+	get_user_data()
+	{
+		user_data_t result;
+		result.m_bandlims.m_in = get< std::uint64_t >();
+		result.m_bandlims.m_out = get< std::uint64_t >();
+		result.m_site_limits_id = get< std::uint32_t >();
+		result.m_user_id = get< std::uint32_t >();
+
+		return result;
+	}
+};
+
+//
+// mapped_file_t
+//
+//! Read-only memory mapping of the whole file.
+class mapped_file_t
+{
+	int m_fd{ -1 };
+	void * m_data{ MAP_FAILED };
+	std::size_t m_size{ 0u };
+
+public:
+	mapped_file_t() = default;
+	mapped_file_t( const mapped_file_t & ) = delete;
+	mapped_file_t( mapped_file_t && ) = delete;
+
+	~mapped_file_t()
+	{
+		if( MAP_FAILED != m_data )
+			::munmap( m_data, m_size );
+		if( -1 != m_fd )
+			::close( m_fd );
+	}
+
+	//! Open and map the file.
+	/*!
+	 * @return false if there is no such file.
+	 */
+	[[nodiscard]]
+	bool
+	open( const std::filesystem::path & file_name )
+	{
+		m_fd = ::open( file_name.c_str(), O_RDONLY | O_CLOEXEC );
+		if( -1 == m_fd && ENOENT == errno )
+			return false;
+
+		::arataga::utils::ensure_successful_syscall( m_fd,
+				fmt::format( "trying to open snapshot file {}", file_name ) );
+
+		struct stat file_stat;
+		::arataga::utils::ensure_successful_syscall(
+				::fstat( m_fd, &file_stat ),
+				fmt::format( "trying to get size of snapshot file {}",
+						file_name ) );
+
+		m_size = static_cast< std::size_t >( file_stat.st_size );
+		if( m_size < sizeof(header_t) )
+			throw std::runtime_error{
+					fmt::format( "snapshot file {} is too small: {} byte(s)",
+							file_name, m_size )
+				};
+
+		m_data = ::mmap( nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0 );
+		if( MAP_FAILED == m_data )
+			::arataga::utils::ensure_successful_syscall( -1,
+					fmt::format( "trying to map snapshot file {}", file_name ) );
+
+		return true;
+	}
+
+	[[nodiscard]]
+	const char *
+	data() const noexcept { return static_cast< const char * >( m_data ); }
+
+	[[nodiscard]]
+	std::size_t
+	size() const noexcept { return m_size; }
+};
+
+[[nodiscard]]
+std::string
+serialize( const auth_data_t & auth_data )
+{
+	writer_t writer;
+
+	writer.put( static_cast< std::uint64_t >( auth_data.m_by_ip.size() ) );
+	for( const auto & [k, v] : auth_data.m_by_ip )
+	{
+		writer.put( k.m_proxy_in_addr );
+		writer.put( k.m_proxy_port );
+		writer.put( k.m_user_ip );
+		writer.put( v );
+	}
+
+	writer.put( static_cast< std::uint64_t >( auth_data.m_by_login.size() ) );
+	for( const auto & [k, v] : auth_data.m_by_login )
+	{
+		writer.put( k.m_proxy_in_addr );
+		writer.put( k.m_proxy_port );
+		writer.put( k.m_username );
+		writer.put( k.m_password );
+		writer.put( v );
+	}
+
+	writer.put( static_cast< std::uint64_t >( auth_data.m_site_limits.size() ) );
+	for( const auto & [k, v] : auth_data.m_site_limits )
+	{
+		writer.put( static_cast< std::uint32_t >( k.m_site_limits_id ) );
+		writer.put( static_cast< std::uint64_t >( v.m_limits.size() ) );
+		for( const auto & limit : v.m_limits )
+		{
+			writer.put( limit.m_domain.value() );
+			writer.put( static_cast< std::uint64_t >( limit.m_bandlims.m_in ) );
+			writer.put( static_cast< std::uint64_t >( limit.m_bandlims.m_out ) );
+		}
+	}
+
+	return writer.buffer();
+}
+
+[[nodiscard]]
+auth_data_t
+deserialize( reader_t & reader )
+{
+	auth_data_t result;
+
+	for( auto n = reader.get< std::uint64_t >(); n; --n )
+	{
+		auth_by_ip_key_t key;
+		key.m_proxy_in_addr = reader.get_address();
+		key.m_proxy_port = reader.get< ip_port_t >();
+		key.m_user_ip = reader.get_address();
+
+		result.m_by_ip.emplace_hint(
+				result.m_by_ip.end(),
+				std::move(key),
+				reader.get_user_data() );
+	}
+
+	for( auto n = reader.get< std::uint64_t >(); n; --n )
+	{
+		auth_by_login_key_t key;
+		key.m_proxy_in_addr = reader.get_address();
+		key.m_proxy_port = reader.get< ip_port_t >();
+		key.m_username = reader.get_string();
+		key.m_password = reader.get_string();
+
+		result.m_by_login.emplace_hint(
+				result.m_by_login.end(),
+				std::move(key),
+				reader.get_user_data() );
+	}
+
+	for( auto n = reader.get< std::uint64_t >(); n; --n )
+	{
+		const site_limits_key_t key{ reader.get< std::uint32_t >() };
+
+		site_limits_data_t limits;
+		for( auto d = reader.get< std::uint64_t >(); d; --d )
+		{
+			domain_name_t domain{ reader.get_string() };
+			bandlim_config_t bandlims;
+			bandlims.m_in = reader.get< std::uint64_t >();
+			bandlims.m_out = reader.get< std::uint64_t >();
+
+			limits.m_limits.push_back(
+					site_limits_data_t::one_limit_t{
+							std::move(domain), bandlims
+					} );
+		}
+
+		result.m_site_limits.emplace_hint(
+				result.m_site_limits.end(),
+				key,
+				std::move(limits) );
+	}
+
+	if( !reader.is_completed() )
+		throw std::runtime_error{ "unexpected data at the end of snapshot" };
+
+	return result;
+}
+
+} /* namespace snapshot_details */
+
+//
+// calculate_content_checksum
+//
+std::uint64_t
+calculate_content_checksum(
+	std::string_view user_list_content ) noexcept
+{
+	return snapshot_details::calculate_checksum(
+			user_list_content.data(), user_list_content.size() );
+}
+
+//
+// store_auth_data_snapshot
+//
+void
+store_auth_data_snapshot(
+	const std::filesystem::path & file_name,
+	const auth_data_t & auth_data,
+	std::uint64_t content_checksum )
+{
+	using namespace snapshot_details;
+
+	const auto payload = serialize( auth_data );
+
+	header_t header{};
+	header.m_magic = magic;
+	header.m_byte_order = byte_order_marker;
+	header.m_version = current_version;
+	header.m_content_checksum = content_checksum;
+	header.m_payload_size = payload.size();
+	header.m_payload_checksum = calculate_checksum(
+			payload.data(), payload.size() );
+
+	auto tmp_file_name = file_name;
+	tmp_file_name += ".tmp";
+
+	{
+		std::ofstream file( tmp_file_name,
+				std::ios_base::out | std::ios_base::binary |
+						std::ios_base::trunc );
+		if( !file )
+			::arataga::utils::ensure_successful_syscall( -1,
+					fmt::format( "unable to open snapshot file {} for writting",
+							tmp_file_name ) );
+
+		file.exceptions( std::ofstream::badbit | std::ofstream::failbit );
+
+		file.write(
+				reinterpret_cast< const char * >(&header),
+				static_cast< std::streamsize >( sizeof(header) ) );
+		file.write(
+				payload.data(),
+				static_cast< std::streamsize >( payload.size() ) );
+
+		file.close();
+	}
+
+	std::filesystem::rename( tmp_file_name, file_name );
+}
+
+//
+// try_load_auth_data_snapshot
+//
+std::optional< auth_data_t >
+try_load_auth_data_snapshot(
+	const std::filesystem::path & file_name,
+	std::uint64_t content_checksum )
+{
+	using namespace snapshot_details;
+
+	mapped_file_t file;
+	if( !file.open( file_name ) )
+		return std::nullopt;
+
+	header_t header;
+	std::memcpy( &header, file.data(), sizeof(header) );
+
+	if( magic != header.m_magic )
+		throw std::runtime_error{
+				fmt::format( "{} isn't a user-list snapshot", file_name )
+			};
+
+	if( byte_order_marker != header.m_byte_order )
+		throw std::runtime_error{
+				fmt::format( "user-list snapshot {} has a foreign byte order",
+						file_name )
+			};
+
+	if( current_version != header.m_version )
+		throw std::runtime_error{
+				fmt::format( "unsupported version of user-list snapshot {}: {}",
+						file_name, header.m_version )
+			};
+
+	// There is no need to check the rest if the snapshot is outdated.
+	if( content_checksum != header.m_content_checksum )
+		return std::nullopt;
+
+	const char * payload = file.data() + sizeof(header);
+	const std::size_t payload_size = file.size() - sizeof(header);
+	if( payload_size != header.m_payload_size ||
+			header.m_payload_checksum !=
+					calculate_checksum( payload, payload_size ) )
+		throw std::runtime_error{
+				fmt::format( "user-list snapshot {} is corrupted", file_name )
+			};
+
+	reader_t reader{ payload, payload_size };
+	return deserialize( reader );
+}
+
+} /* namespace arataga::user_list_auth */
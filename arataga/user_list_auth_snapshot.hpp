@@ -0,0 +1,76 @@
+/*!
+ * @file
+ * @brief Binary snapshot of a user-list.
+ * @since v.0.6.0
+ */
+
+#pragma once
+
+#include <arataga/user_list_auth_data.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+namespace arataga::user_list_auth {
+
+/*!
+ * @brief Calculate a checksum of the content of user-list file.
+ *
+ * This checksum is stored in the binary snapshot and allows to detect
+ * that the snapshot was made for another content.
+ *
+ * @since v.0.6.0
+ */
+[[nodiscard]]
+std::uint64_t
+calculate_content_checksum(
+	std::string_view user_list_content ) noexcept;
+
+/*!
+ * @brief Store the binary snapshot of a user-list.
+ *
+ * The parsing of a big user-list in the text form takes time. The binary
+ * snapshot holds already parsed data and can be loaded much faster.
+ *
+ * The snapshot is written to a temporary file that then replaces
+ * @a file_name. So a reader never sees a partially written snapshot.
+ *
+ * @throw std::runtime_error In the case of an I/O error.
+ *
+ * @since v.0.6.0
+ */
+void
+store_auth_data_snapshot(
+	//! Name of the file for the snapshot.
+	const std::filesystem::path & file_name,
+	//! Data to be stored.
+	const auth_data_t & auth_data,
+	//! Checksum of the text form of @a auth_data.
+	//! It's the value returned by calculate_content_checksum().
+	std::uint64_t content_checksum );
+
+/*!
+ * @brief An attempt to load the binary snapshot of a user-list.
+ *
+ * The file is mapped into memory and decoded without any parsing.
+ *
+ * @return Empty value if there is no snapshot or the snapshot was made
+ * for another content of user-list file.
+ *
+ * @throw std::runtime_error If the snapshot is corrupted or has
+ * an unsupported version.
+ *
+ * @since v.0.6.0
+ */
+[[nodiscard]]
+std::optional< auth_data_t >
+try_load_auth_data_snapshot(
+	//! Name of the file with the snapshot.
+	const std::filesystem::path & file_name,
+	//! Checksum of the current content of user-list file.
+	//! It's the value returned by calculate_content_checksum().
+	std::uint64_t content_checksum );
+
+} /* namespace arataga::user_list_auth */
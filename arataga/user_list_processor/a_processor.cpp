@@ -7,6 +7,7 @@
 #include <arataga/user_list_processor/notifications.hpp>
 
 #include <arataga/user_list_auth_data.hpp>
+#include <arataga/user_list_auth_snapshot.hpp>
 
 #include <arataga/admin_http_entry/helpers.hpp>
 
@@ -18,6 +19,10 @@
 
 #include <fmt/std.h>
 
+#include <algorithm>
+#include <thread>
+#include <variant>
+
 namespace arataga::user_list_processor
 {
 
@@ -33,6 +38,74 @@ public:
 	{}
 };
 
+namespace
+{
+
+//
+// max_delta_size
+//
+/*!
+ * @brief The max number of accumulated changes that are sent with
+ * the current index.
+ *
+ * If there are more changes a new index is made for the whole user-list.
+ *
+ * @since v.0.6.0
+ */
+constexpr std::size_t max_delta_size{ 4096u };
+
+//
+// max_journal_size
+//
+/*!
+ * @brief The max size of the journal of changes in bytes.
+ *
+ * If the journal becomes bigger the local user-list is rewritten and
+ * the journal is removed. It's necessary because the same items can be
+ * changed again and again without the growth of accumulated changes.
+ *
+ * @since v.0.6.0
+ */
+constexpr std::uintmax_t max_journal_size{ 16u * 1024u * 1024u };
+
+//
+// max_journal_lines
+//
+/*!
+ * @brief The max number of lines in the journal of changes.
+ *
+ * See max_journal_size.
+ *
+ * @since v.0.6.0
+ */
+constexpr std::size_t max_journal_lines{ 64u * 1024u };
+
+//
+// parsing_threads_count
+//
+/*!
+ * @brief The number of threads for parsing of a big user-list.
+ *
+ * @since v.0.6.0
+ */
+[[nodiscard]]
+unsigned int
+parsing_threads_count(
+	const io_threads_count_t & io_threads_count ) noexcept
+{
+	// IO-threads serve connections while a new user-list is being
+	// parsed, so there is no sense to use more threads than IO-threads.
+	const std::size_t io_threads = std::visit(
+			[]( const auto & v ) noexcept -> std::size_t { return v.detect(); },
+			io_threads_count );
+	const std::size_t cpus = std::thread::hardware_concurrency();
+
+	return static_cast< unsigned int >(
+			std::max< std::size_t >( 1u, std::min( io_threads, cpus ) ) );
+}
+
+} /* namespace anonymous */
+
 //
 // a_processor_t
 //
@@ -45,13 +118,21 @@ a_processor_t::a_processor_t(
 	,	m_params{ std::move(params) }
 	,	m_local_user_list_file_name{
 			m_params.m_local_config_path / "local-user-list.cfg" }
+	,	m_local_user_list_snapshot_file_name{
+			m_params.m_local_config_path / "local-user-list.bin" }
+	,	m_local_user_list_journal_file_name{
+			m_params.m_local_config_path / "local-user-list.journal" }
 {}
 
 void
 a_processor_t::so_define_agent()
 {
 	so_subscribe( m_app_ctx.m_user_list_processor_mbox )
-		.event( &a_processor_t::on_new_user_list );
+		.event( &a_processor_t::on_new_user_list )
+		.event( &a_processor_t::on_user_list_delta );
+
+	so_subscribe( m_app_ctx.m_global_timer_mbox )
+		.event( &a_processor_t::on_one_second_timer );
 }
 
 void
@@ -85,11 +166,50 @@ a_processor_t::on_new_user_list(
 			} );
 }
 
+void
+a_processor_t::on_user_list_delta(
+	mhood_t< user_list_delta_t > cmd )
+{
+	namespace http_entry = ::arataga::admin_http_entry;
+
+	http_entry::envelope_sync_request_handling(
+			"user_list_processor::a_processor_t::on_user_list_delta",
+			*(cmd->m_replier),
+			http_entry::status_user_list_processor_failure,
+			[&]() -> http_entry::replier_t::reply_params_t
+			{
+				try_handle_user_list_delta_from_request( cmd->m_content );
+
+				// Everything is OK if we are here.
+				return http_entry::replier_t::reply_params_t{
+						http_entry::status_ok,
+						"User list delta accepted\r\n"
+				};
+			} );
+}
+
+void
+a_processor_t::on_one_second_timer(
+	mhood_t< one_second_timer_t > )
+{
+	// The user-list can be changed rarely, so outdated snapshots
+	// shouldn't wait for the next distribution.
+	release_unused_snapshots();
+}
+
 void
 a_processor_t::try_load_local_user_list_first_time()
 {
 	auto auth_data = try_load_local_user_list_content();
 
+	// Changes made after the last full user-list have to be applied.
+	if( auto delta = try_load_local_user_list_journal() )
+	{
+		if( !auth_data )
+			auth_data.emplace();
+		::arataga::user_list_auth::apply_auth_data_delta( *auth_data, *delta );
+	}
+
 	if( auth_data )
 	{
 		// User-list successfully loaded, it can now be distributed
@@ -113,10 +233,22 @@ a_processor_t::try_handle_new_user_list_from_post_request(
 			} );
 
 	// Try to parse the data.
-	auto auth_data = ::arataga::user_list_auth::parse_auth_data( content );
+	auto auth_data = ::arataga::user_list_auth::parse_auth_data_in_parallel(
+			content,
+			parsing_threads_count( m_params.m_io_threads_count ) );
 
 	// Parsing was successful, data can be stored in local file.
-	store_new_user_list_to_file( content );
+	// If it fails the journal and the snapshot are left as is: they
+	// still belong to the previous local copy of the user-list.
+	if( store_new_user_list_to_file( content ) )
+	{
+		// The binary snapshot allows to avoid the parsing at the next start.
+		store_user_list_snapshot(
+				auth_data,
+				::arataga::user_list_auth::calculate_content_checksum( content ) );
+		// All previous changes are in the new user-list now.
+		remove_user_list_journal();
+	}
 
 	// New user-list should be distributed.
 	distribute_updated_user_list( std::move(auth_data) );
@@ -130,6 +262,68 @@ a_processor_t::try_handle_new_user_list_from_post_request(
 			} );
 }
 
+void
+a_processor_t::try_handle_user_list_delta_from_request(
+	std::string_view content )
+{
+	::arataga::logging::direct_mode::info(
+			[&]( auto & logger, auto level )
+			{
+				logger.log(
+						level,
+						"user_list_processor: {} byte(s) of user-list delta "
+							"received from admin HTTP-entry",
+						content.size() );
+			} );
+
+	// Try to parse the data.
+	const auto delta = ::arataga::user_list_auth::parse_auth_data_delta(
+			content );
+
+	// Parsing was successful, changes can be stored in the journal.
+	// The changes are rejected if they can't be stored, otherwise
+	// they will be lost at the next start.
+	append_user_list_delta_to_journal( content );
+
+	::arataga::user_list_auth::apply_auth_data_delta( m_auth_data, delta );
+
+	// Accumulated changes are shared by receivers, so they are
+	// copied before the modification.
+	auto accumulated = m_current_delta ?
+			::arataga::user_list_auth::auth_data_delta_t{ *m_current_delta } :
+			::arataga::user_list_auth::auth_data_delta_t{};
+	::arataga::user_list_auth::merge_auth_data_delta( accumulated, delta );
+
+	if( accumulated.size() > max_delta_size )
+	{
+		// There are too many changes, it's better to make a new index.
+		compact_local_user_list();
+		distribute_updated_user_list( std::move(m_auth_data) );
+	}
+	else
+	{
+		// The same items can be changed many times, so the journal
+		// can grow even if the accumulated changes don't.
+		if( m_journal_size > max_journal_size ||
+				m_journal_lines > max_journal_lines )
+			compact_local_user_list();
+
+		distribute_user_list_delta(
+				std::make_shared< const ::arataga::user_list_auth::auth_data_delta_t >(
+						std::move(accumulated) ) );
+	}
+
+	::arataga::logging::direct_mode::info(
+			[&delta]( auto & logger, auto level )
+			{
+				logger.log(
+						level,
+						"user_list_processor: user-list delta processed, "
+						"changed items: {}",
+						delta.size() );
+			} );
+}
+
 std::optional< ::arataga::user_list_auth::auth_data_t >
 a_processor_t::try_load_local_user_list_content()
 {
@@ -166,9 +360,25 @@ a_processor_t::try_load_local_user_list_content()
 								content.size() );
 					} );
 
-			// ...and parse it.
-			return ::arataga::user_list_auth::parse_auth_data(
-					std::string_view{ content.data(), content.size() } );
+			const std::string_view content_view{
+					content.data(), content.size() };
+
+			// The binary snapshot is used if it was made for that content.
+			const auto content_checksum =
+					::arataga::user_list_auth::calculate_content_checksum(
+							content_view );
+			if( auto from_snapshot = try_load_user_list_snapshot(
+					content_checksum ) )
+				return std::move(*from_snapshot);
+
+			// ...otherwise the content has to be parsed.
+			auto auth_data =
+					::arataga::user_list_auth::parse_auth_data_in_parallel(
+							content_view,
+							parsing_threads_count( m_params.m_io_threads_count ) );
+			store_user_list_snapshot( auth_data, content_checksum );
+
+			return auth_data;
 		}();
 	}
 	catch( const std::exception & x )
@@ -203,9 +413,30 @@ a_processor_t::distribute_updated_user_list(
 							"user_list_processor: distribution of new user-list" );
 				} );
 
+		// The user-list is compiled into an immutable index that
+		// will be shared by all receivers.
+		auto snapshot = std::make_shared<
+				const ::arataga::user_list_auth::auth_data_index_t >(
+						auth_data );
+
 		so_5::send< updated_user_list_t >(
 				m_app_ctx.m_config_updates_mbox,
-				std::move(auth_data) );
+				snapshot,
+				::arataga::user_list_auth::auth_data_delta_snapshot_t{},
+				m_user_list_generation + 1u );
+		++m_user_list_generation;
+
+		// The current user-list is kept for applying of changes.
+		m_auth_data = std::move(auth_data);
+		m_current_delta.reset();
+
+		// The previous snapshot can still be used by receivers, so it's
+		// kept until they release it.
+		if( m_current_snapshot )
+			m_outdated_snapshots.push_back( std::move(m_current_snapshot) );
+		m_current_snapshot = std::move(snapshot);
+
+		release_unused_snapshots();
 	}
 	catch( const std::exception & x )
 	{
@@ -252,6 +483,70 @@ a_processor_t::distribute_updated_user_list(
 }
 
 void
+a_processor_t::distribute_user_list_delta(
+	::arataga::user_list_auth::auth_data_delta_snapshot_t delta ) noexcept
+{
+	try
+	{
+		::arataga::logging::direct_mode::debug(
+				[&]( auto & logger, auto level )
+				{
+					logger.log(
+							level,
+							"user_list_processor: distribution of user-list "
+							"delta, accumulated changes: {}",
+							delta->size() );
+				} );
+
+		// There could be no user-list before the first delta.
+		if( !m_current_snapshot )
+			m_current_snapshot = std::make_shared<
+					const ::arataga::user_list_auth::auth_data_index_t >();
+
+		so_5::send< updated_user_list_t >(
+				m_app_ctx.m_config_updates_mbox,
+				m_current_snapshot,
+				delta,
+				m_user_list_generation + 1u );
+		++m_user_list_generation;
+
+		m_current_delta = std::move(delta);
+
+		// Receivers could release old snapshots since the last distribution.
+		release_unused_snapshots();
+	}
+	catch( const std::exception & x )
+	{
+		::arataga::logging::direct_mode::critical(
+				[&x]( auto & logger, auto level )
+				{
+					logger.log(
+							level,
+							"user_list_processor: "
+							"an exception caught during distribution of "
+							"user-list delta: {}; aborting...",
+							x.what() );
+				} );
+
+		std::abort();
+	}
+}
+
+void
+a_processor_t::release_unused_snapshots() noexcept
+{
+	// NOTE: use_count() can't grow from 1 because there are no other
+	// owners that can make a copy.
+	m_outdated_snapshots.erase(
+			std::remove_if(
+					m_outdated_snapshots.begin(), m_outdated_snapshots.end(),
+					[]( const auto & snapshot ) noexcept {
+						return 1 == snapshot.use_count();
+					} ),
+			m_outdated_snapshots.end() );
+}
+
+bool
 a_processor_t::store_new_user_list_to_file(
 	std::string_view content )
 {
@@ -283,6 +578,8 @@ a_processor_t::store_new_user_list_to_file(
 				static_cast<std::streamsize>(content.size()) );
 
 		file.close();
+
+		return true;
 	}
 	catch( const std::exception & x )
 	{
@@ -297,6 +594,284 @@ a_processor_t::store_new_user_list_to_file(
 							x.what() );
 				} );
 	}
+
+	return false;
+}
+
+std::optional< ::arataga::user_list_auth::auth_data_delta_t >
+a_processor_t::try_load_local_user_list_journal()
+{
+	std::optional< ::arataga::user_list_auth::auth_data_delta_t > result;
+
+	try
+	{
+		if( !std::filesystem::exists( m_local_user_list_journal_file_name ) )
+			return result;
+
+		const auto content = ::arataga::utils::load_file_into_memory(
+				m_local_user_list_journal_file_name );
+
+		const auto records =
+				::arataga::user_list_auth::complete_journal_records(
+						std::string_view{ content.data(), content.size() } );
+		if( records.size() != content.size() )
+		{
+			::arataga::logging::direct_mode::warn(
+					[&]( auto & logger, auto level )
+					{
+						logger.log(
+								level,
+								"user_list_processor: incomplete last record "
+								"({} byte(s)) is dropped from user-list journal {}",
+								content.size() - records.size(),
+								fmt::streamed(m_local_user_list_journal_file_name) );
+					} );
+
+			// Next records have to be appended after complete ones.
+			std::error_code ec;
+			std::filesystem::resize_file(
+					m_local_user_list_journal_file_name,
+					records.size(),
+					ec );
+			if( ec )
+				::arataga::logging::direct_mode::err(
+						[&]( auto & logger, auto level )
+						{
+							logger.log(
+									level,
+									"user_list_processor: unable to truncate "
+									"user-list journal {}: {}",
+									fmt::streamed(m_local_user_list_journal_file_name),
+									ec.message() );
+						} );
+		}
+
+		m_journal_size = records.size();
+		m_journal_lines = static_cast< std::size_t >(
+				std::count( records.begin(), records.end(), '\n' ) );
+
+		// All changes from the journal are parsed as one delta because
+		// the last change for a key wins anyway.
+		result = ::arataga::user_list_auth::parse_auth_data_delta( records );
+
+		::arataga::logging::direct_mode::info(
+				[&]( auto & logger, auto level )
+				{
+					logger.log(
+							level,
+							"user_list_processor: {} change(s) loaded from "
+							"user-list journal {}",
+							result->size(),
+							fmt::streamed(m_local_user_list_journal_file_name) );
+				} );
+	}
+	catch( const std::exception & x )
+	{
+		::arataga::logging::direct_mode::err(
+				[&]( auto & logger, auto level )
+				{
+					logger.log(
+							level,
+							"user_list_processor: load user-list journal {} "
+							"at startup failed: {}",
+							fmt::streamed(m_local_user_list_journal_file_name),
+							x.what() );
+				} );
+	}
+
+	return result;
+}
+
+void
+a_processor_t::append_user_list_delta_to_journal(
+	std::string_view content )
+{
+	try
+	{
+		std::ofstream file( m_local_user_list_journal_file_name,
+				std::ios_base::out | std::ios_base::binary |
+						std::ios_base::app );
+		if( !file )
+			::arataga::utils::ensure_successful_syscall( -1,
+					fmt::format( "unable to open user-list journal {} for "
+							"writting",
+							fmt::streamed(m_local_user_list_journal_file_name) ) );
+
+		file.exceptions( std::ifstream::badbit | std::ifstream::failbit );
+
+		file.write(
+				content.data(),
+				static_cast<std::streamsize>(content.size()) );
+		// The next delta has to start from a new line.
+		const bool needs_eol = !content.empty() && '\n' != content.back();
+		if( needs_eol )
+			file.put( '\n' );
+
+		file.close();
+
+		m_journal_size += content.size() + (needs_eol ? 1u : 0u);
+		m_journal_lines += static_cast< std::size_t >(
+				std::count( content.begin(), content.end(), '\n' ) ) +
+				(needs_eol ? 1u : 0u);
+	}
+	catch( const std::exception & x )
+	{
+		::arataga::logging::direct_mode::err(
+				[&]( auto & logger, auto level )
+				{
+					logger.log(
+							level,
+							"user_list_processor: error appending "
+							"user-list delta to journal {}: {}",
+							fmt::streamed(m_local_user_list_journal_file_name),
+							x.what() );
+				} );
+
+		// A partially written record shouldn't remain in the journal,
+		// otherwise the next record will be appended to it.
+		std::error_code ec;
+		if( std::filesystem::exists( m_local_user_list_journal_file_name, ec ) )
+			std::filesystem::resize_file(
+					m_local_user_list_journal_file_name,
+					m_journal_size,
+					ec );
+
+		throw user_list_processor_ex_t{
+				fmt::format( "unable to store user-list delta in journal {}: {}",
+						fmt::streamed(m_local_user_list_journal_file_name),
+						x.what() )
+			};
+	}
+}
+
+void
+a_processor_t::remove_user_list_journal()
+{
+	std::error_code ec;
+	std::filesystem::remove( m_local_user_list_journal_file_name, ec );
+	if( !ec )
+	{
+		m_journal_size = 0u;
+		m_journal_lines = 0u;
+	}
+	else
+		::arataga::logging::direct_mode::err(
+				[&]( auto & logger, auto level )
+				{
+					logger.log(
+							level,
+							"user_list_processor: unable to remove "
+							"user-list journal {}: {}",
+							fmt::streamed(m_local_user_list_journal_file_name),
+							ec.message() );
+				} );
+}
+
+void
+a_processor_t::compact_local_user_list()
+{
+	::arataga::logging::direct_mode::info(
+			[]( auto & logger, auto level )
+			{
+				logger.log(
+						level,
+						"user_list_processor: too many changes since "
+						"the last full user-list, local user-list will be "
+						"rewritten" );
+			} );
+
+	const auto content = ::arataga::user_list_auth::make_auth_data_content(
+			m_auth_data );
+
+	// The journal is the only persistent copy of changes if the new
+	// content can't be stored.
+	if( !store_new_user_list_to_file( content ) )
+		return;
+
+	// NOTE: if the journal isn't removed because of a failure it will
+	// be applied to the new content at the next start. It's safe
+	// because changes from the journal are already in the new content.
+	store_user_list_snapshot(
+			m_auth_data,
+			::arataga::user_list_auth::calculate_content_checksum( content ) );
+	remove_user_list_journal();
+}
+
+std::optional< ::arataga::user_list_auth::auth_data_t >
+a_processor_t::try_load_user_list_snapshot(
+	std::uint64_t content_checksum )
+{
+	std::optional< ::arataga::user_list_auth::auth_data_t > result;
+
+	try
+	{
+		result = ::arataga::user_list_auth::try_load_auth_data_snapshot(
+				m_local_user_list_snapshot_file_name,
+				content_checksum );
+
+		if( result )
+			::arataga::logging::direct_mode::info(
+					[&]( auto & logger, auto level )
+					{
+						logger.log(
+								level,
+								"user_list_processor: user-list loaded "
+								"from binary snapshot {}",
+								fmt::streamed(m_local_user_list_snapshot_file_name) );
+					} );
+	}
+	catch( const std::exception & x )
+	{
+		::arataga::logging::direct_mode::warn(
+				[&]( auto & logger, auto level )
+				{
+					logger.log(
+							level,
+							"user_list_processor: unable to use binary "
+							"snapshot {}, text form will be parsed: {}",
+							fmt::streamed(m_local_user_list_snapshot_file_name),
+							x.what() );
+				} );
+	}
+
+	return result;
+}
+
+void
+a_processor_t::store_user_list_snapshot(
+	const ::arataga::user_list_auth::auth_data_t & auth_data,
+	std::uint64_t content_checksum )
+{
+	try
+	{
+		::arataga::logging::direct_mode::trace(
+				[&]( auto & logger, auto level )
+				{
+					logger.log(
+							level,
+							"user_list_processor: updating binary "
+							"snapshot of user-list {}",
+							fmt::streamed(m_local_user_list_snapshot_file_name) );
+				} );
+
+		::arataga::user_list_auth::store_auth_data_snapshot(
+				m_local_user_list_snapshot_file_name,
+				auth_data,
+				content_checksum );
+	}
+	catch( const std::exception & x )
+	{
+		::arataga::logging::direct_mode::err(
+				[&]( auto & logger, auto level )
+				{
+					logger.log(
+							level,
+							"user_list_processor: error storing binary "
+							"snapshot of user-list {}: {}",
+							fmt::streamed(m_local_user_list_snapshot_file_name),
+							x.what() );
+				} );
+	}
 }
 
 //
@@ -9,6 +9,12 @@
 
 #include <arataga/config.hpp>
 #include <arataga/user_list_auth_data.hpp>
+#include <arataga/user_list_auth_index.hpp>
+
+#include <arataga/one_second_timer.hpp>
+
+#include <cstdint>
+#include <vector>
 
 namespace arataga::user_list_processor
 {
@@ -47,11 +53,108 @@ private:
 	//! Name of the file with local copy of user-list.
 	const std::filesystem::path m_local_user_list_file_name;
 
+	//! Name of the file with binary snapshot of the local user-list.
+	/*!
+	 * @since v.0.6.0
+	 */
+	const std::filesystem::path m_local_user_list_snapshot_file_name;
+
+	//! Name of the file with the journal of changes for the local
+	//! user-list.
+	/*!
+	 * Every accepted delta is appended to that file. The journal is
+	 * removed when a full user-list is stored into
+	 * m_local_user_list_file_name.
+	 *
+	 * @since v.0.6.0
+	 */
+	const std::filesystem::path m_local_user_list_journal_file_name;
+
+	//! The size of the journal in bytes.
+	/*!
+	 * It's the size of complete records only. If an append fails the
+	 * journal is truncated to that size.
+	 *
+	 * @since v.0.6.0
+	 */
+	std::uintmax_t m_journal_size{ 0u };
+
+	//! The number of lines in the journal.
+	/*!
+	 * @since v.0.6.0
+	 */
+	std::size_t m_journal_lines{ 0u };
+
+	//! The current user-list.
+	/*!
+	 * It's necessary for applying of changes and for making a new
+	 * index when there are too many changes.
+	 *
+	 * @since v.0.6.0
+	 */
+	::arataga::user_list_auth::auth_data_t m_auth_data;
+
+	//! Changes accumulated since the last distributed index.
+	/*!
+	 * It's nullptr if there is no changes.
+	 *
+	 * @since v.0.6.0
+	 */
+	::arataga::user_list_auth::auth_data_delta_snapshot_t m_current_delta;
+
+	//! The last distributed user-list.
+	/*!
+	 * It's nullptr if nothing has been distributed yet.
+	 *
+	 * @since v.0.6.0
+	 */
+	::arataga::user_list_auth::auth_data_snapshot_t m_current_snapshot;
+
+	//! Previously distributed user-lists that can still be in use.
+	/*!
+	 * References to those snapshots are held to guarantee that a snapshot
+	 * will be destroyed on the context of that agent, not on some
+	 * IO-thread. Destruction of a big user-list takes time and
+	 * IO-threads shouldn't be blocked by it.
+	 *
+	 * Receivers don't acknowledge a switch to a new snapshot and can
+	 * hold an old one for an unknown time (e.g. while a message with it
+	 * waits in a queue). So a snapshot is kept here until this agent
+	 * becomes its only owner, see release_unused_snapshots(). This check
+	 * is performed on every distribution of the user-list or its changes
+	 * and every second.
+	 *
+	 * @since v.0.6.0
+	 */
+	std::vector< ::arataga::user_list_auth::auth_data_snapshot_t >
+			m_outdated_snapshots;
+
+	//! The generation of the last distributed user-list.
+	/*!
+	 * @since v.0.6.0
+	 */
+	std::uint64_t m_user_list_generation{ 0u };
+
 	//! Handler for a new incoming user-list.
 	void
 	on_new_user_list(
 		mhood_t< new_user_list_t > cmd );
 
+	//! Handler for incoming changes for the user-list.
+	/*!
+	 * @since v.0.6.0
+	 */
+	void
+	on_user_list_delta(
+		mhood_t< user_list_delta_t > cmd );
+
+	//! Periodic release of outdated snapshots.
+	/*!
+	 * @since v.0.6.0
+	 */
+	void
+	on_one_second_timer( mhood_t< one_second_timer_t > );
+
 	//! Attempt to load user-list from the local copy at the start of agent.
 	void
 	try_load_local_user_list_first_time();
@@ -61,6 +164,14 @@ private:
 	try_handle_new_user_list_from_post_request(
 		std::string_view content );
 
+	//! Attempt to handle incoming changes for the user-list.
+	/*!
+	 * @since v.0.6.0
+	 */
+	void
+	try_handle_user_list_delta_from_request(
+		std::string_view content );
+
 	//! Attempt to load user-list from the local copy.
 	/*!
 	 * Handles exceptions thrown during loading of file content.
@@ -81,14 +192,112 @@ private:
 	distribute_updated_user_list(
 		::arataga::user_list_auth::auth_data_t auth_data ) noexcept;
 
+	//! Distribution of accumulated changes for the current user-list.
+	/*!
+	 * The last distributed index is sent again with @a delta.
+	 *
+	 * This method is marked as noexcept for the same reasons as
+	 * distribute_updated_user_list().
+	 *
+	 * @since v.0.6.0
+	 */
+	void
+	distribute_user_list_delta(
+		::arataga::user_list_auth::auth_data_delta_snapshot_t delta ) noexcept;
+
+	//! Destroy outdated snapshots that aren't used by anyone else.
+	/*!
+	 * If this agent holds the only reference to a snapshot then nobody
+	 * can get a new one, so the snapshot can be safely destroyed here.
+	 *
+	 * @since v.0.6.0
+	 */
+	void
+	release_unused_snapshots() noexcept;
+
 	//! Storing of a new user-list to local file.
 	/*!
 	 * @note
 	 * Exceptions are caught, logged and suppressed.
+	 *
+	 * @return false if the user-list can't be stored (since v.0.6.0).
 	 */
-	void
+	bool
 	store_new_user_list_to_file(
 		std::string_view content );
+
+	//! Attempt to load changes from the journal at the start of agent.
+	/*!
+	 * An incomplete last record (that is left if the application was
+	 * stopped during an append) is ignored and removed from the journal.
+	 *
+	 * @note
+	 * Exceptions are caught, logged and suppressed.
+	 *
+	 * @return Empty value if there is no journal or it can't be loaded.
+	 *
+	 * @since v.0.6.0
+	 */
+	std::optional< ::arataga::user_list_auth::auth_data_delta_t >
+	try_load_local_user_list_journal();
+
+	//! Append changes to the journal.
+	/*!
+	 * If the changes can't be stored the journal is truncated to its
+	 * previous size and an exception is thrown.
+	 *
+	 * @since v.0.6.0
+	 */
+	void
+	append_user_list_delta_to_journal(
+		std::string_view content );
+
+	//! Removal of the journal after storing of the full user-list.
+	/*!
+	 * @note
+	 * Errors are logged and suppressed.
+	 *
+	 * @since v.0.6.0
+	 */
+	void
+	remove_user_list_journal();
+
+	//! Replace the local copy of user-list by the current user-list.
+	/*!
+	 * It's called when there are too many accumulated changes or the
+	 * journal is too big. The local file, the binary snapshot are
+	 * rewritten and the journal is removed.
+	 *
+	 * @since v.0.6.0
+	 */
+	void
+	compact_local_user_list();
+
+	//! Attempt to load user-list from the binary snapshot.
+	/*!
+	 * @note
+	 * Exceptions are caught, logged and suppressed.
+	 *
+	 * @return Empty value if there is no actual snapshot for the
+	 * current content of user-list file.
+	 *
+	 * @since v.0.6.0
+	 */
+	std::optional< ::arataga::user_list_auth::auth_data_t >
+	try_load_user_list_snapshot(
+		std::uint64_t content_checksum );
+
+	//! Storing of the binary snapshot of a new user-list.
+	/*!
+	 * @note
+	 * Exceptions are caught, logged and suppressed.
+	 *
+	 * @since v.0.6.0
+	 */
+	void
+	store_user_list_snapshot(
+		const ::arataga::user_list_auth::auth_data_t & auth_data,
+		std::uint64_t content_checksum );
 };
 
 } /* namespace arataga::user_list_processor */
@@ -7,10 +7,12 @@
 
 #include <arataga/config.hpp>
 
-#include <arataga/user_list_auth_data.hpp>
+#include <arataga/user_list_auth_index.hpp>
 
 #include <so_5/all.hpp>
 
+#include <cstdint>
+
 namespace arataga::user_list_processor
 {
 
@@ -29,16 +31,51 @@ struct started_t final : public so_5::signal_t {};
  * @brief Notification about accepted new user-list.
  *
  * @note
- * For simplicity new user-list is sent by a value.
+ * Before v.0.6.0 new user-list was sent by a value and every receiver
+ * made its own copy of it. Since v.0.6.0 an immutable snapshot is sent
+ * and all receivers share it.
+ *
+ * Since v.0.6.0 a delta update of the user-list doesn't produce a new
+ * snapshot. The same snapshot is sent with the accumulated changes.
  */
 struct updated_user_list_t final : public so_5::message_t
 {
 	//! New user-list.
-	::arataga::user_list_auth::auth_data_t m_auth_data;
+	/*!
+	 * @note
+	 * It can't be nullptr.
+	 */
+	::arataga::user_list_auth::auth_data_snapshot_t m_auth_data;
+
+	//! Changes for m_auth_data.
+	/*!
+	 * Changes received via delta updates since m_auth_data was made.
+	 * They have priority over the content of m_auth_data.
+	 *
+	 * @note
+	 * It can be nullptr if there is no changes.
+	 *
+	 * @since v.0.6.0
+	 */
+	::arataga::user_list_auth::auth_data_delta_snapshot_t m_delta;
+
+	//! The sequence number of that user-list.
+	/*!
+	 * It's incremented for every new user-list. It allows to detect
+	 * that a result of authentification was obtained for an old
+	 * user-list.
+	 *
+	 * @since v.0.6.0
+	 */
+	std::uint64_t m_generation;
 
 	updated_user_list_t(
-		::arataga::user_list_auth::auth_data_t auth_data )
+		::arataga::user_list_auth::auth_data_snapshot_t auth_data,
+		::arataga::user_list_auth::auth_data_delta_snapshot_t delta,
+		std::uint64_t generation )
 		:	m_auth_data{ std::move(auth_data) }
+		,	m_delta{ std::move(delta) }
+		,	m_generation{ generation }
 	{}
 };
 
@@ -9,6 +9,8 @@
 
 #include <arataga/admin_http_entry/pub.hpp>
 
+#include <arataga/io_threads_count.hpp>
+
 #include <filesystem>
 
 namespace arataga::user_list_processor
@@ -27,6 +29,14 @@ struct params_t
 
 	//! mbox for a notification about successful start.
 	so_5::mbox_t m_startup_notify_mbox;
+
+	//! Number of io_threads.
+	/*!
+	 * It limits the number of threads for parsing of a user-list.
+	 *
+	 * @since v.0.6.0
+	 */
+	io_threads_count_t m_io_threads_count{ io_threads_count::default_t{} };
 };
 
 //
@@ -51,6 +61,30 @@ struct new_user_list_t final : public so_5::message_t
 	{}
 };
 
+//
+// user_list_delta_t
+//
+/*!
+ * @brief A notification about incoming changes for the current user-list.
+ *
+ * @since v.0.6.0
+ */
+struct user_list_delta_t final : public so_5::message_t
+{
+	//! An object to send the reply to admin HTTP-entry.
+	::arataga::admin_http_entry::replier_shptr_t m_replier;
+
+	//! The content of incoming changes.
+	const std::string_view m_content;
+
+	user_list_delta_t(
+		::arataga::admin_http_entry::replier_shptr_t replier,
+		std::string_view content )
+		:	m_replier{ std::move(replier) }
+		,	m_content{ std::move(content) }
+	{}
+};
+
 //
 // introduce_user_list_processor
 //
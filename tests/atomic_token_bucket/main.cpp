@@ -0,0 +1,143 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <arataga/acl_handler/atomic_token_bucket.hpp>
+
+#include <thread>
+#include <vector>
+
+using namespace arataga::acl_handler;
+using namespace std::chrono_literals;
+
+TEST_CASE( "unlimited bucket" )
+{
+	atomic_token_bucket_t bucket;
+
+	REQUIRE( bucket.is_unlimited() );
+	REQUIRE( 4096u == bucket.try_acquire( 4096u ) );
+
+	bucket.consume( 100000u );
+	REQUIRE( 4096u == bucket.try_acquire( 4096u ) );
+}
+
+TEST_CASE( "capacity and acquisition" )
+{
+	const auto now = std::chrono::steady_clock::now();
+
+	atomic_token_bucket_t bucket;
+	bucket.set_rate( 10000u, 100ms, now );
+
+	REQUIRE( !bucket.is_unlimited() );
+	REQUIRE( 1000 == bucket.tokens() );
+
+	REQUIRE( 600u == bucket.try_acquire( 600u ) );
+	REQUIRE( 400u == bucket.try_acquire( 600u ) );
+	REQUIRE( 0u == bucket.try_acquire( 600u ) );
+
+	// Unused tokens are returned, but the capacity can't be exceeded.
+	bucket.give_back( 300u );
+	REQUIRE( 300 == bucket.tokens() );
+	bucket.give_back( 5000u );
+	REQUIRE( 1000 == bucket.tokens() );
+
+	// The capacity can't be less than one byte.
+	REQUIRE( 1 == atomic_token_bucket_t::capacity_for( 5u, 20ms ) );
+}
+
+TEST_CASE( "refill" )
+{
+	const auto now = std::chrono::steady_clock::now();
+
+	atomic_token_bucket_t bucket;
+	bucket.set_rate( 10000u, 100ms, now );
+	REQUIRE( 1000u == bucket.try_acquire( 1000u ) );
+
+	// The debt has to be paid off.
+	bucket.consume( 500u );
+	REQUIRE( -500 == bucket.tokens() );
+
+	bucket.refill( now + 10ms );
+	REQUIRE( -400 == bucket.tokens() );
+	REQUIRE( 0u == bucket.try_acquire( 100u ) );
+
+	// A repeated refill for the same time point adds nothing.
+	bucket.refill( now + 10ms );
+	REQUIRE( -400 == bucket.tokens() );
+
+	bucket.refill( now + 60ms );
+	REQUIRE( 100 == bucket.tokens() );
+
+	// The bucket can't be overfilled.
+	bucket.refill( now + 10s );
+	REQUIRE( 1000 == bucket.tokens() );
+}
+
+TEST_CASE( "low rate doesn't lose tokens" )
+{
+	const auto now = std::chrono::steady_clock::now();
+
+	atomic_token_bucket_t bucket;
+	// 3 bytes per second, the capacity is 3 bytes.
+	bucket.set_rate( 3u, 1000ms, now );
+	REQUIRE( 3u == bucket.try_acquire( 3u ) );
+
+	// Every refill adds less than one token, but the elapsed time
+	// is accumulated.
+	for( int i = 1; i <= 10; ++i )
+		bucket.refill( now + std::chrono::milliseconds{ i * 100 } );
+
+	REQUIRE( 3 == bucket.tokens() );
+}
+
+TEST_CASE( "set_rate" )
+{
+	const auto now = std::chrono::steady_clock::now();
+
+	atomic_token_bucket_t bucket;
+	bucket.set_rate( 10000u, 100ms, now );
+	REQUIRE( 500u == bucket.try_acquire( 500u ) );
+
+	// The same rate doesn't reset the bucket.
+	bucket.set_rate( 10000u, 100ms, now + 1ms );
+	REQUIRE( 500 == bucket.tokens() );
+
+	// A new rate resets the bucket.
+	bucket.set_rate( 20000u, 100ms, now + 1ms );
+	REQUIRE( 2000 == bucket.tokens() );
+
+	// A new refill interval resets the bucket too.
+	bucket.set_rate( 20000u, 50ms, now + 1ms );
+	REQUIRE( 1000 == bucket.tokens() );
+
+	bucket.set_rate( 0u, 50ms, now + 1ms );
+	REQUIRE( bucket.is_unlimited() );
+}
+
+TEST_CASE( "concurrent acquisition" )
+{
+	const auto now = std::chrono::steady_clock::now();
+
+	atomic_token_bucket_t bucket;
+	bucket.set_rate( 100000u, 1000ms, now );
+
+	std::atomic< std::size_t > total{ 0u };
+
+	std::vector< std::thread > threads;
+	for( int i = 0; i != 4; ++i )
+		threads.emplace_back( [&] {
+			for(;;)
+			{
+				const auto acquired = bucket.try_acquire( 7u );
+				if( !acquired )
+					break;
+				total += acquired;
+			}
+		} );
+
+	for( auto & t : threads )
+		t.join();
+
+	// No more than the capacity can be acquired without a refill.
+	REQUIRE( 100000u == total.load() );
+	REQUIRE( 0 == bucket.tokens() );
+}
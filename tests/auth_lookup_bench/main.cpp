@@ -0,0 +1,205 @@
+/*
+ * A microbenchmark for lookups in a user-list.
+ *
+ * Compares lookups in auth_data_t (std::map) with lookups in
+ * auth_data_index_t (open-addressing hash tables).
+ *
+ * Usage: auth_lookup_bench [USERS_COUNT]
+ */
+
+#include <arataga/user_list_auth_data.hpp>
+#include <arataga/user_list_auth_index.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace arataga::user_list_auth;
+
+namespace
+{
+
+constexpr std::uint32_t proxy_addr_base = 0x0a000000u;
+constexpr ip_port_t first_port = 3000u;
+constexpr std::uint32_t ports_count = 50u;
+
+struct login_request_t
+{
+	ipv4_address_t m_proxy_in_addr;
+	ip_port_t m_proxy_port;
+	std::string m_username;
+	std::string m_password;
+};
+
+struct ip_request_t
+{
+	ipv4_address_t m_proxy_in_addr;
+	ip_port_t m_proxy_port;
+	ipv4_address_t m_user_ip;
+};
+
+[[nodiscard]]
+auth_data_t
+make_auth_data( std::uint32_t users_count )
+{
+	auth_data_t result;
+
+	for( std::uint32_t i = 0u; i != users_count; ++i )
+	{
+		const user_data_t user{
+				arataga::bandlim_config_t{ 1024u * i, 1024u * i },
+				i % 100u,
+				i
+			};
+		const ipv4_address_t proxy_addr{ proxy_addr_base + i % 8u };
+		const auto port = static_cast< ip_port_t >(
+				first_port + i % ports_count );
+
+		result.m_by_ip.emplace(
+				auth_by_ip_key_t{
+					proxy_addr, port, ipv4_address_t{ 0xc0a80000u + i }
+				},
+				user );
+		result.m_by_login.emplace(
+				auth_by_login_key_t{
+					proxy_addr, port,
+					"user-" + std::to_string( i ),
+					"secret-password-" + std::to_string( i * 7919u )
+				},
+				user );
+	}
+
+	return result;
+}
+
+template< typename Requests >
+[[nodiscard]]
+Requests
+shuffled( Requests requests )
+{
+	std::mt19937 gen{ 42u };
+	std::shuffle( requests.begin(), requests.end(), gen );
+	return requests;
+}
+
+template< typename Lambda >
+void
+measure(
+	const char * name,
+	std::size_t lookups,
+	Lambda && lambda )
+{
+	const auto started_at = std::chrono::steady_clock::now();
+	const auto found = lambda();
+	const auto finished_at = std::chrono::steady_clock::now();
+
+	const double ns = std::chrono::duration< double, std::nano >(
+			finished_at - started_at ).count();
+
+	std::cout << name << ": " << (ns / static_cast<double>(lookups))
+			<< " ns/lookup (found: " << found << ")" << std::endl;
+}
+
+} /* namespace anonymous */
+
+int
+main( int argc, char ** argv )
+{
+	const std::uint32_t users_count = argc > 1 ?
+			static_cast< std::uint32_t >( std::strtoul( argv[ 1 ], nullptr, 10 ) )
+			: 100000u;
+	constexpr int rounds = 10;
+
+	std::cout << "users: " << users_count << std::endl;
+
+	const auto data = make_auth_data( users_count );
+
+	const auto index_started_at = std::chrono::steady_clock::now();
+	const auth_data_index_t index{ data };
+	std::cout << "index built in "
+			<< std::chrono::duration_cast< std::chrono::milliseconds >(
+					std::chrono::steady_clock::now() - index_started_at ).count()
+			<< "ms" << std::endl;
+
+	std::vector< ip_request_t > ip_requests;
+	for( const auto & [key, user] : data.m_by_ip )
+		ip_requests.push_back( ip_request_t{
+				key.m_proxy_in_addr, key.m_proxy_port, key.m_user_ip } );
+	ip_requests = shuffled( std::move(ip_requests) );
+
+	std::vector< login_request_t > login_requests;
+	for( const auto & [key, user] : data.m_by_login )
+		login_requests.push_back( login_request_t{
+				key.m_proxy_in_addr, key.m_proxy_port,
+				key.m_username, key.m_password } );
+	// Every fourth request has a wrong password.
+	for( std::size_t i = 0u; i < login_requests.size(); i += 4u )
+		login_requests[ i ].m_password += "-wrong";
+	login_requests = shuffled( std::move(login_requests) );
+
+	const auto ip_lookups = ip_requests.size() * rounds;
+	const auto login_lookups = login_requests.size() * rounds;
+
+	measure( "by_ip, std::map", ip_lookups, [&] {
+			std::size_t found = 0u;
+			for( int r = 0; r != rounds; ++r )
+				for( const auto & req : ip_requests )
+				{
+					const auto it = data.m_by_ip.find( auth_by_ip_key_t{
+							req.m_proxy_in_addr, req.m_proxy_port, req.m_user_ip
+						} );
+					if( it != data.m_by_ip.end() )
+						found += 1u;
+				}
+			return found;
+		} );
+
+	measure( "by_ip, index", ip_lookups, [&] {
+			std::size_t found = 0u;
+			for( int r = 0; r != rounds; ++r )
+				for( const auto & req : ip_requests )
+				{
+					if( index.find_by_ip(
+							req.m_proxy_in_addr, req.m_proxy_port, req.m_user_ip ) )
+						found += 1u;
+				}
+			return found;
+		} );
+
+	// NOTE: the key for std::map is created for every lookup as it was
+	// done by authentificator before v.0.6.0.
+	measure( "by_login, std::map", login_lookups, [&] {
+			std::size_t found = 0u;
+			for( int r = 0; r != rounds; ++r )
+				for( const auto & req : login_requests )
+				{
+					const auto it = data.m_by_login.find( auth_by_login_key_t{
+							req.m_proxy_in_addr, req.m_proxy_port,
+							req.m_username, req.m_password
+						} );
+					if( it != data.m_by_login.end() )
+						found += 1u;
+				}
+			return found;
+		} );
+
+	measure( "by_login, index", login_lookups, [&] {
+			std::size_t found = 0u;
+			for( int r = 0; r != rounds; ++r )
+				for( const auto & req : login_requests )
+				{
+					if( index.find_by_login(
+							req.m_proxy_in_addr, req.m_proxy_port,
+							req.m_username, req.m_password ) )
+						found += 1u;
+				}
+			return found;
+		} );
+
+	return 0;
+}
@@ -5,7 +5,19 @@ require 'mxx_ru/cpp'
 MxxRu::Cpp::composite_target {
 	required_prj 'tests/config_parser/prj.ut.rb'
 	required_prj 'tests/local_user_list_data/prj.ut.rb'
+	required_prj 'tests/user_list_auth_snapshot/prj.ut.rb'
    required_prj 'tests/dns_types/prj.ut.rb'
+	required_prj 'tests/dns_cache/prj.ut.rb'
+	required_prj 'tests/lookup_coalescer/prj.ut.rb'
+	required_prj 'tests/io_chunk_pool/prj.ut.rb'
+	required_prj 'tests/pacing_wheel/prj.ut.rb'
+	required_prj 'tests/timeout_wheel/prj.ut.rb'
+	required_prj 'tests/upstream_connection_pool/prj.ut.rb'
+	required_prj 'tests/atomic_token_bucket/prj.ut.rb'
+	required_prj 'tests/latency_histogram/prj.ut.rb'
+	required_prj 'tests/openmetrics/prj.ut.rb'
+	required_prj 'tests/traffic_stats/prj.ut.rb'
+	required_prj 'tests/snapshot_registry/prj.ut.rb'
 	required_prj 'tests/socks5/build_tests.rb'
 	required_prj 'tests/http/build_tests.rb'
 }
@@ -29,6 +29,7 @@ nserver 1.1.1.1
 		REQUIRE( 100u == cfg.m_common_acl_params.m_maxconn );
 		REQUIRE( 8u*1024u == cfg.m_common_acl_params.m_io_chunk_size );
 		REQUIRE( 4u == cfg.m_common_acl_params.m_io_chunk_count );
+		REQUIRE( relay_mode_t::copy == cfg.m_common_acl_params.m_relay_mode );
 
 		REQUIRE( bandlim_config_t::is_unlimited(
 				cfg.m_common_acl_params.m_client_bandlim.m_in ) );
@@ -36,11 +37,19 @@ nserver 1.1.1.1
 				cfg.m_common_acl_params.m_client_bandlim.m_out ) );
 
 		REQUIRE( 30s == cfg.m_dns_cache_cleanup_period );
+		REQUIRE( 5s == cfg.m_dns_cache_min_ttl );
+		REQUIRE( 1h == cfg.m_dns_cache_max_ttl );
+		REQUIRE( 10s == cfg.m_dns_cache_negative_ttl );
 
 		REQUIRE( cfg.m_denied_ports.m_cases.empty() );
 
 		REQUIRE( 750ms == cfg.m_common_acl_params.m_failed_auth_reply_timeout );
 
+		REQUIRE( 20ms == cfg.m_common_acl_params.m_bandlim_refill_interval );
+
+		REQUIRE( 64u == cfg.m_common_acl_params.m_http_upstream_pool_size );
+		REQUIRE( 4s == cfg.m_common_acl_params.m_http_upstream_idle_timeout );
+
 		REQUIRE( 8u*1024u == cfg.m_common_acl_params.m_http_message_limits
 				.m_max_request_target_length );
 		REQUIRE( 2u*1024u == cfg.m_common_acl_params.m_http_message_limits
@@ -246,6 +255,114 @@ nserver 1.1.1.1
 	}
 }
 
+TEST_CASE("dns_cache_min_ttl and dns_cache_max_ttl") {
+	using namespace arataga;
+
+	config_parser_t parser;
+
+	{
+		const auto what = 
+R"(
+dns_cache_min_ttl 0
+dns_cache_max_ttl 10min
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_NOTHROW( cfg = parser.parse( what ) );
+
+		REQUIRE( 0s == cfg.m_dns_cache_min_ttl );
+		REQUIRE( 10min == cfg.m_dns_cache_max_ttl );
+	}
+
+	{
+		const auto what = 
+R"(
+dns_cache_min_ttl 30s
+dns_cache_max_ttl 30s
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_NOTHROW( cfg = parser.parse( what ) );
+
+		REQUIRE( 30s == cfg.m_dns_cache_min_ttl );
+		REQUIRE( 30s == cfg.m_dns_cache_max_ttl );
+	}
+
+	{
+		const auto what = 
+R"(
+dns_cache_min_ttl 1500ms
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_THROWS_AS(
+				cfg = parser.parse( what ),
+				arataga::config_parser_t::parser_exception_t );
+	}
+
+	{
+		const auto what = 
+R"(
+dns_cache_min_ttl 2min
+dns_cache_max_ttl 1min
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_THROWS_AS(
+				cfg = parser.parse( what ),
+				arataga::config_parser_t::parser_exception_t );
+	}
+}
+
+TEST_CASE("dns_cache_negative_ttl") {
+	using namespace arataga;
+
+	config_parser_t parser;
+
+	{
+		const auto what = 
+R"(
+dns_cache_negative_ttl 0
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_NOTHROW( cfg = parser.parse( what ) );
+
+		REQUIRE( 0s == cfg.m_dns_cache_negative_ttl );
+	}
+
+	{
+		const auto what = 
+R"(
+dns_cache_negative_ttl 1min
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_NOTHROW( cfg = parser.parse( what ) );
+
+		REQUIRE( 1min == cfg.m_dns_cache_negative_ttl );
+	}
+
+	{
+		const auto what = 
+R"(
+dns_cache_negative_ttl 250ms
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_THROWS_AS(
+				cfg = parser.parse( what ),
+				arataga::config_parser_t::parser_exception_t );
+	}
+}
+
 TEST_CASE("acl.max.conn") {
 	using namespace arataga;
 
@@ -459,6 +576,52 @@ nserver 1.1.1.1
 	}
 }
 
+TEST_CASE("relay_mode") {
+	using namespace arataga;
+
+	config_parser_t parser;
+
+	{
+		const auto what = 
+R"(
+acl.io.relay_mode splice
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_NOTHROW( cfg = parser.parse( what ) );
+
+		REQUIRE( relay_mode_t::splice == cfg.m_common_acl_params.m_relay_mode );
+	}
+
+	{
+		const auto what = 
+R"(
+acl.io.relay_mode splice
+acl.io.relay_mode copy
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_NOTHROW( cfg = parser.parse( what ) );
+
+		REQUIRE( relay_mode_t::copy == cfg.m_common_acl_params.m_relay_mode );
+	}
+
+	{
+		const auto what = 
+R"(
+acl.io.relay_mode sendfile
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_THROWS_AS(
+				cfg = parser.parse( what ),
+				arataga::config_parser_t::parser_exception_t );
+	}
+}
+
 TEST_CASE("failed_auth_reply_timeout") {
 	using namespace arataga;
 
@@ -560,6 +723,7 @@ timeout.connect_target 3s
 timeout.idle_connection 10min
 timeout.http.headers_complete 1min
 timeout.http.negative_response 650ms
+timeout.http.upstream_idle 2500ms
 
 nserver 1.1.1.1
 )"sv;
@@ -576,6 +740,7 @@ nserver 1.1.1.1
 		REQUIRE( 10min == cfg.m_common_acl_params.m_idle_connection_timeout );
 		REQUIRE( 1min == cfg.m_common_acl_params.m_http_headers_complete_timeout );
 		REQUIRE( 650ms == cfg.m_common_acl_params.m_http_negative_response_timeout );
+		REQUIRE( 2'500ms == cfg.m_common_acl_params.m_http_upstream_idle_timeout );
 	}
 }
 
@@ -733,6 +898,64 @@ nserver 1.1.1.1
 	}
 }
 
+TEST_CASE("bandlim.refill_interval") {
+	using namespace arataga;
+
+	config_parser_t parser;
+
+	{
+		const auto what = 
+R"(
+bandlim.refill_interval 50ms
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_NOTHROW( cfg = parser.parse( what ) );
+
+		REQUIRE( 50ms == cfg.m_common_acl_params.m_bandlim_refill_interval );
+	}
+
+	{
+		const auto what = 
+R"(
+bandlim.refill_interval 1
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_NOTHROW( cfg = parser.parse( what ) );
+
+		REQUIRE( 1s == cfg.m_common_acl_params.m_bandlim_refill_interval );
+	}
+
+	{
+		const auto what = 
+R"(
+bandlim.refill_interval 0ms
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_THROWS_AS(
+				cfg = parser.parse( what ),
+				arataga::config_parser_t::parser_exception_t );
+	}
+
+	{
+		const auto what = 
+R"(
+bandlim.refill_interval 2s
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_THROWS_AS(
+				cfg = parser.parse( what ),
+				arataga::config_parser_t::parser_exception_t );
+	}
+}
+
 TEST_CASE("denied_ports") {
 	using namespace arataga;
 
@@ -1115,6 +1338,262 @@ nserver 1.1.1.1
 	}
 }
 
+TEST_CASE("acls with relay mode") {
+	using namespace arataga;
+
+	config_parser_t parser;
+
+	{
+		const auto what = 
+R"(
+acl auto,  port=3000, in_ip=127.0.0.1, out_ip=192.168.100.1, relay=splice
+acl socks, port=3002, relay=copy, in_ip=127.0.0.1, out_ip=192.168.100.2
+acl http,  port=3003, in_ip=127.0.0.1, out_ip=192.168.100.3
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_NOTHROW( cfg = parser.parse( what ) );
+
+		config_t::acl_container_t expected{
+			acl_config_t{ acl_protocol_t::autodetect,
+					3000u,
+					asio::ip::make_address_v4( "127.0.0.1" ),
+					asio::ip::make_address( "192.168.100.1" )
+			},
+			acl_config_t{ acl_protocol_t::socks,
+					3002u,
+					asio::ip::make_address_v4( "127.0.0.1" ),
+					asio::ip::make_address( "192.168.100.2" )
+			},
+			acl_config_t{ acl_protocol_t::http,
+					3003u,
+					asio::ip::make_address_v4( "127.0.0.1" ),
+					asio::ip::make_address( "192.168.100.3" )
+			}
+		};
+		expected[ 0 ].m_relay_mode = relay_mode_t::splice;
+		expected[ 1 ].m_relay_mode = relay_mode_t::copy;
+
+		REQUIRE( expected == cfg.m_acls );
+	}
+
+	{
+		const auto what = 
+R"(
+acl auto, port=3000, in_ip=127.0.0.1, out_ip=192.168.100.1, relay=zerocopy
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_THROWS_AS(
+				cfg = parser.parse( what ),
+				arataga::config_parser_t::parser_exception_t );
+	}
+
+	{
+		const auto what = 
+R"(
+acl auto, port=3000, in_ip=127.0.0.1, out_ip=192.168.100.1, relay=copy, relay=splice
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_THROWS_AS(
+				cfg = parser.parse( what ),
+				arataga::config_parser_t::parser_exception_t );
+	}
+}
+
+TEST_CASE("acls with shards") {
+	using namespace arataga;
+
+	config_parser_t parser;
+
+	{
+		const auto what = 
+R"(
+acl auto,  port=3000, in_ip=127.0.0.1, out_ip=192.168.100.1, shards=4
+acl socks, port=3002, shards=1, in_ip=127.0.0.1, out_ip=192.168.100.2
+acl http,  port=3003, in_ip=127.0.0.1, out_ip=192.168.100.3
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_NOTHROW( cfg = parser.parse( what ) );
+
+		config_t::acl_container_t expected{
+			acl_config_t{ acl_protocol_t::autodetect,
+					3000u,
+					asio::ip::make_address_v4( "127.0.0.1" ),
+					asio::ip::make_address( "192.168.100.1" )
+			},
+			acl_config_t{ acl_protocol_t::socks,
+					3002u,
+					asio::ip::make_address_v4( "127.0.0.1" ),
+					asio::ip::make_address( "192.168.100.2" )
+			},
+			acl_config_t{ acl_protocol_t::http,
+					3003u,
+					asio::ip::make_address_v4( "127.0.0.1" ),
+					asio::ip::make_address( "192.168.100.3" )
+			}
+		};
+		expected[ 0 ].m_shards = 4u;
+
+		REQUIRE( expected == cfg.m_acls );
+	}
+
+	{
+		const auto what = 
+R"(
+acl auto, port=3000, in_ip=127.0.0.1, out_ip=192.168.100.1, shards=0
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_THROWS_AS(
+				cfg = parser.parse( what ),
+				arataga::config_parser_t::parser_exception_t );
+	}
+
+	{
+		const auto what = 
+R"(
+acl auto, port=3000, in_ip=127.0.0.1, out_ip=192.168.100.1, shards=2, shards=3
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_THROWS_AS(
+				cfg = parser.parse( what ),
+				arataga::config_parser_t::parser_exception_t );
+	}
+}
+
+TEST_CASE("acls with defer_accept") {
+	using namespace arataga;
+
+	config_parser_t parser;
+
+	{
+		const auto what = 
+R"(
+acl auto,  port=3000, in_ip=127.0.0.1, out_ip=192.168.100.1, defer_accept=3s
+acl socks, port=3002, defer_accept=1min, in_ip=127.0.0.1, out_ip=192.168.100.2
+acl http,  port=3003, in_ip=127.0.0.1, out_ip=192.168.100.3
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_NOTHROW( cfg = parser.parse( what ) );
+
+		config_t::acl_container_t expected{
+			acl_config_t{ acl_protocol_t::autodetect,
+					3000u,
+					asio::ip::make_address_v4( "127.0.0.1" ),
+					asio::ip::make_address( "192.168.100.1" )
+			},
+			acl_config_t{ acl_protocol_t::socks,
+					3002u,
+					asio::ip::make_address_v4( "127.0.0.1" ),
+					asio::ip::make_address( "192.168.100.2" )
+			},
+			acl_config_t{ acl_protocol_t::http,
+					3003u,
+					asio::ip::make_address_v4( "127.0.0.1" ),
+					asio::ip::make_address( "192.168.100.3" )
+			}
+		};
+		expected[ 0 ].m_defer_accept = std::chrono::seconds{ 3 };
+		expected[ 1 ].m_defer_accept = std::chrono::seconds{ 60 };
+
+		REQUIRE( expected == cfg.m_acls );
+	}
+
+	{
+		const auto what = 
+R"(
+acl auto, port=3000, in_ip=127.0.0.1, out_ip=192.168.100.1, defer_accept=1500ms
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_THROWS_AS(
+				cfg = parser.parse( what ),
+				arataga::config_parser_t::parser_exception_t );
+	}
+
+	{
+		const auto what = 
+R"(
+acl auto, port=3000, in_ip=127.0.0.1, out_ip=192.168.100.1, defer_accept=1s, defer_accept=2s
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_THROWS_AS(
+				cfg = parser.parse( what ),
+				arataga::config_parser_t::parser_exception_t );
+	}
+}
+
+TEST_CASE("acls with bandlims") {
+	using namespace arataga;
+
+	config_parser_t parser;
+
+	{
+		const auto what = 
+R"(
+acl auto,  port=3000, in_ip=127.0.0.1, out_ip=192.168.100.1, bandlim.in=10mib
+acl socks, port=3002, bandlim.out=800kbps, in_ip=127.0.0.1, out_ip=192.168.100.2
+acl http,  port=3003, in_ip=127.0.0.1, out_ip=192.168.100.3, bandlim.out=1kib, bandlim.in=2kib
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_NOTHROW( cfg = parser.parse( what ) );
+
+		config_t::acl_container_t expected{
+			acl_config_t{ acl_protocol_t::autodetect,
+					3000u,
+					asio::ip::make_address_v4( "127.0.0.1" ),
+					asio::ip::make_address( "192.168.100.1" )
+			},
+			acl_config_t{ acl_protocol_t::socks,
+					3002u,
+					asio::ip::make_address_v4( "127.0.0.1" ),
+					asio::ip::make_address( "192.168.100.2" )
+			},
+			acl_config_t{ acl_protocol_t::http,
+					3003u,
+					asio::ip::make_address_v4( "127.0.0.1" ),
+					asio::ip::make_address( "192.168.100.3" )
+			}
+		};
+		expected[ 0 ].m_bandlim.m_in = 10u*1024u*1024u;
+		expected[ 1 ].m_bandlim.m_out = 100000u;
+		expected[ 2 ].m_bandlim.m_in = 2048u;
+		expected[ 2 ].m_bandlim.m_out = 1024u;
+
+		REQUIRE( expected == cfg.m_acls );
+	}
+
+	{
+		const auto what = 
+R"(
+acl auto, port=3000, in_ip=127.0.0.1, out_ip=192.168.100.1, bandlim.in=1kib, bandlim.in=2kib
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_THROWS_AS(
+				cfg = parser.parse( what ),
+				arataga::config_parser_t::parser_exception_t );
+	}
+}
+
 TEST_CASE("http.limits") {
 	using namespace arataga;
 
@@ -1186,3 +1665,48 @@ nserver 1.1.1.1
 	}
 }
 
+TEST_CASE("http.upstream.pool_size") {
+	using namespace arataga;
+
+	config_parser_t parser;
+
+	{
+		const auto what = 
+R"(
+http.upstream.pool_size 128
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_NOTHROW( cfg = parser.parse( what ) );
+
+		REQUIRE( 128u == cfg.m_common_acl_params.m_http_upstream_pool_size );
+	}
+
+	{
+		const auto what = 
+R"(
+http.upstream.pool_size 0
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_NOTHROW( cfg = parser.parse( what ) );
+
+		REQUIRE( 0u == cfg.m_common_acl_params.m_http_upstream_pool_size );
+	}
+
+	{
+		const auto what = 
+R"(
+http.upstream.pool_size off
+nserver 1.1.1.1
+)"sv;
+
+		config_t cfg;
+		REQUIRE_THROWS_AS(
+				cfg = parser.parse( what ),
+				arataga::config_parser_t::parser_exception_t );
+	}
+}
+
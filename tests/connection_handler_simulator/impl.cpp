@@ -57,6 +57,18 @@ public:
 		return m_values.m_io_chunk_count;
 	}
 
+	::arataga::relay_mode_t
+	relay_mode() const noexcept override
+	{
+		return m_values.m_relay_mode;
+	}
+
+	std::chrono::milliseconds
+	bandlim_refill_interval() const noexcept override
+	{
+		return m_values.m_bandlim_refill_interval;
+	}
+
 	std::chrono::milliseconds
 	protocol_detection_timeout() const noexcept override
 	{
@@ -111,6 +123,18 @@ public:
 		return m_values.m_http_negative_response_timeout;
 	}
 
+	std::size_t
+	http_upstream_pool_size() const noexcept override
+	{
+		return m_values.m_http_upstream_pool_size;
+	}
+
+	std::chrono::milliseconds
+	http_upstream_idle_timeout() const noexcept override
+	{
+		return m_values.m_http_upstream_idle_timeout;
+	}
+
 	const ::arataga::http_message_value_limits_t &
 	http_message_limits() const noexcept override
 	{
@@ -171,6 +195,17 @@ public:
 		,	m_entry_point{ entry_point }
 		,	m_actual_config{ std::move(config_values) }
 		,	m_logger_holder{ make_logger() }
+		,	m_io_chunk_pool{
+				::arataga::stats::io_chunks::make_std_io_chunk_stats_reference_manager(),
+				aclh::io_chunk_pool_t::default_max_free_chunks
+			}
+		,	m_pacing_wheel{
+				std::make_shared< aclh::pacing_wheel_t >( io_ctx )
+			}
+		,	m_timeout_wheel{
+				std::make_shared< aclh::timeout_wheel_t >( io_ctx )
+			}
+		,	m_upstream_connection_pool{ m_timeout_wheel }
 	{}
 
 	struct is_ready_ask_t {};
@@ -211,7 +246,6 @@ public:
 	so_define_agent() override
 	{
 		so_subscribe_self()
-			.event( &a_handler_t::on_timer )
 			.event( []( typename is_ready_dialog_t::request_mhood_t cmd ) {
 					cmd->make_reply();
 				} )
@@ -237,10 +271,6 @@ public:
 				true /* SO_REUSEADDR */ );
 		m_acceptor->non_blocking( true );
 
-		// A timer for calling on_timer for connection-handlers.
-		// Run it at a faster pace because execution times in tests won't be big.
-		m_timer = so_5::send_periodic< timer_t >( *this, 100ms, 100ms );
-
 		// Start acception new connections.
 		accept_next();
 	}
@@ -381,9 +411,48 @@ public:
 		// Nothing to do.
 	}
 
-private:
-	struct timer_t final : public so_5::signal_t {};
+	void
+	stats_record_setup_stage(
+		aclh::setup_stage_t /*stage*/,
+		std::chrono::steady_clock::time_point /*started_at*/ ) noexcept override
+	{
+		// Nothing to do.
+	}
 
+	aclh::io_chunk_pool_t &
+	io_chunk_pool() noexcept override
+	{
+		return m_io_chunk_pool;
+	}
+
+	aclh::pacing_wheel_t &
+	pacing_wheel() noexcept override
+	{
+		return *m_pacing_wheel;
+	}
+
+	aclh::timeout_wheel_t &
+	timeout_wheel() noexcept override
+	{
+		return *m_timeout_wheel;
+	}
+
+	aclh::upstream_connection_pool_t &
+	upstream_connection_pool() noexcept override
+	{
+		return m_upstream_connection_pool;
+	}
+
+	bool
+	can_reuse_auth_result(
+		std::uint64_t /*user_list_generation*/,
+		std::uint16_t /*target_port*/ ) const noexcept override
+	{
+		// There is no user-list and no denied ports.
+		return true;
+	}
+
+private:
 	class connection_info_t
 	{
 		aclh::connection_handler_shptr_t m_handler;
@@ -450,9 +519,14 @@ private:
 
 	::arataga::logging::logger_holder_t m_logger_holder;
 
-	std::unique_ptr< asio::ip::tcp::acceptor > m_acceptor;
+	// NOTE: it has to be declared before m_connections because
+	// connection-handlers can hold chunks from that pool.
+	aclh::io_chunk_pool_t m_io_chunk_pool;
+	std::shared_ptr< aclh::pacing_wheel_t > m_pacing_wheel;
+	std::shared_ptr< aclh::timeout_wheel_t > m_timeout_wheel;
+	aclh::upstream_connection_pool_t m_upstream_connection_pool;
 
-	so_5::timer_id_t m_timer;
+	std::unique_ptr< asio::ip::tcp::acceptor > m_acceptor;
 
 	connection_id_t m_connection_id_counter{};
 
@@ -460,19 +534,6 @@ private:
 
 	std::vector< std::string > m_trace;
 
-	void
-	on_timer( mhood_t< timer_t > )
-	{
-		for( auto it = m_connections.begin(); it != m_connections.end(); )
-		{
-			// Hold the pointer until on_timer completes.
-			auto handler = it->second.handler();
-			++it; // Go to the next item while 'it' is valid.
-
-			handler->on_timer();
-		}
-	}
-
 	[[nodiscard]]
 	connection_info_t &
 	connection_info_that_must_be_present(
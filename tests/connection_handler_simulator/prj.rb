@@ -10,6 +10,7 @@ MxxRu::Cpp::lib_target {
 	required_prj 'so_5/prj_s.rb'
 	required_prj 'arataga/logging/logging.rb'
 	required_prj 'arataga/acl_handler/connection_handlers.rb'
+	required_prj 'arataga/stats/prj.rb'
 
 	cpp_source 'impl.cpp'
 }
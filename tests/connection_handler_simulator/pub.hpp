@@ -20,6 +20,8 @@ struct handler_config_values_t
 	asio::ip::address m_out_addr{ asio::ip::make_address( "127.0.0.1" ) };
 	std::size_t m_io_chunk_size{ 1024u };
 	std::size_t m_io_chunk_count{ 3u };
+	::arataga::relay_mode_t m_relay_mode{ ::arataga::relay_mode_t::copy };
+	std::chrono::milliseconds m_bandlim_refill_interval{ 20 };
 	std::chrono::milliseconds m_protocol_detection_timeout{ 500 };
 	std::chrono::milliseconds m_socks_handshake_phase_timeout{ 1'000 };
 	std::chrono::milliseconds m_dns_resolving_timeout{ 500 };
@@ -29,6 +31,8 @@ struct handler_config_values_t
 	std::chrono::milliseconds m_idle_connection_timeout{ 1'500 };
 	std::chrono::milliseconds m_http_headers_complete_timeout{ 1'000 };
 	std::chrono::milliseconds m_http_negative_response_timeout{ 1'000 };
+	std::size_t m_http_upstream_pool_size{ 0u };
+	std::chrono::milliseconds m_http_upstream_idle_timeout{ 1'000 };
 
 	::arataga::http_message_value_limits_t m_http_message_limits{};
 };
@@ -0,0 +1,218 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <arataga/dns_resolver/dns_cache.hpp>
+
+using namespace arataga;
+using namespace arataga::dns_resolver;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+[[nodiscard]]
+asio::ip::address
+addr( const char * v )
+{
+	return asio::ip::make_address( v );
+}
+
+[[nodiscard]]
+std::optional< asio::ip::address >
+address_from( const std::optional< cached_answer_t > & answer )
+{
+	if( answer )
+		if( const auto * a = std::get_if< asio::ip::address >( &*answer ) )
+			return *a;
+
+	return std::nullopt;
+}
+
+} /* namespace anonymous */
+
+TEST_CASE( "empty cache" )
+{
+	dns_cache_t cache;
+	const auto now = std::chrono::steady_clock::now();
+
+	REQUIRE( !cache.resolve( "localhost", ip_version_t::ip_v4, now ) );
+	REQUIRE( 0u == cache.size() );
+}
+
+TEST_CASE( "addresses are rotated" )
+{
+	dns_cache_t cache;
+	const auto now = std::chrono::steady_clock::now();
+
+	cache.add_records( "example.com", ip_version_t::ip_v4,
+			{ addr( "10.0.0.1" ), addr( "10.0.0.2" ), addr( "10.0.0.3" ) },
+			60s, now );
+
+	REQUIRE( addr( "10.0.0.1" ) == address_from(
+			cache.resolve( "example.com", ip_version_t::ip_v4, now ) ) );
+	REQUIRE( addr( "10.0.0.2" ) == address_from(
+			cache.resolve( "example.com", ip_version_t::ip_v4, now ) ) );
+	REQUIRE( addr( "10.0.0.3" ) == address_from(
+			cache.resolve( "example.com", ip_version_t::ip_v4, now ) ) );
+	REQUIRE( addr( "10.0.0.1" ) == address_from(
+			cache.resolve( "example.com", ip_version_t::ip_v4, now ) ) );
+}
+
+TEST_CASE( "items are separated by IP version" )
+{
+	dns_cache_t cache;
+	const auto now = std::chrono::steady_clock::now();
+
+	cache.add_records( "example.com", ip_version_t::ip_v4,
+			{ addr( "10.0.0.1" ) }, 60s, now );
+
+	REQUIRE( !cache.resolve( "example.com", ip_version_t::ip_v6, now ) );
+
+	cache.add_records( "example.com", ip_version_t::ip_v6,
+			{ addr( "::1" ) }, 60s, now );
+
+	REQUIRE( addr( "10.0.0.1" ) == address_from(
+			cache.resolve( "example.com", ip_version_t::ip_v4, now ) ) );
+	REQUIRE( addr( "::1" ) == address_from(
+			cache.resolve( "example.com", ip_version_t::ip_v6, now ) ) );
+	REQUIRE( 2u == cache.size() );
+}
+
+TEST_CASE( "TTL is respected and clamped" )
+{
+	dns_cache_t cache;
+	cache.set_ttl_limits( 10s, 100s );
+
+	const auto now = std::chrono::steady_clock::now();
+
+	cache.add_records( "short.com", ip_version_t::ip_v4,
+			{ addr( "10.0.0.1" ) }, 1s, now );
+	cache.add_records( "normal.com", ip_version_t::ip_v4,
+			{ addr( "10.0.0.2" ) }, 50s, now );
+	cache.add_records( "long.com", ip_version_t::ip_v4,
+			{ addr( "10.0.0.3" ) }, 10000s, now );
+
+	// TTL for short.com is increased to 10s.
+	REQUIRE( cache.resolve( "short.com", ip_version_t::ip_v4, now + 9s ) );
+	REQUIRE( !cache.resolve( "short.com", ip_version_t::ip_v4, now + 10s ) );
+
+	REQUIRE( cache.resolve( "normal.com", ip_version_t::ip_v4, now + 49s ) );
+	REQUIRE( !cache.resolve( "normal.com", ip_version_t::ip_v4, now + 50s ) );
+
+	// TTL for long.com is decreased to 100s.
+	REQUIRE( cache.resolve( "long.com", ip_version_t::ip_v4, now + 99s ) );
+	REQUIRE( !cache.resolve( "long.com", ip_version_t::ip_v4, now + 100s ) );
+}
+
+TEST_CASE( "zero TTL" )
+{
+	dns_cache_t cache;
+	cache.set_ttl_limits( 0s, 100s );
+
+	const auto now = std::chrono::steady_clock::now();
+
+	cache.add_records( "example.com", ip_version_t::ip_v4,
+			{ addr( "10.0.0.1" ) }, 0s, now );
+
+	REQUIRE( 0u == cache.size() );
+}
+
+TEST_CASE( "new records replace old ones" )
+{
+	dns_cache_t cache;
+	const auto now = std::chrono::steady_clock::now();
+
+	cache.add_records( "example.com", ip_version_t::ip_v4,
+			{ addr( "10.0.0.1" ) }, 60s, now );
+	cache.add_records( "example.com", ip_version_t::ip_v4,
+			{ addr( "10.0.0.2" ) }, 60s, now );
+
+	REQUIRE( 1u == cache.size() );
+	REQUIRE( addr( "10.0.0.2" ) == address_from(
+			cache.resolve( "example.com", ip_version_t::ip_v4, now ) ) );
+}
+
+TEST_CASE( "remove outdated records" )
+{
+	dns_cache_t cache;
+	cache.set_ttl_limits( 1s, 1000s );
+
+	const auto now = std::chrono::steady_clock::now();
+
+	for( int i = 0; i != 100; ++i )
+		cache.add_records( "host" + std::to_string(i) + ".com",
+				ip_version_t::ip_v4,
+				{ addr( "10.0.0.1" ) },
+				std::chrono::seconds{ 1 + i % 2 },
+				now );
+
+	REQUIRE( 100u == cache.size() );
+
+	REQUIRE( 50u == cache.remove_outdated_records( now + 1s, 30s ) );
+	REQUIRE( 50u == cache.size() );
+
+	// The next cleanup is ignored because of the cleanup period.
+	REQUIRE( 0u == cache.remove_outdated_records( now + 2s, 30s ) );
+	REQUIRE( 50u == cache.size() );
+
+	REQUIRE( 50u == cache.remove_outdated_records( now + 31s, 30s ) );
+	REQUIRE( 0u == cache.size() );
+}
+
+TEST_CASE( "clear" )
+{
+	dns_cache_t cache;
+	const auto now = std::chrono::steady_clock::now();
+
+	cache.add_records( "example.com", ip_version_t::ip_v4,
+			{ addr( "10.0.0.1" ) }, 60s, now );
+	cache.add_records( "example.com", ip_version_t::ip_v6,
+			{ addr( "::1" ) }, 60s, now );
+
+	cache.clear();
+
+	REQUIRE( 0u == cache.size() );
+	REQUIRE( !cache.resolve( "example.com", ip_version_t::ip_v4, now ) );
+}
+
+TEST_CASE( "negative answers" )
+{
+	dns_cache_t cache;
+	cache.set_negative_ttl( 10s );
+
+	const auto now = std::chrono::steady_clock::now();
+
+	cache.add_negative_answer( "unknown.com", ip_version_t::ip_v4,
+			"name error", now );
+
+	const auto answer = cache.resolve(
+			"unknown.com", ip_version_t::ip_v4, now + 9s );
+	REQUIRE( answer );
+	const auto * negative = std::get_if< negative_answer_t >( &*answer );
+	REQUIRE( negative );
+	REQUIRE( "name error" == negative->m_description );
+
+	REQUIRE( !cache.resolve( "unknown.com", ip_version_t::ip_v6, now ) );
+	REQUIRE( !cache.resolve( "unknown.com", ip_version_t::ip_v4, now + 10s ) );
+
+	// A positive answer replaces a negative one.
+	cache.add_negative_answer( "unknown.com", ip_version_t::ip_v4,
+			"name error", now );
+	cache.add_records( "unknown.com", ip_version_t::ip_v4,
+			{ addr( "10.0.0.1" ) }, 60s, now );
+	REQUIRE( addr( "10.0.0.1" ) == address_from(
+			cache.resolve( "unknown.com", ip_version_t::ip_v4, now ) ) );
+}
+
+TEST_CASE( "negative answers aren't cached with zero TTL" )
+{
+	dns_cache_t cache;
+	cache.set_negative_ttl( 0s );
+
+	const auto now = std::chrono::steady_clock::now();
+
+	cache.add_negative_answer( "unknown.com", ip_version_t::ip_v4,
+			"name error", now );
+
+	REQUIRE( 0u == cache.size() );
+}
@@ -0,0 +1,14 @@
+require 'rubygems'
+
+gem 'Mxx_ru', '>= 1.3.0'
+
+require 'mxx_ru/cpp'
+
+MxxRu::Cpp::exe_target {
+
+  target 'test-bin/ut_dns_cache'
+
+  required_prj 'arataga/dns_resolver/dns_cache.rb'
+
+  cpp_source 'main.cpp'
+}
@@ -7,6 +7,7 @@ MxxRu::Cpp::composite_target {
 	path = 'tests/http'
 
 	required_prj "#{path}/http_fields/prj.ut.rb"
+	required_prj "#{path}/header_table/prj.ut.rb"
 	required_prj "#{path}/auth_params/prj.ut.rb"
 	required_prj "#{path}/chunked_encoding/prj.ut.rb"
 	required_prj "#{path}/illegal_responses/prj.ut.rb"
@@ -0,0 +1,220 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <arataga/acl_handler/handlers/http/header_table.hpp>
+
+#include <array>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+using namespace std::string_view_literals;
+
+using arataga::acl_handler::handlers::http::http_header_table_t;
+
+namespace
+{
+
+//! Simulation of the incoming buffer.
+struct incoming_buffer_t
+{
+	std::array< std::byte, 512 > m_data{};
+
+	[[nodiscard]]
+	const char *
+	store( std::string_view content )
+	{
+		std::memcpy( m_data.data(), content.data(), content.size() );
+		return reinterpret_cast<const char *>(m_data.data());
+	}
+
+	void
+	attach( http_header_table_t & table ) const
+	{
+		table.attach_to_buffer( m_data.data(), m_data.size() );
+	}
+};
+
+//! Pieces of the outgoing header.
+struct outgoing_data_t
+{
+	std::string m_data;
+	std::size_t m_pieces{ 0u };
+};
+
+[[nodiscard]]
+outgoing_data_t
+make_outgoing_data( const http_header_table_t & table )
+{
+	outgoing_data_t result;
+	table.for_each_outgoing_piece( [&result]( std::string_view piece ) {
+			result.m_data += piece;
+			++result.m_pieces;
+		} );
+
+	return result;
+}
+
+// Adds a field that is located at [name_pos, name_pos+name_len) and
+// [value_pos, value_pos+value_len) in the buffer.
+void
+add_field(
+	http_header_table_t & table,
+	const char * buffer,
+	std::size_t name_pos, std::size_t name_len,
+	std::size_t value_pos, std::size_t value_len )
+{
+	table.append_name( std::string_view{ buffer + name_pos, name_len } );
+	table.append_value( std::string_view{ buffer + value_pos, value_len } );
+	table.complete_field();
+}
+
+const auto fields =
+	"Host: localhost\r\n"
+	"Proxy-Authorization: Basic dXNlcjoxMjM0NQ==\r\n"
+	"Accept: */*\r\n"
+	"\r\n"sv;
+
+void
+fill_table(
+	http_header_table_t & table,
+	const char * buffer )
+{
+	add_field( table, buffer, 0, 4, 6, 9 );
+	add_field( table, buffer, 17, 19, 38, 22 );
+	add_field( table, buffer, 62, 6, 70, 3 );
+}
+
+} /* namespace anonymous */
+
+TEST_CASE( "fields in one buffer" )
+{
+	incoming_buffer_t buffer;
+	http_header_table_t table;
+	buffer.attach( table );
+
+	const char * data = buffer.store( fields );
+	fill_table( table, data );
+
+	REQUIRE( 3u == table.fields_count() );
+	REQUIRE( "localhost"sv == *table.opt_value_of( "host" ) );
+	REQUIRE( "*/*"sv == *table.opt_value_of( "ACCEPT" ) );
+	REQUIRE( !table.opt_value_of( "Connection" ) );
+
+	// All fields go as one piece of the original data.
+	const auto out = make_outgoing_data( table );
+	REQUIRE( fields.substr( 0u, fields.size() - 2u ) == out.m_data );
+	REQUIRE( 1u == out.m_pieces );
+}
+
+TEST_CASE( "removed fields" )
+{
+	incoming_buffer_t buffer;
+	http_header_table_t table;
+	buffer.attach( table );
+
+	const char * data = buffer.store( fields );
+	fill_table( table, data );
+
+	table.remove_all_of( "proxy-authorization" );
+
+	REQUIRE( 2u == table.fields_count() );
+	REQUIRE( !table.opt_value_of( "Proxy-Authorization" ) );
+
+	const auto out = make_outgoing_data( table );
+	REQUIRE( "Host: localhost\r\nAccept: */*\r\n" == out.m_data );
+	REQUIRE( 2u == out.m_pieces );
+
+	table.remove_all_of( "Host" );
+	table.remove_all_of( "Accept" );
+
+	REQUIRE( 0u == table.fields_count() );
+	REQUIRE( make_outgoing_data( table ).m_data.empty() );
+}
+
+TEST_CASE( "for_each_value_of" )
+{
+	incoming_buffer_t buffer;
+	http_header_table_t table;
+	buffer.attach( table );
+
+	const char * data = buffer.store(
+			"Connection: close\r\nX-A: 1\r\nconnection: te\r\n\r\n" );
+	add_field( table, data, 0, 10, 12, 5 );
+	add_field( table, data, 19, 3, 24, 1 );
+	add_field( table, data, 27, 10, 39, 2 );
+
+	std::string values;
+	table.for_each_value_of( "CONNECTION", [&]( std::string_view v ) {
+			values += v;
+			values += ';';
+			return http_header_table_t::continue_enumeration();
+		} );
+	REQUIRE( "close;te;" == values );
+
+	values.clear();
+	table.for_each_value_of( "Connection", [&]( std::string_view v ) {
+			values += v;
+			return http_header_table_t::stop_enumeration();
+		} );
+	REQUIRE( "close" == values );
+
+	std::string names;
+	table.for_each_field( [&]( std::string_view n, std::string_view ) {
+			names += n;
+			names += ';';
+		} );
+	REQUIRE( "Connection;X-A;connection;" == names );
+}
+
+TEST_CASE( "field spans several reads" )
+{
+	incoming_buffer_t buffer;
+	http_header_table_t table;
+	buffer.attach( table );
+
+	// The first read.
+	const char * data = buffer.store( "Host: localhost\r\nUser-Ag" );
+	add_field( table, data, 0, 4, 6, 9 );
+	table.append_name( std::string_view{ data + 17, 7 } );
+	REQUIRE( 7u == table.current_name_size() );
+
+	// The buffer is reused for the next read.
+	table.spill_to_arena();
+	data = buffer.store( "ent: curl/7.x\r\nAccept: */*\r\n\r\n" );
+
+	table.append_name( std::string_view{ data, 3 } );
+	REQUIRE( 10u == table.current_name_size() );
+	table.append_value( std::string_view{ data + 5, 8 } );
+	REQUIRE( 8u == table.current_value_size() );
+	table.complete_field();
+	add_field( table, data, 15, 6, 23, 3 );
+
+	REQUIRE( "localhost"sv == *table.opt_value_of( "Host" ) );
+	REQUIRE( "curl/7.x"sv == *table.opt_value_of( "User-Agent" ) );
+	REQUIRE( "*/*"sv == *table.opt_value_of( "Accept" ) );
+
+	const auto out = make_outgoing_data( table );
+	REQUIRE( "Host: localhost\r\nUser-Agent: curl/7.x\r\nAccept: */*\r\n"
+			== out.m_data );
+}
+
+TEST_CASE( "value in several parts" )
+{
+	incoming_buffer_t buffer;
+	http_header_table_t table;
+	buffer.attach( table );
+
+	// A value that is continued on the next line (obs-fold).
+	const char * data = buffer.store( "X-A: a\r\n b\r\nX-B: c\r\n\r\n" );
+	table.append_name( std::string_view{ data, 3 } );
+	table.append_value( std::string_view{ data + 5, 1 } );
+	table.append_value( std::string_view{ data + 9, 1 } );
+	table.complete_field();
+	add_field( table, data, 12, 3, 17, 1 );
+
+	REQUIRE( "ab"sv == *table.opt_value_of( "X-A" ) );
+
+	const auto out = make_outgoing_data( table );
+	REQUIRE( "X-A: ab\r\nX-B: c\r\n" == out.m_data );
+}
@@ -0,0 +1,8 @@
+require 'mxx_ru/cpp'
+
+MxxRu::Cpp::exe_target {
+
+	target 'test-bin/ut_http_header_table'
+
+	cpp_source 'main.cpp'
+}
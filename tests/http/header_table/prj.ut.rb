@@ -0,0 +1,7 @@
+require 'mxx_ru/binary_unittest'
+
+path = 'tests/http/header_table'
+
+MxxRu::setup_target(
+	MxxRu::BinaryUnittestTarget.new( "#{path}/prj.ut.rb", "#{path}/prj.rb" )
+)
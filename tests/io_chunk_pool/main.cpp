@@ -0,0 +1,101 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN 
+#include <doctest/doctest.h>
+
+#include <arataga/acl_handler/io_chunk_pool.hpp>
+
+using namespace arataga::acl_handler;
+using namespace arataga::stats::io_chunks;
+
+namespace {
+
+[[nodiscard]]
+std::uint64_t
+value_of( const std::atomic< std::uint64_t > & v )
+{
+	return v.load( std::memory_order_acquire );
+}
+
+} /* namespace anonymous */
+
+TEST_CASE( "empty chunk" )
+{
+	io_chunk_t chunk;
+
+	REQUIRE( chunk.empty() );
+	REQUIRE( nullptr == chunk.data() );
+	REQUIRE( 0u == chunk.capacity() );
+
+	chunk.reset();
+	REQUIRE( chunk.empty() );
+}
+
+TEST_CASE( "acquire and reuse" )
+{
+	io_chunk_pool_t pool{ make_std_io_chunk_stats_reference_manager(), 4u };
+	const auto & stats = pool.stats();
+
+	auto c1 = pool.acquire( 1024u );
+	REQUIRE( !c1.empty() );
+	REQUIRE( 1024u == c1.capacity() );
+	REQUIRE( 1u == value_of( stats.m_chunks_in_use ) );
+	REQUIRE( 1024u == value_of( stats.m_bytes_in_use ) );
+	REQUIRE( 1u == value_of( stats.m_chunks_allocated ) );
+
+	const std::byte * raw = c1.data();
+	c1.reset();
+	REQUIRE( c1.empty() );
+	REQUIRE( 0u == value_of( stats.m_chunks_in_use ) );
+	REQUIRE( 1u == value_of( stats.m_chunks_cached ) );
+	REQUIRE( 1024u == value_of( stats.m_bytes_cached ) );
+
+	auto c2 = pool.acquire( 1024u );
+	REQUIRE( raw == c2.data() );
+	REQUIRE( 1u == value_of( stats.m_chunks_reused ) );
+	REQUIRE( 1u == value_of( stats.m_chunks_allocated ) );
+	REQUIRE( 0u == value_of( stats.m_chunks_cached ) );
+
+	// Move of a chunk doesn't return it to the pool.
+	io_chunk_t c3{ std::move(c2) };
+	REQUIRE( c2.empty() );
+	REQUIRE( raw == c3.data() );
+	REQUIRE( 1u == value_of( stats.m_chunks_in_use ) );
+}
+
+TEST_CASE( "max free chunks" )
+{
+	io_chunk_pool_t pool{ make_std_io_chunk_stats_reference_manager(), 2u };
+	const auto & stats = pool.stats();
+
+	{
+		auto c1 = pool.acquire( 512u );
+		auto c2 = pool.acquire( 512u );
+		auto c3 = pool.acquire( 512u );
+		REQUIRE( 3u == value_of( stats.m_chunks_in_use ) );
+	}
+
+	REQUIRE( 0u == value_of( stats.m_chunks_in_use ) );
+	REQUIRE( 2u == value_of( stats.m_chunks_cached ) );
+	REQUIRE( 1024u == value_of( stats.m_bytes_cached ) );
+}
+
+TEST_CASE( "change of chunk size" )
+{
+	io_chunk_pool_t pool{ make_std_io_chunk_stats_reference_manager(), 4u };
+	const auto & stats = pool.stats();
+
+	auto old_chunk = pool.acquire( 512u );
+	pool.acquire( 512u ).reset();
+	REQUIRE( 1u == value_of( stats.m_chunks_cached ) );
+
+	auto new_chunk = pool.acquire( 2048u );
+	REQUIRE( 2048u == new_chunk.capacity() );
+	REQUIRE( 0u == value_of( stats.m_chunks_cached ) );
+	REQUIRE( 3u == value_of( stats.m_chunks_allocated ) );
+
+	// A chunk of the outdated size isn't kept in the pool.
+	old_chunk.reset();
+	REQUIRE( 0u == value_of( stats.m_chunks_cached ) );
+	REQUIRE( 1u == value_of( stats.m_chunks_in_use ) );
+	REQUIRE( 2048u == value_of( stats.m_bytes_in_use ) );
+}
+
@@ -0,0 +1,140 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <arataga/stats/latency_histogram.hpp>
+
+#include <thread>
+#include <vector>
+
+using namespace arataga::stats;
+using namespace std::chrono_literals;
+
+TEST_CASE( "bucket indexes" )
+{
+	namespace lb = latency_buckets;
+
+	// Small values have their own buckets.
+	for( std::uint64_t v = 0u; v != lb::sub_buckets; ++v )
+	{
+		REQUIRE( v == lb::index_of( v ) );
+		REQUIRE( v == lb::highest_value_of( lb::index_of( v ) ) );
+	}
+
+	// Every value is not greater than the max value of its bucket
+	// and is greater than the max value of the previous bucket.
+	for( std::uint64_t v = 1u; v <= lb::max_value; v = v * 3u / 2u + 1u )
+	{
+		const auto index = lb::index_of( v );
+		REQUIRE( index < lb::count );
+		REQUIRE( v <= lb::highest_value_of( index ) );
+		REQUIRE( v > lb::highest_value_of( index - 1u ) );
+	}
+
+	REQUIRE( lb::count - 1u == lb::index_of( lb::max_value ) );
+	REQUIRE( lb::count - 1u == lb::index_of( lb::max_value + 1u ) );
+	REQUIRE( lb::max_value == lb::highest_value_of( lb::count - 1u ) );
+}
+
+TEST_CASE( "empty snapshot" )
+{
+	latency_histogram_t histogram;
+
+	latency_snapshot_t snapshot;
+	snapshot.merge( histogram );
+
+	REQUIRE( 0u == snapshot.total() );
+	REQUIRE( 0u == snapshot.percentile( 0.5 ) );
+	REQUIRE( 0u == snapshot.percentile( 0.99 ) );
+}
+
+TEST_CASE( "percentiles" )
+{
+	latency_histogram_t histogram;
+
+	// 1000 values from 1ms to 1s.
+	for( std::uint64_t v = 1u; v <= 1000u; ++v )
+		histogram.record( std::chrono::milliseconds{ v } );
+
+	latency_snapshot_t snapshot;
+	snapshot.merge( histogram );
+
+	REQUIRE( 1000u == snapshot.total() );
+
+	// The error should be no more than 12.5%.
+	const auto check = [&]( double quantile, std::uint64_t expected ) {
+		const auto actual = snapshot.percentile( quantile );
+		REQUIRE( actual >= expected );
+		REQUIRE( actual <= expected + expected / 8u );
+	};
+
+	check( 0.5, 500000u );
+	check( 0.9, 900000u );
+	check( 0.99, 990000u );
+	check( 0.999, 999000u );
+	check( 1.0, 1000000u );
+}
+
+TEST_CASE( "negative and too big values" )
+{
+	latency_histogram_t histogram;
+
+	histogram.record( -5ms );
+	histogram.record( 10min );
+
+	latency_snapshot_t snapshot;
+	snapshot.merge( histogram );
+
+	REQUIRE( 2u == snapshot.total() );
+	REQUIRE( 600000000u == snapshot.sum() );
+	REQUIRE( 0u == snapshot.percentile( 0.5 ) );
+	REQUIRE( latency_buckets::max_value == snapshot.percentile( 1.0 ) );
+}
+
+TEST_CASE( "merge of snapshots" )
+{
+	latency_histogram_t fast;
+	latency_histogram_t slow;
+
+	for( int i = 0; i != 90; ++i )
+		fast.record_microseconds( 100u );
+	for( int i = 0; i != 10; ++i )
+		slow.record_microseconds( 100000u );
+
+	latency_snapshot_t first;
+	first.merge( fast );
+
+	latency_snapshot_t second;
+	second.merge( slow );
+
+	latency_snapshot_t all;
+	all.merge( first );
+	all.merge( second );
+
+	REQUIRE( 100u == all.total() );
+	REQUIRE( 90u * 100u + 10u * 100000u == all.sum() );
+	REQUIRE( all.percentile( 0.9 ) < 128u );
+	REQUIRE( all.percentile( 0.91 ) >= 100000u );
+}
+
+TEST_CASE( "concurrent updates" )
+{
+	latency_histogram_t histogram;
+
+	constexpr std::size_t threads_count = 4u;
+	constexpr std::uint64_t values_per_thread = 10000u;
+
+	std::vector< std::thread > threads;
+	for( std::size_t t = 0u; t != threads_count; ++t )
+		threads.emplace_back( [&histogram, t] {
+				for( std::uint64_t v = 0u; v != values_per_thread; ++v )
+					histogram.record_microseconds( v * (t + 1u) );
+			} );
+
+	for( auto & t : threads )
+		t.join();
+
+	latency_snapshot_t snapshot;
+	snapshot.merge( histogram );
+
+	REQUIRE( threads_count * values_per_thread == snapshot.total() );
+}
@@ -0,0 +1,13 @@
+require 'rubygems'
+
+gem 'Mxx_ru', '>= 1.3.0'
+
+require 'mxx_ru/cpp'
+
+MxxRu::Cpp::exe_target {
+
+  target 'test-bin/ut_latency_histogram'
+
+  cpp_source 'main.cpp'
+}
+
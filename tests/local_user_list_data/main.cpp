@@ -2,6 +2,7 @@
 #include <doctest/doctest.h>
 
 #include <arataga/user_list_auth_data.hpp>
+#include <arataga/user_list_auth_index.hpp>
 
 [[nodiscard]]
 auto
@@ -244,3 +245,314 @@ TEST_CASE("normal-config-1") {
 	}
 }
 
+TEST_CASE("auth_data_index") {
+	using namespace arataga::user_list_auth;
+
+	auth_data_t cnt;
+	REQUIRE_NOTHROW(
+			cnt = load_auth_data(
+				"tests/local_user_list_data/cfgs/normal-config-1"));
+
+	const auth_data_index_t index{ cnt };
+
+	for( const auto & [key, user] : cnt.m_by_ip )
+	{
+		const auto * r = index.find_by_ip(
+				key.m_proxy_in_addr, key.m_proxy_port, key.m_user_ip );
+		REQUIRE( r );
+		REQUIRE( user == *r );
+	}
+
+	for( const auto & [key, user] : cnt.m_by_login )
+	{
+		const auto * r = index.find_by_login(
+				key.m_proxy_in_addr, key.m_proxy_port,
+				key.m_username, key.m_password );
+		REQUIRE( r );
+		REQUIRE( user == *r );
+	}
+
+	for( const auto & [key, limits] : cnt.m_site_limits )
+	{
+		const auto * r = index.find_site_limits( key.m_site_limits_id );
+		REQUIRE( r );
+		REQUIRE( limits == *r );
+	}
+
+	REQUIRE( !index.find_by_ip(
+			ip_from_int(760812377u), 3006u, ip_from_int(908385451u) ) );
+	REQUIRE( !index.find_by_ip(
+			ip_from_int(760812378u), 3002u, ip_from_int(908385451u) ) );
+
+	REQUIRE( !index.find_by_login(
+			ip_from_int(760812377u), 3002u, "xXXXXX", "jGGGGGGGG" ) );
+	// The boundary between username and password matters.
+	REQUIRE( !index.find_by_login(
+			ip_from_int(760812377u), 3002u, "xXXXXXj", "GGGGGGGGG" ) );
+	REQUIRE( !index.find_by_login(
+			ip_from_int(760812377u), 3006u, "xXXXXX", "jGGGGGGGGG" ) );
+
+	REQUIRE( !index.find_site_limits( 100500u ) );
+}
+
+TEST_CASE("empty auth_data_index") {
+	using namespace arataga::user_list_auth;
+
+	const auth_data_index_t index;
+
+	REQUIRE( !index.find_by_ip(
+			ip_from_int(760812377u), 3002u, ip_from_int(908385451u) ) );
+	REQUIRE( !index.find_by_login(
+			ip_from_int(760812377u), 3002u, "xXXXXX", "jGGGGGGGGG" ) );
+	REQUIRE( !index.find_site_limits( 8u ) );
+}
+
+TEST_CASE("auth_data_index: find_domain_limits") {
+	using namespace arataga::user_list_auth;
+	using arataga::bandlim_config_t;
+
+	auth_data_t cnt;
+	cnt.m_site_limits.emplace( site_limits_key_t{ 3u },
+		site_limits_data_t{ site_limits_data_t::limits_container_t{ 
+			{ "vk.com"_dn, bandlim_config_t{ 1024u, 1024u } },
+			{ "facebook.com"_dn, bandlim_config_t{ 1024u, 1024u } },
+			{ "v2.api.vk.com"_dn, bandlim_config_t{ 2024u, 2024u } },
+			{ "api.vk.com"_dn, bandlim_config_t{ 3024u, 3024u } },
+			{ "avito.ru"_dn, bandlim_config_t{ 1024u, 1024u } },
+			{ "css.static.vk.com"_dn, bandlim_config_t{ 4024u, 4024u } },
+			{ "tv.mail.ru"_dn, bandlim_config_t{ 1024u, 1024u } },
+			{ "static.vk.com"_dn, bandlim_config_t{ 5024u, 5024u } },
+			{ "mp4.tv.mail.ru"_dn, bandlim_config_t{ 6024u, 6024u } },
+			// The last occurrence of the same domain wins.
+			{ "avito.ru"_dn, bandlim_config_t{ 7024u, 7024u } }
+		} } );
+	cnt.m_site_limits.emplace( site_limits_key_t{ 4u },
+		site_limits_data_t{ site_limits_data_t::limits_container_t{ 
+			{ "mail.ru"_dn, bandlim_config_t{ 8024u, 8024u } }
+		} } );
+
+	const auth_data_index_t index{ cnt };
+
+	const auto & limits = cnt.m_site_limits.at( site_limits_key_t{ 3u } );
+
+	// Results should be the same as for the sequential search.
+	for( const auto & host : {
+			"vk.com"_dn, "k.com"_dn, "content.vk.com"_dn,
+			"v1.api.vk.com"_dn, "check.v2.api.vk.com"_dn,
+			"www.facebook.com"_dn, "WWW.Avito.RU"_dn, "avito.ru.com"_dn,
+			"video.mp4.tv.mail.ru"_dn, "mail.ru"_dn, "ru"_dn,
+			"static.vk.com"_dn, "css.static.vk.com"_dn } )
+	{
+		const auto expected = limits.try_find_limits_for( host );
+		const auto * r = index.find_domain_limits( 3u, host );
+		REQUIRE( static_cast<bool>(expected) == (nullptr != r) );
+		if( r )
+		{
+			REQUIRE( expected->m_domain == r->m_domain );
+			REQUIRE( expected->m_bandlims.m_in == r->m_bandlims.m_in );
+		}
+	}
+
+	{
+		const auto * r = index.find_domain_limits( 3u, "www.avito.ru"_dn );
+		REQUIRE( r );
+		REQUIRE( 7024u == r->m_bandlims.m_in );
+	}
+
+	// Limits of another user aren't used.
+	REQUIRE( !index.find_domain_limits( 3u, "e.mail.ru"_dn ) );
+	REQUIRE( index.find_domain_limits( 4u, "e.mail.ru"_dn ) );
+	REQUIRE( !index.find_domain_limits( 4u, "vk.com"_dn ) );
+	REQUIRE( !index.find_domain_limits( 5u, "vk.com"_dn ) );
+}
+
+TEST_CASE("parse_auth_data_delta") {
+	using namespace arataga::user_list_auth;
+	using arataga::bandlim_config_t;
+
+	const auto delta = parse_auth_data_delta(
+			"# Add or replace items.\n"
+			"127.0.0.1 3000 10.0.0.1 = 1024 2048 1 100\n"
+			"127.0.0.1 3000 user 12345 = 0 0 2 101\n"
+			"1 = vk.com 1KiB 2KiB\n"
+			"# Remove items.\n"
+			"- 127.0.0.1 3000 10.0.0.2\n"
+			"-127.0.0.1 3000 another-user 54321\n"
+			"- 2\n"
+			"# The last change wins.\n"
+			"127.0.0.1 3000 10.0.0.3 = 0 0 0 102\n"
+			"- 127.0.0.1 3000 10.0.0.3\n" );
+
+	REQUIRE(5u == delta.size());
+
+	{
+		auth_data_delta_t::by_ip_map_t expected{
+				{
+					{ip_from_int(0x7f000001u), 3000u, ip_from_int(0x0a000001u)},
+					user_data_t{ bandlim_config_t{1024u, 2048u}, 1u, 100u }
+				},
+				{
+					{ip_from_int(0x7f000001u), 3000u, ip_from_int(0x0a000002u)},
+					std::nullopt
+				},
+				{
+					{ip_from_int(0x7f000001u), 3000u, ip_from_int(0x0a000003u)},
+					std::nullopt
+				}
+		};
+		REQUIRE(delta.m_by_ip == expected);
+	}
+
+	{
+		auth_data_delta_t::by_login_map_t expected{
+				{
+					{ip_from_int(0x7f000001u), 3000u, "user", "12345"},
+					user_data_t{ bandlim_config_t{}, 2u, 101u }
+				},
+				{
+					{ip_from_int(0x7f000001u), 3000u, "another-user", "54321"},
+					std::nullopt
+				}
+		};
+		REQUIRE(delta.m_by_login == expected);
+	}
+
+	{
+		auth_data_delta_t::site_limits_map_t expected{
+				{
+					{1u},
+					site_limits_data_t{
+						site_limits_data_t::limits_container_t{
+							{"vk.com"_dn, bandlim_config_t{1024u, 2048u}}
+						}
+					}
+				},
+				{ {2u}, std::nullopt }
+		};
+		REQUIRE(delta.m_site_limits == expected);
+	}
+
+	REQUIRE_THROWS(parse_auth_data_delta("- 127.0.0.1"));
+	REQUIRE_THROWS(parse_auth_data_delta("+ 127.0.0.1 3000 10.0.0.1"));
+}
+
+TEST_CASE("apply_auth_data_delta") {
+	using namespace arataga::user_list_auth;
+
+	auto data = parse_auth_data(
+			"127.0.0.1 3000 10.0.0.1 = 0 0 0 1\n"
+			"127.0.0.1 3000 10.0.0.2 = 0 0 0 2\n"
+			"127.0.0.1 3000 user 12345 = 0 0 1 3\n"
+			"1 = vk.com 1KiB 1KiB\n" );
+
+	auto delta = parse_auth_data_delta(
+			"- 127.0.0.1 3000 10.0.0.1\n"
+			"127.0.0.1 3000 10.0.0.2 = 0 0 0 20\n"
+			"- 1\n" );
+	merge_auth_data_delta(delta, parse_auth_data_delta(
+			"127.0.0.1 3000 10.0.0.1 = 0 0 0 10\n"
+			"- 127.0.0.1 3000 unknown-user 12345\n"
+			"2 = ok.ru 1KiB 1KiB\n" ));
+
+	apply_auth_data_delta(data, delta);
+
+	const auto expected = parse_auth_data(
+			"127.0.0.1 3000 10.0.0.1 = 0 0 0 10\n"
+			"127.0.0.1 3000 10.0.0.2 = 0 0 0 20\n"
+			"127.0.0.1 3000 user 12345 = 0 0 1 3\n"
+			"2 = ok.ru 1KiB 1KiB\n" );
+
+	REQUIRE(data.m_by_ip == expected.m_by_ip);
+	REQUIRE(data.m_by_login == expected.m_by_login);
+	REQUIRE(data.m_site_limits == expected.m_site_limits);
+}
+
+TEST_CASE("replay of journal with incomplete last record") {
+	using namespace arataga::user_list_auth;
+
+	const std::string_view journal =
+			"127.0.0.1 3000 10.0.0.1 = 0 0 0 1\n"
+			"127.0.0.1 3000 10.0.0.2 = 0 0 0 2\n"
+			"- 127.0.0.1 3000 10.0.0.1\n"
+			// The application was stopped during an append.
+			"127.0.0.1 3000 10.0.0.3 = 0 0";
+
+	const auto records = complete_journal_records( journal );
+	REQUIRE(journal.substr( 0u, journal.rfind( '\n' ) + 1u ) == records);
+
+	const auto delta = parse_auth_data_delta( records );
+	REQUIRE(2u == delta.size());
+
+	auth_data_t data;
+	apply_auth_data_delta( data, delta );
+
+	const auto expected = parse_auth_data(
+			"127.0.0.1 3000 10.0.0.2 = 0 0 0 2\n" );
+	REQUIRE(data.m_by_ip == expected.m_by_ip);
+
+	// A complete journal is used as is.
+	REQUIRE(records == complete_journal_records( records ));
+
+	// There is no complete record.
+	REQUIRE(complete_journal_records( "127.0.0.1 3000" ).empty());
+	REQUIRE(complete_journal_records( "" ).empty());
+}
+
+TEST_CASE("make_auth_data_content") {
+	using namespace arataga::user_list_auth;
+
+	auth_data_t cnt;
+	REQUIRE_NOTHROW(
+			cnt = load_auth_data(
+				"tests/local_user_list_data/cfgs/normal-config-1"));
+
+	const auto restored = parse_auth_data( make_auth_data_content( cnt ) );
+
+	REQUIRE(cnt.m_by_ip == restored.m_by_ip);
+	REQUIRE(cnt.m_by_login == restored.m_by_login);
+	REQUIRE(cnt.m_site_limits == restored.m_site_limits);
+
+	REQUIRE(make_auth_data_content( auth_data_t{} ).empty());
+}
+
+TEST_CASE("parse_auth_data_in_parallel") {
+	using namespace arataga::user_list_auth;
+
+	// The content should be big enough to be split into several parts.
+	std::string content;
+	for( unsigned i = 0u; i != 100000u; ++i )
+	{
+		// Every key is repeated with another user_id in the next part
+		// of the content, the first occurrence has to win.
+		const unsigned key = i % 50000u;
+		content += "127.0.0.1 3000 user-" + std::to_string( key ) +
+				" password = 1KiB 1KiB 1 " + std::to_string( i ) + "\n";
+		content += "127.0.0.1 3000 " + std::to_string( key ) +
+				" = 0 0 1 " + std::to_string( i ) + "\n\n";
+		if( 0u == i % 1000u )
+			content += "# A comment.\r\n" + std::to_string( key ) +
+					" = vk.com 1KiB 1KiB\n";
+	}
+
+	const auto expected = parse_auth_data( content );
+	const auto actual = parse_auth_data_in_parallel( content, 4u );
+
+	REQUIRE(expected.m_by_ip.size() == 50000u);
+	REQUIRE(expected.m_by_ip == actual.m_by_ip);
+	REQUIRE(expected.m_by_login == actual.m_by_login);
+	REQUIRE(expected.m_site_limits == actual.m_site_limits);
+
+	// The same error has to be reported.
+	content += "127.0.0.1 3000 = 0 0 1 1\n";
+
+	std::string expected_error;
+	try { (void)parse_auth_data( content ); }
+	catch( const std::exception & x ) { expected_error = x.what(); }
+
+	std::string actual_error;
+	try { (void)parse_auth_data_in_parallel( content, 4u ); }
+	catch( const std::exception & x ) { actual_error = x.what(); }
+
+	REQUIRE(!expected_error.empty());
+	REQUIRE(expected_error == actual_error);
+}
@@ -0,0 +1,135 @@
+/*
+ * A microbenchmark for the search of limits for a domain.
+ *
+ * Compares site_limits_data_t::try_find_limits_for (a sequential
+ * search) with auth_data_index_t::find_domain_limits (a lookup for
+ * every suffix of the host).
+ *
+ * Usage: site_limits_bench [DOMAINS_COUNT]
+ */
+
+#include <arataga/user_list_auth_data.hpp>
+#include <arataga/user_list_auth_index.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace arataga::user_list_auth;
+
+namespace
+{
+
+constexpr std::uint32_t site_limits_id = 1u;
+
+[[nodiscard]]
+site_limits_data_t
+make_site_limits( std::size_t domains_count )
+{
+	site_limits_data_t result;
+
+	for( std::size_t i = 0u; i != domains_count; ++i )
+	{
+		const auto base = "site-" + std::to_string( i ) + ".com";
+		result.m_limits.push_back( site_limits_data_t::one_limit_t{
+				domain_name_t{ base },
+				arataga::bandlim_config_t{ 1024u, 1024u }
+			} );
+		// Some domains have limits for subdomains too.
+		if( 0u == i % 4u )
+			result.m_limits.push_back( site_limits_data_t::one_limit_t{
+					domain_name_t{ "api." + base },
+					arataga::bandlim_config_t{ 2048u, 2048u }
+				} );
+	}
+
+	return result;
+}
+
+[[nodiscard]]
+std::vector< domain_name_t >
+make_hosts( std::size_t domains_count, std::size_t hosts_count )
+{
+	std::mt19937 gen{ 42u };
+	std::uniform_int_distribution< std::size_t > site{ 0u, domains_count * 2u };
+	std::uniform_int_distribution< int > kind{ 0, 2 };
+
+	std::vector< domain_name_t > result;
+	result.reserve( hosts_count );
+	for( std::size_t i = 0u; i != hosts_count; ++i )
+	{
+		// Half of hosts have no limits.
+		auto name = "site-" + std::to_string( site( gen ) ) + ".com";
+		switch( kind( gen ) )
+		{
+		case 0: break;
+		case 1: name = "www." + name; break;
+		case 2: name = "v2.api." + name; break;
+		}
+		result.emplace_back( std::move(name) );
+	}
+
+	return result;
+}
+
+template< typename Lambda >
+void
+measure(
+	const char * name,
+	std::size_t lookups,
+	Lambda && lambda )
+{
+	const auto started_at = std::chrono::steady_clock::now();
+	const auto found = lambda();
+	const auto finished_at = std::chrono::steady_clock::now();
+
+	const double ns = std::chrono::duration< double, std::nano >(
+			finished_at - started_at ).count();
+
+	std::cout << name << ": " << (ns / static_cast<double>(lookups))
+			<< " ns/lookup (found: " << found << ")" << std::endl;
+}
+
+} /* namespace anonymous */
+
+int
+main( int argc, char ** argv )
+{
+	const std::size_t domains_count = argc > 1 ?
+			std::strtoul( argv[ 1 ], nullptr, 10 ) : 500u;
+	constexpr std::size_t hosts_count = 100000u;
+
+	auth_data_t data;
+	data.m_site_limits.emplace(
+			site_limits_key_t{ site_limits_id },
+			make_site_limits( domains_count ) );
+	const auth_data_index_t index{ data };
+
+	const auto & limits = data.m_site_limits.begin()->second;
+	const auto hosts = make_hosts( domains_count, hosts_count );
+
+	std::cout << "domains in the list: " << limits.m_limits.size()
+			<< std::endl;
+
+	measure( "try_find_limits_for", hosts.size(), [&] {
+			std::size_t found = 0u;
+			for( const auto & host : hosts )
+				if( limits.try_find_limits_for( host ) )
+					found += 1u;
+			return found;
+		} );
+
+	measure( "find_domain_limits", hosts.size(), [&] {
+			std::size_t found = 0u;
+			for( const auto & host : hosts )
+				if( index.find_domain_limits( site_limits_id, host ) )
+					found += 1u;
+			return found;
+		} );
+
+	return 0;
+}
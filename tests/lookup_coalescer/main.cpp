@@ -0,0 +1,114 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <arataga/dns_resolver/lookup_coalescer.hpp>
+
+#include <vector>
+
+using namespace arataga;
+using namespace arataga::dns_resolver;
+using namespace std::chrono_literals;
+
+TEST_CASE( "lookup coalescing" )
+{
+	basic_lookup_coalescer_t< int > coalescer;
+
+	const auto now = std::chrono::steady_clock::now();
+
+	REQUIRE( coalescer.try_become_leader(
+			"example.com", ip_version_t::ip_v4, 1, now, 4s ) );
+	REQUIRE( !coalescer.try_become_leader(
+			"example.com", ip_version_t::ip_v4, 2, now, 4s ) );
+	REQUIRE( !coalescer.try_become_leader(
+			"example.com", ip_version_t::ip_v4, 3, now + 1s, 4s ) );
+
+	// Another IP version is another lookup.
+	REQUIRE( coalescer.try_become_leader(
+			"example.com", ip_version_t::ip_v6, 4, now, 4s ) );
+
+	REQUIRE( 2u == coalescer.size() );
+
+	const std::vector< int > expected{ 2, 3 };
+	REQUIRE( expected ==
+			coalescer.complete( "example.com", ip_version_t::ip_v4 ) );
+	REQUIRE( coalescer.complete( "example.com", ip_version_t::ip_v6 ).empty() );
+	REQUIRE( coalescer.complete( "example.com", ip_version_t::ip_v4 ).empty() );
+
+	REQUIRE( 0u == coalescer.size() );
+}
+
+TEST_CASE( "too long lookup is taken over" )
+{
+	basic_lookup_coalescer_t< int > coalescer;
+
+	const auto now = std::chrono::steady_clock::now();
+
+	REQUIRE( coalescer.try_become_leader(
+			"example.com", ip_version_t::ip_v4, 1, now, 4s ) );
+	REQUIRE( !coalescer.try_become_leader(
+			"example.com", ip_version_t::ip_v4, 2, now + 1s, 4s ) );
+
+	// The first leader is too slow.
+	REQUIRE( coalescer.try_become_leader(
+			"example.com", ip_version_t::ip_v4, 3, now + 5s, 4s ) );
+	REQUIRE( !coalescer.try_become_leader(
+			"example.com", ip_version_t::ip_v4, 4, now + 6s, 4s ) );
+
+	// Waiters of the first leader are kept.
+	const std::vector< int > expected{ 2, 4 };
+	REQUIRE( expected ==
+			coalescer.complete( "example.com", ip_version_t::ip_v4 ) );
+}
+
+TEST_CASE( "waiter retries after the expiration of its wait" )
+{
+	basic_lookup_coalescer_t< int > coalescer;
+
+	const auto now = std::chrono::steady_clock::now();
+
+	REQUIRE( coalescer.try_become_leader(
+			"example.com", ip_version_t::ip_v4, 1, now, 4s ) );
+	REQUIRE( !coalescer.try_become_leader(
+			"example.com", ip_version_t::ip_v4, 2, now + 1s, 4s ) );
+
+	// The lookup isn't too long yet, the waiter continues to wait
+	// and isn't added twice.
+	REQUIRE( !coalescer.try_become_leader(
+			"example.com", ip_version_t::ip_v4, 2, now + 3s, 4s ) );
+	REQUIRE( 1u == coalescer.size() );
+
+	// The leader is lost, the waiter does the lookup itself
+	// and doesn't wait for itself.
+	REQUIRE( coalescer.try_become_leader(
+			"example.com", ip_version_t::ip_v4, 2, now + 5s, 4s ) );
+	REQUIRE( !coalescer.try_become_leader(
+			"example.com", ip_version_t::ip_v4, 3, now + 6s, 4s ) );
+
+	const std::vector< int > expected{ 3 };
+	REQUIRE( expected ==
+			coalescer.complete( "example.com", ip_version_t::ip_v4 ) );
+	REQUIRE( 0u == coalescer.size() );
+
+	// The result of the lost leader is ignored.
+	REQUIRE( coalescer.complete( "example.com", ip_version_t::ip_v4 ).empty() );
+}
+
+TEST_CASE( "new lookup after completion" )
+{
+	basic_lookup_coalescer_t< int > coalescer;
+
+	const auto now = std::chrono::steady_clock::now();
+
+	REQUIRE( coalescer.try_become_leader(
+			"example.com", ip_version_t::ip_v4, 1, now, 4s ) );
+	REQUIRE( !coalescer.try_become_leader(
+			"example.com", ip_version_t::ip_v4, 2, now, 4s ) );
+	const std::vector< int > expected{ 2 };
+	REQUIRE( expected ==
+			coalescer.complete( "example.com", ip_version_t::ip_v4 ) );
+
+	// The next request for the same name starts a new lookup.
+	REQUIRE( coalescer.try_become_leader(
+			"example.com", ip_version_t::ip_v4, 2, now + 1s, 4s ) );
+	REQUIRE( coalescer.complete( "example.com", ip_version_t::ip_v4 ).empty() );
+}
@@ -0,0 +1,130 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <arataga/stats_collector/openmetrics.hpp>
+
+#include <sstream>
+#include <vector>
+
+using namespace arataga::stats;
+using namespace arataga::stats_collector;
+
+namespace
+{
+
+[[nodiscard]]
+std::vector< std::string >
+lines_of( const std::string & text )
+{
+	std::vector< std::string > result;
+	std::istringstream from{ text };
+	for( std::string line; std::getline( from, line ); )
+		result.push_back( line );
+
+	return result;
+}
+
+} /* namespace anonymous */
+
+TEST_CASE( "bucket mapping" )
+{
+	latency_histogram_t source;
+	source.record_microseconds( 0u );
+	source.record_microseconds( 15u );
+	// The source bucket for 16 is [16, 17], so it goes to (16, 32].
+	source.record_microseconds( 16u );
+	source.record_microseconds( 31u );
+	source.record_microseconds( 1000u );
+	// Greater than the last bound.
+	source.record_microseconds( (std::uint64_t{1u} << 23u) + 1u );
+	source.record_microseconds( std::uint64_t{1u} << 30u );
+
+	metrics_histogram_t histogram;
+	histogram.merge( source );
+
+	REQUIRE( 7u == histogram.count() );
+	// [0, 16]
+	REQUIRE( 2u == histogram.m_buckets[ 0 ] );
+	// (16, 32]
+	REQUIRE( 2u == histogram.m_buckets[ 1 ] );
+	REQUIRE( 0u == histogram.m_buckets[ 2 ] );
+	// (512, 1024]
+	REQUIRE( 1u == histogram.m_buckets[ 6 ] );
+	// +Inf
+	REQUIRE( 2u == histogram.m_buckets.back() );
+
+	// Values are merged, not replaced.
+	histogram.merge( source );
+	REQUIRE( 14u == histogram.count() );
+	REQUIRE( 4u == histogram.m_buckets[ 0 ] );
+	REQUIRE( 2u * source.sum() == histogram.m_sum );
+}
+
+TEST_CASE( "histogram samples" )
+{
+	latency_histogram_t source;
+	source.record_microseconds( 10u );
+	source.record_microseconds( 20u );
+	source.record_microseconds( 20u );
+	source.record_microseconds( std::uint64_t{1u} << 30u );
+
+	metrics_histogram_t histogram;
+	histogram.merge( source );
+
+	std::string out;
+	metric_family( out, "test_latency_seconds", "histogram", "Test." );
+	metric_histogram( out, "test_latency_seconds", R"(acl="a")", histogram );
+	metrics_eof( out );
+
+	const auto lines = lines_of( out );
+	REQUIRE( 2u + metrics_histogram_t::bounds_count + 1u + 2u + 1u ==
+			lines.size() );
+
+	REQUIRE( "# TYPE test_latency_seconds histogram" == lines[ 0 ] );
+	REQUIRE( "# HELP test_latency_seconds Test." == lines[ 1 ] );
+
+	// Counts are cumulative.
+	REQUIRE( R"(test_latency_seconds_bucket{acl="a",le="1.6e-05"} 1)" ==
+			lines[ 2 ] );
+	REQUIRE( R"(test_latency_seconds_bucket{acl="a",le="3.2e-05"} 3)" ==
+			lines[ 3 ] );
+	REQUIRE( R"(test_latency_seconds_bucket{acl="a",le="6.4e-05"} 3)" ==
+			lines[ 4 ] );
+
+	const auto last_bound = 2u + metrics_histogram_t::bounds_count - 1u;
+	REQUIRE( R"(test_latency_seconds_bucket{acl="a",le="8.388608"} 3)" ==
+			lines[ last_bound ] );
+	REQUIRE( R"(test_latency_seconds_bucket{acl="a",le="+Inf"} 4)" ==
+			lines[ last_bound + 1u ] );
+	REQUIRE( R"(test_latency_seconds_count{acl="a"} 4)" ==
+			lines[ last_bound + 2u ] );
+	REQUIRE( R"(test_latency_seconds_sum{acl="a"} 1073.741874)" ==
+			lines[ last_bound + 3u ] );
+
+	REQUIRE( "# EOF" == lines.back() );
+	REQUIRE( '\n' == out.back() );
+}
+
+TEST_CASE( "histogram samples without labels" )
+{
+	metrics_histogram_t histogram;
+
+	std::string out;
+	metric_histogram( out, "rtt_seconds", {}, histogram );
+
+	const auto lines = lines_of( out );
+	REQUIRE( R"(rtt_seconds_bucket{le="1.6e-05"} 0)" == lines[ 0 ] );
+	REQUIRE( R"(rtt_seconds_bucket{le="+Inf"} 0)" ==
+			lines[ metrics_histogram_t::bounds_count ] );
+	REQUIRE( "rtt_seconds_count 0" == lines[ lines.size() - 2u ] );
+	REQUIRE( "rtt_seconds_sum 0" == lines.back() );
+}
+
+TEST_CASE( "samples" )
+{
+	std::string out;
+	metric_sample( out, "requests_total", {}, 3u );
+	metric_sample( out, "auth_total", R"(method="ip")", 5u );
+
+	REQUIRE( "requests_total 3\nauth_total{method=\"ip\"} 5\n" == out );
+}
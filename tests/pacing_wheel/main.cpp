@@ -0,0 +1,97 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <arataga/acl_handler/pacing_wheel.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace arataga::acl_handler;
+using namespace std::chrono_literals;
+
+TEST_CASE( "idle wheel" )
+{
+	asio::io_context io_ctx;
+	auto wheel = std::make_shared< pacing_wheel_t >( io_ctx );
+
+	REQUIRE( 0u == wheel->pending() );
+
+	// There is no active timer, so run() should return immediately.
+	REQUIRE( 0u == io_ctx.run() );
+}
+
+TEST_CASE( "callbacks are invoked in order of delays" )
+{
+	asio::io_context io_ctx;
+	auto wheel = std::make_shared< pacing_wheel_t >( io_ctx );
+
+	std::vector< std::string > trace;
+
+	wheel->schedule( 30ms, [&trace]{ trace.push_back( "30ms" ); } );
+	wheel->schedule( 10ms, [&trace]{ trace.push_back( "10ms" ); } );
+	wheel->schedule( 0ms, [&trace]{ trace.push_back( "0ms" ); } );
+	wheel->schedule( 10ms, [&trace]{ trace.push_back( "10ms-2" ); } );
+
+	REQUIRE( 4u == wheel->pending() );
+
+	const auto started_at = std::chrono::steady_clock::now();
+	io_ctx.run();
+	const auto finished_at = std::chrono::steady_clock::now();
+
+	REQUIRE( 0u == wheel->pending() );
+	const std::vector< std::string > expected{
+			"0ms", "10ms", "10ms-2", "30ms"
+		};
+	REQUIRE( expected == trace );
+
+	// The last callback can be invoked one tick earlier.
+	REQUIRE( finished_at - started_at >= 30ms - pacing_wheel_t::tick );
+}
+
+TEST_CASE( "callback schedules another callback" )
+{
+	asio::io_context io_ctx;
+	auto wheel = std::make_shared< pacing_wheel_t >( io_ctx );
+
+	int calls = 0;
+	std::function< void() > cb = [&] {
+			++calls;
+			if( calls < 3 )
+				wheel->schedule( pacing_wheel_t::tick, cb );
+		};
+
+	wheel->schedule( pacing_wheel_t::tick, cb );
+	io_ctx.run();
+
+	REQUIRE( 3 == calls );
+	REQUIRE( 0u == wheel->pending() );
+
+	// The wheel can be reused after it becomes idle.
+	io_ctx.restart();
+	wheel->schedule( 1ms, cb );
+	io_ctx.run();
+
+	REQUIRE( 4 == calls );
+}
+
+TEST_CASE( "too long delay is truncated" )
+{
+	asio::io_context io_ctx;
+	auto wheel = std::make_shared< pacing_wheel_t >( io_ctx );
+
+	std::vector< std::string > trace;
+
+	wheel->schedule( 1h, [&trace]{ trace.push_back( "long" ); } );
+	wheel->schedule(
+			pacing_wheel_t::tick * 2,
+			[&trace]{ trace.push_back( "short" ); } );
+
+	const auto started_at = std::chrono::steady_clock::now();
+	io_ctx.run();
+	const auto finished_at = std::chrono::steady_clock::now();
+
+	const std::vector< std::string > expected{ "short", "long" };
+	REQUIRE( expected == trace );
+	REQUIRE( finished_at - started_at <
+			pacing_wheel_t::tick * (pacing_wheel_t::slots_count + 100u) );
+}
@@ -0,0 +1,193 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <arataga/stats/snapshot_registry.hpp>
+
+#include <atomic>
+#include <optional>
+#include <thread>
+
+using namespace arataga::stats;
+
+namespace
+{
+
+// An object that counts its destructions.
+struct tracked_t
+{
+	int m_value;
+	int & m_destroyed;
+
+	tracked_t( int value, int & destroyed )
+		:	m_value{ value }
+		,	m_destroyed{ destroyed }
+	{}
+
+	~tracked_t()
+	{
+		++m_destroyed;
+	}
+};
+
+} /* namespace anonymous */
+
+TEST_CASE( "add and remove" )
+{
+	int destroyed{};
+	snapshot_registry_t< tracked_t > registry;
+
+	REQUIRE( registry.snapshot().objects().empty() );
+
+	auto first = std::make_shared< tracked_t >( 1, destroyed );
+	auto second = std::make_shared< tracked_t >( 2, destroyed );
+
+	registry.add( first );
+	registry.add( second );
+
+	{
+		const auto snapshot = registry.snapshot();
+		REQUIRE( 2u == snapshot.objects().size() );
+		REQUIRE( 1 == snapshot.objects()[ 0 ]->m_value );
+		REQUIRE( 2 == snapshot.objects()[ 1 ]->m_value );
+	}
+
+	// The removal is applied when the next snapshot is taken.
+	registry.remove( std::move(first) );
+	REQUIRE( 0 == destroyed );
+
+	{
+		const auto snapshot = registry.snapshot();
+		REQUIRE( 1 == destroyed );
+		REQUIRE( 1u == snapshot.objects().size() );
+		REQUIRE( 2 == snapshot.objects()[ 0 ]->m_value );
+	}
+
+	registry.remove( std::move(second) );
+	REQUIRE( registry.snapshot().objects().empty() );
+	REQUIRE( 2 == destroyed );
+}
+
+TEST_CASE( "removed objects live while they are in use" )
+{
+	int destroyed{};
+	snapshot_registry_t< tracked_t > registry;
+
+	auto first = std::make_shared< tracked_t >( 1, destroyed );
+	auto second = std::make_shared< tracked_t >( 2, destroyed );
+	auto third = std::make_shared< tracked_t >( 3, destroyed );
+
+	registry.add( first );
+	registry.add( second );
+
+	// This snapshot sees the first and the second objects.
+	std::optional< snapshot_registry_t< tracked_t >::snapshot_t > old_snapshot{
+			registry.snapshot()
+		};
+
+	registry.add( third );
+	registry.remove( std::move(second) );
+	registry.remove( std::move(first) );
+
+	REQUIRE( 0 == destroyed );
+	REQUIRE( 2u == old_snapshot->objects().size() );
+	REQUIRE( 1 == old_snapshot->objects()[ 0 ]->m_value );
+	REQUIRE( 2 == old_snapshot->objects()[ 1 ]->m_value );
+
+	{
+		const auto snapshot = registry.snapshot();
+		REQUIRE( 1u == snapshot.objects().size() );
+		REQUIRE( 3 == snapshot.objects()[ 0 ]->m_value );
+	}
+
+	// Removed objects are destroyed with the last snapshot that sees them.
+	old_snapshot.reset();
+	REQUIRE( 2 == destroyed );
+
+	registry.remove( std::move(third) );
+	(void)registry.snapshot();
+	REQUIRE( 3 == destroyed );
+}
+
+TEST_CASE( "old snapshot doesn't hold objects added after it" )
+{
+	int destroyed{};
+	snapshot_registry_t< tracked_t > registry;
+
+	auto first = std::make_shared< tracked_t >( 1, destroyed );
+	registry.add( first );
+
+	const auto old_snapshot = registry.snapshot();
+
+	// Objects added and removed after the old snapshot are destroyed
+	// right after their removal.
+	for( int i = 0; i != 10; ++i )
+	{
+		auto item = std::make_shared< tracked_t >( 2, destroyed );
+		registry.add( item );
+		registry.remove( std::move(item) );
+		(void)registry.snapshot();
+		REQUIRE( i + 1 == destroyed );
+	}
+
+	// But the object from the old snapshot is still alive.
+	registry.remove( std::move(first) );
+	REQUIRE( 10 == destroyed );
+	REQUIRE( 1u == old_snapshot.objects().size() );
+	REQUIRE( 1 == old_snapshot.objects()[ 0 ]->m_value );
+}
+
+TEST_CASE( "changes are folded without snapshots" )
+{
+	int destroyed{};
+	snapshot_registry_t< tracked_t > registry;
+
+	// Nobody takes snapshots, but queued changes don't grow without
+	// limits: removed objects are destroyed by writers.
+	for( int i = 0; i != 1000; ++i )
+	{
+		auto item = std::make_shared< tracked_t >( i, destroyed );
+		registry.add( item );
+		registry.remove( std::move(item) );
+	}
+
+	REQUIRE( 1000 - 64 <= destroyed );
+
+	REQUIRE( registry.snapshot().objects().empty() );
+	REQUIRE( 1000 == destroyed );
+}
+
+TEST_CASE( "concurrent enumeration and modification" )
+{
+	struct item_t
+	{
+		std::atomic< int > m_value{ 1 };
+	};
+
+	snapshot_registry_t< item_t > registry;
+
+	std::atomic< bool > finished{ false };
+
+	std::thread writer{ [&] {
+			for( int i = 0; i != 2000; ++i )
+			{
+				auto item = std::make_shared< item_t >();
+				registry.add( item );
+				registry.remove( std::move(item) );
+			}
+			finished = true;
+		} };
+
+	std::thread reader{ [&] {
+			while( !finished )
+			{
+				const auto snapshot = registry.snapshot();
+				for( const auto & item : snapshot.objects() )
+					REQUIRE( 1 == item->m_value.load() );
+			}
+		} };
+
+	writer.join();
+	reader.join();
+
+	REQUIRE( registry.snapshot().objects().empty() );
+}
@@ -0,0 +1,351 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <arataga/acl_handler/timeout_wheel.hpp>
+
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace arataga::acl_handler;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+class test_entry_t final : public timeout_wheel_t::entry_t
+{
+	std::function< void() > m_hook;
+
+public:
+	explicit test_entry_t( std::function< void() > hook )
+		:	m_hook{ std::move(hook) }
+	{}
+
+	void
+	on_timeout() noexcept override
+	{
+		m_hook();
+	}
+};
+
+[[nodiscard]]
+std::function< void() >
+trace_to( std::vector< std::string > & trace, std::string name )
+{
+	return [&trace, name = std::move(name)] { trace.push_back( name ); };
+}
+
+} /* namespace anonymous */
+
+TEST_CASE( "lowest bit index" )
+{
+	for( unsigned i = 0u; i != 64u; ++i )
+	{
+		const auto bit = std::uint64_t{1u} << i;
+		REQUIRE( i == timeout_wheel_details::lowest_bit_index( bit ) );
+		REQUIRE( i == timeout_wheel_details::lowest_bit_index(
+				bit | (bit << 1u) | (std::uint64_t{1u} << 63u) ) );
+	}
+}
+
+TEST_CASE( "idle wheel" )
+{
+	asio::io_context io_ctx;
+	auto wheel = std::make_shared< timeout_wheel_t >( io_ctx );
+
+	REQUIRE( 0u == wheel->size() );
+
+	// There is no active timer, so run() should return immediately.
+	REQUIRE( 0u == io_ctx.run() );
+}
+
+TEST_CASE( "entries expire in order of deadlines" )
+{
+	asio::io_context io_ctx;
+	auto wheel = std::make_shared< timeout_wheel_t >( io_ctx );
+
+	std::vector< std::string > trace;
+
+	test_entry_t e1{ trace_to( trace, "5ms" ) };
+	test_entry_t e2{ trace_to( trace, "100ms" ) };
+	test_entry_t e3{ trace_to( trace, "5s" ) };
+	test_entry_t e4{ trace_to( trace, "10min" ) };
+	test_entry_t e5{ trace_to( trace, "2h" ) };
+
+	const auto now = std::chrono::steady_clock::now();
+
+	wheel->schedule( e5, now + 2h );
+	wheel->schedule( e4, now + 10min );
+	wheel->schedule( e3, now + 5s );
+	wheel->schedule( e2, now + 100ms );
+	wheel->schedule( e1, now + 5ms );
+
+	REQUIRE( 5u == wheel->size() );
+
+	wheel->advance( now + 4ms );
+	REQUIRE( trace.empty() );
+
+	wheel->advance( now + 6ms );
+	REQUIRE( std::vector< std::string >{ "5ms" } == trace );
+	REQUIRE( !e1.is_scheduled() );
+
+	wheel->advance( now + 99ms );
+	REQUIRE( 1u == trace.size() );
+
+	wheel->advance( now + 4999ms );
+	REQUIRE( std::vector< std::string >{ "5ms", "100ms" } == trace );
+
+	wheel->advance( now + 9min );
+	REQUIRE( std::vector< std::string >{ "5ms", "100ms", "5s" } == trace );
+
+	wheel->advance( now + 2h - 1ms );
+	REQUIRE( std::vector< std::string >{ "5ms", "100ms", "5s", "10min" }
+			== trace );
+	REQUIRE( 1u == wheel->size() );
+
+	wheel->advance( now + 2h + 1ms );
+	REQUIRE( 5u == trace.size() );
+	REQUIRE( 0u == wheel->size() );
+}
+
+TEST_CASE( "cancellation" )
+{
+	asio::io_context io_ctx;
+	auto wheel = std::make_shared< timeout_wheel_t >( io_ctx );
+
+	std::vector< std::string > trace;
+
+	test_entry_t e1{ trace_to( trace, "e1" ) };
+
+	const auto now = std::chrono::steady_clock::now();
+
+	wheel->schedule( e1, now + 10ms );
+	{
+		test_entry_t e2{ trace_to( trace, "e2" ) };
+		wheel->schedule( e2, now + 20ms );
+		REQUIRE( 2u == wheel->size() );
+		// The entry is cancelled by the destructor.
+	}
+	REQUIRE( 1u == wheel->size() );
+
+	e1.cancel();
+	REQUIRE( !e1.is_scheduled() );
+	REQUIRE( 0u == wheel->size() );
+
+	wheel->advance( now + 1s );
+	REQUIRE( trace.empty() );
+}
+
+TEST_CASE( "entry is moved to another deadline" )
+{
+	asio::io_context io_ctx;
+	auto wheel = std::make_shared< timeout_wheel_t >( io_ctx );
+
+	std::vector< std::string > trace;
+
+	test_entry_t e1{ trace_to( trace, "e1" ) };
+
+	const auto now = std::chrono::steady_clock::now();
+
+	wheel->schedule( e1, now + 10s );
+	wheel->schedule( e1, now + 10ms );
+	REQUIRE( 1u == wheel->size() );
+
+	wheel->advance( now + 11ms );
+	REQUIRE( std::vector< std::string >{ "e1" } == trace );
+
+	wheel->schedule( e1, now + 20ms );
+	wheel->schedule( e1, now + 1min );
+
+	wheel->advance( now + 59s );
+	REQUIRE( 1u == trace.size() );
+
+	wheel->advance( now + 61s );
+	REQUIRE( 2u == trace.size() );
+}
+
+TEST_CASE( "hooks can schedule and cancel entries" )
+{
+	asio::io_context io_ctx;
+	auto wheel = std::make_shared< timeout_wheel_t >( io_ctx );
+
+	std::vector< std::string > trace;
+
+	const auto now = std::chrono::steady_clock::now();
+	auto current = now;
+
+	test_entry_t e2{ trace_to( trace, "e2" ) };
+	int e1_calls = 0;
+	std::function< void() > e1_hook;
+	test_entry_t e1{ [&] { e1_hook(); } };
+	e1_hook = [&] {
+			++e1_calls;
+			trace.push_back( "e1" );
+			if( e1_calls < 3 )
+				wheel->schedule( e1, current + 5ms );
+			e2.cancel();
+		};
+
+	wheel->schedule( e1, now + 10ms );
+	wheel->schedule( e2, now + 10ms );
+
+	current = now + 1s;
+	wheel->advance( current );
+	REQUIRE( std::vector< std::string >{ "e1" } == trace );
+	REQUIRE( !e2.is_scheduled() );
+
+	current += 6ms;
+	wheel->advance( current );
+	REQUIRE( std::vector< std::string >{ "e1", "e1" } == trace );
+
+	current += 6ms;
+	wheel->advance( current );
+	REQUIRE( std::vector< std::string >{ "e1", "e1", "e1" } == trace );
+	REQUIRE( 0u == wheel->size() );
+}
+
+TEST_CASE( "deadline in the past" )
+{
+	asio::io_context io_ctx;
+	auto wheel = std::make_shared< timeout_wheel_t >( io_ctx );
+
+	std::vector< std::string > trace;
+
+	test_entry_t e1{ trace_to( trace, "e1" ) };
+
+	const auto now = std::chrono::steady_clock::now();
+
+	wheel->schedule( e1, now - 1h );
+	wheel->advance( now + 1ms );
+	REQUIRE( std::vector< std::string >{ "e1" } == trace );
+}
+
+TEST_CASE( "too long deadline is truncated" )
+{
+	asio::io_context io_ctx;
+	auto wheel = std::make_shared< timeout_wheel_t >( io_ctx );
+
+	std::vector< std::string > trace;
+
+	test_entry_t e1{ trace_to( trace, "long" ) };
+
+	const auto now = std::chrono::steady_clock::now();
+
+	wheel->schedule( e1, now + 1000h );
+
+	wheel->advance( now + timeout_wheel_t::max_distance + 1ms );
+	REQUIRE( std::vector< std::string >{ "long" } == trace );
+}
+
+TEST_CASE( "random deadlines" )
+{
+	asio::io_context io_ctx;
+	auto wheel = std::make_shared< timeout_wheel_t >( io_ctx );
+
+	const auto now = std::chrono::steady_clock::now();
+
+	std::mt19937 gen{ 42u };
+	std::uniform_int_distribution< long > deadline_dist{ 0, 3'600'000 };
+	std::uniform_int_distribution< long > step_dist{ 1, 20'000 };
+
+	constexpr std::size_t entries_count = 5000u;
+
+	std::vector< std::chrono::steady_clock::time_point > deadlines;
+	std::vector< std::chrono::steady_clock::time_point > expired_at(
+			entries_count );
+	std::vector< std::unique_ptr< test_entry_t > > entries;
+
+	auto current = now;
+	for( std::size_t i = 0u; i != entries_count; ++i )
+	{
+		deadlines.push_back(
+				now + std::chrono::milliseconds{ deadline_dist( gen ) } );
+		entries.push_back( std::make_unique< test_entry_t >(
+				[&expired_at, &current, i] { expired_at[ i ] = current; } ) );
+		wheel->schedule( *entries.back(), deadlines.back() );
+	}
+
+	auto previous = now;
+	while( wheel->size() )
+	{
+		previous = current;
+		current += std::chrono::milliseconds{ step_dist( gen ) };
+		wheel->advance( current );
+
+		for( std::size_t i = 0u; i != entries_count; ++i )
+		{
+			if( expired_at[ i ] == current )
+			{
+				// Not too early.
+				REQUIRE( deadlines[ i ] <= current );
+				// And not too late.
+				REQUIRE( previous < deadlines[ i ] + timeout_wheel_t::tick_t{1} );
+			}
+		}
+	}
+
+	for( std::size_t i = 0u; i != entries_count; ++i )
+		REQUIRE( !entries[ i ]->is_scheduled() );
+}
+
+TEST_CASE( "entries expire by the timer" )
+{
+	asio::io_context io_ctx;
+	auto wheel = std::make_shared< timeout_wheel_t >( io_ctx );
+
+	std::vector< std::string > trace;
+
+	test_entry_t e1{ trace_to( trace, "30ms" ) };
+	test_entry_t e2{ trace_to( trace, "10ms" ) };
+
+	const auto started_at = std::chrono::steady_clock::now();
+
+	wheel->schedule( e1, started_at + 30ms );
+	wheel->schedule( e2, started_at + 10ms );
+
+	io_ctx.run();
+	const auto finished_at = std::chrono::steady_clock::now();
+
+	REQUIRE( std::vector< std::string >{ "10ms", "30ms" } == trace );
+	REQUIRE( 0u == wheel->size() );
+	REQUIRE( finished_at - started_at >= 30ms );
+}
+
+TEST_CASE( "hook that reschedules its entry doesn't delay other entries" )
+{
+	asio::io_context io_ctx;
+	auto wheel = std::make_shared< timeout_wheel_t >( io_ctx );
+
+	std::vector< std::string > trace;
+
+	// This entry expires first and moves itself far to the future
+	// (as connection-handlers do after every check of their time-outs).
+	std::unique_ptr< test_entry_t > periodic;
+	periodic = std::make_unique< test_entry_t >( [&] {
+			trace.push_back( "periodic" );
+			wheel->schedule( *periodic, std::chrono::steady_clock::now() + 1h );
+		} );
+
+	// This entry should expire in time even though the timer has been
+	// set for the next deadline of periodic.
+	test_entry_t single{ [&] {
+			trace.push_back( "single" );
+			io_ctx.stop();
+		} };
+
+	const auto started_at = std::chrono::steady_clock::now();
+
+	wheel->schedule( *periodic, started_at + 5ms );
+	wheel->schedule( single, started_at + 30ms );
+
+	io_ctx.run_for( 2s );
+	const auto finished_at = std::chrono::steady_clock::now();
+
+	REQUIRE( std::vector< std::string >{ "periodic", "single" } == trace );
+	REQUIRE( 1u == wheel->size() );
+	REQUIRE( finished_at - started_at >= 30ms );
+	REQUIRE( finished_at - started_at < 1s );
+}
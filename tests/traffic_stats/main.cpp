@@ -0,0 +1,215 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <arataga/stats/traffic/pub.hpp>
+
+#include <thread>
+
+using namespace arataga::stats::traffic;
+using arataga::bandlim_config_t;
+
+namespace
+{
+
+[[nodiscard]]
+std::size_t
+count_registered( traffic_stats_reference_manager_t & manager )
+{
+	std::size_t result{};
+	auto enumerator = lambda_as_enumerator(
+			[&result]( traffic_stats_t & ) {
+				++result;
+				return traffic_stats_enumerator_t::go_next;
+			} );
+	manager.enumerate( enumerator );
+
+	return result;
+}
+
+} /* namespace anonymous */
+
+TEST_CASE( "registration" )
+{
+	auto manager = make_std_traffic_stats_reference_manager();
+	REQUIRE( 0u == count_registered( *manager ) );
+
+	{
+		auto stats = std::make_shared< traffic_stats_t >( manager );
+		REQUIRE( 1u == count_registered( *manager ) );
+	}
+
+	REQUIRE( 0u == count_registered( *manager ) );
+}
+
+TEST_CASE( "collection of differences" )
+{
+	auto stats = std::make_shared< traffic_stats_t >(
+			make_std_traffic_stats_reference_manager() );
+
+	auto user = stats->acquire_user_counters( 42u );
+	auto acl = stats->acquire_acl_counters( "127.0.0.1:3000" );
+
+	user->add_from_user( 100u );
+	user->add_from_target( 1000u );
+	user->add_from_target( 500u );
+	acl->add_from_user( 100u );
+
+	auto collected = stats->collect();
+	REQUIRE( 1u == collected.m_users.size() );
+	REQUIRE( 42u == collected.m_users[ 0 ].m_user_id );
+	REQUIRE( 100u == collected.m_users[ 0 ].m_totals.m_bytes_from_user );
+	REQUIRE( 1500u == collected.m_users[ 0 ].m_totals.m_bytes_from_target );
+	REQUIRE( 1u == collected.m_users[ 0 ].m_totals.m_chunks_from_user );
+	REQUIRE( 2u == collected.m_users[ 0 ].m_totals.m_chunks_from_target );
+	REQUIRE( 1600u == collected.m_users[ 0 ].m_totals.total_bytes() );
+
+	REQUIRE( 1u == collected.m_acls.size() );
+	REQUIRE( "127.0.0.1:3000" == collected.m_acls[ 0 ].first );
+	REQUIRE( 100u == collected.m_acls[ 0 ].second.m_bytes_from_user );
+
+	// There is no new data.
+	collected = stats->collect();
+	REQUIRE( collected.m_users.empty() );
+	REQUIRE( collected.m_acls.empty() );
+
+	// Only new data is collected.
+	user->add_from_user( 5u );
+	collected = stats->collect();
+	REQUIRE( 1u == collected.m_users.size() );
+	REQUIRE( 5u == collected.m_users[ 0 ].m_totals.m_bytes_from_user );
+	REQUIRE( 0u == collected.m_users[ 0 ].m_totals.m_bytes_from_target );
+}
+
+TEST_CASE( "shared counters" )
+{
+	auto stats = std::make_shared< traffic_stats_t >(
+			make_std_traffic_stats_reference_manager() );
+
+	auto first = stats->acquire_user_counters( 1u );
+	auto second = stats->acquire_user_counters( 1u );
+	auto copy = first;
+
+	first->add_from_user( 1u );
+	second->add_from_user( 2u );
+	copy->add_from_user( 3u );
+
+	const auto collected = stats->collect();
+	REQUIRE( 1u == collected.m_users.size() );
+	REQUIRE( 6u == collected.m_users[ 0 ].m_totals.m_bytes_from_user );
+	REQUIRE( 3u == collected.m_users[ 0 ].m_totals.m_chunks_from_user );
+}
+
+TEST_CASE( "data of released counters isn't lost" )
+{
+	auto stats = std::make_shared< traffic_stats_t >(
+			make_std_traffic_stats_reference_manager() );
+
+	{
+		auto user = stats->acquire_user_counters( 7u );
+		user->add_from_target( 300u );
+	}
+
+	auto collected = stats->collect();
+	REQUIRE( 1u == collected.m_users.size() );
+	REQUIRE( 300u == collected.m_users[ 0 ].m_totals.m_bytes_from_target );
+
+	// The counters are removed, new counters start from zero.
+	{
+		auto user = stats->acquire_user_counters( 7u );
+		user->add_from_target( 10u );
+	}
+
+	collected = stats->collect();
+	REQUIRE( 1u == collected.m_users.size() );
+	REQUIRE( 10u == collected.m_users[ 0 ].m_totals.m_bytes_from_target );
+}
+
+TEST_CASE( "released counters in the middle of the list" )
+{
+	auto stats = std::make_shared< traffic_stats_t >(
+			make_std_traffic_stats_reference_manager() );
+
+	auto first = stats->acquire_user_counters( 1u );
+	auto second = stats->acquire_user_counters( 2u );
+	auto third = stats->acquire_user_counters( 3u );
+
+	first->add_from_user( 1u );
+	second->add_from_user( 2u );
+	third->add_from_user( 3u );
+	second = counters_ref_t{};
+
+	auto collected = stats->collect();
+	REQUIRE( 3u == collected.m_users.size() );
+
+	// The released counters are removed, others are still collected.
+	first->add_from_user( 10u );
+	third->add_from_user( 30u );
+	collected = stats->collect();
+	REQUIRE( 2u == collected.m_users.size() );
+	std::uint64_t total{};
+	for( const auto & u : collected.m_users )
+		total += u.m_totals.m_bytes_from_user;
+	REQUIRE( 40u == total );
+}
+
+TEST_CASE( "limits of users" )
+{
+	auto stats = std::make_shared< traffic_stats_t >(
+			make_std_traffic_stats_reference_manager() );
+
+	auto user = stats->acquire_user_counters( 42u );
+	user->add_from_target( 100u );
+
+	auto collected = stats->collect();
+	REQUIRE( 1u == collected.m_users.size() );
+	REQUIRE( bandlim_config_t::is_unlimited(
+			collected.m_users[ 0 ].m_limits.m_in ) );
+	REQUIRE( bandlim_config_t::is_unlimited(
+			collected.m_users[ 0 ].m_limits.m_out ) );
+
+	user.update_limits( bandlim_config_t{ 1000u, 500u } );
+	user->add_from_target( 100u );
+
+	collected = stats->collect();
+	REQUIRE( 1u == collected.m_users.size() );
+	REQUIRE( 1000u == collected.m_users[ 0 ].m_limits.m_in );
+	REQUIRE( 500u == collected.m_users[ 0 ].m_limits.m_out );
+}
+
+TEST_CASE( "collection in parallel with creation and removal of counters" )
+{
+	auto stats = std::make_shared< traffic_stats_t >(
+			make_std_traffic_stats_reference_manager() );
+
+	constexpr std::uint64_t iterations = 20000u;
+	std::atomic< bool > finished{ false };
+
+	std::thread owner{ [&] {
+			auto acl = stats->acquire_acl_counters( "acl" );
+			for( std::uint64_t i = 0u; i != iterations; ++i )
+			{
+				auto user = stats->acquire_user_counters( i % 7u );
+				user->add_from_user( 1u );
+				acl->add_from_user( 1u );
+			}
+			finished = true;
+		} };
+
+	std::uint64_t users_total{};
+	std::uint64_t acls_total{};
+	const auto collect = [&] {
+			const auto collected = stats->collect();
+			for( const auto & u : collected.m_users )
+				users_total += u.m_totals.m_bytes_from_user;
+			for( const auto & a : collected.m_acls )
+				acls_total += a.second.m_bytes_from_user;
+		};
+
+	while( !finished )
+		collect();
+	owner.join();
+	collect();
+
+	REQUIRE( iterations == users_total );
+	REQUIRE( iterations == acls_total );
+}
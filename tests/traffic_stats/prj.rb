@@ -0,0 +1,15 @@
+require 'rubygems'
+
+gem 'Mxx_ru', '>= 1.3.0'
+
+require 'mxx_ru/cpp'
+
+MxxRu::Cpp::exe_target {
+
+  target 'test-bin/ut_traffic_stats'
+
+  required_prj 'arataga/stats/prj.rb'
+
+  cpp_source 'main.cpp'
+}
+
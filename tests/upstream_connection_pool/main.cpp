@@ -0,0 +1,241 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <arataga/acl_handler/upstream_connection_pool.hpp>
+
+#include <asio/read.hpp>
+#include <asio/write.hpp>
+
+using namespace arataga::acl_handler;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+//! A connected pair of sockets.
+struct connection_pair_t
+{
+	//! The side that is stored in the pool.
+	asio::ip::tcp::socket m_client;
+	//! The side of the target host.
+	asio::ip::tcp::socket m_server;
+};
+
+[[nodiscard]]
+connection_pair_t
+make_connection_pair(
+	asio::io_context & io_ctx,
+	asio::ip::tcp::acceptor & acceptor )
+{
+	connection_pair_t result{
+			asio::ip::tcp::socket{ io_ctx },
+			asio::ip::tcp::socket{ io_ctx }
+		};
+
+	result.m_client.connect( acceptor.local_endpoint() );
+	acceptor.accept( result.m_server );
+
+	// Sockets in the pool are always in non-blocking mode.
+	result.m_client.non_blocking( true );
+
+	return result;
+}
+
+[[nodiscard]]
+upstream_connection_pool_t::key_t
+make_key( std::string host, std::uint16_t port = 80u )
+{
+	return { asio::ip::make_address( "127.0.0.1" ), std::move(host), port };
+}
+
+//! Check that the other side sees EOF.
+[[nodiscard]]
+bool
+is_closed_by_pool( asio::ip::tcp::socket & server )
+{
+	std::uint8_t dummy;
+	asio::error_code ec;
+	server.read_some( asio::buffer( &dummy, sizeof(dummy) ), ec );
+
+	return asio::error::eof == ec || asio::error::connection_reset == ec;
+}
+
+class test_env_t
+{
+public:
+	asio::io_context m_io_ctx;
+	asio::ip::tcp::acceptor m_acceptor{
+			m_io_ctx,
+			asio::ip::tcp::endpoint{ asio::ip::make_address( "127.0.0.1" ), 0u }
+		};
+	std::shared_ptr< timeout_wheel_t > m_wheel{
+			std::make_shared< timeout_wheel_t >( m_io_ctx )
+		};
+	upstream_connection_pool_t m_pool{ m_wheel };
+};
+
+} /* namespace anonymous */
+
+TEST_CASE( "empty pool" )
+{
+	test_env_t env;
+
+	REQUIRE( 0u == env.m_pool.size() );
+	REQUIRE( !env.m_pool.try_acquire( make_key( "localhost" ) ) );
+}
+
+TEST_CASE( "connection is reused" )
+{
+	test_env_t env;
+
+	auto pair = make_connection_pair( env.m_io_ctx, env.m_acceptor );
+	const auto local_endpoint = pair.m_client.local_endpoint();
+
+	env.m_pool.release( make_key( "localhost" ),
+			std::move(pair.m_client), 10u, 1s );
+	REQUIRE( 1u == env.m_pool.size() );
+	REQUIRE( 1u == env.m_wheel->size() );
+
+	// Another host, port or address.
+	REQUIRE( !env.m_pool.try_acquire( make_key( "localhost", 8080u ) ) );
+	REQUIRE( !env.m_pool.try_acquire( make_key( "example.com" ) ) );
+	REQUIRE( !env.m_pool.try_acquire( upstream_connection_pool_t::key_t{
+			asio::ip::make_address( "127.0.0.2" ), "localhost", 80u } ) );
+	REQUIRE( 1u == env.m_pool.size() );
+
+	auto socket = env.m_pool.try_acquire( make_key( "localhost" ) );
+	REQUIRE( socket );
+	REQUIRE( local_endpoint == socket->local_endpoint() );
+	REQUIRE( 0u == env.m_pool.size() );
+	REQUIRE( 0u == env.m_wheel->size() );
+
+	// The connection is still usable.
+	asio::write( *socket, asio::buffer( "ping", 4u ) );
+	char data[ 4 ];
+	asio::read( pair.m_server, asio::buffer( data ) );
+	REQUIRE( std::string_view{ "ping" } == std::string_view{ data, 4u } );
+}
+
+TEST_CASE( "the most recent connection is preferred" )
+{
+	test_env_t env;
+
+	auto pair1 = make_connection_pair( env.m_io_ctx, env.m_acceptor );
+	auto pair2 = make_connection_pair( env.m_io_ctx, env.m_acceptor );
+	const auto local_endpoint2 = pair2.m_client.local_endpoint();
+
+	env.m_pool.release( make_key( "localhost" ),
+			std::move(pair1.m_client), 10u, 1s );
+	env.m_pool.release( make_key( "localhost" ),
+			std::move(pair2.m_client), 10u, 1s );
+	REQUIRE( 2u == env.m_pool.size() );
+
+	auto socket = env.m_pool.try_acquire( make_key( "localhost" ) );
+	REQUIRE( socket );
+	REQUIRE( local_endpoint2 == socket->local_endpoint() );
+	REQUIRE( 1u == env.m_pool.size() );
+}
+
+TEST_CASE( "connections closed by the target host are dropped" )
+{
+	test_env_t env;
+
+	auto pair1 = make_connection_pair( env.m_io_ctx, env.m_acceptor );
+	auto pair2 = make_connection_pair( env.m_io_ctx, env.m_acceptor );
+	auto pair3 = make_connection_pair( env.m_io_ctx, env.m_acceptor );
+	const auto local_endpoint1 = pair1.m_client.local_endpoint();
+
+	env.m_pool.release( make_key( "localhost" ),
+			std::move(pair1.m_client), 10u, 1s );
+	env.m_pool.release( make_key( "localhost" ),
+			std::move(pair2.m_client), 10u, 1s );
+	env.m_pool.release( make_key( "localhost" ),
+			std::move(pair3.m_client), 10u, 1s );
+
+	// The target host closed the connection.
+	pair3.m_server.close();
+	// The target host sent something unexpected.
+	asio::write( pair2.m_server, asio::buffer( "garbage", 7u ) );
+
+	auto socket = env.m_pool.try_acquire( make_key( "localhost" ) );
+	REQUIRE( socket );
+	REQUIRE( local_endpoint1 == socket->local_endpoint() );
+	REQUIRE( 0u == env.m_pool.size() );
+	REQUIRE( 0u == env.m_wheel->size() );
+
+	REQUIRE( is_closed_by_pool( pair2.m_server ) );
+}
+
+TEST_CASE( "the oldest connection is closed if the pool is full" )
+{
+	test_env_t env;
+
+	auto pair1 = make_connection_pair( env.m_io_ctx, env.m_acceptor );
+	auto pair2 = make_connection_pair( env.m_io_ctx, env.m_acceptor );
+	auto pair3 = make_connection_pair( env.m_io_ctx, env.m_acceptor );
+
+	env.m_pool.release( make_key( "first" ),
+			std::move(pair1.m_client), 2u, 1s );
+	env.m_pool.release( make_key( "second" ),
+			std::move(pair2.m_client), 2u, 1s );
+	env.m_pool.release( make_key( "third" ),
+			std::move(pair3.m_client), 2u, 1s );
+
+	REQUIRE( 2u == env.m_pool.size() );
+	REQUIRE( is_closed_by_pool( pair1.m_server ) );
+	REQUIRE( !env.m_pool.try_acquire( make_key( "first" ) ) );
+	REQUIRE( env.m_pool.try_acquire( make_key( "second" ) ) );
+	REQUIRE( env.m_pool.try_acquire( make_key( "third" ) ) );
+}
+
+TEST_CASE( "zero size of the pool" )
+{
+	test_env_t env;
+
+	auto pair = make_connection_pair( env.m_io_ctx, env.m_acceptor );
+
+	env.m_pool.release( make_key( "localhost" ),
+			std::move(pair.m_client), 0u, 1s );
+
+	REQUIRE( 0u == env.m_pool.size() );
+	REQUIRE( is_closed_by_pool( pair.m_server ) );
+}
+
+TEST_CASE( "idle connections are closed by the time-out" )
+{
+	test_env_t env;
+
+	auto pair1 = make_connection_pair( env.m_io_ctx, env.m_acceptor );
+	auto pair2 = make_connection_pair( env.m_io_ctx, env.m_acceptor );
+
+	const auto now = std::chrono::steady_clock::now();
+
+	env.m_pool.release( make_key( "localhost" ),
+			std::move(pair1.m_client), 10u, 1s );
+	env.m_pool.release( make_key( "localhost" ),
+			std::move(pair2.m_client), 10u, 1min );
+
+	env.m_wheel->advance( now + 2s );
+	REQUIRE( 1u == env.m_pool.size() );
+	REQUIRE( is_closed_by_pool( pair1.m_server ) );
+
+	env.m_wheel->advance( now + 2min );
+	REQUIRE( 0u == env.m_pool.size() );
+	REQUIRE( is_closed_by_pool( pair2.m_server ) );
+}
+
+TEST_CASE( "clear" )
+{
+	test_env_t env;
+
+	auto pair = make_connection_pair( env.m_io_ctx, env.m_acceptor );
+
+	env.m_pool.release( make_key( "localhost" ),
+			std::move(pair.m_client), 10u, 1s );
+
+	env.m_pool.clear();
+	REQUIRE( 0u == env.m_pool.size() );
+	REQUIRE( 0u == env.m_wheel->size() );
+	REQUIRE( is_closed_by_pool( pair.m_server ) );
+}
+
@@ -0,0 +1,260 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <arataga/user_list_auth_snapshot.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+using namespace arataga::user_list_auth;
+using arataga::bandlim_config_t;
+
+namespace
+{
+
+[[nodiscard]]
+auth_data_t
+make_test_data()
+{
+	auth_data_t data;
+
+	data.m_by_ip.emplace(
+			auth_by_ip_key_t{
+				asio::ip::make_address_v4( "127.0.0.1" ),
+				3000u,
+				asio::ip::make_address_v4( "10.0.0.1" )
+			},
+			user_data_t{ bandlim_config_t{ 1024u, 2048u }, 0u, 1u } );
+	data.m_by_ip.emplace(
+			auth_by_ip_key_t{
+				asio::ip::make_address_v4( "127.0.0.1" ),
+				3000u,
+				asio::ip::make_address_v4( "10.0.0.2" )
+			},
+			user_data_t{ bandlim_config_t{}, 1u, 2u } );
+
+	data.m_by_login.emplace(
+			auth_by_login_key_t{
+				asio::ip::make_address_v4( "127.0.0.1" ),
+				3000u,
+				"user",
+				"12345"
+			},
+			user_data_t{ bandlim_config_t{ 512u, 512u }, 1u, 3u } );
+	data.m_by_login.emplace(
+			auth_by_login_key_t{
+				asio::ip::make_address_v4( "127.0.0.2" ),
+				8080u,
+				"another-user",
+				""
+			},
+			user_data_t{ bandlim_config_t{}, 0u, 4u } );
+
+	data.m_site_limits.emplace(
+			site_limits_key_t{ 1u },
+			site_limits_data_t{ site_limits_data_t::limits_container_t{
+				{ "vk.com"_dn, bandlim_config_t{ 1024u, 1024u } },
+				{ "api.vk.com"_dn, bandlim_config_t{ 3024u, 0u } }
+			} } );
+
+	return data;
+}
+
+[[nodiscard]]
+bool
+same_content( const auth_data_t & a, const auth_data_t & b )
+{
+	return a.m_by_ip == b.m_by_ip &&
+			a.m_by_login == b.m_by_login &&
+			a.m_site_limits == b.m_site_limits;
+}
+
+//! Temporary file that is removed at the end of the test.
+class temp_file_t
+{
+	std::filesystem::path m_name;
+
+public:
+	explicit temp_file_t( std::string name )
+		:	m_name{ std::filesystem::temp_directory_path() / std::move(name) }
+	{
+		std::filesystem::remove( m_name );
+	}
+
+	~temp_file_t()
+	{
+		std::error_code ec;
+		std::filesystem::remove( m_name, ec );
+	}
+
+	[[nodiscard]]
+	const std::filesystem::path &
+	name() const noexcept { return m_name; }
+};
+
+[[nodiscard]]
+std::string
+load_file( const std::filesystem::path & name )
+{
+	std::ifstream file{ name, std::ios_base::in | std::ios_base::binary };
+	return std::string{
+			std::istreambuf_iterator< char >{ file },
+			std::istreambuf_iterator< char >{}
+		};
+}
+
+void
+store_file( const std::filesystem::path & name, const std::string & content )
+{
+	std::ofstream file{ name,
+			std::ios_base::out | std::ios_base::binary | std::ios_base::trunc };
+	file.write( content.data(), static_cast< std::streamsize >( content.size() ) );
+}
+
+} /* namespace anonymous */
+
+TEST_CASE( "content checksum" )
+{
+	REQUIRE( calculate_content_checksum( "abc" ) ==
+			calculate_content_checksum( "abc" ) );
+	REQUIRE( calculate_content_checksum( "abc" ) !=
+			calculate_content_checksum( "abd" ) );
+	REQUIRE( calculate_content_checksum( "" ) !=
+			calculate_content_checksum( "\n" ) );
+}
+
+TEST_CASE( "store and load" )
+{
+	temp_file_t file{ "arataga-ut-user-list-snapshot-1.bin" };
+
+	const auto data = make_test_data();
+	store_auth_data_snapshot( file.name(), data, 42u );
+
+	const auto loaded = try_load_auth_data_snapshot( file.name(), 42u );
+	REQUIRE( loaded );
+	REQUIRE( same_content( data, *loaded ) );
+}
+
+TEST_CASE( "empty user-list" )
+{
+	temp_file_t file{ "arataga-ut-user-list-snapshot-2.bin" };
+
+	store_auth_data_snapshot( file.name(), auth_data_t{}, 0u );
+
+	const auto loaded = try_load_auth_data_snapshot( file.name(), 0u );
+	REQUIRE( loaded );
+	REQUIRE( same_content( auth_data_t{}, *loaded ) );
+}
+
+TEST_CASE( "no snapshot" )
+{
+	temp_file_t file{ "arataga-ut-user-list-snapshot-3.bin" };
+
+	REQUIRE( !try_load_auth_data_snapshot( file.name(), 42u ) );
+}
+
+TEST_CASE( "outdated snapshot" )
+{
+	temp_file_t file{ "arataga-ut-user-list-snapshot-4.bin" };
+
+	store_auth_data_snapshot( file.name(), make_test_data(), 42u );
+
+	REQUIRE( !try_load_auth_data_snapshot( file.name(), 43u ) );
+}
+
+TEST_CASE( "snapshot is replaced" )
+{
+	temp_file_t file{ "arataga-ut-user-list-snapshot-5.bin" };
+
+	store_auth_data_snapshot( file.name(), make_test_data(), 42u );
+	store_auth_data_snapshot( file.name(), auth_data_t{}, 43u );
+
+	REQUIRE( !try_load_auth_data_snapshot( file.name(), 42u ) );
+
+	const auto loaded = try_load_auth_data_snapshot( file.name(), 43u );
+	REQUIRE( loaded );
+	REQUIRE( loaded->m_by_ip.empty() );
+}
+
+TEST_CASE( "damaged payload" )
+{
+	temp_file_t file{ "arataga-ut-user-list-snapshot-6.bin" };
+
+	store_auth_data_snapshot( file.name(), make_test_data(), 42u );
+	auto content = load_file( file.name() );
+	content[ content.size() - 3u ] ^= 0x5a;
+	store_file( file.name(), content );
+
+	REQUIRE_THROWS_AS(
+			(void)try_load_auth_data_snapshot( file.name(), 42u ),
+			std::runtime_error );
+}
+
+TEST_CASE( "truncated payload" )
+{
+	temp_file_t file{ "arataga-ut-user-list-snapshot-7.bin" };
+
+	store_auth_data_snapshot( file.name(), make_test_data(), 42u );
+	const auto content = load_file( file.name() );
+	store_file( file.name(), content.substr( 0u, content.size() - 1u ) );
+
+	REQUIRE_THROWS_AS(
+			(void)try_load_auth_data_snapshot( file.name(), 42u ),
+			std::runtime_error );
+}
+
+TEST_CASE( "truncated header" )
+{
+	temp_file_t file{ "arataga-ut-user-list-snapshot-8.bin" };
+
+	store_auth_data_snapshot( file.name(), make_test_data(), 42u );
+	store_file( file.name(), load_file( file.name() ).substr( 0u, 10u ) );
+
+	REQUIRE_THROWS_AS(
+			(void)try_load_auth_data_snapshot( file.name(), 42u ),
+			std::runtime_error );
+}
+
+TEST_CASE( "not a snapshot" )
+{
+	temp_file_t file{ "arataga-ut-user-list-snapshot-9.bin" };
+
+	store_file( file.name(), std::string( 256u, 'x' ) );
+
+	REQUIRE_THROWS_AS(
+			(void)try_load_auth_data_snapshot( file.name(), 42u ),
+			std::runtime_error );
+}
+
+TEST_CASE( "foreign byte order" )
+{
+	temp_file_t file{ "arataga-ut-user-list-snapshot-10.bin" };
+
+	store_auth_data_snapshot( file.name(), make_test_data(), 42u );
+	auto content = load_file( file.name() );
+	// The byte order marker follows the 8-byte magic.
+	std::reverse( content.begin() + 8, content.begin() + 12 );
+	store_file( file.name(), content );
+
+	REQUIRE_THROWS_AS(
+			(void)try_load_auth_data_snapshot( file.name(), 42u ),
+			std::runtime_error );
+}
+
+TEST_CASE( "unsupported version" )
+{
+	temp_file_t file{ "arataga-ut-user-list-snapshot-11.bin" };
+
+	store_auth_data_snapshot( file.name(), make_test_data(), 42u );
+	auto content = load_file( file.name() );
+	// The version follows the byte order marker.
+	content[ 12u ] ^= 0x5a;
+	store_file( file.name(), content );
+
+	REQUIRE_THROWS_AS(
+			(void)try_load_auth_data_snapshot( file.name(), 42u ),
+			std::runtime_error );
+}
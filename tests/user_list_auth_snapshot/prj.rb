@@ -0,0 +1,16 @@
+require 'rubygems'
+
+gem 'Mxx_ru', '>= 1.3.0'
+
+require 'mxx_ru/cpp'
+
+MxxRu::Cpp::exe_target {
+
+  target 'test-bin/ut_user_list_auth_snapshot'
+
+  lib 'stdc++fs'
+
+  required_prj 'arataga/user_list_auth_data.rb'
+
+  cpp_source 'main.cpp'
+}
@@ -0,0 +1,113 @@
+/*
+ * A benchmark for parsing of a big user-list.
+ *
+ * Compares the sequential parse_auth_data() with
+ * parse_auth_data_in_parallel() for different numbers of threads.
+ *
+ * Usage: user_list_parser_bench [LINES_COUNT [MAX_THREADS]]
+ */
+
+#include <arataga/user_list_auth_data.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <fmt/format.h>
+
+using namespace arataga::user_list_auth;
+
+namespace
+{
+
+constexpr std::uint32_t site_limits_count = 100u;
+
+[[nodiscard]]
+std::string
+make_user_list( std::uint32_t lines_count )
+{
+	std::string result;
+	result.reserve( static_cast< std::size_t >( lines_count ) * 64u );
+
+	auto out = std::back_inserter( result );
+
+	fmt::format_to( out, "# A synthetic user-list with {} lines.\n",
+			lines_count );
+
+	for( std::uint32_t i = 0u; i != site_limits_count; ++i )
+		fmt::format_to( out,
+				"{} = vk.com 10MiB 10MiB api.vk.com 5MiB 5MiB "
+				"site-{}.com 1MiB 1MiB\n",
+				i, i );
+
+	for( std::uint32_t i = site_limits_count; i < lines_count; ++i )
+	{
+		const auto proxy = fmt::format( "10.0.0.{} {}",
+				i % 8u, 3000u + i % 50u );
+
+		if( i % 2u )
+			fmt::format_to( out, "{} user-{} secret-password-{} = "
+					"{}KiB {}KiB {} {}\n",
+					proxy, i, i * 7919u,
+					i % 1000u, i % 1000u, i % site_limits_count, i );
+		else
+			fmt::format_to( out, "{} {} = {}KiB {}KiB {} {}\n",
+					proxy, 0xc0a80000u + i,
+					i % 1000u, i % 1000u, i % site_limits_count, i );
+	}
+
+	return result;
+}
+
+template< typename Lambda >
+void
+measure(
+	const std::string & name,
+	Lambda && lambda )
+{
+	const auto started_at = std::chrono::steady_clock::now();
+	const auto data = lambda();
+	const auto finished_at = std::chrono::steady_clock::now();
+
+	std::cout << name << ": "
+			<< std::chrono::duration_cast< std::chrono::milliseconds >(
+					finished_at - started_at ).count()
+			<< "ms (by_ip: " << data.m_by_ip.size()
+			<< ", by_login: " << data.m_by_login.size()
+			<< ", site_limits: " << data.m_site_limits.size() << ")"
+			<< std::endl;
+}
+
+} /* namespace anonymous */
+
+int
+main( int argc, char ** argv )
+{
+	const std::uint32_t lines_count = argc > 1 ?
+			static_cast< std::uint32_t >( std::strtoul( argv[ 1 ], nullptr, 10 ) )
+			: 1000000u;
+	const unsigned int max_threads = argc > 2 ?
+			static_cast< unsigned int >( std::strtoul( argv[ 2 ], nullptr, 10 ) )
+			: std::max( 1u, std::thread::hardware_concurrency() );
+
+	const auto content = make_user_list( lines_count );
+	std::cout << "lines: " << lines_count
+			<< ", size: " << content.size() << " byte(s)" << std::endl;
+
+	measure( "parse_auth_data", [&] {
+			return parse_auth_data( content );
+		} );
+
+	for( unsigned int threads = 1u; threads <= max_threads; threads *= 2u )
+		measure( fmt::format( "parse_auth_data_in_parallel, threads: {}",
+					threads ),
+			[&] {
+				return parse_auth_data_in_parallel( content, threads );
+			} );
+
+	return 0;
+}
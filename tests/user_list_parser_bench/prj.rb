@@ -0,0 +1,12 @@
+require 'mxx_ru/cpp'
+
+MxxRu::Cpp::exe_target {
+
+	target 'test-bin/user_list_parser_bench'
+
+	lib 'stdc++fs'
+
+	required_prj 'arataga/user_list_auth_data.rb'
+
+	cpp_source 'main.cpp'
+}